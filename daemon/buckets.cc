@@ -55,6 +55,7 @@ void Bucket::reset() {
         c.reset();
     }
     subjson_operation_times.reset();
+    subdocIndexCache.clear();
     timings.reset();
     for (auto& s : high_resolution_stats) {
         s.reset();
@@ -129,6 +130,8 @@ void Bucket::addHighResolutionStats(
                       aggregatedStats.cmd_subdoc_mutation);
     collector.addStat(Key::subdoc_offload_count,
                       aggregatedStats.subdoc_offload_count);
+    collector.addStat(Key::subdoc_frontend_execute_time,
+                      aggregatedStats.subdoc_frontend_execute_time);
 
     collector.addStat(Key::bytes_subdoc_lookup_total,
                       aggregatedStats.bytes_subdoc_lookup_total);
@@ -12,6 +12,7 @@
 #include "cluster_config.h"
 #include "sloppy_gauge.h"
 #include "stat_timings.h"
+#include "subdocument_index_cache.h"
 #include "thread_stats.h"
 #include "timings.h"
 
@@ -175,6 +176,9 @@ public:
     /// Snappy decompression time histogram.
     Hdr1sfMicroSecHistogram snappyDecompressionTimes;
 
+    /// The location of the paths looked up in the hot documents
+    SubdocIndexCache subdocIndexCache;
+
     using ResponseCounter = cb::RelaxedAtomic<uint64_t>;
 
     /**
@@ -0,0 +1,61 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "busy_poller.h"
+
+#include "settings.h"
+#include "stats.h"
+
+void BusyPoller::start() {
+    if (stopped || isLoopCallbackScheduled()) {
+        return;
+    }
+    const auto budget = Settings::instance().getBusyPollTime();
+    if (budget.count() == 0) {
+        return;
+    }
+    lastWork = work.load();
+    last = std::chrono::steady_clock::now();
+    deadline = last + budget;
+    base.runInLoop(this);
+}
+
+void BusyPoller::stop() {
+    stopped = true;
+    if (isLoopCallbackScheduled()) {
+        cancelLoopCallback();
+    }
+    flushSpinTime();
+}
+
+void BusyPoller::runLoopCallback() noexcept {
+    // Only the iterations which didn't serve any connection count as time
+    // burnt polling, and serving a connection restarts the idle timer
+    const auto now = std::chrono::steady_clock::now();
+    const auto current = work.load();
+    if (current == lastWork) {
+        spinTime += now - last;
+    } else {
+        lastWork = current;
+        deadline = now + Settings::instance().getBusyPollTime();
+    }
+    last = now;
+
+    if (!stopped && now < deadline) {
+        base.runInLoop(this);
+        return;
+    }
+    // Let the next iteration block in epoll
+    flushSpinTime();
+}
+
+void BusyPoller::flushSpinTime() {
+    global_statistics.busy_poll_spin_time_ns += spinTime.count();
+    spinTime = std::chrono::nanoseconds{0};
+}
@@ -0,0 +1,69 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <folly/io/async/EventBase.h>
+#include <relaxed_atomic.h>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * The BusyPoller keeps the event loop of a front end thread polling for
+ * events without blocking until the thread has been idle for the
+ * busy_poll_time (see Settings::getBusyPollTime()).
+ *
+ * While it is spinning the BusyPoller keeps itself scheduled as a loop
+ * callback, and folly doesn't block in epoll while a loop callback is
+ * pending. The thread stays in EventBase::loopForever() all the time so
+ * EventBase::isInEventBaseThread() keeps working.
+ *
+ * All methods must be called in the context of the thread running the
+ * event base.
+ */
+class BusyPoller : public folly::EventBase::LoopCallback {
+public:
+    /**
+     * @param base The event base of the thread
+     * @param work The CPU time spent serving connections by the thread
+     *             (the thread is idle as long as it doesn't change)
+     */
+    BusyPoller(folly::EventBase& base, const cb::RelaxedAtomic<uint64_t>& work)
+        : base(base), work(work) {
+    }
+
+    /**
+     * The thread served a connection; start spinning (if busy polling is
+     * enabled and the poller isn't already spinning)
+     */
+    void start();
+
+    /// Stop spinning for good (the event loop is stopping)
+    void stop();
+
+    /// Called once per event loop iteration while spinning
+    void runLoopCallback() noexcept override;
+
+protected:
+    /// Account the time spent spinning without finding any work
+    void flushSpinTime();
+
+    folly::EventBase& base;
+    const cb::RelaxedAtomic<uint64_t>& work;
+    /// Set by stop()
+    bool stopped = false;
+    /// The value of work at the previous iteration
+    uint64_t lastWork = 0;
+    /// The time of the previous iteration
+    std::chrono::steady_clock::time_point last;
+    /// When to stop spinning unless the thread does some work
+    std::chrono::steady_clock::time_point deadline;
+    /// The time spent in iterations which didn't find any work
+    std::chrono::nanoseconds spinTime{0};
+};
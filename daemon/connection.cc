@@ -11,6 +11,7 @@
 
 #include "bucket_manager.h"
 #include "buckets.h"
+#include "connection_io_uring.h"
 #include "connection_libevent.h"
 #include "cookie.h"
 #include "external_auth_manager_thread.h"
@@ -72,7 +73,7 @@ void Connection::shutdown() {
         ++global_statistics.curr_conn_closing;
         shutdown_initiated = std::chrono::steady_clock::now();
         pending_close_next_log = *shutdown_initiated + std::chrono::seconds(10);
-        thread.onInitiateShutdown(*this);
+        thread->onInitiateShutdown(*this);
         state = State::closing;
     }
 }
@@ -208,7 +209,12 @@ nlohmann::json Connection::to_json() const {
         break;
     }
 
+    ret["backend"] = format_as(getBackend());
     ret["ssl"] = isTlsEnabled();
+    if (isTlsEnabled()) {
+        ret["ktls"] = {{"send", kernelTls.send},
+                       {"receive", kernelTls.receive}};
+    }
     ret["datatype"] = cb::mcbp::datatype::to_string(datatypeFilter.getRaw());
     ret["last_used"] =
             cb::time2text(std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -219,11 +225,16 @@ nlohmann::json Connection::to_json() const {
     return ret;
 }
 
+ConnectionBackend Connection::getBackend() const {
+    return ConnectionBackend::Libevent;
+}
+
 nlohmann::json Connection::to_json_tcp() const {
     nlohmann::json ret;
 
     ret["total_recv"] = totalRecv;
     ret["total_send"] = totalSend;
+    ret["total_send_chained"] = totalSendChained;
 
     ret["sendqueue"]["actual"] = getSendQueueSize();
     ret["sendqueue"]["size"] = sendQueueInfo.size;
@@ -507,7 +518,12 @@ void Connection::setBucketIndex(std::shared_ptr<Bucket> bucketptr,
 }
 
 void Connection::addCpuTime(std::chrono::nanoseconds ns) {
+    thread->cpuTime += ns.count();
+    thread->busyPoller.start();
     total_cpu_time += ns;
+    fairShare.virtualTime += static_cast<uint64_t>(ns.count()) *
+                             FairShareWeights::DefaultWeight /
+                             fairShare.weight;
     min_sched_time = std::min(min_sched_time, ns);
     max_sched_time = std::max(max_sched_time, ns);
 }
@@ -612,6 +628,10 @@ bool Connection::processAllReadyCookies() {
                 cookie->reset();
                 ++iter;
             } else {
+                // Keep the cookie (and the buffers it owns) around for
+                // the next command rather than freeing it
+                cookie->reset();
+                spareCookies.emplace_back(std::move(cookie));
                 iter = cookies.erase(iter);
             }
         } else {
@@ -723,7 +743,12 @@ void Connection::executeCommandPipeline() {
                     tokenAuthData && tokenAuthData->isStale(now);
             if (!cookies.back()->empty()) {
                 // Create a new entry if we can't reuse the last entry
-                cookies.emplace_back(std::make_unique<Cookie>(*this));
+                if (spareCookies.empty()) {
+                    cookies.emplace_back(std::make_unique<Cookie>(*this));
+                } else {
+                    cookies.emplace_back(std::move(spareCookies.back()));
+                    spareCookies.pop_back();
+                }
             }
 
             auto& cookie = *cookies.back();
@@ -800,7 +825,12 @@ void Connection::executeCommandPipeline() {
             // We have the entire packet spooled up in the input buffer
             // and may continue processing it at the next time slice
             disableReadEvent();
-            triggerCallback();
+            if (Settings::instance().isFairShareScheduling() &&
+                getSendQueueSize() == 0) {
+                thread->fairShareScheduler.schedule(*this);
+            } else {
+                triggerCallback();
+            }
         } else {
             enableReadEvent();
         }
@@ -918,7 +948,7 @@ void Connection::processNotifiedCookie(
         std::chrono::steady_clock::time_point scheduled) {
     using namespace std::chrono;
     const auto now = steady_clock::now();
-    cookie_notification_histogram[thread.index].add(
+    cookie_notification_histogram[thread->index].add(
             duration_cast<microseconds>(now - scheduled));
     Expects(cookie.isEwouldblock());
     cookie.setAiostat(status);
@@ -1035,11 +1065,18 @@ bool Connection::executeCommandsCallback() {
     cb::DebugVariable bucketName(cb::toCharArrayN<32>(getBucket().name));
     const auto start = last_used_timestamp = std::chrono::steady_clock::now();
 
-    if (thread.keyTrace && thread.keyTrace->is_expired(start)) {
-        thread.keyTrace.reset();
+    if (thread->keyTrace && thread->keyTrace->is_expired(start)) {
+        thread->keyTrace.reset();
     }
 
-    current_timeslice_end = start + Settings::instance().getCommandTimeSlice();
+    std::chrono::microseconds timeslice =
+            Settings::instance().getCommandTimeSlice();
+    if (Settings::instance().isFairShareScheduling()) {
+        // The CPU budget is proportional to the weight
+        timeslice = timeslice * fairShare.weight /
+                    FairShareWeights::DefaultWeight;
+    }
+    current_timeslice_end = start + timeslice;
 
     processBlockedSendQueue(start);
     shutdownIfSendQueueStuck(start);
@@ -1073,7 +1110,7 @@ bool Connection::executeCommandsCallback() {
 
         if (state == State::immediate_close) {
             if (isDCP()) {
-                thread.removeThrottleableDcpConnection(*this);
+                thread->removeThrottleableDcpConnection(*this);
             }
 
             BucketManager::instance().disassociateBucket(*this);
@@ -1188,7 +1225,7 @@ void Connection::setAuthenticated(cb::rbac::UserIdent ui) {
                 std::make_shared<cb::rbac::PrivilegeContext>(createContext({}));
     }
     updatePrivilegeContext();
-    thread.onConnectionAuthenticated(*this);
+    thread->onConnectionAuthenticated(*this);
     if (!isInternal() && !registeredSdk && agentName.front() != '\0') {
         SdkConnectionManager::instance().registerSdk(
                 std::string_view(agentName.data()));
@@ -1238,6 +1275,11 @@ void Connection::updateSendBytes(size_t nbytes) {
     get_high_resolution_thread_stats(*this).bytes_written += nbytes;
 }
 
+void Connection::updateChainedSendBytes(size_t nbytes) {
+    totalSendChained += nbytes;
+    updateSendBytes(nbytes);
+}
+
 void Connection::updateRecvBytes(size_t nbytes) {
     totalRecv += nbytes;
     get_high_resolution_thread_stats(*this).bytes_read += nbytes;
@@ -1246,7 +1288,7 @@ void Connection::updateRecvBytes(size_t nbytes) {
 Connection::Connection(FrontEndThread& thr)
     : ConnectionIface({{"ip", "unknown"}, {"port", 0}},
                       {{"ip", "unknown"}, {"port", 0}}),
-      thread(thr),
+      thread(&thr),
       listening_port(std::make_shared<ListeningPort>(
               "dummy", "127.0.0.1", 11210, AF_INET, false, false)),
       max_reqs_per_event(Settings::instance().getRequestsPerEventNotification(
@@ -1256,7 +1298,7 @@ Connection::Connection(FrontEndThread& thr)
     cookies.emplace_back(std::make_unique<Cookie>(*this));
     setConnectionId("unknown:0");
     global_statistics.conn_structs++;
-    thread.onConnectionCreate(*this);
+    thread->onConnectionCreate(*this);
 }
 
 std::unique_ptr<Connection> Connection::create(
@@ -1268,6 +1310,25 @@ std::unique_ptr<Connection> Connection::create(
             throw std::runtime_error(
                     "Connection::create: Failed to create TLS context");
         }
+#ifdef SSL_OP_ENABLE_KTLS
+        if (Settings::instance().isTlsKernelOffload()) {
+            // OpenSSL installs the session keys in the kernel when the
+            // handshake completes if the kernel supports the negotiated
+            // cipher (and keeps doing the crypto in user space if not).
+            // The socket BIO created by the bufferevent then passes the
+            // plain text records to the kernel.
+            SSL_set_options(context.get(), SSL_OP_ENABLE_KTLS);
+        }
+#endif
+    }
+
+    if (!context && Settings::instance().getConnectionBackend() ==
+                            ConnectionBackend::IoUring) {
+        auto* ring = thr.getIoUringRing();
+        if (ring) {
+            return std::make_unique<IoUringConnection>(
+                    sfd, thr, std::move(descr), *ring);
+        }
     }
 
     return std::make_unique<LibeventConnection>(
@@ -1302,7 +1363,7 @@ Connection::Connection(SOCKET sfd,
                        std::shared_ptr<ListeningPort> descr)
     : ConnectionIface(cb::net::getPeerNameAsJson(sfd),
                       cb::net::getSockNameAsJson(sfd)),
-      thread(thr),
+      thread(&thr),
       listening_port(std::move(descr)),
       max_reqs_per_event(Settings::instance().getRequestsPerEventNotification(
               EventPriority::Default)),
@@ -1311,7 +1372,7 @@ Connection::Connection(SOCKET sfd,
     cookies.emplace_back(std::make_unique<Cookie>(*this));
     setConnectionId(cb::net::getpeername(socketDescriptor));
     global_statistics.conn_structs++;
-    thread.onConnectionCreate(*this);
+    thread->onConnectionCreate(*this);
 }
 
 bool Connection::maybeInitiateShutdown(const std::string_view reason,
@@ -1326,7 +1387,7 @@ bool Connection::maybeInitiateShutdown(const std::string_view reason,
         }
     }
 
-    thread.onConnectionForcedDisconnect(*this);
+    thread->onConnectionForcedDisconnect(*this);
     auto message = fmt::format("Initiate shutdown of connection from '{}': {}",
                                peername.dump(),
                                reason);
@@ -1358,7 +1419,7 @@ void Connection::reportIfStuckInShutdown(
 }
 
 Connection::~Connection() {
-    thread.onConnectionDestroy(*this);
+    thread->onConnectionDestroy(*this);
     cb::audit::addSessionTerminated(*this);
 
     if (listening_port->system) {
@@ -1499,6 +1560,22 @@ bool Connection::signalIfIdle() {
     return false;
 }
 
+bool Connection::isMigratable() const {
+    if (state != State::running || !isAuthenticated() || isDCP() ||
+        isDuplexSupported() || !isMigrationSupported() ||
+        fairShare.queued) {
+        return false;
+    }
+
+    // No commands may be in flight (or referenced by the engine)
+    for (const auto& c : cookies) {
+        if (!c->empty() || c->getRefcount()) {
+            return false;
+        }
+    }
+    return getSendQueueSize() == 0;
+}
+
 void Connection::setPriority(ConnectionPriority priority_) {
     priority.store(priority_);
     switch (priority_) {
@@ -1550,6 +1627,10 @@ void Connection::setDcpFlowControlBufferSize(std::size_t size) {
     }
 }
 
+bool Connection::isSendQueueFull() const {
+    return getSendQueueSize() >= Settings::instance().getMaxSendQueueSize();
+}
+
 static constexpr size_t MaxFrameInfoSize =
         cb::mcbp::response::ServerRecvSendDurationFrameInfoSize +
         cb::mcbp::response::ReadUnitsFrameInfoSize +
@@ -1796,7 +1877,7 @@ cb::engine_errc Connection::add_stream_rsp(uint32_t opaque,
                                            cb::mcbp::Status status) {
     cb::mcbp::response::DcpAddStreamPayload extras;
     extras.setOpaque(dialogopaque);
-    cb::mcbp::ResponseBuilder builder(thread.getScratchBuffer());
+    cb::mcbp::ResponseBuilder builder(thread->getScratchBuffer());
     builder.setMagic(cb::mcbp::Magic::ClientResponse);
     builder.setOpcode(cb::mcbp::ClientOpcode::DcpAddStream);
     builder.setStatus(status);
@@ -1822,7 +1903,7 @@ cb::engine_errc Connection::marker_rsp(uint32_t opaque,
 
 cb::engine_errc Connection::set_vbucket_state_rsp(uint32_t opaque,
                                                   cb::mcbp::Status status) {
-    cb::mcbp::ResponseBuilder builder(thread.getScratchBuffer());
+    cb::mcbp::ResponseBuilder builder(thread->getScratchBuffer());
     builder.setMagic(cb::mcbp::Magic::ClientResponse);
     builder.setOpcode(cb::mcbp::ClientOpcode::DcpSetVbucketState);
     builder.setStatus(status);
@@ -1836,7 +1917,7 @@ cb::engine_errc Connection::stream_end(uint32_t opaque,
                                        cb::mcbp::DcpStreamEndStatus status,
                                        cb::mcbp::DcpStreamId sid) {
     using Framebuilder = cb::mcbp::FrameBuilder<cb::mcbp::Request>;
-    Framebuilder builder(thread.getScratchBuffer());
+    Framebuilder builder(thread->getScratchBuffer());
     builder.setMagic(sid ? cb::mcbp::Magic::AltClientRequest
                          : cb::mcbp::Magic::ClientRequest);
     builder.setOpcode(cb::mcbp::ClientOpcode::DcpStreamEnd);
@@ -1958,7 +2039,7 @@ cb::engine_errc Connection::mutation_or_cache_message(
             sidbuffer = frameExtras.getBuffer();
         }
 
-        if (value.size() > SendBuffer::MinimumDataSize) {
+        if (shouldChainData(value.size())) {
             copyToOutputStream(
                     {reinterpret_cast<const char*>(&req), sizeof(req)},
                     sidbuffer,
@@ -2004,6 +2085,84 @@ cb::engine_errc Connection::mutation(uint32_t opaque,
                                      sid);
 }
 
+cb::engine_errc Connection::mutation_patch(uint32_t opaque,
+                                           cb::unique_item_ptr it,
+                                           Vbid vbucket,
+                                           uint64_t by_seqno,
+                                           uint64_t rev_seqno,
+                                           uint32_t lock_time,
+                                           uint8_t nru,
+                                           uint64_t base_cas,
+                                           uint32_t offset,
+                                           uint32_t remove_length,
+                                           uint32_t insert_length,
+                                           cb::mcbp::DcpStreamId sid) {
+    auto key = it->getDocKey();
+    const auto insert = it->getValueView().substr(offset, insert_length);
+    const auto doc_read_bytes = key.size() + insert.size();
+
+    // The client doesn't support collections, so must not send an encoded key
+    if (!isCollectionsSupported()) {
+        key = key.makeDocKeyWithoutCollectionID();
+    }
+
+    cb::mcbp::request::DcpMutationPayload extras(
+            by_seqno,
+            rev_seqno,
+            it->getFlags(),
+            gsl::narrow<uint32_t>(it->getExptime()),
+            lock_time,
+            nru);
+    cb::mcbp::request::DcpMutationPatchHeader patch(
+            base_cas, offset, remove_length);
+
+    cb::mcbp::DcpStreamIdFrameInfo frameExtras(sid);
+
+    cb::mcbp::Request req = {};
+    req.setMagic(sid ? cb::mcbp::Magic::AltClientRequest
+                     : cb::mcbp::Magic::ClientRequest);
+    req.setOpcode(cb::mcbp::ClientOpcode::DcpMutationPatch);
+    req.setExtlen(gsl::narrow<uint8_t>(sizeof(extras)));
+    req.setKeylen(gsl::narrow<uint16_t>(key.size()));
+    req.setBodylen(gsl::narrow<uint32_t>(
+            sizeof(extras) + key.size() + sizeof(patch) + insert.size() +
+            (sid ? sizeof(cb::mcbp::DcpStreamIdFrameInfo) : 0)));
+    req.setOpaque(opaque);
+    req.setVBucket(vbucket);
+    req.setCas(it->getCas());
+    req.setDatatype(it->getDataType());
+
+    if (sid) {
+        req.setFramingExtraslen(sizeof(cb::mcbp::DcpStreamIdFrameInfo));
+    }
+
+    try {
+        std::string_view sidbuffer;
+        if (sid) {
+            sidbuffer = frameExtras.getBuffer();
+        }
+
+        const auto patchbuffer = patch.getBuffer();
+        std::array<std::string_view, 6> data{
+                {{reinterpret_cast<const char*>(&req), sizeof(req)},
+                 sidbuffer,
+                 extras.getBuffer(),
+                 key.getBuffer(),
+                 {reinterpret_cast<const char*>(patchbuffer.data()),
+                  patchbuffer.size()},
+                 insert}};
+        copyToOutputStream(data);
+    } catch (const std::bad_alloc&) {
+        /// We might have written a partial message into the buffer so
+        /// we need to disconnect the client
+        return cb::engine_errc::disconnect;
+    }
+
+    getBucket().recordDcpMeteringReadBytes(
+            *this, doc_read_bytes, dcpResourceAllocationDomain);
+    return cb::engine_errc::success;
+}
+
 cb::engine_errc Connection::deletionInner(const ItemIface& item,
                                           cb::const_byte_buffer packet,
                                           const DocKeyView& key) {
@@ -2211,7 +2370,7 @@ cb::engine_errc Connection::set_vbucket_state(uint32_t opaque,
 
     cb::mcbp::request::DcpSetVBucketState extras;
     extras.setState(static_cast<uint8_t>(st));
-    cb::mcbp::RequestBuilder builder(thread.getScratchBuffer());
+    cb::mcbp::RequestBuilder builder(thread->getScratchBuffer());
     builder.setMagic(cb::mcbp::Magic::ClientRequest);
     builder.setOpcode(cb::mcbp::ClientOpcode::DcpSetVbucketState);
     builder.setOpaque(opaque);
@@ -2222,7 +2381,7 @@ cb::engine_errc Connection::set_vbucket_state(uint32_t opaque,
 }
 
 cb::engine_errc Connection::noop(uint32_t opaque) {
-    cb::mcbp::RequestBuilder builder(thread.getScratchBuffer());
+    cb::mcbp::RequestBuilder builder(thread->getScratchBuffer());
     builder.setMagic(cb::mcbp::Magic::ClientRequest);
     builder.setOpcode(cb::mcbp::ClientOpcode::DcpNoop);
     builder.setOpaque(opaque);
@@ -2234,7 +2393,7 @@ cb::engine_errc Connection::buffer_acknowledgement(uint32_t opaque,
                                                    uint32_t buffer_bytes) {
     cb::mcbp::request::DcpBufferAckPayload extras;
     extras.setBufferBytes(buffer_bytes);
-    cb::mcbp::RequestBuilder builder(thread.getScratchBuffer());
+    cb::mcbp::RequestBuilder builder(thread->getScratchBuffer());
     builder.setMagic(cb::mcbp::Magic::ClientRequest);
     builder.setOpcode(cb::mcbp::ClientOpcode::DcpBufferAcknowledgement);
     builder.setOpaque(opaque);
@@ -2333,7 +2492,7 @@ cb::engine_errc Connection::prepare(uint32_t opaque,
     req.setDatatype(it->getDataType());
 
     try {
-        if (buffer.size() > SendBuffer::MinimumDataSize) {
+        if (shouldChainData(buffer.size())) {
             copyToOutputStream(
                     {reinterpret_cast<const char*>(&req), sizeof(req)},
                     {reinterpret_cast<const char*>(&extras), sizeof(extras)},
@@ -2361,7 +2520,7 @@ cb::engine_errc Connection::seqno_acknowledged(uint32_t opaque,
                                                Vbid vbucket,
                                                uint64_t prepared_seqno) {
     cb::mcbp::request::DcpSeqnoAcknowledgedPayload extras(prepared_seqno);
-    cb::mcbp::RequestBuilder builder(thread.getScratchBuffer());
+    cb::mcbp::RequestBuilder builder(thread->getScratchBuffer());
     builder.setMagic(cb::mcbp::Magic::ClientRequest);
     builder.setOpcode(cb::mcbp::ClientOpcode::DcpSeqnoAcknowledged);
     builder.setOpaque(opaque);
@@ -2524,6 +2683,11 @@ cb::engine_errc Connection::cache_transfer_end_tx(uint32_t opaque,
 ////////////////////////////////////////////////////////////////////////////
 
 void Connection::onTlsConnect(const SSL* ssl_st) {
+#ifdef SSL_OP_ENABLE_KTLS
+    kernelTls.send = BIO_get_ktls_send(SSL_get_wbio(ssl_st));
+    kernelTls.receive = BIO_get_ktls_recv(SSL_get_rbio(ssl_st));
+#endif
+
     const auto verifyMode = SSL_get_verify_mode(ssl_st);
     const auto enabled = ((verifyMode & SSL_VERIFY_PEER) == SSL_VERIFY_PEER);
 
@@ -2648,7 +2812,9 @@ void Connection::onTlsConnect(const SSL* ssl_st) {
         LOG_INFO_CTX("Using cipher",
                      {"conn_id", getId()},
                      {"cipher", SSL_get_cipher_name(ssl_st)},
-                     {"certificate", static_cast<bool>(cert)});
+                     {"certificate", static_cast<bool>(cert)},
+                     {"ktls_send", kernelTls.send},
+                     {"ktls_receive", kernelTls.receive});
     }
 }
 
@@ -11,6 +11,7 @@
 
 #include "cluster_config.h"
 #include "datatype_filter.h"
+#include "fair_share.h"
 #include "resource_allocation_domain.h"
 #include "sendbuffer.h"
 #include "stats.h"
@@ -25,6 +26,7 @@
 #include <memcached/openssl.h>
 #include <memcached/rbac.h>
 #include <nlohmann/json.hpp>
+#include <platform/byte_literals.h>
 #include <platform/socket.h>
 
 #include <array>
@@ -33,12 +35,14 @@
 #include <memory>
 #include <queue>
 #include <string>
+#include <vector>
 
 class Bucket;
 class Cookie;
 class ListeningPort;
 struct EngineIface;
 struct FrontEndThread;
+enum class ConnectionBackend;
 class SendBuffer;
 
 namespace cb::mcbp {
@@ -180,7 +184,44 @@ public:
     }
 
     FrontEndThread& getThread() const {
-        return thread;
+        return *thread;
+    }
+
+    /**
+     * Can the connection be moved to another front end thread right now.
+     * That is only possible at a safe point: the connection must be idle
+     * (no commands in flight and nothing buffered for sending or
+     * receiving) and the backend must support it. DCP and duplex
+     * connections are never moved as other threads may reference them.
+     *
+     * The connections thread lock must be held when calling the method
+     */
+    bool isMigratable() const;
+
+    /**
+     * Detach the connection from the event base of its current thread
+     * (the connection is no longer notified about any IO until it is
+     * attached to a thread again). Must only be called when the
+     * connection is migratable.
+     */
+    virtual void detachFromThread() {
+    }
+
+    /**
+     * Attach the connection to (the event base of) the provided thread.
+     * Called in the context of the new thread with its thread lock held
+     */
+    virtual void attachToThread(FrontEndThread& thr) {
+        bindToThread(thr);
+    }
+
+    /**
+     * Bind the connection to the provided thread without attaching it to
+     * the thread's event base (used to release a connection which was
+     * dropped on its way to the thread)
+     */
+    void bindToThread(FrontEndThread& thr) {
+        thread = &thr;
     }
 
     /**
@@ -306,6 +347,24 @@ public:
      */
     void addCpuTime(std::chrono::nanoseconds ns);
 
+    /// Get the CPU time the connection used since the previous call (used
+    /// to locate the connections driving the load of the thread)
+    std::chrono::nanoseconds sampleCpuTime() {
+        const auto ret = total_cpu_time - sampled_cpu_time;
+        sampled_cpu_time = total_cpu_time;
+        return ret;
+    }
+
+    /// Get the state used by the FairShareScheduler (only to be used
+    /// from the thread the connection is bound to)
+    FairShareState& getFairShareState() {
+        return fairShare;
+    }
+
+    const FairShareState& getFairShareState() const {
+        return fairShare;
+    }
+
     const std::string& getTerminationReason() const {
         return terminationReason;
     }
@@ -352,6 +411,8 @@ public:
 
     void setDcpFlowControlBufferSize(std::size_t size) override;
 
+    bool isSendQueueFull() const override;
+
     /**
      * Copy the provided data to the end of the output stream.
      *
@@ -429,6 +490,17 @@ public:
     virtual void chainDataToOutputStream(
             std::unique_ptr<SendBuffer> buffer) = 0;
 
+    /**
+     * Should a value of the provided size be added to the output stream
+     * with chainDataToOutputStream() rather than being copied. By default
+     * only values above SendBuffer::MinimumDataSize are chained (see the
+     * SendBuffer for the reasoning), but backends which gather all of the
+     * data into a single system call may use a lower threshold.
+     */
+    virtual bool shouldChainData(std::size_t size) const {
+        return size > SendBuffer::MinimumDataSize;
+    }
+
     /**
      * Enable the datatype which corresponds to the feature
      *
@@ -697,6 +769,19 @@ public:
                              uint8_t nru,
                              cb::mcbp::DcpStreamId sid) override;
 
+    cb::engine_errc mutation_patch(uint32_t opaque,
+                                   cb::unique_item_ptr itm,
+                                   Vbid vbucket,
+                                   uint64_t by_seqno,
+                                   uint64_t rev_seqno,
+                                   uint32_t lock_time,
+                                   uint8_t nru,
+                                   uint64_t base_cas,
+                                   uint32_t offset,
+                                   uint32_t remove_length,
+                                   uint32_t insert_length,
+                                   cb::mcbp::DcpStreamId sid) override;
+
     cb::engine_errc deletion(uint32_t opaque,
                              cb::unique_item_ptr itm,
                              Vbid vbucket,
@@ -952,6 +1037,12 @@ public:
     }
 
 protected:
+    /// Don't allow unauthenticated clients send large packets to
+    /// consume memory on the server (for instance send everything except
+    /// the last byte of a request and let the server be stuck waiting
+    /// for the last byte of a 20MB command)
+    static constexpr size_t MaxUnauthenticatedFrameSize = 16_KiB;
+
     /// Protected constructor so that it may only be used from create();
     Connection(SOCKET sfd,
                FrontEndThread& thr,
@@ -1032,6 +1123,17 @@ protected:
      */
     virtual void enableReadEvent() = 0;
 
+    /**
+     * Is the backend able to move the connection to another thread right
+     * now (see isMigratable())
+     */
+    virtual bool isMigrationSupported() const {
+        return false;
+    }
+
+    /// Get the backend performing the network IO for the connection
+    virtual ConnectionBackend getBackend() const;
+
     /**
      * Format the response header into the provided buffer.
      *
@@ -1053,6 +1155,9 @@ protected:
                                            uint8_t datatype);
 
     void updateSendBytes(size_t nbytes);
+    /// Update the send counters for data added to the output stream with
+    /// chainDataToOutputStream()
+    void updateChainedSendBytes(size_t nbytes);
     void updateRecvBytes(size_t nbytes);
 
     /// Update the privilege context and drop all of the previously dropped
@@ -1094,6 +1199,11 @@ protected:
      */
     std::deque<std::unique_ptr<Cookie>> cookies;
 
+    /// Cookies no longer in use (kept to be reused by the next commands
+    /// rather than allocating a new cookie for every command executed
+    /// out of order). Bounded by the max number of concurrent commands
+    std::vector<std::unique_ptr<Cookie>> spareCookies;
+
     /// The current privilege context
     std::shared_ptr<cb::rbac::PrivilegeContext> privilegeContext;
 
@@ -1122,8 +1232,9 @@ protected:
     /// When the next time we should log for a pending close
     std::chrono::steady_clock::time_point pending_close_next_log{};
 
-    /// Pointer to the thread object serving this connection
-    FrontEndThread& thread;
+    /// Pointer to the thread object serving this connection (changes if
+    /// the connection is migrated to another thread)
+    FrontEndThread* thread;
 
     /// The description of the listening port which accepted the client
     /// (needed in order to shut down the connection if the administrator
@@ -1156,11 +1267,20 @@ protected:
     std::chrono::nanoseconds min_sched_time = std::chrono::nanoseconds::max();
     /// The longest time this connection was occupying the thread
     std::chrono::nanoseconds max_sched_time = std::chrono::nanoseconds::zero();
+    /// The total_cpu_time at the last call to sampleCpuTime()
+    std::chrono::nanoseconds sampled_cpu_time =
+            std::chrono::nanoseconds::zero();
+
+    /// The virtual time and weight used by the FairShareScheduler
+    FairShareState fairShare;
 
     /// Total number of bytes received on the network
     size_t totalRecv = 0;
     /// Total number of bytes sent to the network
     size_t totalSend = 0;
+    /// The part of totalSend which was sent by reference (and not copied
+    /// into the output stream)
+    size_t totalSendChained = 0;
 
     /// The maximum requests we can process in a worker thread timeslice
     int max_reqs_per_event;
@@ -1284,6 +1404,13 @@ protected:
     /// is the sdk registered
     bool registeredSdk = false;
 
+    /// Record encryption / decryption performed by the kernel (kTLS)
+    /// after the TLS handshake
+    struct {
+        bool send = false;
+        bool receive = false;
+    } kernelTls;
+
     /// The type of connection this is
     Type type = Type::Normal;
 
@@ -0,0 +1,301 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "connection_io_uring.h"
+
+#include "front_end_thread.h"
+#include "mcaudit.h"
+#include "sendbuffer.h"
+#include "settings.h"
+#include "tracing.h"
+
+#include <folly/io/IOBuf.h>
+#include <logger/logger.h>
+#include <mcbp/protocol/header.h>
+#include <phosphor/phosphor.h>
+#include <array>
+#include <cstring>
+#include <system_error>
+
+IoUringConnection::IoUringConnection(SOCKET sfd,
+                                     FrontEndThread& thr,
+                                     std::shared_ptr<ListeningPort> descr,
+                                     IoUringRing& ring)
+    : Connection(sfd, thr, std::move(descr)),
+      ring(ring),
+      socket(ring.add(sfd, *this)),
+      input({[this]() { frameAvailable = true; },
+             // EOF and errors are reported by the ring
+             []() {},
+             [](std::string_view, bool) {},
+             [this](std::string_view data) {
+                 audit_invalid_packet(
+                         *this,
+                         {reinterpret_cast<const uint8_t*>(data.data()),
+                          data.size()});
+             }}) {
+}
+
+IoUringConnection::~IoUringConnection() {
+    if (isConnectedToSystemPort()) {
+        LOG_INFO_CTX("Delete connection connected to system port",
+                     {"conn_id", getId()},
+                     {"reason", terminationReason});
+    }
+    if (isDCP() && !inflight.empty()) {
+        LOG_INFO_CTX("Releasing DCP connection",
+                     {"conn_id", socketDescriptor},
+                     {"description", to_json_tcp()});
+    }
+    // The ring keeps the data in flight (and closes the socket) until the
+    // kernel is done with it
+    ring.remove(socket);
+}
+
+void IoUringConnection::runStateMachinery() {
+    TRACE_LOCKGUARD_TIMED(thread->mutex,
+                          "mutex",
+                          "IoUringConnection::runStateMachinery::threadLock",
+                          SlowMutexThreshold);
+    if (!executeCommandsCallback()) {
+        thread->destroy_connection(*this);
+    }
+}
+
+void IoUringConnection::runLoopCallback() noexcept {
+    runStateMachinery();
+}
+
+void IoUringConnection::onDataReceived(std::string_view data) {
+    while (!data.empty()) {
+        void* buffer;
+        size_t size;
+        input.getReadBuffer(&buffer, &size);
+        if (size == 0) {
+            terminate("Failed to allocate memory for the input stream");
+            return;
+        }
+        size = std::min(size, data.size());
+        std::memcpy(buffer, data.data(), size);
+        input.readDataAvailable(size);
+        data.remove_prefix(size);
+    }
+
+    if (readEnabled && (frameAvailable || !frameSizeChecked)) {
+        frameAvailable = false;
+        runStateMachinery();
+    }
+}
+
+void IoUringConnection::onEof() {
+    terminate("Client closed connection: EOF");
+}
+
+void IoUringConnection::onReadError(int error) {
+    onSocketError(error);
+}
+
+void IoUringConnection::onDataSent(size_t nbytes) {
+    transferred += nbytes;
+    while (!inflight.empty() && transferred >= inflight.front()) {
+        transferred -= inflight.front();
+        inflight.pop_front();
+    }
+
+    if (inflight.empty()) {
+        // Everything is transferred to the kernel; the state machinery
+        // may be waiting for the send queue to drain
+        runStateMachinery();
+    }
+}
+
+void IoUringConnection::onWriteError(int error) {
+    onSocketError(error);
+}
+
+void IoUringConnection::onSocketError(int error) {
+    if (error == ECONNRESET || error == EPIPE) {
+        terminate(fmt::format("Client closed connection: {}",
+                              error == EPIPE ? "EPIPE" : "ECONNRESET"));
+        return;
+    }
+
+    const auto errStr = std::system_category().message(error);
+    LOG_WARNING_CTX(
+            "Unrecoverable error encountered, socket_error, shutting down "
+            "connection",
+            {"conn_id", getId()},
+            {"description", getDescription()},
+            {"error_code", error},
+            {"error", errStr});
+    terminate(fmt::format("socket_error: {}: {}", error, errStr));
+}
+
+void IoUringConnection::terminate(std::string reason) {
+    setTerminationReason(std::move(reason));
+    TRACE_LOCKGUARD_TIMED(thread->mutex,
+                          "mutex",
+                          "IoUringConnection::terminate::threadLock",
+                          SlowMutexThreshold);
+    // The other side is gone (see LibeventConnection::event_callback);
+    // don't wait for the send queue to drain
+    sendQueueInfo.term = true;
+
+    if (state == State::running) {
+        shutdown();
+    }
+
+    if (!executeCommandsCallback()) {
+        thread->destroy_connection(*this);
+    }
+}
+
+void IoUringConnection::triggerCallback(bool force) {
+    if (!force && state == State::running && getSendQueueSize() != 0) {
+        // onDataSent() runs the state machinery once the data is sent
+        return;
+    }
+    if (!isLoopCallbackScheduled()) {
+        thread->eventBase.runInLoop(this);
+    }
+}
+
+void IoUringConnection::copyToOutputStream(std::string_view data) {
+    std::array<std::string_view, 1> views{{data}};
+    copyToOutputStream(views);
+}
+
+void IoUringConnection::copyToOutputStream(gsl::span<std::string_view> data) {
+    Expects(getThread().eventBase.isInEventBaseThread());
+    size_t total = 0;
+    for (const auto& d : data) {
+        total += d.size();
+    }
+    if (total == 0) {
+        return;
+    }
+    ring.copy(socket, data);
+    inflight.push_back(total);
+    updateSendBytes(total);
+}
+
+static void iobuf_sendbuffer_cleanup_cb(void*, void* userData) {
+    delete static_cast<SendBuffer*>(userData);
+}
+
+void IoUringConnection::chainDataToOutputStream(
+        std::unique_ptr<SendBuffer> buffer) {
+    Expects(getThread().eventBase.isInEventBaseThread());
+    if (!buffer || buffer->getPayload().empty()) {
+        throw std::logic_error(
+                "IoUringConnection::chainDataToOutputStream: buffer must be "
+                "set");
+    }
+
+    // The IOBuf owns the send buffer (rather than the AsyncWriteCallback)
+    // as the kernel may reference the data after the connection is
+    // deleted. takeOwnership() frees the buffer if it fails
+    auto data = buffer->getPayload();
+    const auto threshold = Settings::instance().getZerocopySendThreshold();
+    auto iob = folly::IOBuf::takeOwnership(const_cast<char*>(data.data()),
+                                           data.size(),
+                                           iobuf_sendbuffer_cleanup_cb,
+                                           buffer.release());
+    ring.send(socket,
+              std::move(iob),
+              threshold != 0 && data.size() >= threshold);
+    inflight.push_back(data.size());
+    updateChainedSendBytes(data.size());
+}
+
+bool IoUringConnection::shouldChainData(std::size_t size) const {
+    // The ring sends the chained data in the same sendmsg as the data
+    // copied around it, so referencing the data only costs the allocation
+    // of the SendBuffer and the IOBuf
+    return size >= MinimumChainDataSize;
+}
+
+ConnectionBackend IoUringConnection::getBackend() const {
+    return ConnectionBackend::IoUring;
+}
+
+bool IoUringConnection::isInvalidPacketHeaderMessage(
+        const char* message) const {
+    return strstr(message, "Invalid packet header detected") != nullptr;
+}
+
+bool IoUringConnection::isPacketAvailable() const {
+    // Validates the header (and audits invalid packets)
+    const auto available = input.isPacketAvailable();
+    const auto bytes = input.getAvailableBytes(sizeof(cb::mcbp::Header));
+    if (bytes.size() < sizeof(cb::mcbp::Header)) {
+        return false;
+    }
+
+    const auto* header =
+            reinterpret_cast<const cb::mcbp::Header*>(bytes.data());
+    const auto framesize = sizeof(*header) + header->getBodylen();
+
+    if (!isAuthenticated() && framesize > MaxUnauthenticatedFrameSize) {
+        throw std::runtime_error(fmt::format(
+                "IoUringConnection::isPacketAvailable(): The packet size {} "
+                "exceeds the max allowed packet size for unauthenticated "
+                "connections {}",
+                framesize,
+                MaxUnauthenticatedFrameSize));
+    }
+
+    // Are we receiving an incredible big packet so that we want to
+    // disconnect the client?
+    if (framesize > Settings::instance().getMaxPacketSize()) {
+        throw std::runtime_error(fmt::format(
+                "IoUringConnection::isPacketAvailable(): The packet size {} "
+                "exceeds the max allowed packet size {}",
+                framesize,
+                Settings::instance().getMaxPacketSize()));
+    }
+
+    frameSizeChecked = true;
+    return available;
+}
+
+const cb::mcbp::Header& IoUringConnection::getPacket() const {
+    return input.getPacket();
+}
+
+void IoUringConnection::nextPacket() {
+    input.nextPacket();
+    frameSizeChecked = false;
+}
+
+cb::const_byte_buffer IoUringConnection::getAvailableBytes() const {
+    return input.getAvailableBytes(1024);
+}
+
+void IoUringConnection::disableReadEvent() {
+    if (readEnabled) {
+        readEnabled = false;
+        ring.disableReceive(socket);
+    }
+}
+
+void IoUringConnection::enableReadEvent() {
+    if (!readEnabled) {
+        readEnabled = true;
+        ring.enableReceive(socket);
+    }
+}
+
+size_t IoUringConnection::getSendQueueSize() const {
+    size_t ret = 0;
+    for (const auto& nbytes : inflight) {
+        ret += nbytes;
+    }
+    return ret - transferred;
+}
@@ -0,0 +1,100 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include "connection.h"
+#include "io_uring_ring.h"
+
+#include <folly/io/async/EventBase.h>
+#include <io/network/read_callback.h>
+#include <deque>
+
+/**
+ * Implementation of the Connection class using io_uring for IO (via the
+ * IoUringRing owned by the front end thread).
+ *
+ * The input stream is managed by an AsyncReadCallback (data received into
+ * the ring's provided buffers is copied into it), and the output stream
+ * is the ring's send queue for the socket. Only used for connections
+ * without TLS.
+ */
+class IoUringConnection : public Connection,
+                          public IoUringSocketListener,
+                          public folly::EventBase::LoopCallback {
+public:
+    IoUringConnection(SOCKET sfd,
+                      FrontEndThread& thr,
+                      std::shared_ptr<ListeningPort> descr,
+                      IoUringRing& ring);
+    ~IoUringConnection() override;
+    void copyToOutputStream(std::string_view data) override;
+    void copyToOutputStream(gsl::span<std::string_view> data) override;
+    void chainDataToOutputStream(std::unique_ptr<SendBuffer> buffer) override;
+    bool shouldChainData(std::size_t size) const override;
+    ConnectionBackend getBackend() const override;
+    bool isPacketAvailable() const override;
+    const cb::mcbp::Header& getPacket() const override;
+    void nextPacket() override;
+    cb::const_byte_buffer getAvailableBytes() const override;
+    size_t getSendQueueSize() const override;
+    void triggerCallback(bool force) override;
+    void disableReadEvent() override;
+    void enableReadEvent() override;
+
+    // IoUringSocketListener interface
+    void onDataReceived(std::string_view data) override;
+    void onEof() override;
+    void onReadError(int error) override;
+    void onDataSent(size_t nbytes) override;
+    void onWriteError(int error) override;
+
+    /// Run the state machinery scheduled by triggerCallback()
+    void runLoopCallback() noexcept override;
+
+    /// Values smaller than this are cheaper to copy than to reference
+    static constexpr std::size_t MinimumChainDataSize = 512;
+
+protected:
+    bool isInvalidPacketHeaderMessage(const char* message) const override;
+
+    /// Run the state machinery (and destroy the connection if it is done).
+    /// The connection may be deleted when the method returns
+    void runStateMachinery();
+
+    /// The socket was closed by the peer or failed; tear down the
+    /// connection (which may be deleted when the method returns)
+    void terminate(std::string reason);
+
+    /// Sending or receiving data failed with the provided error
+    void onSocketError(int error);
+
+    IoUringRing& ring;
+    IoUringSocket& socket;
+
+    /// Set by the input stream when a full frame is available
+    bool frameAvailable = false;
+    /// Should received data trigger the state machinery
+    bool readEnabled = true;
+    /// Has the size of the frame at the head of the input stream been
+    /// checked (we want to run the state machinery as soon as the header
+    /// is available so that oversized frames are rejected without waiting
+    /// for the entire frame)
+    mutable bool frameSizeChecked = false;
+
+    /// The number of bytes in each of the entries passed to the ring
+    /// which isn't completely transferred yet
+    std::deque<size_t> inflight;
+    /// The number of bytes transferred of the first entry in inflight
+    size_t transferred = 0;
+
+    /// The input stream (mutable as the "const" packet inspection
+    /// methods may need to make the header continuous)
+    mutable cb::io::network::AsyncReadCallback input;
+};
@@ -28,48 +28,51 @@
 #include <phosphor/phosphor.h>
 #include <platform/string_hex.h>
 
-/// Don't allow unauthenticated clients send large packets to
-/// consume memory on the server (for instance send everything except
-/// the last byte of a request and let the server be stuck waiting
-/// for the last byte of a 20MB command)
-static constexpr size_t MaxUnauthenticatedFrameSize = 16_KiB;
+// We need to use BEV_OPT_UNLOCK_CALLBACKS (which again require
+// BEV_OPT_DEFER_CALLBACKS) to avoid lock ordering problem (and
+// potential deadlock) because otherwise we'll hold the internal mutex
+// in libevent as part of the callback and later on we acquire the
+// worker threads mutex, but when we try to signal another cookie we
+// hold the worker thread mutex when we try to acquire the mutex inside
+// libevent.
+static constexpr auto libeventBuffereventOptions =
+        BEV_OPT_THREADSAFE | BEV_OPT_UNLOCK_CALLBACKS | BEV_OPT_CLOSE_ON_FREE |
+        BEV_OPT_DEFER_CALLBACKS;
 
 LibeventConnection::LibeventConnection(SOCKET sfd,
                                        FrontEndThread& thr,
                                        std::shared_ptr<ListeningPort> descr,
                                        uniqueSslPtr sslStructure)
     : Connection(sfd, thr, std::move(descr)) {
-    // We need to use BEV_OPT_UNLOCK_CALLBACKS (which again require
-    // BEV_OPT_DEFER_CALLBACKS) to avoid lock ordering problem (and
-    // potential deadlock) because otherwise we'll hold the internal mutex
-    // in libevent as part of the callback and later on we acquire the
-    // worker threads mutex, but when we try to signal another cookie we
-    // hold the worker thread mutex when we try to acquire the mutex inside
-    // libevent.
-    constexpr auto options = BEV_OPT_THREADSAFE | BEV_OPT_UNLOCK_CALLBACKS |
-                             BEV_OPT_CLOSE_ON_FREE | BEV_OPT_DEFER_CALLBACKS;
     if (sslStructure) {
         bev.reset(
                 bufferevent_openssl_socket_new(thr.eventBase.getLibeventBase(),
                                                sfd,
                                                sslStructure.release(),
                                                BUFFEREVENT_SSL_ACCEPTING,
-                                               options));
+                                               libeventBuffereventOptions));
         bufferevent_setcb(bev.get(),
                           LibeventConnection::ssl_read_callback,
                           LibeventConnection::rw_callback,
                           LibeventConnection::event_callback,
                           this);
+        bufferevent_enable(bev.get(), EV_READ);
+        bufferevent_setwatermark(
+                bev.get(), EV_READ, sizeof(cb::mcbp::Header), 0);
     } else {
-        bev.reset(bufferevent_socket_new(
-                thr.eventBase.getLibeventBase(), sfd, options));
-        bufferevent_setcb(bev.get(),
-                          LibeventConnection::rw_callback,
-                          LibeventConnection::rw_callback,
-                          LibeventConnection::event_callback,
-                          this);
+        createSocketBufferevent();
     }
+}
 
+void LibeventConnection::createSocketBufferevent() {
+    bev.reset(bufferevent_socket_new(thread->eventBase.getLibeventBase(),
+                                     socketDescriptor,
+                                     libeventBuffereventOptions));
+    bufferevent_setcb(bev.get(),
+                      LibeventConnection::rw_callback,
+                      LibeventConnection::rw_callback,
+                      LibeventConnection::event_callback,
+                      this);
     bufferevent_enable(bev.get(), EV_READ);
     bufferevent_setwatermark(bev.get(), EV_READ, sizeof(cb::mcbp::Header), 0);
 }
@@ -85,6 +88,11 @@ LibeventConnection::~LibeventConnection() {
                      {"conn_id", socketDescriptor},
                      {"description", to_json_tcp()});
     }
+    if (!bev && socketDescriptor != INVALID_SOCKET) {
+        // Deleted while migrating to another thread (the bufferevent owns
+        // the socket otherwise)
+        cb::net::closesocket(socketDescriptor);
+    }
 }
 
 std::vector<unsigned long> LibeventConnection::getOpenSslErrorCodes() {
@@ -103,7 +111,7 @@ std::string LibeventConnection::formatOpenSslErrorCodes(
         return {};
     }
 
-    auto buffer = thread.getScratchBuffer();
+    auto buffer = thread->getScratchBuffer();
     std::vector<std::string> messages;
     for (const auto& err : codes) {
         ERR_error_string_n(err, buffer.data(), buffer.size());
@@ -139,7 +147,7 @@ void LibeventConnection::rw_callback() {
         }
     }
 
-    TRACE_LOCKGUARD_TIMED(thread.mutex,
+    TRACE_LOCKGUARD_TIMED(thread->mutex,
                           "mutex",
                           "LibeventConnection::rw_callback::threadLock",
                           SlowMutexThreshold);
@@ -151,9 +159,9 @@ void LibeventConnection::rw_callback() {
         // that the folly intra-thread communication notification works. This
         // libevent function ensures all currently active events are handled
         // before dropping out of the loop. MB-70548
-        event_base_loopexit(thread.eventBase.getLibeventBase(), nullptr);
+        event_base_loopexit(thread->eventBase.getLibeventBase(), nullptr);
     } else {
-        thread.destroy_connection(*this);
+        thread->destroy_connection(*this);
     }
 }
 
@@ -277,7 +285,7 @@ void LibeventConnection::event_callback(short event) {
 
     if (term) {
         auto& thread = getThread();
-        TRACE_LOCKGUARD_TIMED(thread.mutex,
+        TRACE_LOCKGUARD_TIMED(thread->mutex,
                               "mutex",
                               "LibeventConnection::event_callback::threadLock",
                               SlowMutexThreshold);
@@ -299,7 +307,7 @@ void LibeventConnection::event_callback(short event) {
         }
 
         if (!executeCommandsCallback()) {
-            thread.destroy_connection(*this);
+            thread->destroy_connection(*this);
         }
     }
 }
@@ -387,7 +395,7 @@ void LibeventConnection::chainDataToOutputStream(
     // (sendbuffer_cleanup_cb) will free the memory.
     // Move the ownership of the buffer!
     (void)buffer.release();
-    updateSendBytes(data.size());
+    updateChainedSendBytes(data.size());
 }
 
 constexpr const char* invalidPacketHeaderMessage =
@@ -516,10 +524,36 @@ void LibeventConnection::enableReadEvent() {
     }
 }
 
+bool LibeventConnection::isMigrationSupported() const {
+    // The OpenSSL bufferevent can't be moved to another event base, and
+    // data already read from the socket would be lost
+    return !isTlsEnabled() && bev &&
+           evbuffer_get_length(bufferevent_get_input(bev.get())) == 0;
+}
+
+void LibeventConnection::detachFromThread() {
+    // Create a new bufferevent in the new event base rather than moving
+    // this one as it may have deferred callbacks pending in this event
+    // base. Clear the callbacks so that they don't fire, and detach the
+    // socket so that it isn't closed when the bufferevent is released
+    bufferevent_disable(bev.get(), EV_READ | EV_WRITE);
+    bufferevent_setcb(bev.get(), nullptr, nullptr, nullptr, nullptr);
+    bufferevent_setfd(bev.get(), -1);
+    bev.reset();
+}
+
+void LibeventConnection::attachToThread(FrontEndThread& thr) {
+    Connection::attachToThread(thr);
+    createSocketBufferevent();
+}
+
 size_t LibeventConnection::getSendQueueSize() const {
     return getSendQueueSizeImpl();
 }
 
 size_t LibeventConnection::getSendQueueSizeImpl() const {
+    if (!bev) {
+        return 0;
+    }
     return evbuffer_get_length(bufferevent_get_output(bev.get()));
 }
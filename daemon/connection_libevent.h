@@ -34,6 +34,9 @@ public:
     void triggerCallback(bool force) override;
     void disableReadEvent() override;
     void enableReadEvent() override;
+    bool isMigrationSupported() const override;
+    void detachFromThread() override;
+    void attachToThread(FrontEndThread& thr) override;
 
 protected:
     LibeventConnection(FrontEndThread& thr) : Connection(thr) {
@@ -46,6 +49,10 @@ protected:
 
     bool isInvalidPacketHeaderMessage(const char* message) const override;
 
+    /// Create the bufferevent for a plain (non-TLS) socket in the event
+    /// base of the thread serving the connection
+    void createSocketBufferevent();
+
     /// The bufferevent structure for the object
     cb::libevent::unique_bufferevent_ptr bev;
 
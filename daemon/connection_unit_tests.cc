@@ -13,14 +13,23 @@
 #include "daemon/external_auth_manager_thread.h"
 #include "enginemap.h"
 #include "front_end_thread.h"
+#include "listening_port.h"
 #include "log_macros.h"
 #include "memcached.h"
+#include "settings.h"
 
 #include <daemon/cookie.h>
+#include <mcbp/protocol/request.h>
+#include <mcbp/protocol/response.h>
+#include <memcached/rbac/privilege_database.h>
 #include <platform/socket.h>
 
 #include <folly/portability/GTest.h>
 #include <folly/synchronization/Baton.h>
+#include <chrono>
+#include <map>
+#include <system_error>
+#include <thread>
 
 /// A mock connection
 class MockConnection : public LibeventConnection {
@@ -73,6 +82,31 @@ public:
     void removeMockConnection(MockConnection& connection) {
         destroy_connection(connection);
     }
+
+    /// Adds a connection for the provided socket to the front end thread.
+    /// Must be called in the context of the thread with its lock held
+    Connection& addSocketConnection(SOCKET sfd) {
+        auto connection = std::make_unique<LibeventConnection>(
+                sfd,
+                *this,
+                std::make_shared<ListeningPort>(
+                        "dummy", "127.0.0.1", 11210, AF_INET, false, false),
+                uniqueSslPtr{});
+        BucketManager::instance().associateInitialBucket(*connection);
+        auto* conn = connection.get();
+        add_connection(std::move(connection));
+        return *conn;
+    }
+
+    void migrate(Connection& connection, FrontEndThread& to) {
+        migrateConnection(connection, to);
+    }
+
+    /// Get the number of connections bound to the thread (must be called
+    /// in the context of the thread)
+    size_t getNumConnections() const {
+        return connections.size();
+    }
 };
 
 class ConnectionUnitTests : public ::testing::Test {
@@ -137,6 +171,313 @@ TEST_F(ConnectionUnitTests, CpuTime) {
     EXPECT_EQ("100", json["total_cpu_time"]);
 }
 
+TEST_F(ConnectionUnitTests, SampleCpuTime) {
+    using namespace std::chrono_literals;
+    connection->addCpuTime(40ns);
+    connection->addCpuTime(30ns);
+    EXPECT_EQ(70ns, connection->sampleCpuTime());
+    EXPECT_EQ(0ns, connection->sampleCpuTime());
+    connection->addCpuTime(10ns);
+    EXPECT_EQ(10ns, connection->sampleCpuTime());
+
+    // The time is accounted to the thread as well
+    EXPECT_EQ(80, frontEndThread->cpuTime.load());
+}
+
+TEST_F(ConnectionUnitTests, UnauthenticatedNotMigratable) {
+    // Connections must be authenticated before they may be moved to
+    // another thread
+    ASSERT_FALSE(connection->isAuthenticated());
+    EXPECT_FALSE(connection->isMigratable());
+}
+
+/// A connection recording the order in which the FairShareScheduler
+/// resumes it
+class FairShareConnection : public MockConnection {
+public:
+    FairShareConnection(FrontEndThread& thr,
+                        std::string id,
+                        std::vector<std::string>& resumed)
+        : MockConnection(thr), id(std::move(id)), resumed(resumed) {
+        setAuthenticated({this->id, cb::rbac::Domain::Local});
+    }
+
+    void triggerCallback(bool) override {
+        resumed.push_back(id);
+    }
+
+    const std::string id;
+
+protected:
+    std::vector<std::string>& resumed;
+};
+
+class FairShareSchedulerTest : public ConnectionUnitTests {
+public:
+    void SetUp() override {
+        ConnectionUnitTests::SetUp();
+        cb::rbac::createPrivilegeDatabase(R"({
+  "light": { "privileges": [ "all" ], "domain": "local" },
+  "heavy": { "privileges": [ "all" ], "domain": "local" },
+  "a": { "privileges": [ "all" ], "domain": "local" },
+  "b": { "privileges": [ "all" ], "domain": "local" },
+  "c": { "privileges": [ "all" ], "domain": "local" }
+})");
+        timeslice = Settings::instance().getCommandTimeSlice();
+        weights = Settings::instance().getFairShareWeights();
+        Settings::instance().setCommandTimeSlice(std::chrono::milliseconds{1});
+        FairShareWeights heavy;
+        heavy.users["heavy"] = 2 * FairShareWeights::DefaultWeight;
+        Settings::instance().setFairShareWeights(std::move(heavy));
+    }
+
+    void TearDown() override {
+        connections.clear();
+        Settings::instance().setCommandTimeSlice(timeslice);
+        Settings::instance().setFairShareWeights(weights);
+        ConnectionUnitTests::TearDown();
+    }
+
+    /// Create a connection authenticated as the provided user with the
+    /// provided virtual time
+    FairShareConnection& createConnection(std::string user,
+                                          std::chrono::nanoseconds time = {}) {
+        connections.emplace_back(std::make_unique<FairShareConnection>(
+                *frontEndThread, std::move(user), resumed));
+        connections.back()->getFairShareState().virtualTime = time.count();
+        return *connections.back();
+    }
+
+    /// Run one iteration of the scheduler and return the connections
+    /// resumed in that iteration
+    std::vector<std::string> resume() {
+        resumed.clear();
+        scheduler().runLoopCallback();
+        return resumed;
+    }
+
+    FairShareScheduler& scheduler() {
+        return frontEndThread->fairShareScheduler;
+    }
+
+protected:
+    std::vector<std::string> resumed;
+    std::vector<std::unique_ptr<FairShareConnection>> connections;
+    std::chrono::milliseconds timeslice;
+    FairShareWeights weights;
+};
+
+TEST_F(FairShareSchedulerTest, ResumeInVirtualTimeOrder) {
+    using namespace std::chrono_literals;
+    auto& a = createConnection("a", 300us);
+    auto& b = createConnection("b", 100us);
+    auto& c = createConnection("c", 300us);
+    scheduler().schedule(a);
+    scheduler().schedule(b);
+    scheduler().schedule(c);
+    // Scheduling a queued connection is a noop
+    scheduler().schedule(a);
+    EXPECT_EQ(3, scheduler().size());
+
+    // Lowest virtual time first, and FIFO for the same virtual time
+    EXPECT_EQ(std::vector<std::string>({"b", "a", "c"}), resume());
+    EXPECT_EQ(0, scheduler().size());
+}
+
+TEST_F(FairShareSchedulerTest, HoldBackConnectionsAheadByTimeslice) {
+    using namespace std::chrono_literals;
+    auto& a = createConnection("a", 1ms);
+    auto& b = createConnection("b", 2ms);
+    auto& c = createConnection("c", 2001us);
+    scheduler().schedule(c);
+    scheduler().schedule(b);
+    scheduler().schedule(a);
+
+    // b is exactly a timeslice ahead of a, c is more than a timeslice
+    // ahead and must wait for the next iteration
+    EXPECT_EQ(std::vector<std::string>({"a", "b"}), resume());
+    EXPECT_EQ(1, scheduler().size());
+    EXPECT_EQ(std::vector<std::string>({"c"}), resume());
+    EXPECT_EQ(0, scheduler().size());
+
+    // A connection which was idle is queued no more than a timeslice
+    // behind the virtual clock, so it can't monopolize the thread
+    auto& idle = createConnection("light");
+    scheduler().schedule(c);
+    scheduler().schedule(idle);
+    EXPECT_EQ(1001us, std::chrono::nanoseconds(
+                              idle.getFairShareState().virtualTime));
+    EXPECT_EQ(std::vector<std::string>({"light", "c"}), resume());
+}
+
+TEST_F(FairShareSchedulerTest, ShareProportionalToWeight) {
+    using namespace std::chrono_literals;
+    auto& light = createConnection("light");
+    auto& heavy = createConnection("heavy");
+    scheduler().schedule(light);
+    scheduler().schedule(heavy);
+    EXPECT_EQ(2 * FairShareWeights::DefaultWeight,
+              heavy.getFairShareState().weight);
+    EXPECT_EQ("user:heavy", heavy.getFairShareState().weightClass);
+    EXPECT_EQ(FairShareWeights::DefaultWeight,
+              light.getFairShareState().weight);
+    EXPECT_EQ("default", light.getFairShareState().weightClass);
+
+    // Let both connections use 1ms of CPU every time they're resumed and
+    // yield again. The connection with twice the weight should be resumed
+    // twice as often
+    std::map<std::string, int> count;
+    for (int ii = 0; ii < 300; ++ii) {
+        for (const auto& id : resume()) {
+            ++count[id];
+            auto& connection = id == "light" ? light : heavy;
+            connection.addCpuTime(1ms);
+            scheduler().schedule(connection);
+        }
+    }
+    EXPECT_EQ(2, scheduler().size());
+    EXPECT_NEAR(2.0, double(count["heavy"]) / count["light"], 0.05);
+}
+
+/// Create a pair of connected TCP sockets over the loopback interface
+static std::pair<SOCKET, SOCKET> createLoopbackSocketPair() {
+    auto listener = cb::net::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == INVALID_SOCKET) {
+        throw std::system_error(cb::net::get_socket_error(),
+                                std::system_category(),
+                                "Failed to create socket");
+    }
+    sockaddr_in sin = {};
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(sin);
+    if (cb::net::bind(listener,
+                      reinterpret_cast<const sockaddr*>(&sin),
+                      sizeof(sin)) != 0 ||
+        cb::net::listen(listener, 1) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&sin), &len) != 0) {
+        cb::net::closesocket(listener);
+        throw std::system_error(cb::net::get_socket_error(),
+                                std::system_category(),
+                                "Failed to listen on the loopback interface");
+    }
+
+    auto client = cb::net::socket(AF_INET, SOCK_STREAM, 0);
+    if (client == INVALID_SOCKET ||
+        cb::net::connect(client,
+                         reinterpret_cast<const sockaddr*>(&sin),
+                         sizeof(sin)) != 0) {
+        cb::net::closesocket(listener);
+        throw std::system_error(cb::net::get_socket_error(),
+                                std::system_category(),
+                                "Failed to connect to the listener");
+    }
+    auto server = cb::net::accept(listener, nullptr, nullptr);
+    cb::net::closesocket(listener);
+    if (server == INVALID_SOCKET) {
+        cb::net::closesocket(client);
+        throw std::system_error(cb::net::get_socket_error(),
+                                std::system_category(),
+                                "Failed to accept the connection");
+    }
+    cb::net::set_socket_noblocking(server);
+    return {client, server};
+}
+
+/// Send a NOOP on the (blocking) socket and return the status of the
+/// response
+static cb::mcbp::Status sendNoop(SOCKET sock) {
+    cb::mcbp::Request request{};
+    request.setMagic(cb::mcbp::Magic::ClientRequest);
+    request.setOpcode(cb::mcbp::ClientOpcode::Noop);
+    if (cb::net::send(sock, &request, sizeof(request), 0) !=
+        ssize_t(sizeof(request))) {
+        throw std::system_error(cb::net::get_socket_error(),
+                                std::system_category(),
+                                "Failed to send NOOP");
+    }
+
+    cb::mcbp::Response response{};
+    auto* ptr = reinterpret_cast<char*>(&response);
+    size_t nr = 0;
+    while (nr < sizeof(response)) {
+        const auto ret =
+                cb::net::recv(sock, ptr + nr, sizeof(response) - nr, 0);
+        if (ret <= 0) {
+            throw std::system_error(cb::net::get_socket_error(),
+                                    std::system_category(),
+                                    "Failed to receive NOOP response");
+        }
+        nr += ret;
+    }
+    EXPECT_EQ(cb::mcbp::ClientOpcode::Noop, response.getClientOpcode());
+    return response.getStatus();
+}
+
+TEST_F(ConnectionUnitTests, MigrateLiveConnection) {
+    cb::rbac::createPrivilegeDatabase(R"({
+  "@admin": {
+    "buckets": { "*": [ "all" ] },
+    "privileges": [ "all" ],
+    "domain": "local"
+  }
+})");
+
+    // Connection::executeCommandsCallback may record stats,
+    // make sure the appropriate histogram exists.
+    scheduler_info.resize(1);
+
+    auto [client, server] = createLoopbackSocketPair();
+    auto& from = *frontEndThread;
+    MockFrontEndThread to;
+    std::thread fromThread([&from] { from.eventBase.loopForever(); });
+    std::thread toThread([&to] { to.eventBase.loopForever(); });
+
+    Connection* conn = nullptr;
+    from.eventBase.runInEventBaseThreadAndWait([&from, &conn, sfd = server]() {
+        std::lock_guard<std::mutex> guard(from.mutex);
+        conn = &from.addSocketConnection(sfd);
+        conn->setAuthenticated({"@admin", cb::rbac::Domain::Local});
+    });
+    EXPECT_EQ(cb::mcbp::Status::Success, sendNoop(client));
+
+    from.eventBase.runInEventBaseThreadAndWait([&from, &to, conn]() {
+        std::lock_guard<std::mutex> guard(from.mutex);
+        ASSERT_TRUE(conn->isMigratable());
+        from.migrate(*conn, to);
+        // Only the fixture's mock connection is left
+        EXPECT_EQ(1, from.getNumConnections());
+    });
+
+    // The callback adopting the connection was queued before this one
+    to.eventBase.runInEventBaseThreadAndWait([&to, conn]() {
+        std::lock_guard<std::mutex> guard(to.mutex);
+        EXPECT_EQ(1, to.getNumConnections());
+        EXPECT_EQ(&to, &conn->getThread());
+    });
+
+    // And traffic is now served by the new thread
+    EXPECT_EQ(cb::mcbp::Status::Success, sendNoop(client));
+    EXPECT_EQ(cb::mcbp::Status::Success, sendNoop(client));
+
+    // Disconnecting the client should release the connection from the new
+    // thread
+    cb::net::closesocket(client);
+    size_t remaining = 1;
+    const auto timeout =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (remaining && std::chrono::steady_clock::now() < timeout) {
+        to.eventBase.runInEventBaseThreadAndWait(
+                [&to, &remaining]() { remaining = to.getNumConnections(); });
+    }
+    EXPECT_EQ(0, remaining);
+
+    from.eventBase.terminateLoopSoon();
+    to.eventBase.terminateLoopSoon();
+    fromThread.join();
+    toThread.join();
+}
+
 TEST_F(ConnectionUnitTests, NotificationOrder) {
     // Test mimicking what would happen if a frontend thread was the last
     // owner of a ConnHandler. There may be pending callbacks from
@@ -646,7 +646,7 @@ void Cookie::reset() {
     authorized = false;
     preserveTtl = false;
     reorder = connection.allowUnorderedExecution();
-    inflated_input_payload.reset();
+    releaseInflatedInputPayload();
     currentCollectionInfo.reset();
     privilegeContext = connection.getPrivilegeContext();
     euid.reset();
@@ -702,30 +702,89 @@ void Cookie::collectTimings(
 
 std::string_view Cookie::getInflatedInputPayload() const {
     if (inflated_input_payload) {
-        return folly::StringPiece{inflated_input_payload->coalesce()};
+        return {inflated_input_payload->data(), inflated_input_payload->size()};
     }
 
     return getHeader().getValueString();
 }
 
+/// The store commands (see MutationCommandContext) validate the complete
+/// value as JSON
+static bool isStoreCommand(const cb::mcbp::Header& header) {
+    if (!header.isRequest()) {
+        return false;
+    }
+    switch (header.getRequest().getClientOpcode()) {
+    case cb::mcbp::ClientOpcode::Set:
+    case cb::mcbp::ClientOpcode::Setq:
+    case cb::mcbp::ClientOpcode::Add:
+    case cb::mcbp::ClientOpcode::Addq:
+    case cb::mcbp::ClientOpcode::Replace:
+    case cb::mcbp::ClientOpcode::Replaceq:
+        return true;
+    default:
+        return false;
+    }
+}
+
 bool Cookie::inflateInputPayload(const cb::mcbp::Header& header) {
-    inflated_input_payload.reset();
+    releaseInflatedInputPayload();
     if (!cb::mcbp::datatype::is_snappy(header.getDatatype())) {
         return true;
     }
 
-    try {
-        inflated_input_payload = inflateSnappy(header.getValueString());
-        return true;
-    } catch (const std::range_error&) {
+    // The payload cannot exceed the maximum packet size (otherwise we couldn't
+    // access the document from a client witout snappy support)
+    const auto input = header.getValueString();
+    if (cb::compression::getUncompressedLengthSnappy(input) >
+        Settings::instance().getMaxPacketSize()) {
         setErrorContext("Inflated data is too big");
-    } catch (const std::runtime_error&) {
-        setErrorContext("Failed to inflate payload");
+        return false;
+    }
+
+    auto& thread = connection.getThread();
+    try {
+        inflated_input_payload = thread.eventBase.isInEventBaseThread()
+                                         ? thread.getInflateBuffer()
+                                         : cb::compression::Buffer{};
+        using namespace cb::tracing;
+        ScopeTimer2<HdrMicroSecStopwatch, SpanStopwatch<Code>> timer(
+                std::forward_as_tuple(
+                        connection.getBucket().snappyDecompressionTimes),
+                std::forward_as_tuple(*this, Code::SnappyDecompress));
+        if (!cb::compression::inflateSnappy(
+                    input,
+                    *inflated_input_payload,
+                    Settings::instance().getMaxPacketSize())) {
+            releaseInflatedInputPayload();
+            setErrorContext("Failed to inflate payload");
+            return false;
+        }
     } catch (const std::bad_alloc&) {
+        releaseInflatedInputPayload();
         setErrorContext("Failed to allocate memory");
+        return false;
     }
 
-    return false;
+    if (isStoreCommand(header)) {
+        // Validate the value while it is still in the CPU caches rather
+        // than scanning it again once the command executes
+        inflated_input_payload_json =
+                thread.isValidJson(*this, getInflatedInputPayload());
+    }
+    return true;
+}
+
+void Cookie::releaseInflatedInputPayload() {
+    inflated_input_payload_json.reset();
+    if (!inflated_input_payload) {
+        return;
+    }
+    auto& thread = connection.getThread();
+    if (thread.eventBase.isInEventBaseThread()) {
+        thread.releaseInflateBuffer(std::move(*inflated_input_payload));
+    }
+    inflated_input_payload.reset();
 }
 
 std::unique_ptr<folly::IOBuf> Cookie::inflateSnappy(std::string_view input) {
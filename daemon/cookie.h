@@ -22,6 +22,7 @@
 #include <nlohmann/json.hpp>
 #include <platform/compression/buffer.h>
 #include <chrono>
+#include <optional>
 
 // Forward decls
 class Connection;
@@ -455,7 +456,10 @@ public:
 
     /**
      * Inflate the value (if deflated); caching the inflated value inside the
-     * cookie.
+     * cookie. The value is inflated into a buffer borrowed from the front
+     * end thread, and the value of the store commands is validated as JSON
+     * as part of the same pass while it is still in the CPU caches (see
+     * getInflatedInputPayloadIsJson()).
      *
      * @param header The packet header
      * @return true if success, false if an error occurs (the error context
@@ -463,6 +467,13 @@ public:
      */
     bool inflateInputPayload(const cb::mcbp::Header& header);
 
+    /// Get the result of validating the inflated input payload as JSON
+    /// (or an empty optional if it wasn't validated by
+    /// inflateInputPayload())
+    std::optional<bool> getInflatedInputPayloadIsJson() const {
+        return inflated_input_payload_json;
+    }
+
     std::unique_ptr<folly::IOBuf> inflateSnappy(
             std::string_view input) override;
 
@@ -745,7 +756,16 @@ protected:
      */
     std::unique_ptr<CommandContext> commandContext;
 
-    std::unique_ptr<folly::IOBuf> inflated_input_payload;
+    /// Return the buffer holding the inflated input payload (if any) to
+    /// the front end thread
+    void releaseInflatedInputPayload();
+
+    /// The inflated input payload (if the input payload is compressed)
+    std::optional<cb::compression::Buffer> inflated_input_payload;
+
+    /// Is the inflated input payload JSON (if validated as part of
+    /// inflateInputPayload())
+    std::optional<bool> inflated_input_payload_json;
 
     /// The Scope and Collection information for the current command picked
     /// out from the incoming packet as part of packet validation. This stores
@@ -0,0 +1,72 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "fair_share.h"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <utilities/json_utilities.h>
+#include <stdexcept>
+
+std::pair<uint32_t, std::string> FairShareWeights::lookup(
+        std::string_view bucket, std::string_view user) const {
+    if (!user.empty()) {
+        auto iter = users.find(user);
+        if (iter != users.end()) {
+            return {iter->second, fmt::format("user:{}", iter->first)};
+        }
+    }
+    if (!bucket.empty()) {
+        auto iter = buckets.find(bucket);
+        if (iter != buckets.end()) {
+            return {iter->second, fmt::format("bucket:{}", iter->first)};
+        }
+    }
+    return {DefaultWeight, "default"};
+}
+
+static void parseWeights(const nlohmann::json& json,
+                         std::string_view type,
+                         std::map<std::string, uint32_t, std::less<>>& map) {
+    if (!json.is_object()) {
+        cb::throwJsonTypeError(fmt::format(
+                R"("fair_share_weights.{}" must be an object)", type));
+    }
+    for (const auto& [name, value] : json.items()) {
+        const auto weight = value.get<uint32_t>();
+        if (weight == 0 || weight > FairShareWeights::MaxWeight) {
+            throw std::invalid_argument(fmt::format(
+                    R"("fair_share_weights.{}.{}" must be between 1 and {})",
+                    type,
+                    name,
+                    FairShareWeights::MaxWeight));
+        }
+        map[name] = weight;
+    }
+}
+
+void from_json(const nlohmann::json& json, FairShareWeights& weights) {
+    if (!json.is_object()) {
+        cb::throwJsonTypeError(R"("fair_share_weights" must be an object)");
+    }
+    for (const auto& [key, value] : json.items()) {
+        if (key == "buckets") {
+            parseWeights(value, key, weights.buckets);
+        } else if (key == "users") {
+            parseWeights(value, key, weights.users);
+        } else {
+            throw std::invalid_argument(fmt::format(
+                    R"(Unknown key "{}" in "fair_share_weights")", key));
+        }
+    }
+}
+
+void to_json(nlohmann::json& json, const FairShareWeights& weights) {
+    json = {{"buckets", weights.buckets}, {"users", weights.users}};
+}
@@ -0,0 +1,75 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/**
+ * The weights used by the FairShareScheduler, configured with
+ * "fair_share_weights" in memcached.json:
+ *
+ *     {
+ *       "buckets" : { "analytics" : 25 },
+ *       "users" : { "@cbq-engine" : 200 }
+ *     }
+ *
+ * A connection gets the weight of its user if present, otherwise the
+ * weight of its selected bucket (or DefaultWeight). Connections yielding
+ * on the same front end thread get a share of the CPU time proportional
+ * to their weight.
+ */
+struct FairShareWeights {
+    static constexpr uint32_t DefaultWeight = 100;
+    static constexpr uint32_t MaxWeight = 10000;
+
+    /**
+     * Get the weight to use for a connection
+     *
+     * @param bucket The name of the selected bucket
+     * @param user The name of the authenticated user
+     * @return The weight and the name of the class the weight came from
+     *         ("user:<name>", "bucket:<name>" or "default")
+     */
+    std::pair<uint32_t, std::string> lookup(std::string_view bucket,
+                                            std::string_view user) const;
+
+    bool operator==(const FairShareWeights&) const = default;
+
+    std::map<std::string, uint32_t, std::less<>> buckets;
+    std::map<std::string, uint32_t, std::less<>> users;
+};
+
+/// Parse the weights (throws std::invalid_argument for weights outside
+/// [1, MaxWeight])
+void from_json(const nlohmann::json& json, FairShareWeights& weights);
+void to_json(nlohmann::json& json, const FairShareWeights& weights);
+
+/// The per connection state used by the FairShareScheduler
+struct FairShareState {
+    /// The CPU time (in ns) used by the connection scaled by
+    /// DefaultWeight / weight
+    uint64_t virtualTime = 0;
+    /// The weight of the connection (updated when it is scheduled)
+    uint32_t weight = FairShareWeights::DefaultWeight;
+    /// The class the weight came from (used for the queueing delay stats)
+    std::string weightClass = "default";
+    /// When the connection was put in the run queue (if queued)
+    std::optional<std::chrono::steady_clock::time_point> queued;
+    /// The key of the connection in the run queue
+    std::pair<uint64_t, uint64_t> key;
+};
@@ -0,0 +1,103 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "fair_share_scheduler.h"
+
+#include "buckets.h"
+#include "connection.h"
+#include "settings.h"
+
+#include <chrono>
+#include <vector>
+
+/// The virtual time corresponding to a timeslice
+static uint64_t getTimesliceVirtualTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   Settings::instance().getCommandTimeSlice())
+            .count();
+}
+
+void FairShareScheduler::schedule(Connection& connection) {
+    auto& state = connection.getFairShareState();
+    if (state.queued) {
+        return;
+    }
+
+    auto [weight, weightClass] = Settings::instance().getFairShareWeight(
+            connection.getBucket().name, connection.getUser().name);
+    state.weight = weight;
+    if (state.weightClass != weightClass) {
+        state.weightClass = std::move(weightClass);
+    }
+
+    const auto slice = getTimesliceVirtualTime();
+    if (virtualClock > slice) {
+        state.virtualTime = std::max(state.virtualTime, virtualClock - slice);
+    }
+    state.key = {state.virtualTime, sequence++};
+    state.queued = std::chrono::steady_clock::now();
+    runQueue.emplace(state.key, &connection);
+
+    if (!isLoopCallbackScheduled()) {
+        base.runInLoop(this);
+    }
+}
+
+void FairShareScheduler::remove(const Connection& connection) {
+    const auto& state = connection.getFairShareState();
+    if (state.queued) {
+        runQueue.erase(state.key);
+    }
+}
+
+void FairShareScheduler::runLoopCallback() noexcept {
+    if (runQueue.empty()) {
+        return;
+    }
+
+    virtualClock = std::max(virtualClock, runQueue.begin()->first.first);
+    const auto limit = runQueue.begin()->first.first +
+                       getTimesliceVirtualTime();
+    const auto now = std::chrono::steady_clock::now();
+
+    // The connections may be scheduled again (or destroyed) as part of
+    // triggerCallback() so pick the connections to resume first
+    std::vector<Connection*> resume;
+    while (!runQueue.empty() && runQueue.begin()->first.first <= limit) {
+        auto node = runQueue.extract(runQueue.begin());
+        auto& connection = *node.mapped();
+        auto& state = connection.getFairShareState();
+        const auto delay =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                        now - *state.queued);
+        queueDelay.lock()->try_emplace(state.weightClass).first->second.add(
+                delay);
+        state.queued.reset();
+        resume.push_back(&connection);
+    }
+
+    for (auto* connection : resume) {
+        connection->triggerCallback(true);
+    }
+
+    if (!runQueue.empty()) {
+        // The rest of the connections must wait for the next iteration
+        base.runInLoop(this);
+    }
+}
+
+void FairShareScheduler::iterateQueueDelay(
+        const std::function<void(std::string_view,
+                                 const Hdr1sfMicroSecHistogram&)>& callback)
+        const {
+    auto locked = queueDelay.lock();
+    for (const auto& [weightClass, histogram] : *locked) {
+        callback(weightClass, histogram);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/io/async/EventBase.h>
+#include <hdrhistogram/hdrhistogram.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+class Connection;
+
+/**
+ * The FairShareScheduler decides the order in which the connections bound
+ * to a front end thread are resumed after they yielded with more work to
+ * do (they used their CPU budget, or the number of requests allowed per
+ * event).
+ *
+ * Each connection has a virtual time which advances by the CPU time it
+ * uses scaled by DefaultWeight / weight (see FairShareWeights), so
+ * connections with a higher weight advance slower. The runnable
+ * connections are resumed in virtual time order once the network events
+ * of the current event loop iteration are processed, and connections
+ * more than a timeslice ahead of the one with the lowest virtual time
+ * have used more than their share and are held back to a later
+ * iteration. The time a connection spends in the run queue is recorded
+ * per weight class.
+ *
+ * All methods except iterateQueueDelay() must be called in the context of
+ * the thread running the event base.
+ */
+class FairShareScheduler : public folly::EventBase::LoopCallback {
+public:
+    explicit FairShareScheduler(folly::EventBase& base) : base(base) {
+    }
+
+    /**
+     * Queue the connection to be resumed. The weight of the connection
+     * is refreshed from the settings. If the connection is already queued
+     * this is a noop.
+     */
+    void schedule(Connection& connection);
+
+    /// Remove the connection from the run queue (if queued)
+    void remove(const Connection& connection);
+
+    /// Resume the connections in the run queue
+    void runLoopCallback() noexcept override;
+
+    /// The number of connections in the run queue
+    std::size_t size() const {
+        return runQueue.size();
+    }
+
+    /// Iterate over the queueing delay histogram of each weight class.
+    /// May be called from any thread
+    void iterateQueueDelay(
+            const std::function<void(std::string_view,
+                                     const Hdr1sfMicroSecHistogram&)>&
+                    callback) const;
+
+protected:
+    folly::EventBase& base;
+
+    /// The lowest virtual time seen in the run queue when the connections
+    /// were last resumed. A connection is queued with at least this
+    /// virtual time minus a timeslice so that connections which were idle
+    /// for a while don't get to monopolize the thread
+    uint64_t virtualClock = 0;
+
+    /// Used to keep connections with the same virtual time in FIFO order
+    uint64_t sequence = 0;
+
+    /// The runnable connections ordered by (virtual time, sequence)
+    std::map<std::pair<uint64_t, uint64_t>, Connection*> runQueue;
+
+    /// The time spent in the run queue per weight class
+    folly::Synchronized<
+            std::unordered_map<std::string, Hdr1sfMicroSecHistogram>,
+            std::mutex>
+            queueDelay;
+};
@@ -14,6 +14,7 @@
 #include "buckets.h"
 #include "connection.h"
 #include "cookie.h"
+#include "io_uring_ring.h"
 #include "listening_port.h"
 #include "log_macros.h"
 #include "mcaudit.h"
@@ -22,6 +23,7 @@
 #include "stats.h"
 #include "thread_stats.h"
 #include "tracing.h"
+#include <folly/Random.h>
 #include <hdrhistogram/hdrhistogram.h>
 #include <json/syntax_validator.h>
 #include <memcached/tracer.h>
@@ -37,6 +39,7 @@
 #include <cstdlib>
 #include <mutex>
 #include <queue>
+#include <system_error>
 
 void ClientConnectionDetails::onConnect() {
     ++current_connections;
@@ -170,6 +173,8 @@ static bool eraseConnection(
 }
 
 void FrontEndThread::onConnectionDestroy(const Connection& connection) {
+    fairShareScheduler.remove(connection);
+
     {
         auto iter = clientConnectionMap.find(connection.getPeername()["ip"]);
         if (iter != clientConnectionMap.end()) {
@@ -281,10 +286,18 @@ static void worker_libevent(void* arg) {
         init_cond.notify_all();
     }
 
-    me.eventBase.loopForever();
+    me.runEventLoop();
     me.running = false;
 }
 
+void FrontEndThread::runEventLoop() {
+    // Busy polling is done by the BusyPoller from within the loop, so that
+    // the thread never leaves loopForever() (isInEventBaseThread() is only
+    // reliable while the loop runs)
+    eventBase.loopForever();
+    busyPoller.stop();
+}
+
 void FrontEndThread::do_dispatch(SOCKET sfd,
                                  std::shared_ptr<ListeningPort> descr) {
     tryDisconnectUnauthenticatedConnections();
@@ -382,9 +395,21 @@ void FrontEndThread::dispatch(SOCKET sfd,
                               std::shared_ptr<ListeningPort> descr) {
     // Which thread we assigned a connection to most recently.
     static std::atomic<size_t> last_thread = 0;
-    size_t tid = (last_thread + 1) % Settings::instance().getNumWorkerThreads();
+    const auto nthreads = Settings::instance().getNumWorkerThreads();
+    size_t tid;
+    if (Settings::instance().isConnectionLoadBalancing() && nthreads > 1) {
+        // Use the least loaded of two random threads rather than the least
+        // loaded thread, as the load is only sampled once a second and all
+        // of the connections arriving until then would end up on the same
+        // thread
+        const size_t first = folly::Random::rand32(nthreads);
+        const size_t second = folly::Random::rand32(nthreads);
+        tid = threads[first].load <= threads[second].load ? first : second;
+    } else {
+        tid = (last_thread + 1) % nthreads;
+        last_thread = tid;
+    }
     auto& thread = threads[tid];
-    last_thread = tid;
 
     try {
         using namespace std::chrono;
@@ -407,12 +432,267 @@ void FrontEndThread::dispatch(SOCKET sfd,
     }
 }
 
+bool FrontEndThread::isInitialized() {
+    return !threads.empty();
+}
+
+void FrontEndThread::iterateFairShareQueueDelay(
+        const std::function<void(size_t,
+                                 std::string_view,
+                                 const Hdr1sfMicroSecHistogram&)>& callback) {
+    for (const auto& thr : threads) {
+        thr.fairShareScheduler.iterateQueueDelay(
+                [&callback, &thr](auto weightClass, const auto& histogram) {
+                    callback(thr.index, weightClass, histogram);
+                });
+    }
+}
+
+std::map<std::string, Hdr1sfMicroSecHistogram, std::less<>>
+FrontEndThread::getAggregatedFairShareQueueDelay() {
+    std::map<std::string, Hdr1sfMicroSecHistogram, std::less<>> ret;
+    iterateFairShareQueueDelay(
+            [&ret](auto, auto weightClass, const auto& histogram) {
+                auto iter = ret.find(weightClass);
+                if (iter == ret.end()) {
+                    iter = ret.try_emplace(std::string(weightClass)).first;
+                }
+                iter->second += histogram;
+            });
+    return ret;
+}
+
+/// Set while a connection is being moved to another thread (we only move
+/// one connection at a time as the load of the threads must be sampled
+/// again before moving more)
+static std::atomic_bool connectionMigrationInProgress{false};
+
+void FrontEndThread::balanceLoad() {
+    /// Move connections when the busiest thread used this much (in percent)
+    /// more CPU than the average
+    static constexpr uint64_t MigrationThreshold = 25;
+    /// Don't bother moving connections off threads using less than this
+    /// much CPU time per second
+    static constexpr uint64_t MinimumMigrationLoad =
+            std::chrono::nanoseconds(std::chrono::milliseconds(50)).count();
+
+    if (threads.empty()) {
+        return;
+    }
+
+    uint64_t total = 0;
+    FrontEndThread* busiest = nullptr;
+    FrontEndThread* idlest = nullptr;
+    for (auto& thr : threads) {
+        const uint64_t now = thr.cpuTime;
+        thr.load = now - thr.sampledCpuTime;
+        thr.sampledCpuTime = now;
+        total += thr.load;
+        if (!busiest || thr.load > busiest->load) {
+            busiest = &thr;
+        }
+        if (!idlest || thr.load < idlest->load) {
+            idlest = &thr;
+        }
+    }
+
+    // Report the load of the busiest thread relative to the average
+    // (100 means that the load is evenly spread)
+    const uint64_t average = total / threads.size();
+    const uint64_t busiestLoad = busiest->load;
+    global_statistics.worker_thread_cpu_imbalance =
+            average ? busiestLoad * 100 / average : 100;
+
+    if (!Settings::instance().isConnectionLoadBalancing() ||
+        busiest == idlest || busiestLoad < MinimumMigrationLoad ||
+        busiestLoad * 100 < average * (100 + MigrationThreshold)) {
+        return;
+    }
+
+    if (connectionMigrationInProgress.exchange(true)) {
+        return;
+    }
+
+    // Moving more than the busiest thread's excess over the average would
+    // just move the hot spot
+    const double share =
+            static_cast<double>(busiestLoad - average) / busiestLoad;
+    try {
+        busiest->eventBase.runInEventBaseThread(
+                [&from = *busiest, &to = *idlest, share]() {
+                    TRACE_LOCKGUARD_TIMED(from.mutex,
+                                          "mutex",
+                                          "balanceLoad::threadLock",
+                                          SlowMutexThreshold);
+                    from.migrateBusyConnection(to, share);
+                });
+    } catch (const std::bad_alloc&) {
+        connectionMigrationInProgress = false;
+    }
+}
+
+void FrontEndThread::migrateBusyConnection(FrontEndThread& to,
+                                           double share) {
+    const uint64_t now = cpuTime;
+    const auto elapsed = now - connectionSampleCpuTime;
+    connectionSampleCpuTime = now;
+
+    // Sample all of the connections so that the next sample covers the
+    // same period for all of them
+    Connection* victim = nullptr;
+    double victimShare = 0;
+    for (const auto& [c, conn] : connections) {
+        const auto used = static_cast<double>(c->sampleCpuTime().count());
+        const auto connectionShare = elapsed ? used / elapsed : 0;
+        if (connectionShare > victimShare && connectionShare <= share &&
+            c->isMigratable()) {
+            victim = c;
+            victimShare = connectionShare;
+        }
+    }
+
+    if (!victim) {
+        connectionMigrationInProgress = false;
+        return;
+    }
+
+    LOG_DEBUG_CTX("Moving connection to another worker thread",
+                  {"conn_id", victim->getId()},
+                  {"from", index},
+                  {"to", to.index},
+                  {"share", victimShare});
+    migrateConnection(*victim, to);
+}
+
+/**
+ * A connection on its way to another thread. The connection isn't owned
+ * by any thread while the callback to adopt it is queued in the target
+ * thread (and its bookkeeping in the old thread is already released). If
+ * the callback is dropped without being run (the event base of the target
+ * thread is destroyed) the connection is released in the context of the
+ * target thread (and not the thread it used to be bound to).
+ */
+class FrontEndThread::ConnectionInFlight {
+public:
+    ConnectionInFlight(FrontEndThread& to,
+                       std::unique_ptr<Connection> connection)
+        : to(to), connection(std::move(connection)) {
+    }
+
+    ConnectionInFlight(ConnectionInFlight&&) = default;
+
+    ~ConnectionInFlight() {
+        if (connection) {
+            TRACE_LOCKGUARD_TIMED(to.mutex,
+                                  "mutex",
+                                  "dropConnection::threadLock",
+                                  SlowMutexThreshold);
+            to.dropConnection(std::move(connection));
+        }
+    }
+
+    void adopt() {
+        TRACE_LOCKGUARD_TIMED(to.mutex,
+                              "mutex",
+                              "adoptConnection::threadLock",
+                              SlowMutexThreshold);
+        to.adoptConnection(std::move(connection));
+    }
+
+protected:
+    FrontEndThread& to;
+    std::unique_ptr<Connection> connection;
+};
+
+void FrontEndThread::migrateConnection(Connection& connection,
+                                       FrontEndThread& to) {
+    const auto id = connection.getId();
+    const std::string ip = connection.getPeername()["ip"];
+    auto node = connections.extract(&connection);
+    if (node.empty()) {
+        throw std::logic_error("migrateConnection: Connection not found");
+    }
+    connection.detachFromThread();
+
+    // The connection is accounted to the target thread once it is adopted
+    // (or dropped) by the target thread
+    auto iter = clientConnectionMap.find(ip);
+    if (iter != clientConnectionMap.end()) {
+        --iter->second.current_connections;
+    }
+
+    try {
+        to.eventBase.runInEventBaseThread(
+                [inflight = ConnectionInFlight(
+                         to, std::move(node.mapped()))]() mutable {
+                    inflight.adopt();
+                });
+    } catch (const std::bad_alloc&) {
+        // The connection was dropped (and disconnected) as part of
+        // unwinding
+        LOG_WARNING_CTX("Failed to move connection to another worker thread",
+                        {"conn_id", id});
+    }
+}
+
+void FrontEndThread::accountMigratedConnection(Connection& connection) {
+    const std::string ip = connection.getPeername()["ip"];
+    auto iter = clientConnectionMap.find(ip);
+    if (iter != clientConnectionMap.end()) {
+        ++iter->second.current_connections;
+    } else if (maybeTrimClientConnectionMap()) {
+        ++clientConnectionMap[ip].current_connections;
+    }
+    connectionMigrationInProgress = false;
+}
+
+void FrontEndThread::adoptConnection(std::unique_ptr<Connection> connection) {
+    connection->attachToThread(*this);
+    // The virtual time is relative to the fair share scheduler of the
+    // previous thread
+    connection->getFairShareState().virtualTime = 0;
+    accountMigratedConnection(*connection);
+    add_connection(std::move(connection));
+    ++global_statistics.connections_migrated;
+}
+
+void FrontEndThread::dropConnection(std::unique_ptr<Connection> connection) {
+    LOG_WARNING_CTX(
+            "Dropping connection which was moving to another worker thread",
+            {"conn_id", connection->getId()},
+            {"thread", index});
+    // Bind the connection to this thread without attaching it to the
+    // event base so that the destructor releases it from this thread
+    connection->bindToThread(*this);
+    accountMigratedConnection(*connection);
+    BucketManager::instance().disassociateBucket(*connection);
+    connection.reset();
+}
+
 FrontEndThread::FrontEndThread()
-    : scratch_buffer(), validator(cb::json::SyntaxValidator::New()) {
+    : fairShareScheduler(eventBase),
+      scratch_buffer(),
+      validator(cb::json::SyntaxValidator::New()) {
 }
 
 FrontEndThread::~FrontEndThread() = default;
 
+IoUringRing* FrontEndThread::getIoUringRing() {
+    if (!ioUring && !ioUringUnavailable) {
+        try {
+            ioUring = IoUringRing::create(eventBase);
+        } catch (const std::exception& e) {
+            ioUringUnavailable = true;
+            LOG_WARNING_CTX(
+                    "Failed to create io_uring instance. Using libevent for "
+                    "connections",
+                    {"thread", index},
+                    {"error", e.what()});
+        }
+    }
+    return ioUring.get();
+}
+
 bool FrontEndThread::isValidJson(Cookie& cookie, std::string_view view) const {
     // Record how long JSON checking takes to both Tracer and bucket-level
     // histogram.
@@ -431,6 +711,24 @@ bool FrontEndThread::isXattrBlobValid(std::string_view view) {
     return cb::xattr::validate(*validator, view);
 }
 
+cb::compression::Buffer FrontEndThread::getInflateBuffer() {
+    Expects(eventBase.isInEventBaseThread());
+    if (inflateBuffers.empty()) {
+        return {};
+    }
+    auto ret = std::move(inflateBuffers.back());
+    inflateBuffers.pop_back();
+    return ret;
+}
+
+void FrontEndThread::releaseInflateBuffer(cb::compression::Buffer buffer) {
+    Expects(eventBase.isInEventBaseThread());
+    if (inflateBuffers.size() < MaxInflateBuffers &&
+        buffer.size() <= MaxInflateBufferSize) {
+        inflateBuffers.emplace_back(std::move(buffer));
+    }
+}
+
 /******************************* GLOBAL STATS ******************************/
 
 void worker_threads_init() {
@@ -11,17 +11,23 @@
 #pragma once
 
 #include "auditd/src/audit_event_filter.h"
+#include "busy_poller.h"
 #include "connection.h"
+#include "fair_share_scheduler.h"
 #include "top_keys.h"
 
 #include <folly/Synchronized.h>
 #include <folly/io/async/EventBase.h>
+#include <json/structural_index.h>
+#include <platform/compression/buffer.h>
 #include <platform/sized_buffer.h>
 #include <platform/socket.h>
+#include <relaxed_atomic.h>
 #include <subdoc/operations.h>
 #include <array>
 #include <atomic>
 #include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -70,6 +76,8 @@ struct ClientConnectionDetails {
     nlohmann::json to_json(std::chrono::steady_clock::time_point now) const;
 };
 
+class IoUringRing;
+
 struct FrontEndThread {
     FrontEndThread();
     ~FrontEndThread();
@@ -81,14 +89,36 @@ struct FrontEndThread {
     folly::EventBase eventBase;
 
     /**
-     * Dispatches a new connection to the worker thread by using round
-     * robin.
+     * Dispatches a new connection to a worker thread by using round
+     * robin (or the least loaded of two random threads when connection
+     * load balancing is enabled).
      *
      * @param sfd the socket to use
      * @param descr The description of the port it is listening to
      */
     static void dispatch(SOCKET sfd, std::shared_ptr<ListeningPort> descr);
 
+    /// Have the front end threads been created (by worker_threads_init())
+    static bool isInitialized();
+
+    /**
+     * Iterate over the fair share queueing delay histograms of all of
+     * the front end threads
+     *
+     * @param callback called with the thread index, the weight class and
+     *                 the histogram
+     */
+    static void iterateFairShareQueueDelay(
+            const std::function<void(size_t,
+                                     std::string_view,
+                                     const Hdr1sfMicroSecHistogram&)>&
+                    callback);
+
+    /// Get the fair share queueing delay histogram of each weight class
+    /// aggregated over all of the front end threads
+    static std::map<std::string, Hdr1sfMicroSecHistogram, std::less<>>
+    getAggregatedFairShareQueueDelay();
+
     /// Mutex to lock protect access to this object.
     std::mutex mutex;
 
@@ -101,6 +131,12 @@ struct FrontEndThread {
      */
     Subdoc::Operation subdoc_op;
 
+    /**
+     * Shared structural index used to navigate large documents in
+     * sub-document lookups for all connections serviced by this thread
+     */
+    cb::json::StructuralIndex subdoc_index;
+
     /// Check to see if the data in view is valid JSON and update
     /// the bucket histogram (and cookie trace scope) with time spent
     /// for JSON validation
@@ -109,9 +145,56 @@ struct FrontEndThread {
     /// Use the JSON SyntaxValidator to validate the XATTR blob
     bool isXattrBlobValid(std::string_view view);
 
+    /**
+     * Get a buffer to inflate the input payload of a command into. The
+     * buffers are recycled between the commands served by this thread
+     * (see releaseInflateBuffer()) to avoid allocating a new buffer for
+     * every compressed value. Must be called in the context of this thread
+     */
+    cb::compression::Buffer getInflateBuffer();
+
+    /// Return a buffer obtained from getInflateBuffer() for reuse (it is
+    /// freed if the pool is full or the buffer is large). Must be called
+    /// in the context of this thread
+    void releaseInflateBuffer(cb::compression::Buffer buffer);
+
+    /**
+     * Run the event loop until threads_shutdown() stops the thread. If
+     * busy polling is enabled (see Settings::getBusyPollTime()) the thread
+     * spins polling for events for the configured time after it last did
+     * any work before it blocks waiting for events (trading CPU for the
+     * latency of waking up the thread). See BusyPoller.
+     */
+    void runEventLoop();
+
     /// Is the thread running or not
     std::atomic_bool running{false};
 
+    /// The CPU time (in ns) spent serving the connections bound to this
+    /// thread
+    cb::RelaxedAtomic<uint64_t> cpuTime;
+
+    /// Keeps the event loop spinning after the thread served a connection
+    /// (when busy polling is enabled)
+    BusyPoller busyPoller{eventBase, cpuTime};
+
+    /// The CPU time (in ns) spent serving connections in the last load
+    /// sample (see balanceLoad())
+    cb::RelaxedAtomic<uint64_t> load;
+
+    /// Decides the order the connections which yielded are resumed in
+    FairShareScheduler fairShareScheduler;
+
+    /**
+     * Sample the load of the front end threads (and update the imbalance
+     * stat). If connection load balancing is enabled and the busiest
+     * thread is significantly busier than the average, one of its busy
+     * connections is moved to the least loaded thread.
+     *
+     * Called periodically from the clock tick (once a second)
+     */
+    static void balanceLoad();
+
     /// A temporary buffer the connections may utilize (never expect anything
     /// about the content of the buffer (expect it to be overwritten when your
     /// method returns) (It is currently big enough to keep a protocol
@@ -124,6 +207,15 @@ struct FrontEndThread {
                                scratch_buffer.size()};
     }
 
+    /**
+     * Get the io_uring instance used by the connections bound to this
+     * thread (created upon first use).
+     *
+     * @return the ring or nullptr if io_uring isn't available (in which
+     *         case connections should use libevent)
+     */
+    IoUringRing* getIoUringRing();
+
     /// The key trace collector used by this thread. Not set
     /// when tracing is disabled
     std::shared_ptr<cb::trace::topkeys::Collector> keyTrace;
@@ -211,9 +303,67 @@ struct FrontEndThread {
     void iterate_connections(
             const std::function<void(Connection&)>& callback) const;
 
-protected:
+    /**
+     * Create the connection for a newly accepted socket and bind it to
+     * this thread. Must be called in the context of this thread (the
+     * socket is either accepted by a listener owned by the thread, or
+     * dispatched to the thread)
+     *
+     * @param sfd the socket to use
+     * @param descr The description of the port it is listening to
+     */
     void do_dispatch(SOCKET sfd, std::shared_ptr<ListeningPort> descr);
 
+protected:
+
+    /**
+     * Move the connection using the largest share of this thread's CPU
+     * time without exceeding the provided share to the provided thread.
+     * Only connections at a safe point (see Connection::isMigratable())
+     * are considered.
+     *
+     * Called in the context of this thread with the thread lock held
+     *
+     * @param to The thread to move the connection to
+     * @param share The maximum share of the CPU time of this thread the
+     *              connection may have used
+     */
+    void migrateBusyConnection(FrontEndThread& to, double share);
+
+    /**
+     * Move the provided connection to the provided thread. The connection
+     * must be at a safe point (see Connection::isMigratable()). Until the
+     * target thread adopts the connection it isn't bound to any thread
+     * (and not visible to iterate_connections() of either thread).
+     *
+     * Called in the context of this thread with the thread lock held
+     */
+    void migrateConnection(Connection& connection, FrontEndThread& to);
+
+    /// Holder for a connection queued for adoption by another thread
+    class ConnectionInFlight;
+
+    /// Take over a connection migrated from another thread. Called in
+    /// the context of this thread with the thread lock held
+    void adoptConnection(std::unique_ptr<Connection> connection);
+
+    /// Release a connection migrated to this thread which could not be
+    /// adopted (the callback to adopt it was dropped). Called with the
+    /// thread lock held
+    void dropConnection(std::unique_ptr<Connection> connection);
+
+    /// Account a connection migrated to this thread in the per client
+    /// connection counts (and allow the next migration to start)
+    void accountMigratedConnection(Connection& connection);
+
+    /// The cpuTime at the last call to balanceLoad() (only used by
+    /// balanceLoad())
+    uint64_t sampledCpuTime = 0;
+
+    /// The cpuTime when the connections CPU time was last sampled by
+    /// migrateBusyConnection()
+    uint64_t connectionSampleCpuTime = 0;
+
     /// Add a connection to the thread.
     void add_connection(std::unique_ptr<Connection> connection);
 
@@ -221,12 +371,26 @@ protected:
     /// when they need to validate a JSON document
     std::unique_ptr<cb::json::SyntaxValidator> validator;
 
+    /// The max number of inflate buffers kept for reuse
+    static constexpr std::size_t MaxInflateBuffers = 32;
+    /// Inflate buffers larger than this are freed rather than kept for
+    /// reuse
+    static constexpr std::size_t MaxInflateBufferSize = 1024 * 1024;
+    /// The inflate buffers available for reuse (see getInflateBuffer())
+    std::vector<cb::compression::Buffer> inflateBuffers;
+
     /// A list of all DCP connections bound this thread
     std::deque<std::reference_wrapper<Connection>> dcp_connections;
 
     /// The audit event filter used by this thread
     std::unique_ptr<AuditEventFilter> auditEventFilter;
 
+    /// The io_uring instance used by connections using io_uring. Declared
+    /// before the connections as it must outlive them
+    std::unique_ptr<IoUringRing> ioUring;
+    /// Set if we failed to create the io_uring instance
+    bool ioUringUnavailable = false;
+
     /// All connections bound to this thread
     std::unordered_map<Connection*, std::unique_ptr<Connection>> connections;
 
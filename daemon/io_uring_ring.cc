@@ -0,0 +1,696 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "io_uring_ring.h"
+
+#include <folly/io/IOBuf.h>
+#include <folly/io/async/EventBase.h>
+#include <stdexcept>
+
+#ifdef HAVE_LIBURING
+#include "stats.h"
+
+#include <folly/io/IOBufQueue.h>
+#include <folly/io/async/EventHandler.h>
+#include <liburing.h>
+#include <logger/logger.h>
+#include <platform/byte_literals.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+/// The number of entries in the submission queue
+static constexpr unsigned int QueueDepth = 4096;
+/// The number of buffers in the provided buffer ring (must be a power of 2)
+static constexpr unsigned int NumReceiveBuffers = 256;
+/// The size of each of the buffers in the provided buffer ring
+static constexpr size_t ReceiveBufferSize = 16_KiB;
+/// The buffer group used for the provided buffer ring
+static constexpr int ReceiveBufferGroup = 0;
+/// The maximum number of completions to reap in one batch
+static constexpr unsigned int CompletionBatchSize = 256;
+
+/// The operation a completion belongs to is encoded in the low bits of the
+/// user data (the rest is the address of the socket, or for ZeroCopySend
+/// the address of the ZeroCopyRequest)
+enum class IoUringOperation : uint64_t {
+    Receive = 0,
+    Send = 1,
+    Cancel = 2,
+    ZeroCopySend = 3
+};
+static constexpr uint64_t OperationMask = 0x3;
+
+/// The size of the buffers small copies queued for sending are packed into
+static constexpr size_t SendSlabSize = 16_KiB;
+
+/// A chunk of data queued for sending
+struct PendingSend {
+    explicit PendingSend(bool zerocopy) : zerocopy(zerocopy) {
+    }
+    /// Send the data with zero copy (only one buffer per entry)
+    const bool zerocopy;
+    folly::IOBufQueue data{folly::IOBufQueue::cacheChainLength()};
+};
+
+class IoUringSocket {
+public:
+    IoUringSocket(SOCKET sfd, IoUringSocketListener& listener)
+        : sfd(sfd), listener(&listener) {
+    }
+
+    const SOCKET sfd;
+    /// The listener to notify (nullptr once removed from the ring)
+    IoUringSocketListener* listener;
+    /// The number of requests in flight for the socket. The socket can't
+    /// be released until all of them have completed
+    int inflight = 0;
+    /// Should the socket receive data
+    bool receiveEnabled = true;
+    /// Is there a multishot recv in flight
+    bool receiveArmed = false;
+    /// Has cancellation of the multishot recv been requested
+    bool cancelRequested = false;
+    /// Is the socket queued for send submission at the end of the loop
+    bool sendScheduled = false;
+    /// Is there a send request in flight
+    bool sendInFlight = false;
+    /// Data queued, but not yet submitted
+    std::deque<PendingSend> pending;
+    /// Data in the sendmsg request in flight (the kernel reference the
+    /// memory until the request completes)
+    std::unique_ptr<folly::IOBuf> sending;
+    std::vector<iovec> iov;
+    msghdr msg{};
+};
+
+static_assert(alignof(IoUringSocket) > OperationMask,
+              "The low bits of the socket address are used for the operation");
+
+static uint64_t encodeUserData(IoUringSocket& socket, IoUringOperation op) {
+    return reinterpret_cast<uint64_t>(&socket) | static_cast<uint64_t>(op);
+}
+
+/**
+ * A zero copy send in flight. The kernel references the data until it
+ * posts the notification completion (which may be long after the request
+ * itself completed, as it waits for the peer to ack the data) so the data
+ * lives in its own object rather than in the socket.
+ */
+struct ZeroCopyRequest {
+    ZeroCopyRequest(IoUringSocket& socket, std::unique_ptr<folly::IOBuf> data)
+        : socket(socket), data(std::move(data)) {
+    }
+    IoUringSocket& socket;
+    std::unique_ptr<folly::IOBuf> data;
+    /// The number of bytes the kernel accepted
+    size_t sent = 0;
+};
+
+static_assert(alignof(ZeroCopyRequest) > OperationMask,
+              "The low bits of the request address are used for the "
+              "operation");
+
+class IoUringRingImpl : public IoUringRing,
+                        public folly::EventHandler,
+                        public folly::EventBase::LoopCallback {
+public:
+    explicit IoUringRingImpl(folly::EventBase& base);
+    ~IoUringRingImpl() override;
+
+    IoUringSocket& add(SOCKET sfd, IoUringSocketListener& listener) override;
+    void remove(IoUringSocket& socket) override;
+    void enableReceive(IoUringSocket& socket) override;
+    void disableReceive(IoUringSocket& socket) override;
+    void copy(IoUringSocket& socket,
+              gsl::span<std::string_view> data) override;
+    void send(IoUringSocket& socket,
+              std::unique_ptr<folly::IOBuf> data,
+              bool zerocopy) override;
+
+    /// Called when the eventfd signals that completions are available
+    void handlerReady(uint16_t events) noexcept override;
+
+    /// Submit all requests queued while running the loop iteration
+    void runLoopCallback() noexcept override;
+
+protected:
+    struct Completion {
+        uint64_t data;
+        int32_t res;
+        uint32_t flags;
+    };
+
+    /// Get a submission queue entry (flushing the queue if it is full)
+    io_uring_sqe& getSqe();
+    /// Make sure the submission queue gets flushed in this loop iteration
+    void scheduleSubmit();
+    void armReceive(IoUringSocket& socket);
+    void scheduleSend(IoUringSocket& socket);
+    void submitSend(IoUringSocket& socket);
+    void reapCompletions();
+    void dispatch(const Completion& completion);
+    void onReceiveComplete(IoUringSocket& socket, int32_t res, uint32_t flags);
+    void onSendComplete(IoUringSocket& socket, int32_t res);
+    void onZeroCopySendComplete(ZeroCopyRequest& request,
+                                int32_t res,
+                                uint32_t flags);
+    /// Close and release the socket if it is removed and idle
+    void maybeRelease(IoUringSocket& socket);
+
+    uint8_t* getReceiveBuffer(uint16_t bid) {
+        return receiveBuffers.get() + bid * ReceiveBufferSize;
+    }
+    void recycleReceiveBuffer(uint16_t bid);
+
+    folly::EventBase& base;
+    io_uring ring{};
+    io_uring_buf_ring* bufferRing = nullptr;
+    std::unique_ptr<uint8_t[]> receiveBuffers;
+    int eventFd = -1;
+
+    /// All of the sockets registered in the ring (including the ones
+    /// removed which still have requests in flight)
+    std::unordered_map<IoUringSocket*, std::unique_ptr<IoUringSocket>>
+            sockets;
+    /// The sockets with data to submit at the end of the loop iteration
+    std::vector<IoUringSocket*> sendQueue;
+    /// The zero copy sends waiting for the kernel to release the data
+    std::unordered_map<ZeroCopyRequest*, std::unique_ptr<ZeroCopyRequest>>
+            zeroCopyRequests;
+};
+
+IoUringRingImpl::IoUringRingImpl(folly::EventBase& base) : base(base) {
+    int ret = io_uring_queue_init(QueueDepth, &ring, 0);
+    if (ret < 0) {
+        throw std::system_error(
+                -ret, std::system_category(), "io_uring_queue_init");
+    }
+
+    try {
+        // Multishot recv was added in the same kernel release (6.0) as
+        // zero copy send (which may be probed for), and we can't fall
+        // back to single shot recv on a per connection basis.
+        auto* probe = io_uring_get_probe_ring(&ring);
+        const bool supported =
+                probe && io_uring_opcode_supported(probe, IORING_OP_SEND_ZC);
+        if (probe) {
+            io_uring_free_probe(probe);
+        }
+        if (!supported) {
+            throw std::runtime_error(
+                    "The kernel does not support multishot recv");
+        }
+
+        bufferRing = io_uring_setup_buf_ring(
+                &ring, NumReceiveBuffers, ReceiveBufferGroup, 0, &ret);
+        if (!bufferRing) {
+            throw std::system_error(
+                    -ret, std::system_category(), "io_uring_setup_buf_ring");
+        }
+        receiveBuffers = std::make_unique<uint8_t[]>(NumReceiveBuffers *
+                                                     ReceiveBufferSize);
+        for (unsigned int ii = 0; ii < NumReceiveBuffers; ++ii) {
+            io_uring_buf_ring_add(bufferRing,
+                                  getReceiveBuffer(ii),
+                                  ReceiveBufferSize,
+                                  ii,
+                                  io_uring_buf_ring_mask(NumReceiveBuffers),
+                                  ii);
+        }
+        io_uring_buf_ring_advance(bufferRing, NumReceiveBuffers);
+
+        eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (eventFd == -1) {
+            throw std::system_error(errno, std::system_category(), "eventfd");
+        }
+        ret = io_uring_register_eventfd(&ring, eventFd);
+        if (ret < 0) {
+            throw std::system_error(-ret,
+                                    std::system_category(),
+                                    "io_uring_register_eventfd");
+        }
+    } catch (const std::exception&) {
+        if (eventFd != -1) {
+            ::close(eventFd);
+        }
+        if (bufferRing) {
+            io_uring_free_buf_ring(
+                    &ring, bufferRing, NumReceiveBuffers, ReceiveBufferGroup);
+        }
+        io_uring_queue_exit(&ring);
+        throw;
+    }
+
+    initHandler(&base, folly::NetworkSocket::fromFd(eventFd));
+    registerHandler(folly::EventHandler::READ | folly::EventHandler::PERSIST);
+}
+
+IoUringRingImpl::~IoUringRingImpl() {
+    cancelLoopCallback();
+    unregisterHandler();
+    // Tearing down the ring cancels all of the requests still in flight
+    io_uring_free_buf_ring(
+            &ring, bufferRing, NumReceiveBuffers, ReceiveBufferGroup);
+    io_uring_queue_exit(&ring);
+    ::close(eventFd);
+    for (const auto& [ptr, socket] : sockets) {
+        cb::net::closesocket(socket->sfd);
+    }
+}
+
+IoUringSocket& IoUringRingImpl::add(SOCKET sfd,
+                                    IoUringSocketListener& listener) {
+    auto socket = std::make_unique<IoUringSocket>(sfd, listener);
+    auto& ret = *socket;
+    sockets.emplace(&ret, std::move(socket));
+    armReceive(ret);
+    return ret;
+}
+
+void IoUringRingImpl::remove(IoUringSocket& socket) {
+    socket.listener = nullptr;
+    socket.pending.clear();
+    if (socket.inflight) {
+        // Terminate the multishot recv and any send stuck on a full
+        // socket buffer so that the socket may be released
+        cb::net::shutdown(socket.sfd, SHUT_RDWR);
+    }
+    maybeRelease(socket);
+}
+
+void IoUringRingImpl::enableReceive(IoUringSocket& socket) {
+    socket.receiveEnabled = true;
+    // If the recv is still armed (with a cancel in flight) it is
+    // re-armed when the cancellation completes
+    if (!socket.receiveArmed) {
+        armReceive(socket);
+    }
+}
+
+void IoUringRingImpl::disableReceive(IoUringSocket& socket) {
+    socket.receiveEnabled = false;
+    if (socket.receiveArmed && !socket.cancelRequested) {
+        auto& sqe = getSqe();
+        io_uring_prep_cancel64(
+                &sqe, encodeUserData(socket, IoUringOperation::Receive), 0);
+        io_uring_sqe_set_data64(
+                &sqe, encodeUserData(socket, IoUringOperation::Cancel));
+        socket.cancelRequested = true;
+        ++socket.inflight;
+        scheduleSubmit();
+    }
+}
+
+void IoUringRingImpl::copy(IoUringSocket& socket,
+                           gsl::span<std::string_view> data) {
+    if (!socket.listener) {
+        return;
+    }
+    if (socket.pending.empty() || socket.pending.back().zerocopy) {
+        socket.pending.emplace_back(false);
+    }
+    // Pack the copies into the tail of the queue to keep the number of
+    // iovecs (and with that the cost of the sendmsg) down. The tail is
+    // never part of a send in flight (submitSend() moves the data out)
+    auto& queue = socket.pending.back().data;
+    for (auto view : data) {
+        while (!view.empty()) {
+            const auto [ptr, avail] = queue.preallocate(1, SendSlabSize);
+            const auto nbytes = std::min(avail, view.size());
+            std::memcpy(ptr, view.data(), nbytes);
+            queue.postallocate(nbytes);
+            view.remove_prefix(nbytes);
+        }
+    }
+    scheduleSend(socket);
+}
+
+void IoUringRingImpl::send(IoUringSocket& socket,
+                           std::unique_ptr<folly::IOBuf> data,
+                           bool zerocopy) {
+    if (!socket.listener) {
+        return;
+    }
+    if (zerocopy || socket.pending.empty() ||
+        socket.pending.back().zerocopy) {
+        socket.pending.emplace_back(zerocopy);
+    }
+    // The buffer is sent as is (as its own iovec)
+    socket.pending.back().data.append(std::move(data), false);
+    scheduleSend(socket);
+}
+
+void IoUringRingImpl::handlerReady(uint16_t) noexcept {
+    uint64_t value;
+    if (::read(eventFd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+        LOG_WARNING_CTX("IoUringRing: Failed to read eventfd",
+                        {"error", std::strerror(errno)});
+    }
+    reapCompletions();
+}
+
+void IoUringRingImpl::runLoopCallback() noexcept {
+    auto queue = std::move(sendQueue);
+    sendQueue.clear();
+    for (auto* socket : queue) {
+        socket->sendScheduled = false;
+        try {
+            submitSend(*socket);
+        } catch (const std::exception& e) {
+            LOG_WARNING_CTX("IoUringRing: Failed to submit send",
+                            {"error", e.what()});
+        }
+    }
+
+    const int ret = io_uring_submit(&ring);
+    if (ret < 0) {
+        LOG_WARNING_CTX("IoUringRing: io_uring_submit failed",
+                        {"error", std::strerror(-ret)});
+    }
+}
+
+io_uring_sqe& IoUringRingImpl::getSqe() {
+    auto* sqe = io_uring_get_sqe(&ring);
+    if (!sqe) {
+        // The submission queue is full; hand the entries to the kernel
+        // before the end of the loop iteration
+        io_uring_submit(&ring);
+        sqe = io_uring_get_sqe(&ring);
+        if (!sqe) {
+            throw std::runtime_error(
+                    "IoUringRing::getSqe(): Submission queue is full");
+        }
+    }
+    return *sqe;
+}
+
+void IoUringRingImpl::scheduleSubmit() {
+    if (!isLoopCallbackScheduled()) {
+        base.runInLoop(this);
+    }
+}
+
+void IoUringRingImpl::armReceive(IoUringSocket& socket) {
+    auto& sqe = getSqe();
+    io_uring_prep_recv_multishot(&sqe, socket.sfd, nullptr, 0, 0);
+    sqe.flags |= IOSQE_BUFFER_SELECT;
+    sqe.buf_group = ReceiveBufferGroup;
+    io_uring_sqe_set_data64(
+            &sqe, encodeUserData(socket, IoUringOperation::Receive));
+    socket.receiveArmed = true;
+    ++socket.inflight;
+    scheduleSubmit();
+}
+
+void IoUringRingImpl::scheduleSend(IoUringSocket& socket) {
+    if (socket.listener && !socket.sendScheduled && !socket.sendInFlight &&
+        !socket.pending.empty()) {
+        socket.sendScheduled = true;
+        sendQueue.push_back(&socket);
+        scheduleSubmit();
+    }
+}
+
+void IoUringRingImpl::submitSend(IoUringSocket& socket) {
+    if (!socket.listener || socket.sendInFlight || socket.pending.empty()) {
+        return;
+    }
+
+    auto& sqe = getSqe();
+    if (socket.pending.front().zerocopy) {
+        auto request = std::make_unique<ZeroCopyRequest>(
+                socket, socket.pending.front().data.move());
+        socket.pending.pop_front();
+        request->data->coalesce();
+        io_uring_prep_send_zc(&sqe,
+                              socket.sfd,
+                              request->data->data(),
+                              request->data->length(),
+                              MSG_NOSIGNAL,
+                              0);
+#ifdef IORING_SEND_ZC_REPORT_USAGE
+        // Let the notification tell if the kernel had to copy the data
+        sqe.ioprio |= IORING_SEND_ZC_REPORT_USAGE;
+#endif
+        io_uring_sqe_set_data64(
+                &sqe,
+                reinterpret_cast<uint64_t>(request.get()) |
+                        static_cast<uint64_t>(IoUringOperation::ZeroCopySend));
+        auto* ptr = request.get();
+        zeroCopyRequests.emplace(ptr, std::move(request));
+        socket.sendInFlight = true;
+        ++socket.inflight;
+        return;
+    }
+
+    socket.sending = socket.pending.front().data.move();
+    socket.pending.pop_front();
+    socket.iov.clear();
+    for (const auto& range : *socket.sending) {
+        if (socket.iov.size() == IOV_MAX) {
+            // The rest is sent when this request completes
+            break;
+        }
+        if (!range.empty()) {
+            socket.iov.push_back(
+                    {const_cast<uint8_t*>(range.data()), range.size()});
+        }
+    }
+    socket.msg = {};
+    socket.msg.msg_iov = socket.iov.data();
+    socket.msg.msg_iovlen = socket.iov.size();
+    io_uring_prep_sendmsg(&sqe, socket.sfd, &socket.msg, MSG_NOSIGNAL);
+    io_uring_sqe_set_data64(&sqe,
+                            encodeUserData(socket, IoUringOperation::Send));
+    socket.sendInFlight = true;
+    ++socket.inflight;
+}
+
+void IoUringRingImpl::reapCompletions() {
+    std::array<io_uring_cqe*, CompletionBatchSize> cqes;
+    std::array<Completion, CompletionBatchSize> completions;
+    unsigned int count;
+    while ((count = io_uring_peek_batch_cqe(&ring, cqes.data(), cqes.size())) >
+           0) {
+        // Copy the completions out and hand the slots back to the kernel
+        // before dispatching, as the callbacks may submit new requests
+        for (unsigned int ii = 0; ii < count; ++ii) {
+            completions[ii] = {
+                    cqes[ii]->user_data, cqes[ii]->res, cqes[ii]->flags};
+        }
+        io_uring_cq_advance(&ring, count);
+        for (unsigned int ii = 0; ii < count; ++ii) {
+            dispatch(completions[ii]);
+        }
+    }
+}
+
+void IoUringRingImpl::dispatch(const Completion& completion) {
+    const auto op =
+            static_cast<IoUringOperation>(completion.data & OperationMask);
+    const auto address = completion.data & ~OperationMask;
+    // A multishot recv stays in flight until the final completion, and
+    // a zero copy send until the notification completion
+    const bool more =
+            (completion.flags & IORING_CQE_F_MORE) == IORING_CQE_F_MORE;
+
+    ZeroCopyRequest* request = nullptr;
+    IoUringSocket* socket;
+    if (op == IoUringOperation::ZeroCopySend) {
+        request = reinterpret_cast<ZeroCopyRequest*>(address);
+        socket = &request->socket;
+    } else {
+        socket = reinterpret_cast<IoUringSocket*>(address);
+    }
+
+    try {
+        switch (op) {
+        case IoUringOperation::Receive:
+            onReceiveComplete(*socket, completion.res, completion.flags);
+            break;
+        case IoUringOperation::Send:
+            onSendComplete(*socket, completion.res);
+            break;
+        case IoUringOperation::Cancel:
+            break;
+        case IoUringOperation::ZeroCopySend:
+            onZeroCopySendComplete(*request, completion.res, completion.flags);
+            break;
+        }
+    } catch (const std::exception& e) {
+        LOG_WARNING_CTX("IoUringRing: Exception occurred in completion handler",
+                        {"error", e.what()});
+    }
+
+    if (!more) {
+        if (request) {
+            // The kernel no longer references the data (release the
+            // SendBuffer owned by it)
+            zeroCopyRequests.erase(request);
+        }
+        --socket->inflight;
+    }
+    maybeRelease(*socket);
+}
+
+void IoUringRingImpl::onReceiveComplete(IoUringSocket& socket,
+                                        int32_t res,
+                                        uint32_t flags) {
+    const bool more = (flags & IORING_CQE_F_MORE) == IORING_CQE_F_MORE;
+    if (!more) {
+        socket.receiveArmed = false;
+        socket.cancelRequested = false;
+    }
+
+    if ((flags & IORING_CQE_F_BUFFER) == IORING_CQE_F_BUFFER) {
+        const auto bid =
+                static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (res > 0 && socket.listener) {
+            // The data is copied into the connections input stream so that
+            // the buffer may be handed back to the kernel right away
+            socket.listener->onDataReceived(
+                    {reinterpret_cast<const char*>(getReceiveBuffer(bid)),
+                     static_cast<size_t>(res)});
+        }
+        recycleReceiveBuffer(bid);
+    }
+
+    if (res == 0) {
+        if (socket.listener) {
+            socket.listener->onEof();
+        }
+        return;
+    }
+
+    // ENOBUFS: All of the provided buffers were in use (they're all
+    // returned by now). ECANCELED: disableReceive() cancelled the recv
+    if (res < 0 && res != -ENOBUFS && res != -ECANCELED) {
+        if (socket.listener) {
+            socket.listener->onReadError(-res);
+        }
+        return;
+    }
+
+    if (!more && socket.listener && socket.receiveEnabled) {
+        armReceive(socket);
+    }
+}
+
+void IoUringRingImpl::onSendComplete(IoUringSocket& socket, int32_t res) {
+    if (res < 0) {
+        socket.sending.reset();
+        socket.sendInFlight = false;
+        if (socket.listener) {
+            socket.listener->onWriteError(-res);
+        }
+        return;
+    }
+
+    const auto nbytes = static_cast<size_t>(res);
+    // Put whatever the kernel didn't accept in front of the data queued
+    // while the request was in flight
+    folly::IOBufQueue remaining{folly::IOBufQueue::cacheChainLength()};
+    remaining.append(std::move(socket.sending));
+    remaining.trimStart(nbytes);
+    socket.sendInFlight = false;
+    if (!remaining.empty()) {
+        if (socket.pending.empty() || socket.pending.front().zerocopy) {
+            socket.pending.emplace_front(false);
+        }
+        remaining.append(socket.pending.front().data);
+        socket.pending.front().data = std::move(remaining);
+    }
+
+    if (socket.listener) {
+        socket.listener->onDataSent(nbytes);
+    }
+    scheduleSend(socket);
+}
+
+void IoUringRingImpl::onZeroCopySendComplete(ZeroCopyRequest& request,
+                                             int32_t res,
+                                             uint32_t flags) {
+    if ((flags & IORING_CQE_F_NOTIF) == IORING_CQE_F_NOTIF) {
+        global_statistics.zerocopy_send_bytes += request.sent;
+#ifdef IORING_NOTIF_USAGE_ZC_COPIED
+        if ((res & IORING_NOTIF_USAGE_ZC_COPIED) ==
+            IORING_NOTIF_USAGE_ZC_COPIED) {
+            // The kernel fell back to copying the data (for instance
+            // because the device doesn't support scatter-gather)
+            global_statistics.zerocopy_send_copied_bytes += request.sent;
+        }
+#endif
+        return;
+    }
+
+    auto& socket = request.socket;
+    socket.sendInFlight = false;
+    if (res < 0) {
+        if (socket.listener) {
+            socket.listener->onWriteError(-res);
+        }
+        return;
+    }
+
+    request.sent = static_cast<size_t>(res);
+    if (request.sent < request.data->length()) {
+        // Send the rest in a new request. The clone shares the buffer so
+        // it stays alive until both requests are done with it
+        auto rest = request.data->clone();
+        rest->trimStart(request.sent);
+        socket.pending.emplace_front(true);
+        socket.pending.front().data.append(std::move(rest));
+    }
+
+    if (socket.listener) {
+        socket.listener->onDataSent(request.sent);
+    }
+    scheduleSend(socket);
+}
+
+void IoUringRingImpl::maybeRelease(IoUringSocket& socket) {
+    if (socket.listener || socket.inflight) {
+        return;
+    }
+    if (socket.sendScheduled) {
+        std::erase(sendQueue, &socket);
+    }
+    cb::net::closesocket(socket.sfd);
+    sockets.erase(&socket);
+}
+
+void IoUringRingImpl::recycleReceiveBuffer(uint16_t bid) {
+    io_uring_buf_ring_add(bufferRing,
+                          getReceiveBuffer(bid),
+                          ReceiveBufferSize,
+                          bid,
+                          io_uring_buf_ring_mask(NumReceiveBuffers),
+                          0);
+    io_uring_buf_ring_advance(bufferRing, 1);
+}
+#endif
+
+std::unique_ptr<IoUringRing> IoUringRing::create(folly::EventBase& base) {
+#ifdef HAVE_LIBURING
+    return std::make_unique<IoUringRingImpl>(base);
+#else
+    (void)base;
+    throw std::runtime_error(
+            "IoUringRing::create(): Built without io_uring support");
+#endif
+}
@@ -0,0 +1,120 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+#include <platform/socket.h>
+#include <memory>
+#include <string_view>
+
+namespace folly {
+class EventBase;
+class IOBuf;
+} // namespace folly
+
+/**
+ * The IoUringSocketListener receives the notifications for a socket
+ * registered in an IoUringRing. All of the methods are called from the
+ * thread running the event base the ring is bound to.
+ */
+class IoUringSocketListener {
+public:
+    virtual ~IoUringSocketListener() = default;
+    /// Data was received on the socket. The data is only valid for the
+    /// duration of the call (the buffer is handed back to the kernel)
+    virtual void onDataReceived(std::string_view data) = 0;
+    /// The other end closed the socket
+    virtual void onEof() = 0;
+    /// Receiving data failed with the provided error (errno)
+    virtual void onReadError(int error) = 0;
+    /// The provided number of bytes was transferred to the kernel
+    virtual void onDataSent(size_t nbytes) = 0;
+    /// Sending data failed with the provided error (errno)
+    virtual void onWriteError(int error) = 0;
+};
+
+/// Opaque handle of a socket registered in an IoUringRing
+class IoUringSocket;
+
+/**
+ * The IoUringRing performs network IO for the sockets bound to a
+ * FrontEndThread by using io_uring:
+ *
+ *  * Reads use multishot recv with the data received into buffers
+ *    selected by the kernel from a provided buffer ring shared by all of
+ *    the sockets (so idle sockets don't pin any receive buffers)
+ *  * Sends queued while running the event loop are submitted as a single
+ *    batch (one io_uring_submit call) at the end of the loop iteration,
+ *    and each socket only has one send in flight to preserve ordering.
+ *    Small copies are packed into buffers owned by the ring, and buffers
+ *    passed by reference are sent as they are, so a response made of a
+ *    copied header and a referenced value goes out in a single sendmsg.
+ *  * Large buffers may be sent with zero copy.
+ *
+ * Completions are signalled through an eventfd registered in the
+ * folly::EventBase so that the ring integrates with the rest of the
+ * event processing on the thread.
+ */
+class IoUringRing {
+public:
+    /**
+     * Create a new ring bound to the provided event base
+     *
+     * @throws std::runtime_error if io_uring isn't supported by the build
+     *                            or the kernel
+     */
+    static std::unique_ptr<IoUringRing> create(folly::EventBase& base);
+
+    virtual ~IoUringRing() = default;
+
+    /**
+     * Register a socket in the ring. Receive is enabled and the ring
+     * takes ownership of the socket (it is closed when removed and all
+     * operations in flight for the socket have completed)
+     */
+    virtual IoUringSocket& add(SOCKET sfd, IoUringSocketListener& listener) = 0;
+
+    /**
+     * Remove the socket from the ring. No further notifications will be
+     * sent to the listener, and data not yet transferred to the kernel is
+     * dropped.
+     */
+    virtual void remove(IoUringSocket& socket) = 0;
+
+    /// Start (or keep) receiving data on the socket
+    virtual void enableReceive(IoUringSocket& socket) = 0;
+
+    /// Stop receiving data on the socket. Data already in flight may
+    /// still be delivered to the listener
+    virtual void disableReceive(IoUringSocket& socket) = 0;
+
+    /**
+     * Copy the data into the send queue of the socket. Copies are packed
+     * together into buffers owned by the ring.
+     */
+    virtual void copy(IoUringSocket& socket,
+                      gsl::span<std::string_view> data) = 0;
+
+    /**
+     * Queue the data for sending without copying it. The ring keeps the
+     * buffer (and any resources owned by it) until the data is transferred
+     * to the kernel or the socket is removed.
+     *
+     * With zerocopy the kernel sends the data straight out of the buffer
+     * (IORING_OP_SEND_ZC) and the buffer is kept until the kernel posts
+     * the notification that it no longer references it (after the peer
+     * acked the data); even if the socket is removed before that.
+     * Zero copy has a per request overhead so it should only be used for
+     * large buffers.
+     */
+    virtual void send(IoUringSocket& socket,
+                      std::unique_ptr<folly::IOBuf> data,
+                      bool zerocopy) = 0;
+};
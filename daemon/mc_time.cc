@@ -35,6 +35,7 @@
 
 #include "bucket_manager.h"
 #include "buckets.h"
+#include "front_end_thread.h"
 #include "memcached.h"
 
 #include <fmt/chrono.h>
@@ -210,6 +211,7 @@ void Regulator::tick(std::optional<Duration> expectedPeriod) {
     // Every 1s we should tick the BucketManager.
     if (now >= nextBucketManagerTick) {
         BucketManager::instance().tick();
+        FrontEndThread::balanceLoad();
         nextBucketManagerTick = now + 1s;
     }
     mc_gather_timing_samples();
@@ -857,6 +857,8 @@ void initialize_mbcp_lookup_map() {
                            process_bin_dcp_response);
     setup_response_handler(cb::mcbp::ClientOpcode::DcpCacheTransferEnd,
                            process_bin_dcp_response);
+    setup_response_handler(cb::mcbp::ClientOpcode::DcpMutationPatch,
+                           process_bin_dcp_response);
     setup_response_handler(cb::mcbp::ClientOpcode::GetErrorMap,
                            process_bin_dcp_response);
 
@@ -877,6 +879,8 @@ void initialize_mbcp_lookup_map() {
     setup_handler(cb::mcbp::ClientOpcode::DcpGetFailoverLog,
                   dcp_get_failover_log_executor);
     setup_handler(cb::mcbp::ClientOpcode::DcpMutation, dcp_mutation_executor);
+    setup_handler(cb::mcbp::ClientOpcode::DcpMutationPatch,
+                  dcp_mutation_patch_executor);
     setup_handler(cb::mcbp::ClientOpcode::DcpSetVbucketState,
                   dcp_set_vbucket_state_executor);
     setup_handler(cb::mcbp::ClientOpcode::DcpNoop, dcp_noop_executor);
@@ -1046,6 +1050,8 @@ void initialize_mbcp_lookup_map() {
                   range_scan_continue_executor);
     setup_handler(cb::mcbp::ClientOpcode::RangeScanCancel,
                   range_scan_cancel_executor);
+    setup_handler(cb::mcbp::ClientOpcode::RangeScanMulti,
+                  range_scan_multi_executor);
 
     setup_handler(cb::mcbp::ClientOpcode::GetFusionStorageSnapshot,
                   get_fusion_storage_snapshot_executor);
@@ -210,6 +210,7 @@ McbpPrivilegeChains::McbpPrivilegeChains() {
     setup(ClientOpcode::DcpCachedValue, require<Privilege::DcpConsumer>);
     setup(ClientOpcode::DcpCachedKeyMeta, require<Privilege::DcpConsumer>);
     setup(ClientOpcode::DcpCacheTransferEnd, require<Privilege::DcpConsumer>);
+    setup(ClientOpcode::DcpMutationPatch, require<Privilege::DcpConsumer>);
     setup(ClientOpcode::StopPersistence, require<Privilege::Administrator>);
     setup(ClientOpcode::StartPersistence, require<Privilege::Administrator>);
     setup(ClientOpcode::SetParam, require<Privilege::Administrator>);
@@ -286,6 +287,7 @@ McbpPrivilegeChains::McbpPrivilegeChains() {
     setup(ClientOpcode::RangeScanCreate, empty);
     setup(ClientOpcode::RangeScanContinue, empty);
     setup(ClientOpcode::RangeScanCancel, empty);
+    setup(ClientOpcode::RangeScanMulti, empty);
     setup(ClientOpcode::GetFusionStorageSnapshot,
           require<Privilege::NodeSupervisor>);
     setup(ClientOpcode::ReleaseFusionStorageSnapshot,
@@ -923,6 +923,47 @@ static Status dcp_cached_key_meta_validator(Cookie& cookie) {
     return verify_common_dcp_restrictions(cookie);
 }
 
+static Status dcp_mutation_patch_validator(Cookie& cookie) {
+    using cb::mcbp::request::DcpMutationPatchHeader;
+    using cb::mcbp::request::DcpMutationPayload;
+
+    auto status = McbpValidator::verify_header(
+            cookie,
+            sizeof(DcpMutationPayload),
+            ExpectedKeyLen::NonZero,
+            ExpectedValueLen::NonZero,
+            ExpectedCas::Any,
+            GeneratesDocKey::Yes,
+            McbpValidator::AllSupportedDatatypes,
+            // The value is the patch (the datatype is the datatype of the
+            // patched document)
+            false);
+    if (status != Status::Success) {
+        return status;
+    }
+
+    const auto& request = cookie.getRequest();
+    if (cb::mcbp::datatype::is_snappy(request.getDatatype())) {
+        cookie.setErrorContext("DCP Mutation Patch can't be compressed");
+        return Status::Einval;
+    }
+    if (request.getValue().size() < sizeof(DcpMutationPatchHeader)) {
+        cookie.setErrorContext("DCP Mutation Patch value too small");
+        return Status::Einval;
+    }
+    const auto& payload = request.getCommandSpecifics<DcpMutationPayload>();
+    if (payload.getBySeqno() == 0) {
+        cookie.setErrorContext("Invalid seqno(0) for DCP Mutation Patch");
+        return Status::Einval;
+    }
+    if (payload.getNmeta()) {
+        cookie.setErrorContext("DCP does not support extended metadata");
+        return Status::Einval;
+    }
+
+    return verify_common_dcp_restrictions(cookie);
+}
+
 static Status dcp_cache_transfer_end_validator(Cookie& cookie) {
     return McbpValidator::verify_header(cookie,
                                         0,
@@ -3394,6 +3435,7 @@ McbpValidator::McbpValidator() {
     setup(ClientOpcode::DcpCachedValue, dcp_mutation_validator);
     setup(ClientOpcode::DcpCachedKeyMeta, dcp_cached_key_meta_validator);
     setup(ClientOpcode::DcpCacheTransferEnd, dcp_cache_transfer_end_validator);
+    setup(ClientOpcode::DcpMutationPatch, dcp_mutation_patch_validator);
     setup(ClientOpcode::IsaslRefresh, configuration_refresh_validator);
     setup(ClientOpcode::Verbosity, verbosity_validator);
     setup(ClientOpcode::Hello, hello_validator);
@@ -3606,6 +3648,8 @@ McbpValidator::McbpValidator() {
     setup(ClientOpcode::RangeScanCreate, create_range_scan_validator);
     setup(ClientOpcode::RangeScanContinue, continue_range_scan_validator);
     setup(ClientOpcode::RangeScanCancel, cancel_range_scan_validator);
+    // range-scan-multi is encoded as range-scan-create
+    setup(ClientOpcode::RangeScanMulti, create_range_scan_validator);
 
     setup(ClientOpcode::GetFileFragment, get_file_fragment_validator);
     setup(ClientOpcode::PrepareSnapshot, prepare_snapshot_validator);
@@ -32,6 +32,7 @@
 #include "settings.h"
 #include "stats.h"
 #include "stdin_check.h"
+#include "subdocument_worker_pool.h"
 #include "tracing.h"
 #include "utilities/terminate_handler.h"
 #include <cbsasl/mechanism.h>
@@ -154,6 +155,13 @@ static void stats_init() {
     global_statistics.conn_structs.reset();
     global_statistics.total_conns.reset();
     global_statistics.rejected_conns.reset();
+    global_statistics.zerocopy_send_bytes.reset();
+    global_statistics.zerocopy_send_copied_bytes.reset();
+    global_statistics.connections_migrated.reset();
+    global_statistics.busy_poll_spin_time_ns.reset();
+    global_statistics.subdoc_index_cache_hits.reset();
+    global_statistics.subdoc_index_cache_misses.reset();
+    global_statistics.subdoc_index_cache_indexed.reset();
     global_statistics.curr_conns = 0;
     global_statistics.curr_conn_closing = 0;
 }
@@ -181,6 +189,13 @@ void stats_reset(Cookie& cookie) {
     setStatsResetTime();
     global_statistics.total_conns.reset();
     global_statistics.rejected_conns.reset();
+    global_statistics.zerocopy_send_bytes.reset();
+    global_statistics.zerocopy_send_copied_bytes.reset();
+    global_statistics.connections_migrated.reset();
+    global_statistics.busy_poll_spin_time_ns.reset();
+    global_statistics.subdoc_index_cache_hits.reset();
+    global_statistics.subdoc_index_cache_misses.reset();
+    global_statistics.subdoc_index_cache_indexed.reset();
     reset_high_resolution_thread_stats(
             cookie.getConnection().getBucket().high_resolution_stats);
     reset_low_resolution_thread_stats(
@@ -702,6 +717,12 @@ static void startExecutorPool() {
                                updateMagmaThreadPool());
     settings.addChangeListener("magma_flusher_thread_percentage",
                                updateMagmaThreadPool());
+    settings.addChangeListener(
+            "subdoc_offload_threads",
+            [](const std::string&, Settings& s) -> void {
+                SubdocWorkerPool::instance().setNumThreads(
+                        s.getSubdocOffloadThreads());
+            });
 }
 
 static void initialize_serverless_config() {
@@ -1131,6 +1152,9 @@ int memcached_main(int argc, char** argv) {
     LOG_INFO_RAW("Shutting down client worker threads");
     threads_shutdown();
 
+    LOG_INFO_RAW("Shutting down subdoc worker pool");
+    SubdocWorkerPool::instance().shutdown();
+
     LOG_INFO_RAW("Releasing bucket resources");
     BucketManager::instance().shutdown();
 
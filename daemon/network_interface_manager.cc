@@ -9,6 +9,7 @@
 #include "network_interface_manager.h"
 
 #include "connection.h"
+#include "front_end_thread.h"
 #include "listening_port.h"
 #include "log_macros.h"
 #include "memcached.h"
@@ -19,6 +20,7 @@
 #include "stats.h"
 #include "tls_configuration.h"
 
+#include <folly/Portability.h>
 #include <folly/io/async/EventBase.h>
 #include <nlohmann/json.hpp>
 #include <platform/dirutils.h>
@@ -294,6 +296,60 @@ static SOCKET new_server_socket(addrinfo* ai) {
     return sfd;
 }
 
+/**
+ * Create the sockets used by the front end threads to listen to the same
+ * address as the provided (bound) socket, which is used by the first
+ * thread. All of the sockets use SO_REUSEPORT so the kernel distributes
+ * the connections between them.
+ *
+ * @param sfd The bound socket (closed if the method fails)
+ * @param ai The address information used to create the socket
+ * @param errors Where to add a description of any errors
+ * @return the socket for each thread or an empty vector upon failure
+ */
+static std::vector<SOCKET> new_per_thread_server_sockets(
+        SOCKET sfd, addrinfo* ai, nlohmann::json& errors) {
+    std::vector<SOCKET> ret{sfd};
+
+    // Bind to the address the first socket got bound to (the port may be
+    // an ephemeral port)
+    sockaddr_storage addr{};
+    socklen_t addrlen = sizeof(addr);
+    if (getsockname(sfd, reinterpret_cast<sockaddr*>(&addr), &addrlen) ==
+        SOCKET_ERROR) {
+        errors.push_back("Failed to get socket name - " +
+                         cb_strerror(cb::net::get_socket_error()));
+        close_server_socket(sfd);
+        return {};
+    }
+
+    const auto nthreads = Settings::instance().getNumWorkerThreads();
+    while (ret.size() < nthreads) {
+        auto next = new_server_socket(ai);
+        if (next == INVALID_SOCKET) {
+            errors.push_back("Failed to create socket - " +
+                             cb_strerror(cb::net::get_socket_error()));
+            break;
+        }
+        ret.push_back(next);
+        if (bind(next, reinterpret_cast<sockaddr*>(&addr), addrlen) ==
+            SOCKET_ERROR) {
+            errors.push_back("Failed to bind to " +
+                             cb::net::to_string(&addr, addrlen) + " - " +
+                             cb_strerror(cb::net::get_socket_error()));
+            break;
+        }
+    }
+
+    if (ret.size() != nthreads) {
+        for (auto s : ret) {
+            close_server_socket(s);
+        }
+        ret.clear();
+    }
+    return ret;
+}
+
 std::pair<nlohmann::json, nlohmann::json>
 NetworkInterfaceManager::createInterface(
         const NetworkInterfaceDescription& description) {
@@ -332,6 +388,14 @@ NetworkInterfaceManager::createInterface(
     nlohmann::json errors = nlohmann::json::array();
     nlohmann::json ret = nlohmann::json::array();
 
+    // The kernel only balances the connections between the sockets in a
+    // SO_REUSEPORT group on Linux. The bootstrap interfaces are created
+    // before the front end threads are started and always use a single
+    // listener
+    const bool perThread = folly::kIsLinux &&
+                           Settings::instance().isPerThreadListeners() &&
+                           FrontEndThread::isInitialized();
+
     // getaddrinfo may return multiple entries for a given name/port pair.
     // Iterate over all of them and try to set up a listen object.
     // We need at least _one_ entry per requested configuration (IPv4/6) in
@@ -366,7 +430,22 @@ NetworkInterfaceManager::createInterface(
                 next->ai_addr->sa_family,
                 description.isSystem(),
                 description.isTls());
-        listen_conn.emplace_back(ServerSocket::create(sfd, eventBase, inter));
+        if (perThread) {
+            auto sfds = new_per_thread_server_sockets(sfd, next, errors);
+            if (sfds.empty()) {
+                continue;
+            }
+            try {
+                listen_conn.emplace_back(
+                        ServerSocket::createPerThread(std::move(sfds), inter));
+            } catch (const std::exception& e) {
+                errors.push_back(e.what());
+                continue;
+            }
+        } else {
+            listen_conn.emplace_back(
+                    ServerSocket::create(sfd, eventBase, inter));
+        }
         ret.push_back(listen_conn.back()->to_json());
     }
 
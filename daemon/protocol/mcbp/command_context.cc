@@ -0,0 +1,89 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "command_context.h"
+
+#include <array>
+#include <new>
+#include <vector>
+
+/// The free command contexts of a thread (one list per size class)
+struct CommandContextPool {
+    CommandContextPool() {
+        for (auto& list : freelists) {
+            list.reserve(CommandContext::MaxPooledPerSizeClass);
+        }
+    }
+
+    ~CommandContextPool();
+
+    std::array<std::vector<void*>,
+               CommandContext::MaxPooledSize / CommandContext::PoolSizeClass>
+            freelists;
+    uint64_t misses = 0;
+};
+
+static thread_local CommandContextPool commandContextPool;
+/// Set once the pool is destroyed as part of the thread exit (contexts
+/// may still be released after that)
+static thread_local bool commandContextPoolDestroyed = false;
+
+CommandContextPool::~CommandContextPool() {
+    commandContextPoolDestroyed = true;
+    for (auto& list : freelists) {
+        for (auto* ptr : list) {
+            ::operator delete(ptr);
+        }
+    }
+}
+
+static std::size_t getCommandContextSizeClass(std::size_t size) {
+    return (size + CommandContext::PoolSizeClass - 1) /
+                   CommandContext::PoolSizeClass -
+           1;
+}
+
+void* CommandContext::operator new(std::size_t size) {
+    if (size == 0 || size > MaxPooledSize || commandContextPoolDestroyed) {
+        return ::operator new(size);
+    }
+
+    const auto sizeClass = getCommandContextSizeClass(size);
+    auto& list = commandContextPool.freelists[sizeClass];
+    if (!list.empty()) {
+        auto* ret = list.back();
+        list.pop_back();
+        return ret;
+    }
+
+    // Allocate the full size class so that the memory may be reused for
+    // any context in the same size class
+    ++commandContextPool.misses;
+    return ::operator new((sizeClass + 1) * PoolSizeClass);
+}
+
+void CommandContext::operator delete(void* ptr, std::size_t size) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (size != 0 && size <= MaxPooledSize && !commandContextPoolDestroyed) {
+        auto& list =
+                commandContextPool.freelists[getCommandContextSizeClass(size)];
+        if (list.size() < MaxPooledPerSizeClass) {
+            // Never reallocates as the capacity is reserved up front
+            list.push_back(ptr);
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
+
+uint64_t CommandContext::getPoolMisses() {
+    return commandContextPoolDestroyed ? 0 : commandContextPool.misses;
+}
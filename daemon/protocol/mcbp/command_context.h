@@ -12,6 +12,8 @@
 
 #include <memcached/engine_error.h>
 #include <memcached/types.h>
+#include <cstddef>
+#include <cstdint>
 
 /**
  *  A command may need to store command specific context during the duration
@@ -35,4 +37,23 @@ public:
     virtual cb::engine_errc pre_link_document(item_info&) {
         return cb::engine_errc::success;
     }
+
+    /**
+     * A context is allocated for (almost) every command, so the memory is
+     * recycled through a per thread pool with a size class per
+     * PoolSizeClass bytes (up to MaxPooledSize) rather than going
+     * through the allocator for every command. Larger contexts use the
+     * global allocator.
+     */
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size) noexcept;
+
+    /// The number of contexts allocated by the calling thread which
+    /// couldn't be served from the pool
+    static uint64_t getPoolMisses();
+
+    static constexpr std::size_t PoolSizeClass = 64;
+    static constexpr std::size_t MaxPooledSize = 2048;
+    /// The max number of free contexts kept per size class and thread
+    static constexpr std::size_t MaxPooledPerSizeClass = 64;
 };
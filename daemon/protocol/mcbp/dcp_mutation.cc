@@ -54,3 +54,28 @@ void dcp_mutation_executor(Cookie& cookie) {
                   cookie, [](Cookie& c) { return do_dcp_mutation(c); })
             .drive();
 }
+
+static cb::engine_errc do_dcp_mutation_patch(Cookie& cookie) {
+    const auto& req = cookie.getRequest();
+    const auto& extras =
+            req.getCommandSpecifics<cb::mcbp::request::DcpMutationPayload>();
+    return dcpMutationPatch(cookie,
+                            req.getOpaque(),
+                            cookie.getConnection().makeDocKey(req.getKey()),
+                            req.getValue(),
+                            uint8_t(req.getDatatype()),
+                            req.getCas(),
+                            req.getVBucket(),
+                            extras.getFlags(),
+                            extras.getBySeqno(),
+                            extras.getRevSeqno(),
+                            extras.getExpiration(),
+                            extras.getLockTime(),
+                            extras.getNru());
+}
+
+void dcp_mutation_patch_executor(Cookie& cookie) {
+    cookie.obtainContext<NoSuccessResponseCommandContext>(
+                  cookie, [](Cookie& c) { return do_dcp_mutation_patch(c); })
+            .drive();
+}
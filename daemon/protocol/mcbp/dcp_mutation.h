@@ -17,3 +17,9 @@
  * DCP_MUTATION packet.
  */
 void dcp_mutation_executor(Cookie& cookie);
+
+/**
+ * Implementation of the method responsible for handle the incoming
+ * DCP_MUTATION_PATCH packet.
+ */
+void dcp_mutation_patch_executor(Cookie& cookie);
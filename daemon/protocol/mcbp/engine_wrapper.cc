@@ -792,6 +792,46 @@ cb::engine_errc dcpMutation(Cookie& cookie,
     return ret;
 }
 
+cb::engine_errc dcpMutationPatch(Cookie& cookie,
+                                 uint32_t opaque,
+                                 const DocKeyView& key,
+                                 cb::const_byte_buffer patch,
+                                 uint8_t datatype,
+                                 uint64_t cas,
+                                 Vbid vbid,
+                                 uint32_t flags,
+                                 uint64_t bySeqno,
+                                 uint64_t revSeqno,
+                                 uint32_t expiration,
+                                 uint32_t lockTime,
+                                 uint8_t nru) {
+    auto& connection = cookie.getConnection();
+    auto* dcp = connection.getBucket().getDcpIface();
+    auto ret = dcp->mutation_patch(cookie,
+                                   opaque,
+                                   key,
+                                   patch,
+                                   datatype,
+                                   cas,
+                                   vbid,
+                                   flags,
+                                   bySeqno,
+                                   revSeqno,
+                                   expiration,
+                                   lockTime,
+                                   nru);
+    if (ret == cb::engine_errc::success && !connection.isInternal()) {
+        cookie.addDocumentWriteBytes(patch.size() + key.size());
+    } else if (ret == cb::engine_errc::disconnect) {
+        LOG_WARNING_CTX(
+                "dcp.mutation_patch returned cb::engine_errc::disconnect",
+                {"conn_id", connection.getId()},
+                {"description", connection.getDescription()});
+        connection.setTerminationReason("Engine forced disconnect");
+    }
+    return ret;
+}
+
 cb::engine_errc dcpCachedValue(Cookie& cookie,
                                uint32_t opaque,
                                const DocKeyView& key,
@@ -1173,6 +1213,20 @@ cb::engine_errc cancelRangeScan(Cookie& cookie,
     return ret;
 }
 
+cb::engine_errc multiRangeScan(
+        Cookie& cookie, const cb::rangescan::MultiVbucketParameters& params) {
+    auto& c = cookie.getConnection();
+    auto ret = c.getBucketEngine().multiRangeScan(cookie, params);
+
+    if (ret == cb::engine_errc::disconnect) {
+        LOG_WARNING_CTX("multiRangeScan return cb::engine_errc::disconnect",
+                        {"conn_id", c.getId()},
+                        {"description", c.getDescription()});
+        c.setTerminationReason("Engine forced disconnect");
+    }
+    return ret;
+}
+
 cb::engine_errc bucket_set_parameter(Cookie& cookie,
                                      EngineParamCategory category,
                                      std::string_view key,
@@ -360,6 +360,39 @@ cb::engine_errc dcpMutation(Cookie& cookie,
                             uint32_t lockTime,
                             uint8_t nru);
 
+/**
+ * Calls the underlying engine DCP mutation_patch
+ *
+ * @param cookie The cookie representing the connection
+ * @param opaque The opaque field in the received message
+ * @param key The document key
+ * @param patch The patch (DcpMutationPatchHeader followed by the bytes to
+ *              insert)
+ * @param datatype The datatype of the patched document
+ * @param cas The CAS of the patched document
+ * @param vbid The vbucket id
+ * @param flags
+ * @param bySeqno The db sequence number
+ * @param revSeqno The revision sequence number
+ * @param expiration The document expiration
+ * @param lockTime The document lock time
+ * @param nru The document NRU
+ * @return cb::engine_errc
+ */
+cb::engine_errc dcpMutationPatch(Cookie& cookie,
+                                 uint32_t opaque,
+                                 const DocKeyView& key,
+                                 cb::const_byte_buffer patch,
+                                 uint8_t datatype,
+                                 uint64_t cas,
+                                 Vbid vbid,
+                                 uint32_t flags,
+                                 uint64_t bySeqno,
+                                 uint64_t revSeqno,
+                                 uint32_t expiration,
+                                 uint32_t lockTime,
+                                 uint8_t nru);
+
 /**
  * Calls the underlying engine DCP cached_value
  *
@@ -611,6 +644,9 @@ cb::engine_errc cancelRangeScan(Cookie& cookie,
                                 Vbid vbid,
                                 cb::rangescan::Id uuid);
 
+cb::engine_errc multiRangeScan(
+        Cookie& cookie, const cb::rangescan::MultiVbucketParameters& params);
+
 cb::engine_errc bucket_set_parameter(Cookie& cookie,
                                      EngineParamCategory category,
                                      std::string_view key,
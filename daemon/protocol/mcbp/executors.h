@@ -58,6 +58,7 @@ void adjust_timeofday_executor(Cookie&);
 void range_scan_create_executor(Cookie&);
 void range_scan_cancel_executor(Cookie&);
 void range_scan_continue_executor(Cookie&);
+void range_scan_multi_executor(Cookie&);
 
 /**
  * Handle the status for an executor (update ewouldblock state / disconnect
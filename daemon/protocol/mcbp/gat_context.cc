@@ -86,7 +86,7 @@ cb::engine_errc GatCommandContext::sendResponse() {
             {}, // no key
             value,
             datatype,
-            value.size() > SendBuffer::MinimumDataSize
+            connection.shouldChainData(value.size())
                     ? item_dissector->takeSendBuffer(value,
                                                      connection.getBucket())
                     : std::unique_ptr<SendBuffer>{});
@@ -87,7 +87,7 @@ void GetCommandContext::sendResponse() {
             {reinterpret_cast<const char*>(key.data()), keylen},
             value,
             datatype,
-            value.size() > SendBuffer::MinimumDataSize
+            connection.shouldChainData(value.size())
                     ? item_dissector->takeSendBuffer(value,
                                                      connection.getBucket())
                     : std::unique_ptr<SendBuffer>{});
@@ -71,7 +71,7 @@ cb::engine_errc GetLockedCommandContext::sendResponse() {
             {},
             value,
             datatype,
-            value.size() > SendBuffer::MinimumDataSize
+            connection.shouldChainData(value.size())
                     ? item_dissector->takeSendBuffer(value,
                                                      connection.getBucket())
                     : std::unique_ptr<SendBuffer>{});
@@ -102,7 +102,7 @@ void GetExCommandContext::sendResponse() {
     } else {
         std::unique_ptr<SendBuffer> sendbuffer;
         auto value = item->getValueView();
-        if (value.size() > SendBuffer::MinimumDataSize) {
+        if (connection.shouldChainData(value.size())) {
             sendbuffer =
                     std::make_unique<ItemSendBuffer>(std::move(item),
                                                      item->getValueView(),
@@ -134,8 +134,16 @@ cb::engine_errc MutationCommandContext::validateInput() {
     }
 
     // Determine if document is JSON or not. We do not trust what the client
-    // sent - instead we check for ourselves.
-    setDatatypeJSONFromValue(raw_value, datatype);
+    // sent - instead we check for ourselves. A compressed value was
+    // already checked while it was inflated
+    const auto json = cookie.getInflatedInputPayloadIsJson();
+    if (!json.has_value()) {
+        setDatatypeJSONFromValue(raw_value, datatype);
+    } else if (*json) {
+        datatype |= PROTOCOL_BINARY_DATATYPE_JSON;
+    } else {
+        datatype &= ~PROTOCOL_BINARY_DATATYPE_JSON;
+    }
     state = State::AllocateNewItem;
     return cb::engine_errc::success;
 }
@@ -15,15 +15,21 @@
 
 #include <daemon/cookie.h>
 #include <daemon/memcached.h>
+#include <daemon/settings.h>
+#include <daemon/subdocument_validators.h>
 #include <mcbp/protocol/request.h>
 #include <memcached/range_scan.h>
 #include <memcached/range_scan_id.h>
 #include <memcached/range_scan_optional_configuration.h>
+#include <memcached/range_scan_status.h>
 #include <nlohmann/json.hpp>
 #include <platform/base64.h>
 #include <spdlog/fmt/fmt.h>
 #include <utilities/json_utilities.h>
 
+#include <algorithm>
+#include <limits>
+
 static cb::rangescan::KeyOnly getKeyOnly(const nlohmann::json& jsonObject) {
     auto rv = cb::rangescan::KeyOnly::No;
     auto keyOnly = cb::getOptionalJsonObject(
@@ -123,6 +129,61 @@ static cb::rangescan::SnapshotRequirements getSnapshotRequirements(
     return rv;
 }
 
+static std::optional<cb::rangescan::ProjectionConfiguration> getProjection(
+        const nlohmann::json& jsonObject) {
+    auto paths = cb::getOptionalJsonObject(
+            jsonObject, "projection", nlohmann::json::value_t::array);
+    auto filter = cb::getOptionalJsonObject(
+            jsonObject, "filter", nlohmann::json::value_t::object);
+    if (!paths && !filter) {
+        return {};
+    }
+
+    const auto checkPath = [](const std::string& path) {
+        if (path.empty() || path.size() > SUBDOC_PATH_MAX_LENGTH) {
+            throw std::invalid_argument(
+                    fmt::format("invalid projection path size:{}",
+                                path.size()));
+        }
+    };
+
+    cb::rangescan::ProjectionConfiguration rv;
+    if (paths) {
+        if (paths->empty() ||
+            paths->size() > Settings::instance().getSubdocMultiMaxPaths()) {
+            throw std::invalid_argument(
+                    fmt::format("invalid number of projection paths:{}",
+                                paths->size()));
+        }
+        for (const auto& path : *paths) {
+            if (!path.is_string()) {
+                throw std::invalid_argument(
+                        "projection paths must be strings");
+            }
+            auto value = path.get<std::string>();
+            checkPath(value);
+            // A path is only projected once (it's the key of its value in
+            // the projected object)
+            if (std::ranges::find(rv.paths, value) == rv.paths.end()) {
+                rv.paths.emplace_back(std::move(value));
+            }
+        }
+    }
+    if (filter) {
+        auto path = cb::getJsonObject(filter.value(),
+                                      "path",
+                                      nlohmann::json::value_t::string,
+                                      "getProjection");
+        if (!filter->contains("equals")) {
+            throw std::invalid_argument("filter did not include equals");
+        }
+        rv.filter = cb::rangescan::ProjectionConfiguration::Filter{
+                path.get<std::string>(), filter->at("equals").dump()};
+        checkPath(rv.filter->path);
+    }
+    return rv;
+}
+
 static bool isValidKey(const std::string& key) {
     return key.size() <= KEY_MAX_LENGTH;
 }
@@ -162,96 +223,148 @@ static std::pair<std::string, cb::rangescan::KeyType> getRange(
             cb::rangescan::KeyType::Exclusive};
 }
 
-static std::pair<cb::engine_errc, cb::rangescan::Id> createRangeScan(
-        Cookie& cookie) {
-    const auto& req = cookie.getRequest();
-
-    // let it throw
-    nlohmann::json parsed = nlohmann::json::parse(req.getValueString());
-
-    auto range = cb::getOptionalJsonObject(
-            parsed, "range", nlohmann::json::value_t::object);
-    auto samplingConfigJSON = cb::getOptionalJsonObject(
-            parsed, "sampling", nlohmann::json::value_t::object);
-    auto snapshotReqsJSON = cb::getOptionalJsonObject(
-            parsed, "snapshot_requirements", nlohmann::json::value_t::object);
-
-    if (range && samplingConfigJSON) {
-        return {cb::engine_errc::invalid_arguments, {}};
-    }
-
+/// The options of a scan common to range-scan-create and range-scan-multi
+struct ScanOptions {
     // Define the complete range, which may get overridden
     std::string start{"\0", 1};
     std::string end{"\xFF"};
     cb::rangescan::KeyType startType = cb::rangescan::KeyType::Inclusive;
     cb::rangescan::KeyType endType = cb::rangescan::KeyType::Inclusive;
+    cb::rangescan::KeyOnly keyOnly = cb::rangescan::KeyOnly::No;
+    cb::rangescan::IncludeXattrs includeXattrs =
+            cb::rangescan::IncludeXattrs::No;
+    std::optional<cb::rangescan::ProjectionConfiguration> projection;
+    std::string name;
+};
+
+/**
+ * Read the range, name and the document options of the scan from the
+ * request.
+ *
+ * @param cookie The cookie of the request (for the error context)
+ * @param parsed The request value
+ * @param options The options to populate
+ * @return success or the status to fail the request with
+ */
+static cb::engine_errc getScanOptions(Cookie& cookie,
+                                      const nlohmann::json& parsed,
+                                      ScanOptions& options) {
+    auto range = cb::getOptionalJsonObject(
+            parsed, "range", nlohmann::json::value_t::object);
     if (range) {
         try {
-            std::tie(start, startType) =
+            std::tie(options.start, options.startType) =
                     getRange(range.value(), "start", "excl_start");
-            std::tie(end, endType) = getRange(range.value(), "end", "excl_end");
+            std::tie(options.end, options.endType) =
+                    getRange(range.value(), "end", "excl_end");
         } catch (const std::exception& e) {
             cookie.setErrorContext(e.what());
-            return {cb::engine_errc::invalid_arguments, {}};
+            return cb::engine_errc::invalid_arguments;
         }
 
         // And now get the 'raw' key encoding from the base64 encoding
-        start = cb::base64::decode(start);
-        end = cb::base64::decode(end);
+        options.start = cb::base64::decode(options.start);
+        options.end = cb::base64::decode(options.end);
 
-        if (!isValidKey(start) || !isValidKey(end)) {
+        if (!isValidKey(options.start) || !isValidKey(options.end)) {
             cookie.setErrorContext(
                     fmt::format("invalid key size in range start:{}, end:{}",
-                                start.size(),
-                                end.size()));
-            return {cb::engine_errc::invalid_arguments, {}};
+                                options.start.size(),
+                                options.end.size()));
+            return cb::engine_errc::invalid_arguments;
         }
     }
 
-    std::optional<cb::rangescan::SnapshotRequirements> snapshotReqs;
-    if (snapshotReqsJSON) {
-        snapshotReqs = getSnapshotRequirements(snapshotReqsJSON.value());
-    }
-    std::optional<cb::rangescan::SamplingConfiguration> samplingConfig;
-    if (samplingConfigJSON) {
-        samplingConfig = getSamplingConfig(samplingConfigJSON.value());
-    }
-    std::string name;
     auto optionalName = cb::getOptionalJsonObject(
             parsed, "name", nlohmann::json::value_t::string);
     if (optionalName) {
-        name = optionalName->get<std::string>();
+        options.name = optionalName->get<std::string>();
 
         // Keep the name to a reasonable size
-        if (name.size() > cb::rangescan::MaximumNameSize) {
+        if (options.name.size() > cb::rangescan::MaximumNameSize) {
             cookie.setErrorContext("name exceeds 50 bytes");
-            return {cb::engine_errc::invalid_arguments, {}};
+            return cb::engine_errc::invalid_arguments;
         }
     }
 
-    auto keyOnly = getKeyOnly(parsed);
+    options.keyOnly = getKeyOnly(parsed);
     auto [err, includeXattrs] = getIncludeXattrs(cookie, parsed);
     if (err != cb::engine_errc::success) {
-        return {err, {}};
+        return err;
     }
+    options.includeXattrs = includeXattrs;
     if (includeXattrs == cb::rangescan::IncludeXattrs::Yes &&
-        keyOnly == cb::rangescan::KeyOnly::Yes) {
+        options.keyOnly == cb::rangescan::KeyOnly::Yes) {
         cookie.setErrorContext(
                 "cannot set key_only:true and include_xattrs:true");
+        return cb::engine_errc::invalid_arguments;
+    }
+
+    try {
+        options.projection = getProjection(parsed);
+    } catch (const std::exception& e) {
+        cookie.setErrorContext(e.what());
+        return cb::engine_errc::invalid_arguments;
+    }
+    if (options.projection && options.keyOnly == cb::rangescan::KeyOnly::Yes) {
+        cookie.setErrorContext(
+                "cannot set key_only:true and projection or filter");
+        return cb::engine_errc::invalid_arguments;
+    }
+    if (options.projection &&
+        includeXattrs == cb::rangescan::IncludeXattrs::Yes) {
+        cookie.setErrorContext(
+                "cannot set include_xattrs:true and projection or filter");
+        return cb::engine_errc::invalid_arguments;
+    }
+    return cb::engine_errc::success;
+}
+
+static std::pair<cb::engine_errc, cb::rangescan::Id> createRangeScan(
+        Cookie& cookie) {
+    const auto& req = cookie.getRequest();
+
+    // let it throw
+    nlohmann::json parsed = nlohmann::json::parse(req.getValueString());
+
+    auto range = cb::getOptionalJsonObject(
+            parsed, "range", nlohmann::json::value_t::object);
+    auto samplingConfigJSON = cb::getOptionalJsonObject(
+            parsed, "sampling", nlohmann::json::value_t::object);
+    auto snapshotReqsJSON = cb::getOptionalJsonObject(
+            parsed, "snapshot_requirements", nlohmann::json::value_t::object);
+
+    if (range && samplingConfigJSON) {
         return {cb::engine_errc::invalid_arguments, {}};
     }
 
-    return createRangeScan(cookie,
-                           cb::rangescan::CreateParameters{
-                                   req.getVBucket(),
-                                   getCollectionID(parsed),
-                                   cb::rangescan::KeyView{start, startType},
-                                   cb::rangescan::KeyView{end, endType},
-                                   keyOnly,
-                                   includeXattrs,
-                                   snapshotReqs,
-                                   samplingConfig,
-                                   name});
+    ScanOptions options;
+    auto status = getScanOptions(cookie, parsed, options);
+    if (status != cb::engine_errc::success) {
+        return {status, {}};
+    }
+
+    std::optional<cb::rangescan::SnapshotRequirements> snapshotReqs;
+    if (snapshotReqsJSON) {
+        snapshotReqs = getSnapshotRequirements(snapshotReqsJSON.value());
+    }
+    std::optional<cb::rangescan::SamplingConfiguration> samplingConfig;
+    if (samplingConfigJSON) {
+        samplingConfig = getSamplingConfig(samplingConfigJSON.value());
+    }
+
+    cb::rangescan::CreateParameters params{
+            req.getVBucket(),
+            getCollectionID(parsed),
+            cb::rangescan::KeyView{options.start, options.startType},
+            cb::rangescan::KeyView{options.end, options.endType},
+            options.keyOnly,
+            options.includeXattrs,
+            snapshotReqs,
+            samplingConfig,
+            options.name};
+    params.projection = std::move(options.projection);
+    return createRangeScan(cookie, params);
 }
 
 void range_scan_create_executor(Cookie& cookie) {
@@ -277,3 +390,115 @@ void range_scan_create_executor(Cookie& cookie) {
                 nullptr);
     }
 }
+
+/**
+ * Read the vbuckets to scan (when not given, all of the active vbuckets are
+ * scanned) and where the scan of each vbucket resumes
+ */
+static void getMultiVbucketOptions(
+        const nlohmann::json& parsed,
+        cb::rangescan::MultiVbucketParameters& params) {
+    auto vbuckets = cb::getOptionalJsonObject(
+            parsed, "vbuckets", nlohmann::json::value_t::array);
+    if (vbuckets) {
+        for (const auto& vbid : *vbuckets) {
+            if (!vbid.is_number_unsigned() ||
+                vbid.get<uint64_t>() > std::numeric_limits<uint16_t>::max()) {
+                throw std::invalid_argument("invalid vbucket in vbuckets");
+            }
+            params.vbuckets.emplace_back(vbid.get<uint16_t>());
+        }
+    }
+
+    auto resume = cb::getOptionalJsonObject(
+            parsed, "resume", nlohmann::json::value_t::object);
+    if (resume) {
+        for (const auto& [vb, key] : resume->items()) {
+            std::size_t len{0};
+            const auto vbid = std::stoul(vb, &len);
+            if (len != vb.size() ||
+                vbid > std::numeric_limits<uint16_t>::max()) {
+                throw std::invalid_argument("invalid vbucket in resume");
+            }
+            if (!key.is_string()) {
+                throw std::invalid_argument("resume keys must be strings");
+            }
+            auto decoded = cb::base64::decode(key.get<std::string>());
+            if (decoded.empty() || !isValidKey(decoded)) {
+                throw std::invalid_argument(
+                        fmt::format("invalid key size in resume:{}",
+                                    decoded.size()));
+            }
+            params.resume.emplace_back(Vbid(uint16_t(vbid)),
+                                       std::move(decoded));
+        }
+    }
+
+    auto timeLimit = cb::getOptionalJsonObject(
+            parsed, "time_limit_ms", nlohmann::json::value_t::number_unsigned);
+    if (timeLimit) {
+        params.timeLimit =
+                std::chrono::milliseconds(timeLimit->get<uint32_t>());
+    }
+    auto byteLimit = cb::getOptionalJsonObject(
+            parsed, "byte_limit", nlohmann::json::value_t::number_unsigned);
+    if (byteLimit) {
+        params.byteLimit = byteLimit->get<size_t>();
+    }
+}
+
+static cb::engine_errc multiRangeScan(Cookie& cookie,
+                                      cb::engine_errc currentStatus) {
+    const auto& req = cookie.getRequest();
+
+    // let it throw
+    nlohmann::json parsed = nlohmann::json::parse(req.getValueString());
+
+    // The scan is of the current state of each vbucket (and of every key in
+    // the range)
+    if (parsed.contains("sampling") ||
+        parsed.contains("snapshot_requirements")) {
+        cookie.setErrorContext(
+                "sampling and snapshot_requirements are not supported");
+        return cb::engine_errc::invalid_arguments;
+    }
+
+    ScanOptions options;
+    auto status = getScanOptions(cookie, parsed, options);
+    if (status != cb::engine_errc::success) {
+        return status;
+    }
+
+    cb::rangescan::MultiVbucketParameters params{
+            getCollectionID(parsed),
+            cb::rangescan::KeyView{options.start, options.startType},
+            cb::rangescan::KeyView{options.end, options.endType},
+            options.keyOnly,
+            options.includeXattrs,
+            currentStatus};
+    params.projection = std::move(options.projection);
+    params.name = options.name;
+    try {
+        getMultiVbucketOptions(parsed, params);
+    } catch (const std::exception& e) {
+        cookie.setErrorContext(e.what());
+        return cb::engine_errc::invalid_arguments;
+    }
+    return multiRangeScan(cookie, params);
+}
+
+void range_scan_multi_executor(Cookie& cookie) {
+    auto status = cookie.swapAiostat(cb::engine_errc::success);
+    if (status == cb::engine_errc::success) {
+        status = multiRangeScan(cookie, status);
+    }
+
+    switch (cb::rangescan::getContinueHandlingStatus(status)) {
+    case cb::rangescan::HandlingStatus::EngineSends:
+        // The engine has sent the final response (and all of the data)
+        return;
+    case cb::rangescan::HandlingStatus::ExecutorSends:
+        handle_executor_status(cookie, status);
+        break;
+    }
+}
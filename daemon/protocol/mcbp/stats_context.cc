@@ -149,6 +149,14 @@ static cb::engine_errc stat_sched_executor(const StatGroup&,
                          cookie_notification_histogram[ii].to_string(),
                          cookie);
         }
+        FrontEndThread::iterateFairShareQueueDelay(
+                [&cookie](auto ii, auto weightClass, const auto& histogram) {
+                    append_stats(fmt::format("Thread-{}-fair-share-{}",
+                                             ii,
+                                             weightClass),
+                                 histogram.to_string(),
+                                 cookie);
+                });
         return cb::engine_errc::success;
     }
 
@@ -166,6 +174,13 @@ static cb::engine_errc stat_sched_executor(const StatGroup&,
         add("Thread-aggregate-dispatch-socket", dispatch_socket_histogram);
         add("Thread-aggregate-cookie-notification",
             cookie_notification_histogram);
+        for (const auto& [weightClass, histogram] :
+             FrontEndThread::getAggregatedFairShareQueueDelay()) {
+            append_stats(
+                    fmt::format("Thread-aggregate-fair-share-{}", weightClass),
+                    histogram.to_string(),
+                    cookie);
+        }
         return cb::engine_errc::success;
     }
 
@@ -25,9 +25,11 @@
 #include <platform/strerror.h>
 #include <platform/timeutils.h>
 #include <platform/uuid.h>
+#include <atomic>
 #include <exception>
 #include <memory>
 #include <string>
+#include <vector>
 
 std::atomic<uint64_t> ServerSocket::numInstances{0};
 
@@ -118,10 +120,14 @@ public:
      * @param sfd The socket to operate on
      * @param b The event base to use (the caller owns the event base)
      * @param interf The interface object containing properties to use
+     * @param owner The front end thread running the event base which
+     *              should serve the accepted clients (or nullptr to
+     *              dispatch them to the front end threads)
      */
     LibeventServerSocketImpl(SOCKET sfd,
                              folly::EventBase& b,
-                             std::shared_ptr<ListeningPort> interf);
+                             std::shared_ptr<ListeningPort> interf,
+                             FrontEndThread* owner = nullptr);
 
     ~LibeventServerSocketImpl() override;
 
@@ -160,6 +166,10 @@ protected:
 
     std::shared_ptr<ListeningPort> interface;
 
+    /// The front end thread serving the clients accepted on this socket
+    /// (nullptr if they should be dispatched to the front end threads)
+    FrontEndThread* const owner;
+
     /// The sockets name (used for debug)
     const std::string sockname;
 
@@ -198,10 +208,14 @@ void LibeventServerSocketImpl::listen_event_handler(evutil_socket_t,
 }
 
 LibeventServerSocketImpl::LibeventServerSocketImpl(
-        SOCKET fd, folly::EventBase& b, std::shared_ptr<ListeningPort> interf)
+        SOCKET fd,
+        folly::EventBase& b,
+        std::shared_ptr<ListeningPort> interf,
+        FrontEndThread* owner)
     : sfd(fd),
       uuid(to_string(cb::uuid::random())),
       interface(std::move(interf)),
+      owner(owner),
       sockname(cb::net::getsockname(fd)),
       ev(event_new(b.getLibeventBase(),
                    sfd,
@@ -399,12 +413,39 @@ void LibeventServerSocketImpl::acceptNewClient() {
                         {"error", cb_strerror(cb::net::get_socket_error())});
     }
 
+#ifdef SO_BUSY_POLL
+    // Let the kernel busy poll the device queue when we find the socket
+    // empty (requires CAP_NET_ADMIN to raise above the system default;
+    // only log the first failure)
+    const auto busyPoll = Settings::instance().getBusyPollTime().count();
+    if (busyPoll != 0 &&
+        !cb::net::setSocketOption<uint32_t>(
+                client,
+                SOL_SOCKET,
+                SO_BUSY_POLL,
+                gsl::narrow_cast<uint32_t>(busyPoll))) {
+        static std::atomic_bool logged{false};
+        if (!logged.exchange(true)) {
+            LOG_WARNING_CTX(
+                    "Failed to set SO_BUSY_POLL",
+                    {"socket", static_cast<uint64_t>(client)},
+                    {"to", busyPoll},
+                    {"error", cb_strerror(cb::net::get_socket_error())});
+        }
+    }
+#endif
+
     if (interface->system) {
         system_accept_handler.onAcceptSuccess(current, limit);
     } else {
         user_system_accept_handler.onAcceptSuccess(current, limit);
     }
-    FrontEndThread::dispatch(client, interface);
+    if (owner) {
+        // We're running in the context of the thread serving the client
+        owner->do_dispatch(client, interface);
+    } else {
+        FrontEndThread::dispatch(client, interface);
+    }
 }
 
 void LibeventServerSocketImpl::setTcpKeepalive(SOCKET client) {
@@ -465,13 +506,113 @@ nlohmann::json LibeventServerSocketImpl::to_json() const {
     ret["tag"] = interface->tag;
     ret["type"] = "mcbp";
     ret["uuid"] = uuid;
+    ret["listeners"] = 1;
 
     return ret;
 }
 
+/**
+ * The PerThreadServerSocketImpl represents an interface where each of the
+ * front end threads owns a LibeventServerSocketImpl bound to the address
+ * of the interface (with SO_REUSEPORT), and serves the clients it accepts
+ * itself. The listeners are created and destroyed in the context of the
+ * thread owning them as they're registered in its event base.
+ */
+class PerThreadServerSocketImpl : public ServerSocket {
+public:
+    PerThreadServerSocketImpl(std::vector<SOCKET> sfds,
+                              std::shared_ptr<ListeningPort> interf);
+
+    ~PerThreadServerSocketImpl() override;
+
+    const ListeningPort& getInterfaceDescription() const override {
+        return *interface;
+    }
+
+    nlohmann::json to_json() const override {
+        auto ret = listeners.front()->to_json();
+        ret["uuid"] = uuid;
+        ret["listeners"] = listeners.size();
+        return ret;
+    }
+
+    const std::string& getUuid() const override {
+        return uuid;
+    }
+
+protected:
+    /// Destroy the listeners in the context of the threads owning them
+    void releaseListeners();
+
+    /// The unique id used to identify _this_ port
+    const std::string uuid;
+
+    std::shared_ptr<ListeningPort> interface;
+
+    /// The listener owned by each of the front end threads (indexed by
+    /// the thread index)
+    std::vector<std::unique_ptr<LibeventServerSocketImpl>> listeners;
+};
+
+PerThreadServerSocketImpl::PerThreadServerSocketImpl(
+        std::vector<SOCKET> sfds, std::shared_ptr<ListeningPort> interf)
+    : uuid(to_string(cb::uuid::random())), interface(std::move(interf)) {
+    if (sfds.size() != Settings::instance().getNumWorkerThreads()) {
+        throw std::invalid_argument(
+                "PerThreadServerSocketImpl: A socket must be provided for "
+                "each front end thread");
+    }
+    listeners.resize(sfds.size());
+    FrontEndThread::forEach(
+            [this, &sfds](auto& thread) {
+                try {
+                    listeners[thread.index] =
+                            std::make_unique<LibeventServerSocketImpl>(
+                                    sfds[thread.index],
+                                    thread.eventBase,
+                                    interface,
+                                    &thread);
+                } catch (const std::exception& e) {
+                    LOG_WARNING_CTX("Failed to create listener",
+                                    {"worker_tid", thread.index},
+                                    {"error", e.what()});
+                }
+            },
+            true);
+
+    bool failed = false;
+    for (std::size_t ii = 0; ii < listeners.size(); ++ii) {
+        if (!listeners[ii]) {
+            close_server_socket(sfds[ii]);
+            failed = true;
+        }
+    }
+    if (failed) {
+        releaseListeners();
+        throw std::runtime_error(
+                "PerThreadServerSocketImpl: Failed to create the listener "
+                "for all front end threads");
+    }
+}
+
+PerThreadServerSocketImpl::~PerThreadServerSocketImpl() {
+    releaseListeners();
+}
+
+void PerThreadServerSocketImpl::releaseListeners() {
+    FrontEndThread::forEach(
+            [this](auto& thread) { listeners[thread.index].reset(); }, true);
+}
+
 std::unique_ptr<ServerSocket> ServerSocket::create(
         SOCKET sfd,
         folly::EventBase& b,
         std::shared_ptr<ListeningPort> interf) {
     return std::make_unique<LibeventServerSocketImpl>(sfd, b, interf);
 }
+
+std::unique_ptr<ServerSocket> ServerSocket::createPerThread(
+        std::vector<SOCKET> sfds, std::shared_ptr<ListeningPort> interf) {
+    return std::make_unique<PerThreadServerSocketImpl>(std::move(sfds),
+                                                       std::move(interf));
+}
@@ -13,6 +13,7 @@
 #include <platform/socket.h>
 #include <atomic>
 #include <memory>
+#include <vector>
 
 namespace folly {
 class EventBase;
@@ -39,6 +40,23 @@ public:
             folly::EventBase& b,
             std::shared_ptr<ListeningPort> interf);
 
+    /**
+     * Create a new instance where each of the front end threads accept
+     * clients on its own socket (all bound to the same address with
+     * SO_REUSEPORT so that the kernel distributes the connections between
+     * them) and serve them without dispatching them to another thread.
+     *
+     * The front end threads must be running, and the sockets are
+     * registered in (and removed from) the threads event base before
+     * the method (and the destructor) returns.
+     *
+     * @param sfds The socket to use for each of the front end threads
+     *             (indexed by the thread index)
+     * @param interf The interface object containing properties to use
+     */
+    static std::unique_ptr<ServerSocket> createPerThread(
+            std::vector<SOCKET> sfds, std::shared_ptr<ListeningPort> interf);
+
     virtual ~ServerSocket() = default;
 
     virtual const ListeningPort& getInterfaceDescription() const = 0;
@@ -12,6 +12,7 @@
 
 #include "environment.h"
 #include "log_macros.h"
+#include "sendbuffer.h"
 #include "ssl_utils.h"
 #include <fmt/chrono.h>
 #include <mcbp/mcbp.h>
@@ -42,6 +43,17 @@ Settings& Settings::instance() {
     return settings;
 }
 
+std::string format_as(ConnectionBackend backend) {
+    switch (backend) {
+    case ConnectionBackend::Libevent:
+        return "libevent";
+    case ConnectionBackend::IoUring:
+        return "io_uring";
+    }
+    throw std::invalid_argument("Invalid connection backend: " +
+                                std::to_string(int(backend)));
+}
+
 std::string storageThreadConfig2String(int val) {
     if (val == 0) {
         return "default";
@@ -158,6 +170,43 @@ void Settings::reconfigure(const nlohmann::json& json) {
             if (value.get<std::string>() == "serverless") {
                 setDeploymentModel(DeploymentModel::Serverless);
             }
+        } else if (key == "connection_backend"sv) {
+            const auto backend = value.get<std::string>();
+            if (backend == "libevent") {
+                setConnectionBackend(ConnectionBackend::Libevent);
+            } else if (backend == "io_uring") {
+                setConnectionBackend(ConnectionBackend::IoUring);
+            } else {
+                throw std::invalid_argument(fmt::format(
+                        "\"connection_backend\" must be \"libevent\" or "
+                        "\"io_uring\": {}",
+                        backend));
+            }
+        } else if (key == "zerocopy_send_threshold"sv) {
+            const auto threshold = value.get<size_t>();
+            if (threshold != 0 && threshold <= SendBuffer::MinimumDataSize) {
+                throw std::invalid_argument(fmt::format(
+                        "\"zerocopy_send_threshold\" must be 0 (disabled) "
+                        "or above {}",
+                        SendBuffer::MinimumDataSize));
+            }
+            setZerocopySendThreshold(threshold);
+        } else if (key == "tls_kernel_offload"sv) {
+            setTlsKernelOffload(value.get<bool>());
+        } else if (key == "connection_load_balancing"sv) {
+            setConnectionLoadBalancing(value.get<bool>());
+        } else if (key == "per_thread_listeners"sv) {
+            setPerThreadListeners(value.get<bool>());
+        } else if (key == "fair_share_scheduling"sv) {
+            setFairShareScheduling(value.get<bool>());
+        } else if (key == "fair_share_weights"sv) {
+            setFairShareWeights(value.get<FairShareWeights>());
+        } else if (key == "busy_poll_time"sv) {
+            setBusyPollTime(std::chrono::microseconds(value.get<uint32_t>()));
+        } else if (key == "subdoc_index_cache_size"sv) {
+            setSubdocIndexCacheSize(value.get<size_t>());
+        } else if (key == "subdoc_index_cache_index_bytes"sv) {
+            setSubdocIndexCacheIndexBytes(value.get<size_t>());
         } else if (key == "error_maps_dir"sv) {
             setErrorMapsDir(value.get<std::string>());
         } else if (key == "enable_deprecated_bucket_autoselect"sv) {
@@ -498,6 +547,8 @@ void Settings::reconfigure(const nlohmann::json& json) {
             setSubdocOffloadSizeThreshold(value.get<size_t>());
         } else if (key == "subdoc_offload_paths_threshold"sv) {
             setSubdocOffloadPathThreshold(value.get<size_t>());
+        } else if (key == "subdoc_offload_threads"sv) {
+            setSubdocOffloadThreads(value.get<size_t>());
         } else if (key == "abrupt_shutdown_timeout"sv) {
             setAbruptShutdownTimeout(
                     std::chrono::milliseconds(value.get<size_t>()));
@@ -837,6 +888,96 @@ void Settings::updateSettings(const Settings& other, bool apply) {
         }
     }
 
+    if (other.has.connection_backend) {
+        if (other.connection_backend != connection_backend) {
+            LOG_INFO_CTX("Change connection backend",
+                         {"from", format_as(connection_backend.load())},
+                         {"to", format_as(other.connection_backend.load())});
+            setConnectionBackend(other.connection_backend.load());
+        }
+    }
+
+    if (other.has.zerocopy_send_threshold) {
+        if (other.zerocopy_send_threshold != zerocopy_send_threshold) {
+            LOG_INFO_CTX("Change zero copy send threshold",
+                         {"from", zerocopy_send_threshold.load()},
+                         {"to", other.zerocopy_send_threshold.load()});
+            setZerocopySendThreshold(other.zerocopy_send_threshold.load());
+        }
+    }
+
+    if (other.has.tls_kernel_offload) {
+        if (other.tls_kernel_offload != tls_kernel_offload) {
+            LOG_INFO_CTX("Change TLS kernel offload",
+                         {"enabled", other.tls_kernel_offload.load()});
+            setTlsKernelOffload(other.tls_kernel_offload.load());
+        }
+    }
+
+    if (other.has.connection_load_balancing) {
+        if (other.connection_load_balancing != connection_load_balancing) {
+            LOG_INFO_CTX("Change connection load balancing",
+                         {"enabled", other.connection_load_balancing.load()});
+            setConnectionLoadBalancing(
+                    other.connection_load_balancing.load());
+        }
+    }
+
+    if (other.has.per_thread_listeners) {
+        if (other.per_thread_listeners != per_thread_listeners) {
+            LOG_INFO_CTX("Change per thread listeners",
+                         {"enabled", other.per_thread_listeners.load()});
+            setPerThreadListeners(other.per_thread_listeners.load());
+        }
+    }
+
+    if (other.has.fair_share_scheduling) {
+        if (other.fair_share_scheduling != fair_share_scheduling) {
+            LOG_INFO_CTX("Change fair share scheduling",
+                         {"enabled", other.fair_share_scheduling.load()});
+            setFairShareScheduling(other.fair_share_scheduling.load());
+        }
+    }
+
+    if (other.has.fair_share_weights) {
+        auto weights = other.getFairShareWeights();
+        if (weights != getFairShareWeights()) {
+            LOG_INFO_CTX("Change fair share weights",
+                         {"from", getFairShareWeights()},
+                         {"to", weights});
+            setFairShareWeights(std::move(weights));
+        }
+    }
+
+    if (other.has.busy_poll_time) {
+        if (other.getBusyPollTime() != getBusyPollTime()) {
+            LOG_INFO_CTX("Change busy poll time",
+                         {"from", getBusyPollTime()},
+                         {"to", other.getBusyPollTime()});
+            setBusyPollTime(other.getBusyPollTime());
+        }
+    }
+
+    if (other.has.subdoc_index_cache_size) {
+        if (other.getSubdocIndexCacheSize() != getSubdocIndexCacheSize()) {
+            LOG_INFO_CTX("Change subdoc index cache size",
+                         {"from", getSubdocIndexCacheSize()},
+                         {"to", other.getSubdocIndexCacheSize()});
+            setSubdocIndexCacheSize(other.getSubdocIndexCacheSize());
+        }
+    }
+
+    if (other.has.subdoc_index_cache_index_bytes) {
+        if (other.getSubdocIndexCacheIndexBytes() !=
+            getSubdocIndexCacheIndexBytes()) {
+            LOG_INFO_CTX("Change subdoc index cache index bytes",
+                         {"from", getSubdocIndexCacheIndexBytes()},
+                         {"to", other.getSubdocIndexCacheIndexBytes()});
+            setSubdocIndexCacheIndexBytes(
+                    other.getSubdocIndexCacheIndexBytes());
+        }
+    }
+
     if (other.has.dedupe_nmvb_maps) {
         if (other.dedupe_nmvb_maps != dedupe_nmvb_maps) {
             LOG_INFO_CTX("Change deduplication of NMVB maps",
@@ -1372,6 +1513,15 @@ void Settings::updateSettings(const Settings& other, bool apply) {
         }
     }
 
+    if (other.has.subdoc_offload_threads) {
+        if (other.getSubdocOffloadThreads() != getSubdocOffloadThreads()) {
+            LOG_INFO_CTX("Change number of subdoc offload threads",
+                         {"from", getSubdocOffloadThreads()},
+                         {"to", other.getSubdocOffloadThreads()});
+            setSubdocOffloadThreads(other.getSubdocOffloadThreads());
+        }
+    }
+
     if (other.has.file_fragment_max_chunk_size) {
         if (other.getFileFragmentMaxChunkSize() !=
             getFileFragmentMaxChunkSize()) {
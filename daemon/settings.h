@@ -11,6 +11,7 @@
 #pragma once
 
 #include "client_cert_config.h"
+#include "fair_share.h"
 #include "logger/logger_config.h"
 #include "network_interface.h"
 
@@ -45,6 +46,18 @@ enum class DeploymentModel {
     Serverless
 };
 
+/// The implementations available for performing network IO on the
+/// (non-TLS) client connections
+enum class ConnectionBackend {
+    /// Use libevent bufferevents
+    Libevent,
+    /// Use io_uring (Linux only). Falls back to libevent if io_uring
+    /// isn't available
+    IoUring
+};
+
+std::string format_as(ConnectionBackend backend);
+
 /**
  * Globally accessible settings as derived from the commandline / JSON config
  * file.
@@ -1008,6 +1021,131 @@ public:
         return deployment_model;
     }
 
+    /// Get the backend to use for network IO on new connections
+    ConnectionBackend getConnectionBackend() const {
+        return connection_backend.load(std::memory_order_acquire);
+    }
+
+    void setConnectionBackend(ConnectionBackend val) {
+        connection_backend.store(val, std::memory_order_release);
+        has.connection_backend = true;
+        notify_changed("connection_backend");
+    }
+
+    /// Get the minimum size of a document value to send with zero copy
+    /// (0 = disabled)
+    size_t getZerocopySendThreshold() const {
+        return zerocopy_send_threshold.load(std::memory_order_acquire);
+    }
+
+    void setZerocopySendThreshold(size_t val) {
+        zerocopy_send_threshold.store(val, std::memory_order_release);
+        has.zerocopy_send_threshold = true;
+        notify_changed("zerocopy_send_threshold");
+    }
+
+    /// Should new TLS connections try to use kernel TLS once the
+    /// handshake completes
+    bool isTlsKernelOffload() const {
+        return tls_kernel_offload.load(std::memory_order_acquire);
+    }
+
+    void setTlsKernelOffload(bool val) {
+        tls_kernel_offload.store(val, std::memory_order_release);
+        has.tls_kernel_offload = true;
+        notify_changed("tls_kernel_offload");
+    }
+
+    /// Should new connections be placed on lightly loaded front end
+    /// threads (and busy connections be moved off overloaded threads)
+    bool isConnectionLoadBalancing() const {
+        return connection_load_balancing.load(std::memory_order_acquire);
+    }
+
+    void setConnectionLoadBalancing(bool val) {
+        connection_load_balancing.store(val, std::memory_order_release);
+        has.connection_load_balancing = true;
+        notify_changed("connection_load_balancing");
+    }
+
+    /// Should each front end thread accept the connections it serves on
+    /// its own SO_REUSEPORT socket (used for interfaces created after
+    /// the value is changed)
+    bool isPerThreadListeners() const {
+        return per_thread_listeners.load(std::memory_order_acquire);
+    }
+
+    void setPerThreadListeners(bool val) {
+        per_thread_listeners.store(val, std::memory_order_release);
+        has.per_thread_listeners = true;
+        notify_changed("per_thread_listeners");
+    }
+
+    /// Should connections yielding with more work to do be resumed in
+    /// weighted fair share order (see FairShareScheduler)
+    bool isFairShareScheduling() const {
+        return fair_share_scheduling.load(std::memory_order_acquire);
+    }
+
+    void setFairShareScheduling(bool val) {
+        fair_share_scheduling.store(val, std::memory_order_release);
+        has.fair_share_scheduling = true;
+        notify_changed("fair_share_scheduling");
+    }
+
+    FairShareWeights getFairShareWeights() const {
+        return *fair_share_weights.rlock();
+    }
+
+    /// Get the fair share weight (and weight class) for a connection
+    /// with the provided bucket and user
+    std::pair<uint32_t, std::string> getFairShareWeight(
+            std::string_view bucket, std::string_view user) const {
+        return fair_share_weights.rlock()->lookup(bucket, user);
+    }
+
+    void setFairShareWeights(FairShareWeights weights) {
+        *fair_share_weights.wlock() = std::move(weights);
+        has.fair_share_weights = true;
+        notify_changed("fair_share_weights");
+    }
+
+    /// The time a front end thread spins polling for events before it
+    /// blocks waiting for events (0 = never spin)
+    std::chrono::microseconds getBusyPollTime() const {
+        return busy_poll_time.load(std::memory_order_acquire);
+    }
+
+    void setBusyPollTime(std::chrono::microseconds val) {
+        busy_poll_time.store(val, std::memory_order_release);
+        has.busy_poll_time = true;
+        notify_changed("busy_poll_time");
+    }
+
+    /// The max number of documents per bucket to keep the location of the
+    /// looked up paths for (see SubdocIndexCache; 0 = disabled)
+    size_t getSubdocIndexCacheSize() const {
+        return subdoc_index_cache_size.load(std::memory_order_acquire);
+    }
+
+    void setSubdocIndexCacheSize(size_t val) {
+        subdoc_index_cache_size.store(val, std::memory_order_release);
+        has.subdoc_index_cache_size = true;
+        notify_changed("subdoc_index_cache_size");
+    }
+
+    /// The max number of bytes per bucket used by the structural indexes
+    /// of the hot documents in the subdoc index cache
+    size_t getSubdocIndexCacheIndexBytes() const {
+        return subdoc_index_cache_index_bytes.load(std::memory_order_acquire);
+    }
+
+    void setSubdocIndexCacheIndexBytes(size_t val) {
+        subdoc_index_cache_index_bytes.store(val, std::memory_order_release);
+        has.subdoc_index_cache_index_bytes = true;
+        notify_changed("subdoc_index_cache_index_bytes");
+    }
+
     bool isDeprecatedBucketAutoselectEnabled() {
         return enable_deprecated_bucket_autoselect.load(
                 std::memory_order_acquire);
@@ -1104,6 +1242,14 @@ public:
         has.subdoc_offload_paths_threshold = true;
         notify_changed("subdoc_offload_paths_threshold");
     }
+    size_t getSubdocOffloadThreads() const {
+        return subdoc_offload_threads.load(std::memory_order_acquire);
+    }
+    void setSubdocOffloadThreads(size_t val) {
+        subdoc_offload_threads.store(val, std::memory_order_release);
+        has.subdoc_offload_threads = true;
+        notify_changed("subdoc_offload_threads");
+    }
 
     void setAbruptShutdownTimeout(std::chrono::milliseconds val) {
         abrupt_shutdown_timeout.store(val, std::memory_order_release);
@@ -1620,6 +1766,46 @@ protected:
     }
     std::atomic<DeploymentModel> deployment_model{DeploymentModel::Normal};
 
+    /// The backend used for network IO on new connections (existing
+    /// connections keep the backend they were created with)
+    std::atomic<ConnectionBackend> connection_backend{
+            ConnectionBackend::Libevent};
+
+    /// Document values of at least this size are sent with zero copy by
+    /// connections using the io_uring backend (0 = disabled)
+    std::atomic<size_t> zerocopy_send_threshold{0};
+
+    /// Let OpenSSL hand the record encryption over to the kernel (kTLS)
+    /// for new TLS connections when the negotiated cipher allows
+    std::atomic_bool tls_kernel_offload{false};
+
+    /// Balance the connections across the front end threads by their CPU
+    /// usage rather than their number
+    std::atomic_bool connection_load_balancing{false};
+
+    /// Let the kernel distribute new connections to a listening socket
+    /// owned by each front end thread rather than dispatching them from
+    /// the network interface manager thread
+    std::atomic_bool per_thread_listeners{false};
+
+    /// Resume the connections which yielded in weighted fair share order
+    std::atomic_bool fair_share_scheduling{false};
+
+    /// The weights used by the fair share scheduler
+    folly::Synchronized<FairShareWeights> fair_share_weights;
+
+    /// The time a front end thread spins polling for events (after it
+    /// last did any work) before it blocks waiting for events
+    std::atomic<std::chrono::microseconds> busy_poll_time{
+            std::chrono::microseconds::zero()};
+
+    /// The max number of documents per bucket in the subdoc index cache
+    std::atomic<size_t> subdoc_index_cache_size{0};
+
+    /// The max number of bytes per bucket used by the structural indexes in
+    /// the subdoc index cache
+    std::atomic<size_t> subdoc_index_cache_index_bytes{64_MiB};
+
     std::atomic_bool enable_deprecated_bucket_autoselect{false};
 
     /// The number of concurrent paging visitors to use for quota sharing,
@@ -1663,6 +1849,10 @@ protected:
     /// to the threadpool for execution
     std::atomic_size_t subdoc_offload_paths_threshold{16};
 
+    /// The number of threads in the pool running the offloaded sub-document
+    /// operations
+    std::atomic_size_t subdoc_offload_threads{4};
+
     /// The maximum size of a chunk when reading file fragments
     std::atomic<size_t> file_fragment_max_chunk_size{20_MiB};
 
@@ -1734,6 +1924,16 @@ public:
         bool default_reqs_per_event = false;
         bool command_time_slice = false;
         bool deployment_model = false;
+        bool connection_backend = false;
+        bool tls_kernel_offload = false;
+        bool connection_load_balancing = false;
+        bool per_thread_listeners = false;
+        bool fair_share_scheduling = false;
+        bool fair_share_weights = false;
+        bool busy_poll_time = false;
+        bool subdoc_index_cache_size = false;
+        bool subdoc_index_cache_index_bytes = false;
+        bool zerocopy_send_threshold = false;
         bool enable_deprecated_bucket_autoselect = false;
         bool verbose = false;
         bool connection_idle_time = false;
@@ -1797,6 +1997,7 @@ public:
         bool subdoc_multi_max_paths = false;
         bool subdoc_offload_size_threshold = false;
         bool subdoc_offload_paths_threshold = false;
+        bool subdoc_offload_threads = false;
         bool clustermap_push_notifications_enabled = false;
         bool file_fragment_max_chunk_size = false;
         bool file_fragment_max_read_size = false;
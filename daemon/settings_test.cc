@@ -1302,6 +1302,303 @@ TEST(SettingsUpdateTest, OpcodeAttributesMustBeValidFormat) {
     EXPECT_EQ("", settings.getOpcodeAttributesOverride());
 }
 
+TEST_F(SettingsTest, FairShareWeights) {
+    nonObjectValuesShouldFail("fair_share_weights");
+
+    nlohmann::json json;
+    json["fair_share_weights"] = {{"buckets", {{"analytics", 25}}},
+                                  {"users", {{"@cbq-engine", 200}}}};
+    Settings settings(json);
+    EXPECT_TRUE(settings.has.fair_share_weights);
+
+    using Weight = std::pair<uint32_t, std::string>;
+    EXPECT_EQ(Weight(200, "user:@cbq-engine"),
+              settings.getFairShareWeight("analytics", "@cbq-engine"));
+    EXPECT_EQ(Weight(25, "bucket:analytics"),
+              settings.getFairShareWeight("analytics", "joe"));
+    EXPECT_EQ(Weight(FairShareWeights::DefaultWeight, "default"),
+              settings.getFairShareWeight("default", "joe"));
+
+    // The weights must be in the range [1, MaxWeight]
+    json["fair_share_weights"] = {{"buckets", {{"analytics", 0}}}};
+    expectFail<std::invalid_argument>(json);
+    json["fair_share_weights"] = {
+            {"users", {{"joe", FairShareWeights::MaxWeight + 1}}}};
+    expectFail<std::invalid_argument>(json);
+    json["fair_share_weights"] = {{"groups", nlohmann::json::object()}};
+    expectFail<std::invalid_argument>(json);
+}
+
+TEST(SettingsUpdateTest, FairShareWeightsIsDynamic) {
+    Settings settings;
+    Settings updated;
+    FairShareWeights weights;
+    weights.buckets["analytics"] = 25;
+    updated.setFairShareWeights(weights);
+    updated.setFairShareScheduling(true);
+
+    // Dry-run
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_FALSE(settings.isFairShareScheduling());
+    EXPECT_NE(weights, settings.getFairShareWeights());
+
+    EXPECT_NO_THROW(settings.updateSettings(updated, true));
+    EXPECT_TRUE(settings.isFairShareScheduling());
+    EXPECT_EQ(weights, settings.getFairShareWeights());
+}
+
+TEST_F(SettingsTest, ConnectionBackend) {
+    nonStringValuesShouldFail("connection_backend");
+
+    Settings defaults;
+    EXPECT_EQ(ConnectionBackend::Libevent, defaults.getConnectionBackend());
+    EXPECT_FALSE(defaults.has.connection_backend);
+
+    nlohmann::json json;
+    json["connection_backend"] = "io_uring";
+    Settings settings(json);
+    EXPECT_EQ(ConnectionBackend::IoUring, settings.getConnectionBackend());
+    EXPECT_TRUE(settings.has.connection_backend);
+
+    json["connection_backend"] = "libevent";
+    settings.reconfigure(json);
+    EXPECT_EQ(ConnectionBackend::Libevent, settings.getConnectionBackend());
+
+    json["connection_backend"] = "epoll";
+    expectFail<std::invalid_argument>(json);
+
+    EXPECT_EQ("libevent", format_as(ConnectionBackend::Libevent));
+    EXPECT_EQ("io_uring", format_as(ConnectionBackend::IoUring));
+}
+
+TEST(SettingsUpdateTest, ConnectionBackendIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setConnectionBackend(settings.getConnectionBackend());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setConnectionBackend(ConnectionBackend::IoUring);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(ConnectionBackend::Libevent, settings.getConnectionBackend());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(ConnectionBackend::IoUring, settings.getConnectionBackend());
+}
+
+TEST_F(SettingsTest, ConnectionLoadBalancing) {
+    nonBooleanValuesShouldFail("connection_load_balancing");
+
+    Settings defaults;
+    EXPECT_FALSE(defaults.isConnectionLoadBalancing());
+    EXPECT_FALSE(defaults.has.connection_load_balancing);
+
+    nlohmann::json json;
+    json["connection_load_balancing"] = true;
+    Settings settings(json);
+    EXPECT_TRUE(settings.isConnectionLoadBalancing());
+    EXPECT_TRUE(settings.has.connection_load_balancing);
+}
+
+TEST(SettingsUpdateTest, ConnectionLoadBalancingIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setConnectionLoadBalancing(settings.isConnectionLoadBalancing());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setConnectionLoadBalancing(true);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_FALSE(settings.isConnectionLoadBalancing());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_TRUE(settings.isConnectionLoadBalancing());
+}
+
+TEST_F(SettingsTest, TlsKernelOffload) {
+    nonBooleanValuesShouldFail("tls_kernel_offload");
+
+    Settings defaults;
+    EXPECT_FALSE(defaults.isTlsKernelOffload());
+    EXPECT_FALSE(defaults.has.tls_kernel_offload);
+
+    nlohmann::json json;
+    json["tls_kernel_offload"] = true;
+    Settings settings(json);
+    EXPECT_TRUE(settings.isTlsKernelOffload());
+    EXPECT_TRUE(settings.has.tls_kernel_offload);
+}
+
+TEST(SettingsUpdateTest, TlsKernelOffloadIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setTlsKernelOffload(settings.isTlsKernelOffload());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setTlsKernelOffload(true);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_FALSE(settings.isTlsKernelOffload());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_TRUE(settings.isTlsKernelOffload());
+}
+
+TEST_F(SettingsTest, PerThreadListeners) {
+    nonBooleanValuesShouldFail("per_thread_listeners");
+
+    Settings defaults;
+    EXPECT_FALSE(defaults.isPerThreadListeners());
+    EXPECT_FALSE(defaults.has.per_thread_listeners);
+
+    nlohmann::json json;
+    json["per_thread_listeners"] = true;
+    Settings settings(json);
+    EXPECT_TRUE(settings.isPerThreadListeners());
+    EXPECT_TRUE(settings.has.per_thread_listeners);
+}
+
+TEST(SettingsUpdateTest, PerThreadListenersIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setPerThreadListeners(settings.isPerThreadListeners());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setPerThreadListeners(true);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_FALSE(settings.isPerThreadListeners());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_TRUE(settings.isPerThreadListeners());
+}
+
+TEST_F(SettingsTest, BusyPollTime) {
+    nonNumericValuesShouldFail("busy_poll_time");
+
+    Settings defaults;
+    EXPECT_EQ(std::chrono::microseconds{0}, defaults.getBusyPollTime());
+    EXPECT_FALSE(defaults.has.busy_poll_time);
+
+    nlohmann::json json;
+    json["busy_poll_time"] = 50;
+    Settings settings(json);
+    EXPECT_EQ(std::chrono::microseconds{50}, settings.getBusyPollTime());
+    EXPECT_TRUE(settings.has.busy_poll_time);
+}
+
+TEST(SettingsUpdateTest, BusyPollTimeIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setBusyPollTime(settings.getBusyPollTime());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setBusyPollTime(std::chrono::microseconds{50});
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(std::chrono::microseconds{0}, settings.getBusyPollTime());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(std::chrono::microseconds{50}, settings.getBusyPollTime());
+}
+
+TEST_F(SettingsTest, SubdocIndexCacheSize) {
+    nonNumericValuesShouldFail("subdoc_index_cache_size");
+
+    Settings defaults;
+    EXPECT_EQ(0, defaults.getSubdocIndexCacheSize());
+    EXPECT_FALSE(defaults.has.subdoc_index_cache_size);
+
+    nlohmann::json json;
+    json["subdoc_index_cache_size"] = 1000;
+    Settings settings(json);
+    EXPECT_EQ(1000, settings.getSubdocIndexCacheSize());
+    EXPECT_TRUE(settings.has.subdoc_index_cache_size);
+}
+
+TEST(SettingsUpdateTest, SubdocIndexCacheSizeIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setSubdocIndexCacheSize(settings.getSubdocIndexCacheSize());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setSubdocIndexCacheSize(1000);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(0, settings.getSubdocIndexCacheSize());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(1000, settings.getSubdocIndexCacheSize());
+}
+
+TEST_F(SettingsTest, SubdocIndexCacheIndexBytes) {
+    nonNumericValuesShouldFail("subdoc_index_cache_index_bytes");
+
+    Settings defaults;
+    EXPECT_EQ(64_MiB, defaults.getSubdocIndexCacheIndexBytes());
+    EXPECT_FALSE(defaults.has.subdoc_index_cache_index_bytes);
+
+    nlohmann::json json;
+    json["subdoc_index_cache_index_bytes"] = 1024;
+    Settings settings(json);
+    EXPECT_EQ(1024, settings.getSubdocIndexCacheIndexBytes());
+    EXPECT_TRUE(settings.has.subdoc_index_cache_index_bytes);
+}
+
+TEST(SettingsUpdateTest, SubdocIndexCacheIndexBytesIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setSubdocIndexCacheIndexBytes(
+            settings.getSubdocIndexCacheIndexBytes());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setSubdocIndexCacheIndexBytes(1024);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(64_MiB, settings.getSubdocIndexCacheIndexBytes());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(1024, settings.getSubdocIndexCacheIndexBytes());
+}
+
+TEST_F(SettingsTest, SubdocOffloadThreads) {
+    nonNumericValuesShouldFail("subdoc_offload_threads");
+
+    Settings defaults;
+    EXPECT_EQ(4, defaults.getSubdocOffloadThreads());
+    EXPECT_FALSE(defaults.has.subdoc_offload_threads);
+
+    nlohmann::json json;
+    json["subdoc_offload_threads"] = 8;
+    Settings settings(json);
+    EXPECT_EQ(8, settings.getSubdocOffloadThreads());
+    EXPECT_TRUE(settings.has.subdoc_offload_threads);
+}
+
+TEST(SettingsUpdateTest, SubdocOffloadThreadsIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setSubdocOffloadThreads(settings.getSubdocOffloadThreads());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work, and notify the listeners (which resize
+    // the pool)
+    size_t notified = 0;
+    settings.addChangeListener(
+            "subdoc_offload_threads",
+            [&notified](const std::string&, Settings& s) {
+                notified = s.getSubdocOffloadThreads();
+            });
+    updated.setSubdocOffloadThreads(8);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(4, settings.getSubdocOffloadThreads());
+    EXPECT_EQ(0, notified);
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(8, settings.getSubdocOffloadThreads());
+    EXPECT_EQ(8, notified);
+}
+
 TEST_F(SettingsTest, ScramshaFallbackSaltIsDynamic) {
     Settings settings;
     Settings updated;
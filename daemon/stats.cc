@@ -70,6 +70,22 @@ static void server_global_stats(const StatCollector& collector) {
                           global_statistics.conn_structs);
         collector.addStat(Key::curr_connections_closing,
                           global_statistics.curr_conn_closing);
+        collector.addStat(Key::zerocopy_send_bytes,
+                          global_statistics.zerocopy_send_bytes);
+        collector.addStat(Key::zerocopy_send_copied_bytes,
+                          global_statistics.zerocopy_send_copied_bytes);
+        collector.addStat(Key::connections_migrated,
+                          global_statistics.connections_migrated);
+        collector.addStat(Key::worker_thread_cpu_imbalance,
+                          global_statistics.worker_thread_cpu_imbalance);
+        collector.addStat(Key::busy_poll_spin_time_ns,
+                          global_statistics.busy_poll_spin_time_ns);
+        collector.addStat(Key::subdoc_index_cache_hits,
+                          global_statistics.subdoc_index_cache_hits);
+        collector.addStat(Key::subdoc_index_cache_misses,
+                          global_statistics.subdoc_index_cache_misses);
+        collector.addStat(Key::subdoc_index_cache_indexed,
+                          global_statistics.subdoc_index_cache_indexed);
         if (isFusionSupportEnabled()) {
             collector.addStat(Key::fusion_migration_rate_limit,
                               magma::Magma::GetFusionMigrationRateLimit());
@@ -270,6 +286,12 @@ cb::engine_errc server_prometheus_stats(
                 dispatch_socket_histogram);
             add(cb::stats::Key::cookie_notification_histogram,
                 cookie_notification_histogram);
+            for (const auto& [weightClass, histogram] :
+                 FrontEndThread::getAggregatedFairShareQueueDelay()) {
+                collector.withLabels({{"class", weightClass}})
+                        .addStat(cb::stats::Key::fair_share_queue_delay,
+                                 histogram);
+            }
             try {
                 auto instance = sigar::SigarIface::New();
                 instance->iterate_threads([&kvCollector](auto tid,
@@ -54,6 +54,30 @@ struct GlobalStatistics {
     /// Number of connections currently closing
     cb::RelaxedAtomic<uint64_t> curr_conn_closing;
 
+    /// The number of bytes sent with zero copy
+    cb::RelaxedAtomic<uint64_t> zerocopy_send_bytes;
+    /// The number of bytes sent with zero copy where the kernel fell back
+    /// to copying the data
+    cb::RelaxedAtomic<uint64_t> zerocopy_send_copied_bytes;
+
+    /// The number of connections moved to another front end thread
+    cb::RelaxedAtomic<uint64_t> connections_migrated;
+    /// The CPU time used by the busiest front end thread in the last
+    /// second relative to the average of all front end threads (percent)
+    cb::RelaxedAtomic<uint64_t> worker_thread_cpu_imbalance;
+    /// The time (in ns) the front end threads spent busy polling without
+    /// finding any work
+    cb::RelaxedAtomic<uint64_t> busy_poll_spin_time_ns;
+    /// The number of subdoc lookups which found the location of the path
+    /// in the subdoc index cache
+    cb::RelaxedAtomic<uint64_t> subdoc_index_cache_hits;
+    /// The number of subdoc lookups which had to parse the document
+    /// (while the subdoc index cache was enabled)
+    cb::RelaxedAtomic<uint64_t> subdoc_index_cache_misses;
+    /// The number of hot documents given a structural index by the subdoc
+    /// index cache
+    cb::RelaxedAtomic<uint64_t> subdoc_index_cache_indexed;
+
     /** The number of auth commands sent */
     cb::RelaxedAtomic<uint64_t> auth_cmds;
     /** The number of authentication errors */
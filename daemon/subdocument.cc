@@ -13,15 +13,14 @@
 #include "buckets.h"
 #include "front_end_thread.h"
 #include "mcaudit.h"
-#include "one_shot_task.h"
 #include "protocol/mcbp/engine_wrapper.h"
 #include "settings.h"
 #include "subdocument_context.h"
 #include "subdocument_parser.h"
 #include "subdocument_traits.h"
+#include "subdocument_worker_pool.h"
 #include "thread_stats.h"
 
-#include <executor/executorpool.h>
 #include <gsl/gsl-lite.hpp>
 #include <logger/logger.h>
 #include <memcached/durability_spec.h>
@@ -91,6 +90,9 @@ public:
             case State::ExecuteSpecInFrontendThread:
                 do_execute_spec_in_frontend_thread();
                 break;
+            case State::InflateFailed:
+                cookie.sendResponse(inflate_status);
+                return;
             case State::AllocateNewItem:
                 if (do_allocate_new_item(aio_status)) {
                     aio_status = cb::engine_errc::success;
@@ -133,6 +135,7 @@ protected:
         FetchItem,
         ExecuteSpecInThreadpool,
         ExecuteSpecInFrontendThread,
+        InflateFailed,
         AllocateNewItem,
         UpdateItem,
         SendResponse,
@@ -141,13 +144,14 @@ protected:
     };
     State state{State::CreateContext};
 
-    /// Return true if the operation should be run on the thread pool
+    /// Return true if the operation should be run on the subdoc worker pool
     bool shouldRunOnThreadPool() const {
-        auto& settings = Settings::instance();
-        return execution_context->in_doc.view.size() >
-                       settings.getSubdocOffloadSizeThreshold() ||
-               execution_context->getNumOperations() >
-                       settings.getSubdocOffloadPathThreshold();
+        const auto cost = SubdocWorkerPool::estimateCost(
+                execution_context->get_input_document_size(),
+                execution_context->getNumOperations(),
+                traits.is_mutator,
+                cb::mcbp::datatype::is_snappy(execution_context->in_datatype));
+        return SubdocWorkerPool::shouldOffload(cost);
     }
 
     /// Callback implementing CreateContext state. Create the execution
@@ -171,6 +175,7 @@ protected:
     /// The next state would be:
     ///    AllocateNewItem - if this is a mutation which executed successfully
     ///    SendResponse - Errors and lookup
+    ///    InflateFailed - The input document could not be inflated
     ///    InitiateShutdown - An exception occurred
     void do_execute_spec_in_thread_pool();
 
@@ -178,6 +183,7 @@ protected:
     /// The next state would be:
     ///    AllocateNewItem - if this is a mutation which executed successfully
     ///    SendResponse - Errors and lookup
+    ///    InflateFailed - The input document could not be inflated
     void do_execute_spec_in_frontend_thread();
 
     /// Allocate an item to store the result. The method may be called
@@ -245,6 +251,9 @@ protected:
     /// The current retry count
     size_t retries = 0;
 
+    /// The error to return to the client in the InflateFailed state
+    cb::engine_errc inflate_status = cb::engine_errc::success;
+
     /// If operations should be retried or not
     const bool auto_retry_mode;
 
@@ -273,6 +282,15 @@ private:
     void send_multi_lookup_response();
 
     void execute_subdoc_spec() {
+        // Inflate the document on the thread executing the spec (so that
+        // the front end thread doesn't pay for it when offloaded)
+        inflate_status = cookie.getConnection().remapErrorCode(
+                execution_context->inflate_input_document());
+        if (inflate_status != cb::engine_errc::success) {
+            state = State::InflateFailed;
+            return;
+        }
+
         {
             using namespace cb::tracing;
             ScopeTimer2<HdrMicroSecStopwatch, SpanStopwatch<Code>> timer(
@@ -390,10 +408,8 @@ bool SubdocCommandContext::do_fetch_item(cb::engine_errc aio_status) {
         ++get_high_resolution_thread_stats(cookie.getConnection())
                   .subdoc_offload_count;
         cookie.setEwouldblock();
-        ExecutorPool::get()->schedule(std::make_shared<OneShotTask>(
-                TaskId::Core_SubdocExecuteTask, "Execute SUBDOC", [this]() {
-                    do_execute_spec_in_thread_pool();
-                }));
+        SubdocWorkerPool::instance().add(
+                [this]() { do_execute_spec_in_thread_pool(); });
         return false;
     }
 
@@ -418,7 +434,13 @@ void SubdocCommandContext::do_execute_spec_in_thread_pool() {
 }
 
 void SubdocCommandContext::do_execute_spec_in_frontend_thread() {
+    const auto start = std::chrono::steady_clock::now();
     execute_subdoc_spec();
+    get_high_resolution_thread_stats(cookie.getConnection())
+            .subdoc_frontend_execute_time +=
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
 }
 
 bool SubdocCommandContext::do_allocate_new_item(cb::engine_errc aio_status) {
@@ -9,13 +9,17 @@
  */
 #include "subdocument_context.h"
 
+#include "buckets.h"
 #include "front_end_thread.h"
 #include "protocol/mcbp/engine_wrapper.h"
 #include "settings.h"
 #include "subdocument_parser.h"
+#include "subdocument_path_scanner.h"
+#include "subdocument_worker_pool.h"
 #include "thread_stats.h"
 #include <gsl/gsl-lite.hpp>
 #include <logger/logger.h>
+#include <platform/compress.h>
 #include <platform/crc32c.h>
 #include <platform/string_hex.h>
 #include <subdoc/util.h>
@@ -23,7 +27,10 @@
 #include <utilities/string_utilities.h>
 #include <xattr/blob.h>
 #include <xattr/key_validator.h>
+#include <bit>
 #include <iomanip>
+#include <limits>
+#include <optional>
 #include <random>
 #include <sstream>
 #include <utility>
@@ -263,6 +270,18 @@ cb::engine_errc SubdocExecutionContext::pre_link_document(item_info& info) {
             }
         }
 
+        // Indexing the blob costs about log2(n) scans of its n keys, so it
+        // only pays off when looking up more keys than that
+        if (keys.size() > 1) {
+            size_t count = 0;
+            for (auto iter = xattr_blob.begin(); iter != xattr_blob.end();
+                 ++iter) {
+                ++count;
+            }
+            if (keys.size() > size_t(std::bit_width(count))) {
+                xattr_blob.build_index();
+            }
+        }
         for (const auto& key : keys) {
             auto view = xattr_blob.get(key);
             if (view.empty()) {
@@ -645,32 +664,43 @@ cb::engine_errc SubdocExecutionContext::get_document_for_searching(
     in_datatype = info.datatype;
     in_document_state = info.document_state;
 
-    if (cb::mcbp::datatype::is_snappy(info.datatype)) {
-        // Need to expand before attempting to extract from it.
-        try {
-            inflated_doc = cookie.inflateSnappy(in_doc.view);
-        } catch (const std::runtime_error&) {
-            LOG_ERROR_CTX(
-                    "Failed to inflate body, key may have an incorrect "
-                    "datatype",
-                    {"conn_id", cookie.getConnectionId()},
-                    {"key",
-                     cb::UserDataView(
-                             cookie.getRequestKey().toPrintableString())},
-                    {"datatype", info.datatype});
-            return cb::engine_errc::failed;
-        } catch (const std::bad_alloc&) {
-            return cb::engine_errc::no_memory;
-        }
+    return cb::engine_errc::success;
+}
+
+size_t SubdocExecutionContext::get_input_document_size() const {
+    if (cb::mcbp::datatype::is_snappy(in_datatype)) {
+        return cb::compression::getUncompressedLengthSnappy(in_doc.view);
+    }
+    return in_doc.view.size();
+}
 
-        // Update the document to point to the uncompressed version.
-        auto range = inflated_doc->coalesce();
-        std::string_view view{reinterpret_cast<const char*>(range.data()),
-                              range.size()};
-        in_doc = MemoryBackedBuffer{view};
-        in_datatype &= ~PROTOCOL_BINARY_DATATYPE_SNAPPY;
+cb::engine_errc SubdocExecutionContext::inflate_input_document() {
+    if (!cb::mcbp::datatype::is_snappy(in_datatype)) {
+        return cb::engine_errc::success;
     }
 
+    // Need to expand before attempting to extract from it.
+    try {
+        inflated_doc = cookie.inflateSnappy(in_doc.view);
+    } catch (const std::runtime_error&) {
+        LOG_ERROR_CTX(
+                "Failed to inflate body, key may have an incorrect "
+                "datatype",
+                {"conn_id", cookie.getConnectionId()},
+                {"key",
+                 cb::UserDataView(cookie.getRequestKey().toPrintableString())},
+                {"datatype", in_datatype});
+        return cb::engine_errc::failed;
+    } catch (const std::bad_alloc&) {
+        return cb::engine_errc::no_memory;
+    }
+
+    // Update the document to point to the uncompressed version.
+    auto range = inflated_doc->coalesce();
+    std::string_view view{reinterpret_cast<const char*>(range.data()),
+                          range.size()};
+    in_doc = MemoryBackedBuffer{view};
+    in_datatype &= ~PROTOCOL_BINARY_DATATYPE_SNAPPY;
     return cb::engine_errc::success;
 }
 
@@ -690,14 +720,34 @@ Subdoc::Operation& SubdocExecutionContext::get_subdoc_operation_object() {
     if (thread.eventBase.isInEventBaseThread()) {
         return thread.subdoc_op;
     }
+    if (SubdocWorkerPool::isWorkerThread()) {
+        return SubdocWorkerPool::getThreadBuffers().operation;
+    }
     if (!subdoc_op) {
         subdoc_op = std::make_unique<Subdoc::Operation>();
     }
     return *subdoc_op;
 }
 
+cb::json::StructuralIndex&
+SubdocExecutionContext::get_structural_index_object() {
+    auto& thread = connection.getThread();
+    if (thread.eventBase.isInEventBaseThread()) {
+        return thread.subdoc_index;
+    }
+    if (SubdocWorkerPool::isWorkerThread()) {
+        return SubdocWorkerPool::getThreadBuffers().index;
+    }
+    if (!structural_index) {
+        structural_index = std::make_unique<cb::json::StructuralIndex>();
+    }
+    return *structural_index;
+}
+
 cb::mcbp::Status SubdocExecutionContext::operate_one_path(
-        SubdocExecutionContext::OperationSpec& spec, std::string_view view) {
+        SubdocExecutionContext::OperationSpec& spec,
+        std::string_view view,
+        bool lookupIndexCache) {
     // Prepare the specified sub-document command.
     auto& op = get_subdoc_operation_object();
     op.clear();
@@ -752,8 +802,51 @@ cb::mcbp::Status SubdocExecutionContext::operate_one_path(
         op.set_doc(doc.data(), doc.size());
     }
 
-    // ... and execute it.
-    const auto subdoc_res = op.op_exec(spec.path.data(), spec.path.size());
+    // ... and execute it (unless we already know where the value is)
+    const bool cacheable = isIndexCacheable(spec, view);
+    auto& indexCache = connection.getBucket().subdocIndexCache;
+    std::optional<SubdocIndexCache::Location> location;
+    if (cacheable && lookupIndexCache) {
+        location = indexCache.lookup(getIndexCacheDocument(view), spec.path);
+    }
+
+    if (!location && cacheable && lookupIndexCache) {
+        // A hot document is navigated with its structural index instead of
+        // being parsed (for the paths the scanner supports)
+        SubdocPathScanner scanner;
+        auto index = get_hot_document_index(view);
+        if (index && scanner.add(spec.path)) {
+            scanner.setStructuralIndex(index.get(),
+                                       getIndexCacheDocument(view).crc32c);
+            const auto values = scanner.scan(view);
+            if (values.front()) {
+                location = SubdocIndexCache::Location{
+                        gsl::narrow_cast<uint32_t>(values.front()->data() -
+                                                   view.data()),
+                        gsl::narrow_cast<uint32_t>(values.front()->size())};
+                indexCache.insert(
+                        getIndexCacheDocument(view), spec.path, *location);
+            }
+        }
+    }
+
+    Subdoc::Error subdoc_res = Subdoc::Error::SUCCESS;
+    if (location) {
+        spec.result.set_matchloc(
+                {view.data() + location->offset, location->length});
+    } else {
+        subdoc_res = op.op_exec(spec.path.data(), spec.path.size());
+        const auto& match = spec.result.matchloc();
+        if (cacheable && subdoc_res == Subdoc::Error::SUCCESS &&
+            match.at >= view.data() &&
+            match.at + match.length <= view.data() + view.size()) {
+            indexCache.insert(
+                    getIndexCacheDocument(view),
+                    spec.path,
+                    {gsl::narrow_cast<uint32_t>(match.at - view.data()),
+                     gsl::narrow_cast<uint32_t>(match.length)});
+        }
+    }
 
     switch (subdoc_res) {
     case Subdoc::Error::SUCCESS:
@@ -820,6 +913,156 @@ cb::mcbp::Status SubdocExecutionContext::operate_one_path(
     }
 }
 
+bool SubdocExecutionContext::isIndexCacheable(
+        const SubdocExecutionContext::OperationSpec& spec,
+        std::string_view view) {
+    if (traits.is_mutator ||
+        getCurrentPhase() != SubdocExecutionContext::Phase::Body ||
+        (spec.traits.subdocCommand != Subdoc::Command::GET &&
+         spec.traits.subdocCommand != Subdoc::Command::EXISTS) ||
+        view.size() > std::numeric_limits<uint32_t>::max() ||
+        !SubdocIndexCache::isEnabled(view.size())) {
+        return false;
+    }
+    const auto cas = getInputItemInfo().cas;
+    return cas != 0 && cas != LOCKED_CAS;
+}
+
+const SubdocIndexCache::Document&
+SubdocExecutionContext::getIndexCacheDocument(std::string_view view) {
+    if (!indexCacheDocument || indexCacheBody.data() != view.data() ||
+        indexCacheBody.size() != view.size()) {
+        indexCacheBody = view;
+        indexCacheDocument = SubdocIndexCache::Document{
+                vbucket,
+                std::string_view{cookie.getRequestKey()},
+                getInputItemInfo().cas,
+                view.size(),
+                crc32c(view)};
+    }
+    return *indexCacheDocument;
+}
+
+std::shared_ptr<const cb::json::StructuralIndex>
+SubdocExecutionContext::get_hot_document_index(std::string_view view) {
+    auto& indexCache = connection.getBucket().subdocIndexCache;
+    const auto& document = getIndexCacheDocument(view);
+    auto cached = indexCache.getStructuralIndex(document);
+    if (cached.index) {
+        return cached.index->isFor(view, document.crc32c) ? cached.index
+                                                           : nullptr;
+    }
+    if (!cached.hot ||
+        view.size() > SubdocIndexCache::MaxIndexedDocumentSize) {
+        return {};
+    }
+
+    auto index = std::make_shared<cb::json::StructuralIndex>();
+    if (!index->build(view)) {
+        return {};
+    }
+    // The index is kept after this copy of the document is released
+    index->detach(document.crc32c);
+    indexCache.insertStructuralIndex(document, index);
+    return index;
+}
+
+std::vector<bool> SubdocExecutionContext::operate_lookups_in_one_pass(
+        std::string_view view) {
+    auto& operations = getOperations();
+    std::vector<bool> done(operations.size());
+    if (traits.is_mutator ||
+        getCurrentPhase() != SubdocExecutionContext::Phase::Body) {
+        return done;
+    }
+
+    // Find the lookups using path syntax supported by the scanner
+    SubdocPathScanner supported;
+    std::vector<std::size_t> eligible;
+    for (std::size_t ii = 0; ii < operations.size(); ++ii) {
+        const auto& spec = operations[ii];
+        if (spec.traits.scope == CommandScope::SubJSON &&
+            (spec.traits.subdocCommand == Subdoc::Command::GET ||
+             spec.traits.subdocCommand == Subdoc::Command::EXISTS) &&
+            !hasBinaryValue(spec.flags) && supported.add(spec.path)) {
+            eligible.push_back(ii);
+        }
+    }
+    if (eligible.size() < 2) {
+        // Nothing to gain over running subjson for the path
+        return done;
+    }
+
+    // Paths whose location is already known in the index cache don't
+    // need to be searched for
+    auto& indexCache = connection.getBucket().subdocIndexCache;
+    std::vector<bool> cacheable(operations.size());
+    SubdocPathScanner scanner;
+    std::vector<std::size_t> scanned;
+    for (const auto ii : eligible) {
+        auto& spec = operations[ii];
+        cacheable[ii] = isIndexCacheable(spec, view);
+        if (cacheable[ii]) {
+            auto location =
+                    indexCache.lookup(getIndexCacheDocument(view), spec.path);
+            if (location) {
+                spec.result.set_matchloc(
+                        {view.data() + location->offset, location->length});
+                spec.status = cb::mcbp::Status::Success;
+                done[ii] = true;
+                continue;
+            }
+        }
+        scanner.add(spec.path);
+        scanned.push_back(ii);
+    }
+
+    // Large documents are indexed first so that the scanner can skip the
+    // containers not leading to any of the paths without looking at them
+    // (hot documents keep their index in the index cache)
+    std::shared_ptr<const cb::json::StructuralIndex> hotIndex;
+    if (!scanned.empty() &&
+        std::ranges::any_of(cacheable, [](bool c) { return c; })) {
+        hotIndex = get_hot_document_index(view);
+    }
+    cb::json::StructuralIndex* index = nullptr;
+    if (hotIndex) {
+        scanner.setStructuralIndex(hotIndex.get(),
+                                   getIndexCacheDocument(view).crc32c);
+    } else if (view.size() >= SubdocPathScanner::MinIndexedDocumentSize) {
+        index = &get_structural_index_object();
+        if (index->build(view)) {
+            scanner.setStructuralIndex(index);
+        }
+    }
+    const auto values = scanner.scan(view);
+    if (index) {
+        index->clear();
+    }
+    for (std::size_t jj = 0; jj < scanned.size(); ++jj) {
+        const auto ii = scanned[jj];
+        auto& spec = operations[ii];
+        if (values[jj]) {
+            spec.result.set_matchloc({values[jj]->data(), values[jj]->size()});
+            spec.status = cb::mcbp::Status::Success;
+            if (cacheable[ii]) {
+                indexCache.insert(
+                        getIndexCacheDocument(view),
+                        spec.path,
+                        {gsl::narrow_cast<uint32_t>(values[jj]->data() -
+                                                    view.data()),
+                         gsl::narrow_cast<uint32_t>(values[jj]->size())});
+            }
+        } else {
+            // Not found (or the scanner gave up); let subjson work out
+            // the correct status
+            spec.status = operate_one_path(spec, view, false);
+        }
+        done[ii] = true;
+    }
+    return done;
+}
+
 cb::mcbp::Status SubdocExecutionContext::operate_wholedoc(
         SubdocExecutionContext::OperationSpec& spec, std::string_view& doc) {
     switch (spec.traits.mcbpCommand) {
@@ -905,11 +1148,20 @@ bool SubdocExecutionContext::operate_single_doc(
                             ? *xattr
                             : body;
 
-    // 2. Perform each of the operations on document.
+    // 2. Perform each of the operations on document. The lookups in the
+    // body are resolved together in a single pass over the document
+    std::vector<bool> done(getOperations().size());
+    if (cb::mcbp::datatype::is_json(doc_datatype)) {
+        done = operate_lookups_in_one_pass(current.view);
+    }
+    std::size_t index = 0;
     for (auto& op : getOperations()) {
+        const bool performed = done[index++];
         switch (op.traits.scope) {
         case CommandScope::SubJSON:
-            if (cb::mcbp::datatype::is_json(doc_datatype)) {
+            if (performed) {
+                // Already performed (and the status set)
+            } else if (cb::mcbp::datatype::is_json(doc_datatype)) {
                 // Got JSON, perform the operation.
                 op.status = operate_one_path(op, current.view);
             } else {
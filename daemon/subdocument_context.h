@@ -15,6 +15,7 @@
 
 #include "connection.h"
 #include "cookie.h"
+#include "subdocument_index_cache.h"
 #include "subdocument_traits.h"
 #include "xattr/utils.h"
 #include <folly/io/IOBuf.h>
@@ -22,7 +23,9 @@
 #include <cstddef>
 #include <iomanip>
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 /**
  * The MemoryBackedBuffer may be used for a "copy on write" context
@@ -133,8 +136,9 @@ public:
     //     inflated.
     // c). {intermediate_result} member of this object.
     // Either way, it should /not/ be cb_free()d.
-    // Note this is *always* in a decompressed form (and hence can safely be
-    // read / manipulated directly) - see get_document_for_searching().
+    // Note this is in a decompressed form (and hence can safely be
+    // read / manipulated directly) once inflate_input_document() has been
+    // called, which is done by the thread executing the specs.
     // TODO: Remove (b), and just use intermediate result.
     MemoryBackedBuffer in_doc;
 
@@ -153,8 +157,8 @@ public:
     // The datatype for the document currently held in `in_doc`. This
     // is used to set the new documents datatype.
     // Note: If the original input was Snappy compressed; it will be
-    // decompressed during fetch (by get_document_for_searching()) - as such
-    // this field will never have the Snappy bit set.
+    // decompressed before the specs are executed (by
+    // inflate_input_document()) which clears the Snappy bit.
     protocol_binary_datatype_t in_datatype = PROTOCOL_BINARY_RAW_BYTES;
 
     // The state of the document currently held in `in_doc`. This is used
@@ -272,6 +276,19 @@ public:
      */
     cb::engine_errc get_document_for_searching(uint64_t client_cas);
 
+    /**
+     * Inflate the input document if it is Snappy compressed (it is left
+     * compressed by get_document_for_searching() so that the inflation
+     * happens on the thread executing the specs).
+     *
+     * @return cb::engine_errc::success for success, otherwise an error
+     *         code which should be returned to the client
+     */
+    cb::engine_errc inflate_input_document();
+
+    /// The (uncompressed) size of the input document
+    size_t get_input_document_size() const;
+
     /**
      * The result of subdoc_fetch.
      */
@@ -402,11 +419,53 @@ protected:
 
     /**
      * Perform the subjson operation specified by {spec} to one path in the
-     * document.
+     * document. {lookupIndexCache} is false if the caller already looked
+     * up the path in the SubdocIndexCache.
      */
     cb::mcbp::Status operate_one_path(
             SubdocExecutionContext::OperationSpec& spec,
-            std::string_view in_doc);
+            std::string_view in_doc,
+            bool lookupIndexCache = true);
+
+    /**
+     * Resolve the (body) lookups of a multi-path command in a single pass
+     * over the document with the SubdocPathScanner (instead of running
+     * subjson over the entire document for each path). The paths the
+     * scanner doesn't find are resolved with operate_one_path.
+     *
+     * @param view The document body
+     * @return an entry per operation which is true if the operation was
+     *         performed (and its status set)
+     */
+    std::vector<bool> operate_lookups_in_one_pass(std::string_view view);
+
+    /**
+     * May the location of the value found by {spec} in {view} be looked
+     * up in (and added to) the bucket's SubdocIndexCache? Only lookups in
+     * the body of documents which aren't locked are cached.
+     */
+    bool isIndexCacheable(const SubdocExecutionContext::OperationSpec& spec,
+                          std::string_view view);
+
+    /**
+     * Get the identity of the document body {view} used to look up the
+     * bucket's SubdocIndexCache. The CRC32C of the body is computed the
+     * first time it is needed for the body.
+     */
+    const SubdocIndexCache::Document& getIndexCacheDocument(
+            std::string_view view);
+
+    /**
+     * Get the structural index of the body of a hot document from the
+     * bucket's SubdocIndexCache (indexing the body if the document just
+     * became hot). Must only be called for index cacheable lookups.
+     *
+     * @param view The document body
+     * @return The index to navigate the body with (or nullptr if the
+     *         document isn't hot or can't be indexed)
+     */
+    std::shared_ptr<const cb::json::StructuralIndex> get_hot_document_index(
+            std::string_view view);
 
     cb::mcbp::Status operate_attributes_and_body(
             SubdocExecutionContext::OperationSpec& spec,
@@ -486,4 +545,14 @@ protected:
     /// The Subdoc::Operation instance to use
     std::unique_ptr<Subdoc::Operation> subdoc_op;
 
+    cb::json::StructuralIndex& get_structural_index_object();
+
+    /// The StructuralIndex instance to use (when not running in the
+    /// front end thread)
+    std::unique_ptr<cb::json::StructuralIndex> structural_index;
+
+    /// The body (and its identity) last used with the SubdocIndexCache
+    std::string_view indexCacheBody;
+    std::optional<SubdocIndexCache::Document> indexCacheDocument;
+
 }; // class SubdocExecutionContext
@@ -0,0 +1,128 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "subdocument_index_cache.h"
+
+#include "settings.h"
+#include "stats.h"
+
+#include <algorithm>
+
+bool SubdocIndexCache::isEnabled(std::size_t documentSize) {
+    return documentSize >= MinDocumentSize &&
+           Settings::instance().getSubdocIndexCacheSize() != 0;
+}
+
+void SubdocIndexCache::resize(Shard& shard) {
+    const auto size = Settings::instance().getSubdocIndexCacheSize();
+    const auto shardSize = std::max<std::size_t>(
+            1, (size + NumShards - 1) / NumShards);
+    if (shard.documents.getMaxSize() != shardSize) {
+        shard.documents.setMaxSize(shardSize);
+    }
+}
+
+std::optional<SubdocIndexCache::Location> SubdocIndexCache::lookup(
+        const Document& document, std::string_view path) {
+    auto& shard = getShard(document.vbid);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto iter = shard.documents.find(document.key);
+    if (iter != shard.documents.end() && iter->second.isFor(document)) {
+        if (iter->second.lookups < HotDocumentLookups) {
+            ++iter->second.lookups;
+        }
+        auto location = iter->second.paths.find(path);
+        if (location != iter->second.paths.end() &&
+            uint64_t{location->second.offset} + location->second.length <=
+                    document.size) {
+            ++global_statistics.subdoc_index_cache_hits;
+            return location->second;
+        }
+    }
+    ++global_statistics.subdoc_index_cache_misses;
+    return {};
+}
+
+void SubdocIndexCache::insert(const Document& document,
+                              std::string_view path,
+                              Location location) {
+    auto& shard = getShard(document.vbid);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    resize(shard);
+    auto iter = shard.documents.find(document.key);
+    if (iter == shard.documents.end() || !iter->second.isFor(document)) {
+        // A new document (or the document changed)
+        Entry entry;
+        entry.cas = document.cas;
+        entry.size = document.size;
+        entry.crc32c = document.crc32c;
+        entry.paths.emplace(path, location);
+        shard.documents.set(std::string{document.key}, std::move(entry));
+        return;
+    }
+
+    auto& paths = iter->second.paths;
+    if (paths.size() < MaxPathsPerDocument) {
+        paths.emplace(path, location);
+    }
+}
+
+SubdocIndexCache::DocumentIndex SubdocIndexCache::getStructuralIndex(
+        const Document& document) {
+    auto& shard = getShard(document.vbid);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto iter = shard.documents.findWithoutPromotion(document.key);
+    if (iter == shard.documents.end() || !iter->second.isFor(document)) {
+        return {};
+    }
+    return {iter->second.index,
+            iter->second.lookups >= HotDocumentLookups};
+}
+
+void SubdocIndexCache::insertStructuralIndex(
+        const Document& document,
+        std::shared_ptr<const cb::json::StructuralIndex> index) {
+    const auto bytes = index->getMemoryUsage();
+    const auto budget = Settings::instance().getSubdocIndexCacheIndexBytes();
+    if (bytes > budget) {
+        return;
+    }
+
+    auto& shard = getShard(document.vbid);
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto iter = shard.documents.findWithoutPromotion(document.key);
+    if (iter == shard.documents.end() || !iter->second.isFor(document) ||
+        iter->second.index) {
+        return;
+    }
+
+    // Make room by dropping the indexes of the least recently used
+    // documents (the memory is released once the last user is done)
+    for (auto lru = shard.documents.rbegin();
+         indexBytes + bytes > budget && lru != shard.documents.rend();
+         ++lru) {
+        lru->second.index.reset();
+    }
+    if (indexBytes + bytes > budget) {
+        return;
+    }
+
+    // The bytes are accounted for as long as the index is referenced
+    indexBytes += bytes;
+    iter->second.index = std::shared_ptr<const cb::json::StructuralIndex>(
+            index.get(), [this, index, bytes](auto*) { indexBytes -= bytes; });
+    ++global_statistics.subdoc_index_cache_indexed;
+}
+
+void SubdocIndexCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        shard.documents.clear();
+    }
+}
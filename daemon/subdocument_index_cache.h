@@ -0,0 +1,168 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/container/F14Map.h>
+#include <json/structural_index.h>
+#include <memcached/vbucket.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * The SubdocIndexCache keeps the location of the values found by the
+ * sub-document lookups in the body of the most recently used documents
+ * so that repeated lookups of the same paths in a hot document may jump
+ * straight to the value instead of parsing the document from the start.
+ *
+ * Documents which keep getting looked up (hot documents) are also given a
+ * structural index of their body, so that the lookup of paths not seen
+ * before may navigate the document instead of parsing it.
+ *
+ * The entries are keyed by the document key and CAS; a new CAS means the
+ * document changed and the old locations are dropped. The size and
+ * CRC32C of the body are kept as well, and an entry is only used for a
+ * body with the same size and CRC32C (the CAS alone doesn't identify the
+ * body, e.g. a restored document may get its old CAS back). The cache is
+ * sharded by vBucket and bounded by the "subdoc_index_cache_size"
+ * setting (the number of documents per bucket, 0 disables the cache).
+ * The memory used by the structural indexes is bounded by the
+ * "subdoc_index_cache_index_bytes" setting.
+ */
+class SubdocIndexCache {
+public:
+    /// The location of a value within the document body
+    struct Location {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    /// The version of a document body the cache is used for
+    struct Document {
+        /// The vBucket the document belongs to
+        Vbid vbid;
+        /// The document key (including the collection)
+        std::string_view key;
+        uint64_t cas;
+        /// The size of the body
+        std::size_t size;
+        /// The CRC32C of the body
+        uint32_t crc32c;
+    };
+
+    /// Documents smaller than this are cheap enough to parse that it isn't
+    /// worth looking them up in the cache
+    static constexpr std::size_t MinDocumentSize = 1024;
+
+    /// The max number of paths kept per document
+    static constexpr std::size_t MaxPathsPerDocument = 32;
+
+    /// The number of path lookups in a document (since it last changed)
+    /// which makes the document hot
+    static constexpr uint32_t HotDocumentLookups = 4;
+
+    /// Documents larger than this aren't given a structural index (the
+    /// index is about the size of the document)
+    static constexpr std::size_t MaxIndexedDocumentSize = 1024 * 1024;
+
+    /// The structural index of the body of a document
+    struct DocumentIndex {
+        /// The (detached) index if the document was indexed
+        std::shared_ptr<const cb::json::StructuralIndex> index;
+        /// Is the document hot (and should be indexed if it isn't)
+        bool hot = false;
+    };
+
+    /// Is the cache enabled (and the document large enough) to be used
+    static bool isEnabled(std::size_t documentSize);
+
+    /**
+     * Look up the location of a path in the body of a document
+     *
+     * @param document The document body looked up in
+     * @param path The path looked up
+     * @return The location of the value (if known, and within the body)
+     */
+    std::optional<Location> lookup(const Document& document,
+                                   std::string_view path);
+
+    /// Record the location of a path in the body of a document
+    void insert(const Document& document,
+                std::string_view path,
+                Location location);
+
+    /// Get the structural index of the body of a document
+    DocumentIndex getStructuralIndex(const Document& document);
+
+    /**
+     * Keep the (detached) structural index of the body of a hot document.
+     * The indexes of the least recently used documents in the shard are
+     * dropped to keep the indexes within the byte budget, and the index
+     * isn't kept if that isn't enough.
+     */
+    void insertStructuralIndex(
+            const Document& document,
+            std::shared_ptr<const cb::json::StructuralIndex> index);
+
+    /// The number of bytes used by the structural indexes in the cache (and
+    /// the copies of them still in use)
+    std::size_t getIndexBytes() const {
+        return indexBytes;
+    }
+
+    /// Drop all of the entries
+    void clear();
+
+protected:
+    static constexpr std::size_t NumShards = 64;
+
+    struct Entry {
+        /// Is the entry for the provided version of the document
+        bool isFor(const Document& document) const {
+            return cas == document.cas && size == document.size &&
+                   crc32c == document.crc32c;
+        }
+
+        uint64_t cas = 0;
+        std::size_t size = 0;
+        uint32_t crc32c = 0;
+        folly::F14FastMap<std::string, Location> paths;
+        /// The number of path lookups in the document
+        uint32_t lookups = 0;
+        std::shared_ptr<const cb::json::StructuralIndex> index;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        /// The documents in LRU order (resized to the current setting when
+        /// used)
+        folly::EvictingCacheMap<std::string, Entry> documents{1};
+    };
+
+    /// Get the shard for the vBucket
+    Shard& getShard(Vbid vbid) {
+        return shards[vbid.get() % NumShards];
+    }
+
+    /// Resize the shard to its share of the current cache size. Must be
+    /// called with the shard locked
+    static void resize(Shard& shard);
+
+    std::array<Shard, NumShards> shards;
+
+    /// The number of bytes used by the structural indexes in the cache
+    std::atomic<std::size_t> indexBytes{0};
+};
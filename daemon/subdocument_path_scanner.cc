@@ -0,0 +1,353 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "subdocument_path_scanner.h"
+
+#include <algorithm>
+#include <charconv>
+#include <tuple>
+#include <type_traits>
+
+bool SubdocPathScanner::Component::operator<(const Component& other) const {
+    return std::tie(isIndex, index, key) <
+           std::tie(other.isIndex, other.index, other.key);
+}
+
+bool SubdocPathScanner::Component::operator==(const Component& other) const {
+    return isIndex == other.isIndex && index == other.index &&
+           key == other.key;
+}
+
+bool SubdocPathScanner::add(std::string_view path) {
+    Path entry{paths.size(), {}};
+    std::size_t pos = 0;
+    while (pos < path.size()) {
+        if (entry.components.size() == MaxDepth) {
+            return false;
+        }
+        if (path[pos] == '[') {
+            const auto end = path.find(']', pos);
+            if (end == std::string_view::npos) {
+                return false;
+            }
+            const auto digits = path.substr(pos + 1, end - pos - 1);
+            if (digits.empty() || (digits.size() > 1 && digits[0] == '0')) {
+                return false;
+            }
+            Component component;
+            component.isIndex = true;
+            const auto [ptr, ec] = std::from_chars(
+                    digits.data(), digits.data() + digits.size(),
+                    component.index);
+            if (ec != std::errc() || ptr != digits.data() + digits.size()) {
+                // Negative (or invalid) index
+                return false;
+            }
+            entry.components.emplace_back(std::move(component));
+            pos = end + 1;
+            if (pos < path.size() && path[pos] != '.' && path[pos] != '[') {
+                // e.g. "a[0]b" which subjson rejects
+                return false;
+            }
+        } else {
+            const auto end = path.find_first_of(".[", pos);
+            const auto key = path.substr(pos, end - pos);
+            if (key.empty() || key.find_first_of("`]") != key.npos) {
+                return false;
+            }
+            Component component;
+            component.key = std::string{key};
+            entry.components.emplace_back(std::move(component));
+            pos = end == std::string_view::npos ? path.size() : end;
+        }
+
+        if (pos < path.size() && path[pos] == '.') {
+            ++pos;
+            if (pos == path.size() || path[pos] == '[') {
+                return false;
+            }
+        }
+    }
+
+    if (entry.components.empty()) {
+        return false;
+    }
+    paths.emplace_back(std::move(entry));
+    return true;
+}
+
+std::vector<std::optional<std::string_view>> SubdocPathScanner::scan(
+        std::string_view document) {
+    if (paths.empty()) {
+        return {};
+    }
+    doc = document;
+    activeIndex = nullptr;
+    if (structuralIndex && structuralIndex->isFor(doc, structuralIndexHash) &&
+        structuralIndex->getMaxDepth() <= MaxDepth) {
+        // (Too deep documents are left for the byte scan to give up on)
+        activeIndex = structuralIndex;
+    }
+    results.assign(paths.size(), std::nullopt);
+    remaining = paths.size();
+
+    // Sort the paths so that the ones sharing a prefix are next to each
+    // other (and a path sorts before the paths it is a prefix of)
+    std::sort(paths.begin(), paths.end(), [](const auto& a, const auto& b) {
+        return std::lexicographical_compare(a.components.begin(),
+                                            a.components.end(),
+                                            b.components.begin(),
+                                            b.components.end());
+    });
+
+    if (scanValue(0, paths.cbegin(), paths.cend(), 0) == Failed) {
+        results.assign(paths.size(), std::nullopt);
+    }
+    doc = {};
+    activeIndex = nullptr;
+    return std::move(results);
+}
+
+std::size_t SubdocPathScanner::scanValue(std::size_t pos,
+                                         Iterator first,
+                                         Iterator last,
+                                         std::size_t depth) {
+    pos = skipWhitespace(pos);
+    if (pos >= doc.size() || depth > MaxDepth) {
+        return Failed;
+    }
+
+    // The paths ending at this value sort before the paths continuing
+    // into it
+    auto children = first;
+    while (children != last && children->components.size() == depth) {
+        ++children;
+    }
+
+    std::size_t end;
+    if (children == last) {
+        end = skipValue(pos, depth);
+    } else if (doc[pos] == '{') {
+        end = scanObject(pos, children, last, depth);
+    } else if (doc[pos] == '[') {
+        end = scanArray(pos, children, last, depth);
+    } else {
+        // A primitive can't contain the remaining paths
+        end = skipValue(pos, depth);
+    }
+    if (end == Done || end == Failed) {
+        return end;
+    }
+
+    for (auto iter = first; iter != children; ++iter) {
+        if (!results[iter->id]) {
+            results[iter->id] = doc.substr(pos, end - pos);
+            --remaining;
+        }
+    }
+    return remaining == 0 ? Done : end;
+}
+
+std::size_t SubdocPathScanner::scanObject(std::size_t pos,
+                                          Iterator first,
+                                          Iterator last,
+                                          std::size_t depth) {
+    // Only the first occurrence of a key is searched
+    std::vector<Iterator> visited;
+    pos = skipWhitespace(pos + 1);
+    if (pos < doc.size() && doc[pos] == '}') {
+        return pos + 1;
+    }
+
+    while (pos < doc.size()) {
+        if (doc[pos] != '"') {
+            return Failed;
+        }
+        const auto keyEnd = skipString(pos);
+        if (keyEnd == Failed) {
+            return Failed;
+        }
+        const auto key = doc.substr(pos + 1, keyEnd - pos - 2);
+        if (key.find('\\') != std::string_view::npos) {
+            // Let subjson deal with the escape sequences
+            return Failed;
+        }
+        pos = skipWhitespace(keyEnd);
+        if (pos >= doc.size() || doc[pos] != ':') {
+            return Failed;
+        }
+
+        Component component;
+        component.key = std::string{key};
+        const auto [begin, end] = std::equal_range(
+                first,
+                last,
+                component,
+                [depth](const auto& a, const auto& b) {
+                    using T = std::decay_t<decltype(a)>;
+                    if constexpr (std::is_same_v<T, Component>) {
+                        return a < b.components[depth];
+                    } else {
+                        return a.components[depth] < b;
+                    }
+                });
+        if (begin != end &&
+            std::find(visited.begin(), visited.end(), begin) ==
+                    visited.end()) {
+            visited.push_back(begin);
+            pos = scanValue(pos + 1, begin, end, depth + 1);
+        } else {
+            pos = skipValue(skipWhitespace(pos + 1), depth + 1);
+        }
+        if (pos == Done || pos == Failed) {
+            return pos;
+        }
+
+        pos = skipWhitespace(pos);
+        if (pos >= doc.size()) {
+            break;
+        }
+        if (doc[pos] == '}') {
+            return pos + 1;
+        }
+        if (doc[pos] != ',') {
+            break;
+        }
+        pos = skipWhitespace(pos + 1);
+    }
+    return Failed;
+}
+
+std::size_t SubdocPathScanner::scanArray(std::size_t pos,
+                                         Iterator first,
+                                         Iterator last,
+                                         std::size_t depth) {
+    pos = skipWhitespace(pos + 1);
+    if (pos < doc.size() && doc[pos] == ']') {
+        return pos + 1;
+    }
+
+    // The index components sort in increasing order (and after any key
+    // components, which can't match an array element)
+    auto next = std::find_if(first, last, [depth](const auto& path) {
+        return path.components[depth].isIndex;
+    });
+
+    uint64_t index = 0;
+    while (pos < doc.size()) {
+        while (next != last && next->components[depth].index < index) {
+            ++next;
+        }
+        if (next != last && next->components[depth].index == index) {
+            auto end = next;
+            while (end != last && end->components[depth].index == index) {
+                ++end;
+            }
+            pos = scanValue(pos, next, end, depth + 1);
+            next = end;
+        } else {
+            pos = skipValue(pos, depth + 1);
+        }
+        if (pos == Done || pos == Failed) {
+            return pos;
+        }
+
+        pos = skipWhitespace(pos);
+        if (pos >= doc.size()) {
+            break;
+        }
+        if (doc[pos] == ']') {
+            return pos + 1;
+        }
+        if (doc[pos] != ',') {
+            break;
+        }
+        pos = skipWhitespace(pos + 1);
+        ++index;
+    }
+    return Failed;
+}
+
+std::size_t SubdocPathScanner::skipValue(std::size_t pos,
+                                         std::size_t depth) const {
+    if (pos >= doc.size()) {
+        return Failed;
+    }
+
+    switch (doc[pos]) {
+    case '"':
+        return skipString(pos);
+    case '{':
+    case '[':
+        if (activeIndex) {
+            const auto close = activeIndex->findClose(pos);
+            if (close != std::string_view::npos) {
+                return close + 1;
+            }
+        }
+        break;
+    default:
+        // Number, true, false or null
+        pos = doc.find_first_of(",}] \t\r\n", pos);
+        return pos == std::string_view::npos ? doc.size() : pos;
+    }
+
+    std::size_t level = 0;
+    while (pos < doc.size()) {
+        pos = doc.find_first_of("\"{}[]", pos);
+        if (pos == std::string_view::npos) {
+            return Failed;
+        }
+        switch (doc[pos]) {
+        case '"':
+            pos = skipString(pos);
+            if (pos == Failed) {
+                return Failed;
+            }
+            continue;
+        case '{':
+        case '[':
+            if (depth + ++level > MaxDepth) {
+                // Let subjson report the document as too deep
+                return Failed;
+            }
+            break;
+        default:
+            if (--level == 0) {
+                return pos + 1;
+            }
+        }
+        ++pos;
+    }
+    return Failed;
+}
+
+std::size_t SubdocPathScanner::skipString(std::size_t pos) const {
+    ++pos;
+    while (pos < doc.size()) {
+        pos = doc.find_first_of("\"\\", pos);
+        if (pos == std::string_view::npos) {
+            return Failed;
+        }
+        if (doc[pos] == '"') {
+            return pos + 1;
+        }
+        // Skip the escaped character
+        pos += 2;
+    }
+    return Failed;
+}
+
+std::size_t SubdocPathScanner::skipWhitespace(std::size_t pos) const {
+    while (pos < doc.size() && (doc[pos] == ' ' || doc[pos] == '\t' ||
+                                doc[pos] == '\n' || doc[pos] == '\r')) {
+        ++pos;
+    }
+    return pos;
+}
@@ -0,0 +1,144 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <json/structural_index.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The SubdocPathScanner locates the values of multiple paths in a JSON
+ * document in a single forward traversal of the document (instead of
+ * running a subjson operation over the full document per path).
+ *
+ * The paths are sorted so that all of the paths sharing a prefix are
+ * resolved while the scanner is within the container the prefix refers
+ * to, and the containers (and values) which aren't on the way to any of
+ * the paths are skipped without being parsed.
+ *
+ * The scanner only supports the plain path syntax (dictionary keys and
+ * non-negative array indexes); paths using escaped keys or negative
+ * indexes are rejected by add() and must be resolved by subjson. It only
+ * reports the values found; paths not found (or a document the scanner
+ * gives up on) must be resolved by subjson to get the correct error.
+ */
+class SubdocPathScanner {
+public:
+    /// The max number of components in a path (or nesting levels in the
+    /// document) the scanner handles
+    static constexpr std::size_t MaxDepth = 32;
+
+    /// Documents smaller than this are skipped through faster than they
+    /// may be indexed
+    static constexpr std::size_t MinIndexedDocumentSize = 4096;
+
+    /**
+     * Add a path to look up
+     *
+     * @param path The path to look up
+     * @return true if the path was added, false if the path uses syntax
+     *         the scanner doesn't support
+     */
+    bool add(std::string_view path);
+
+    /// The number of paths added
+    std::size_t size() const {
+        return paths.size();
+    }
+
+    /**
+     * Use the structural index of the document to skip the containers
+     * not leading to any of the paths (instead of scanning through them).
+     * The index is only used if it is for the scanned document (see
+     * cb::json::StructuralIndex::isFor()).
+     *
+     * @param index The index to use (nullptr to scan without an index)
+     * @param documentHash The hash of the scanned document, required to
+     *                     use a detached index
+     */
+    void setStructuralIndex(const cb::json::StructuralIndex* index,
+                            std::optional<uint32_t> documentHash = {}) {
+        structuralIndex = index;
+        structuralIndexHash = documentHash;
+    }
+
+    /**
+     * Locate all of the paths added in the document
+     *
+     * @param doc The (validated) JSON document to scan
+     * @return The value of each path, in the order they were added (or an
+     *         empty optional for the paths which wasn't found)
+     */
+    std::vector<std::optional<std::string_view>> scan(std::string_view doc);
+
+protected:
+    /// A dictionary key or an array index
+    struct Component {
+        bool isIndex = false;
+        uint64_t index = 0;
+        std::string key;
+
+        bool operator<(const Component& other) const;
+        bool operator==(const Component& other) const;
+    };
+
+    struct Path {
+        /// The order the path was added in
+        std::size_t id;
+        std::vector<Component> components;
+    };
+
+    using Iterator = std::vector<Path>::const_iterator;
+
+    /// Returned by the scan methods when there is nothing more to look for
+    static constexpr std::size_t Done = std::string_view::npos;
+    /// Returned by the scan methods when the scanner gives up
+    static constexpr std::size_t Failed = Done - 1;
+
+    /**
+     * Scan the value at offset pos for the paths in [first, last) which
+     * all share the first depth components
+     *
+     * @return the offset after the value (or Done / Failed)
+     */
+    std::size_t scanValue(std::size_t pos,
+                          Iterator first,
+                          Iterator last,
+                          std::size_t depth);
+    std::size_t scanObject(std::size_t pos,
+                           Iterator first,
+                           Iterator last,
+                           std::size_t depth);
+    std::size_t scanArray(std::size_t pos,
+                          Iterator first,
+                          Iterator last,
+                          std::size_t depth);
+
+    /// Skip the value at offset pos (returns the offset after the value)
+    std::size_t skipValue(std::size_t pos, std::size_t depth) const;
+    std::size_t skipString(std::size_t pos) const;
+    std::size_t skipWhitespace(std::size_t pos) const;
+
+    std::vector<Path> paths;
+
+    const cb::json::StructuralIndex* structuralIndex = nullptr;
+    std::optional<uint32_t> structuralIndexHash;
+
+    // The state of the current scan
+    std::string_view doc;
+    /// The structural index to skip containers with (if usable for doc)
+    const cb::json::StructuralIndex* activeIndex = nullptr;
+    std::vector<std::optional<std::string_view>> results;
+    std::size_t remaining = 0;
+};
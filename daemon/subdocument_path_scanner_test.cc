@@ -0,0 +1,236 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "subdocument_path_scanner.h"
+
+#include <folly/portability/GTest.h>
+#include <json/structural_index.h>
+#include <subdoc/operations.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Values = std::vector<std::optional<std::string_view>>;
+
+/// Scan the document for the provided paths (which must all be supported)
+static Values scanPaths(std::string_view doc,
+                        const std::vector<std::string_view>& paths,
+                        const cb::json::StructuralIndex* index = nullptr) {
+    SubdocPathScanner scanner;
+    for (const auto& path : paths) {
+        EXPECT_TRUE(scanner.add(path)) << path;
+    }
+    scanner.setStructuralIndex(index);
+    return scanner.scan(doc);
+}
+
+/// Look up the path with subjson (what the scanner falls back to)
+static std::optional<std::string_view> subjsonGet(std::string_view doc,
+                                                  std::string_view path) {
+    Subdoc::Operation op;
+    Subdoc::Result result;
+    op.set_result_buf(&result);
+    op.set_code(Subdoc::Command::GET);
+    op.set_doc(doc.data(), doc.size());
+    const auto rv = op.op_exec(path.data(), path.size());
+    if (rv != Subdoc::Error::SUCCESS) {
+        return {};
+    }
+    return result.matchloc().to_view();
+}
+
+TEST(SubdocPathScannerTest, AddSupportedPaths) {
+    SubdocPathScanner scanner;
+    EXPECT_TRUE(scanner.add("a"));
+    EXPECT_TRUE(scanner.add("a.b.c"));
+    EXPECT_TRUE(scanner.add("a[0]"));
+    EXPECT_TRUE(scanner.add("[10]"));
+    EXPECT_TRUE(scanner.add("a[1][2].b"));
+    EXPECT_EQ(5, scanner.size());
+}
+
+TEST(SubdocPathScannerTest, AddRejectsUnsupportedPaths) {
+    SubdocPathScanner scanner;
+    // Escaped keys and negative indexes are left for subjson
+    EXPECT_FALSE(scanner.add("`a.b`"));
+    EXPECT_FALSE(scanner.add("a.`b`"));
+    EXPECT_FALSE(scanner.add("a[-1]"));
+    // Invalid syntax
+    EXPECT_FALSE(scanner.add(""));
+    EXPECT_FALSE(scanner.add("a."));
+    EXPECT_FALSE(scanner.add("a..b"));
+    EXPECT_FALSE(scanner.add("a.[0]"));
+    EXPECT_FALSE(scanner.add("a[]"));
+    EXPECT_FALSE(scanner.add("a[0"));
+    EXPECT_FALSE(scanner.add("a[01]"));
+    EXPECT_FALSE(scanner.add("a[x]"));
+    EXPECT_FALSE(scanner.add("a]"));
+    EXPECT_FALSE(scanner.add("a[0]b"));
+    EXPECT_EQ(0, scanner.size());
+}
+
+TEST(SubdocPathScannerTest, AddRejectsTooDeepPaths) {
+    std::string path = "a";
+    for (std::size_t ii = 1; ii < SubdocPathScanner::MaxDepth; ++ii) {
+        path.append(".a");
+    }
+    SubdocPathScanner scanner;
+    EXPECT_TRUE(scanner.add(path));
+    EXPECT_FALSE(scanner.add(path + "[0]"));
+    EXPECT_EQ(1, scanner.size());
+}
+
+TEST(SubdocPathScannerTest, ValuesInAddOrder) {
+    const std::string_view doc =
+            R"({"b": {"c": 1, "d": [true, null]}, "a": "x", "e": 2.5e3})";
+    EXPECT_EQ(Values({"2.5e3",
+                      R"({"c": 1, "d": [true, null]})",
+                      "null",
+                      R"("x")",
+                      "1",
+                      "[true, null]"}),
+              scanPaths(doc, {"e", "b", "b.d[1]", "a", "b.c", "b.d"}));
+}
+
+TEST(SubdocPathScannerTest, NestedArrays) {
+    const std::string_view doc = R"([[1, [2, 3]], [], [[[4]], "5"]])";
+    EXPECT_EQ(Values({"3", "[2, 3]", "[]", "4", R"("5")", {}, {}}),
+              scanPaths(doc,
+                        {"[0][1][1]",
+                         "[0][1]",
+                         "[1]",
+                         "[2][0][0][0]",
+                         "[2][1]",
+                         "[1][0]",
+                         "[3]"}));
+}
+
+TEST(SubdocPathScannerTest, LargeArrayIndex) {
+    std::string doc = "{\"a\": [";
+    for (int ii = 0; ii < 1000; ++ii) {
+        doc.append(std::to_string(ii)).append(", ");
+    }
+    doc.append("\"last\"]}");
+    EXPECT_EQ(Values({"0", "999", R"("last")", {}}),
+              scanPaths(doc, {"a[0]", "a[999]", "a[1000]", "a[1001]"}));
+}
+
+TEST(SubdocPathScannerTest, EscapedStringValues) {
+    // Escape sequences in the values (and keys not looked for) are skipped
+    const std::string_view doc =
+            R"({"a": "x\"}]y", "b": ["\\", "\"[", {"c": "\\\""}], "d": 1})";
+    EXPECT_EQ(Values({R"("x\"}]y")", R"("\"[")", R"("\\\"")", "1"}),
+              scanPaths(doc, {"a", "b[1]", "b[2].c", "d"}));
+}
+
+TEST(SubdocPathScannerTest, EscapedKeyGivesUp) {
+    // The scanner doesn't unescape keys, so it gives up on the document
+    // rather than risk reporting the wrong value
+    const std::string_view doc = R"({"a": 1, "b\"c": 2, "d": 3})";
+    EXPECT_EQ(Values({{}, {}}), scanPaths(doc, {"a", "d"}));
+    EXPECT_EQ("1", subjsonGet(doc, "a"));
+    EXPECT_EQ("3", subjsonGet(doc, "d"));
+}
+
+TEST(SubdocPathScannerTest, FirstOccurrenceOfKey) {
+    const std::string_view doc = R"({"a": {"b": 1}, "a": {"c": 2}})";
+    EXPECT_EQ(Values({"1", {}}), scanPaths(doc, {"a.b", "a.c"}));
+}
+
+TEST(SubdocPathScannerTest, NotFound) {
+    const std::string_view doc = R"({"a": [1, 2], "b": {"c": "x"}, "d": 4})";
+    // Missing keys, indexes out of range and paths into a primitive aren't
+    // reported (and don't stop the other paths from being found)
+    EXPECT_EQ(Values({{}, {}, {}, {}, "4", {}}),
+              scanPaths(doc, {"missing", "a[2]", "b.c.d", "a.x", "d", "[0]"}));
+}
+
+TEST(SubdocPathScannerTest, TooDeepDocumentGivesUp) {
+    std::string deep;
+    for (std::size_t ii = 0; ii <= SubdocPathScanner::MaxDepth; ++ii) {
+        deep.push_back('[');
+    }
+    for (std::size_t ii = 0; ii <= SubdocPathScanner::MaxDepth; ++ii) {
+        deep.push_back(']');
+    }
+    const auto doc = R"({"a": 1, "deep": )" + deep + R"(, "b": 2})";
+    EXPECT_EQ(Values({{}, {}}), scanPaths(doc, {"a", "b"}));
+
+    // Also when navigating with a structural index
+    cb::json::StructuralIndex index;
+    ASSERT_TRUE(index.build(doc));
+    EXPECT_EQ(Values({{}, {}}), scanPaths(doc, {"a", "b"}, &index));
+}
+
+TEST(SubdocPathScannerTest, MalformedDocumentGivesUp) {
+    for (const std::string_view doc : {R"({"a": 1, "b": 2)",
+                                       R"({"a": 1, "b" 2})",
+                                       R"({"a": 1, "b": "2})",
+                                       R"({"a": 1 "b": 2})",
+                                       R"({a: 1, "b": 2})",
+                                       R"({"a": 1, "b": [)",
+                                       ""}) {
+        EXPECT_EQ(Values({{}, {}}), scanPaths(doc, {"b", "b[0]"})) << doc;
+    }
+}
+
+TEST(SubdocPathScannerTest, StructuralIndex) {
+    std::string doc = R"({"skip": [)";
+    for (int ii = 0; ii < 1000; ++ii) {
+        doc.append(R"({"x": "]}", "y": [1, 2, 3]}, )");
+    }
+    doc.append(R"({}], "a": {"b": [1, {"c": "found"}]}})");
+    const std::vector<std::string_view> paths = {"a.b[1].c", "skip[1000]"};
+    const auto expected = scanPaths(doc, paths);
+    EXPECT_EQ(Values({R"("found")", "{}"}), expected);
+
+    cb::json::StructuralIndex index;
+    ASSERT_TRUE(index.build(doc));
+    EXPECT_EQ(expected, scanPaths(doc, paths, &index));
+
+    // An index for another document is ignored
+    cb::json::StructuralIndex other;
+    ASSERT_TRUE(other.build(R"({"a": {"b": [1, {"c": 1}]}})"));
+    EXPECT_EQ(expected, scanPaths(doc, paths, &other));
+}
+
+TEST(SubdocPathScannerTest, MatchesSubjson) {
+    // The values found must be the ones subjson finds, and the paths not
+    // found must fail in subjson (which reports the correct error)
+    const std::string_view doc = R"({
+      "name": "scanner",
+      "tags": ["a", "b", ["c", {"d": [0, -1.5, true, false, null]}]],
+      "nested": {"x": {"y": {"z": "deep"}}, "empty": {}, "list": []},
+      "escaped": "a\\b\"c",
+      "n": 12345678901234567890
+    })";
+    const std::vector<std::string_view> paths = {"name",
+                                                 "tags",
+                                                 "tags[1]",
+                                                 "tags[2][1].d[1]",
+                                                 "tags[2][1].d[4]",
+                                                 "tags[2][1].d[5]",
+                                                 "tags[3]",
+                                                 "nested.x.y.z",
+                                                 "nested.x.y.z.w",
+                                                 "nested.empty",
+                                                 "nested.empty.a",
+                                                 "nested.list",
+                                                 "nested.list[0]",
+                                                 "escaped",
+                                                 "n",
+                                                 "missing"};
+    const auto values = scanPaths(doc, paths);
+    ASSERT_EQ(paths.size(), values.size());
+    for (std::size_t ii = 0; ii < paths.size(); ++ii) {
+        EXPECT_EQ(subjsonGet(doc, paths[ii]), values[ii]) << paths[ii];
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "subdocument_worker_pool.h"
+
+#include "settings.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <algorithm>
+
+/// The objects of the calling worker thread (null for all other threads)
+static thread_local std::unique_ptr<SubdocWorkerPool::Buffers>
+        subdocWorkerBuffers;
+
+SubdocWorkerPool& SubdocWorkerPool::instance() {
+    static SubdocWorkerPool pool;
+    return pool;
+}
+
+SubdocWorkerPool::SubdocWorkerPool() = default;
+
+SubdocWorkerPool::~SubdocWorkerPool() {
+    shutdown();
+}
+
+std::size_t SubdocWorkerPool::estimateCost(std::size_t documentSize,
+                                           std::size_t numSpecs,
+                                           bool mutator,
+                                           bool compressed) {
+    const auto& settings = Settings::instance();
+    // The smallest cost which makes more specs than the paths threshold
+    // cost more than the size threshold
+    const auto perSpec = settings.getSubdocOffloadSizeThreshold() /
+                                 (settings.getSubdocOffloadPathThreshold() +
+                                  1) +
+                         1;
+    const auto passes = (mutator ? numSpecs : 1) + (compressed ? 1 : 0);
+    return documentSize * passes + numSpecs * perSpec;
+}
+
+bool SubdocWorkerPool::shouldOffload(std::size_t cost) {
+    return cost > Settings::instance().getSubdocOffloadSizeThreshold();
+}
+
+bool SubdocWorkerPool::isWorkerThread() {
+    return subdocWorkerBuffers != nullptr;
+}
+
+SubdocWorkerPool::Buffers& SubdocWorkerPool::getThreadBuffers() {
+    if (!subdocWorkerBuffers) {
+        throw std::logic_error(
+                "SubdocWorkerPool::getThreadBuffers: Not a worker thread");
+    }
+    return *subdocWorkerBuffers;
+}
+
+void SubdocWorkerPool::add(folly::Func func) {
+    getExecutor().add([f = std::move(func)]() mutable {
+        if (!subdocWorkerBuffers) {
+            subdocWorkerBuffers = std::make_unique<Buffers>();
+        }
+        f();
+    });
+}
+
+void SubdocWorkerPool::setNumThreads(std::size_t num) {
+    getExecutor().setNumThreads(std::max(num, std::size_t{1}));
+}
+
+std::size_t SubdocWorkerPool::getNumThreads() {
+    return getExecutor().numThreads();
+}
+
+void SubdocWorkerPool::shutdown() {
+    std::unique_ptr<folly::CPUThreadPoolExecutor> stopped;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopped = std::move(executor);
+    }
+    if (stopped) {
+        stopped->join();
+    }
+}
+
+folly::CPUThreadPoolExecutor& SubdocWorkerPool::getExecutor() {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!executor) {
+        executor = std::make_unique<folly::CPUThreadPoolExecutor>(
+                std::max(Settings::instance().getSubdocOffloadThreads(),
+                         std::size_t{1}),
+                std::make_shared<folly::NamedThreadFactory>("mc:subdoc_"));
+    }
+    return *executor;
+}
@@ -0,0 +1,95 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <folly/Function.h>
+#include <json/structural_index.h>
+#include <subdoc/operations.h>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace folly {
+class CPUThreadPoolExecutor;
+}
+
+/**
+ * The SubdocWorkerPool runs the sub-document operations which are too
+ * expensive to run on the front end threads. It is a dedicated pool of
+ * threads (sized by the "subdoc_offload_threads" setting) so the
+ * operations don't compete with the NonIO tasks of the engines, and each
+ * of the threads owns the subjson objects used by all of the operations
+ * it runs (as the front end threads do).
+ */
+class SubdocWorkerPool {
+public:
+    /// The objects a thread reuses for all of the operations it runs
+    struct Buffers {
+        Subdoc::Operation operation;
+        cb::json::StructuralIndex index;
+    };
+
+    static SubdocWorkerPool& instance();
+
+    /**
+     * Estimate the cost of a sub-document operation, in bytes of document
+     * processed.
+     *
+     * A lookup scans the document once, where every mutation spec rewrites
+     * the document. A compressed document has to be inflated first (which
+     * costs about as much as a scan). Every spec adds a fixed cost, set so
+     * that more specs than "subdoc_offload_paths_threshold" cost more than
+     * scanning a "subdoc_offload_size_threshold" sized document.
+     *
+     * Operations over either threshold are therefore always offloaded, and
+     * operations below both thresholds are offloaded when the combined
+     * cost of the document and the specs is over the size threshold.
+     *
+     * @param documentSize The (inflated) size of the document
+     * @param numSpecs The number of specs in the operation
+     * @param mutator If the operation is a mutation
+     * @param compressed If the document is snappy compressed
+     */
+    static std::size_t estimateCost(std::size_t documentSize,
+                                    std::size_t numSpecs,
+                                    bool mutator,
+                                    bool compressed);
+
+    /// Should an operation of the given cost run in the pool (instead of
+    /// on the front end thread)
+    static bool shouldOffload(std::size_t cost);
+
+    /// Is the calling thread one of the worker threads
+    static bool isWorkerThread();
+
+    /// Get the objects owned by the calling worker thread
+    static Buffers& getThreadBuffers();
+
+    /// Run the function on one of the worker threads
+    void add(folly::Func func);
+
+    /// Set the number of worker threads (at least one)
+    void setNumThreads(std::size_t num);
+
+    /// Get the number of worker threads
+    std::size_t getNumThreads();
+
+    /// Wait for the scheduled functions to complete, and stop the threads
+    void shutdown();
+
+protected:
+    SubdocWorkerPool();
+    ~SubdocWorkerPool();
+
+    folly::CPUThreadPoolExecutor& getExecutor();
+
+    std::mutex mutex;
+    std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
+};
@@ -0,0 +1,118 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "subdocument_worker_pool.h"
+
+#include "settings.h"
+
+#include <folly/portability/GTest.h>
+#include <folly/synchronization/Baton.h>
+#include <platform/byte_literals.h>
+
+class SubdocWorkerPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto& settings = Settings::instance();
+        sizeThreshold = settings.getSubdocOffloadSizeThreshold();
+        pathThreshold = settings.getSubdocOffloadPathThreshold();
+        setThresholds(1_MiB, 16);
+    }
+
+    void TearDown() override {
+        setThresholds(sizeThreshold, pathThreshold);
+    }
+
+    static void setThresholds(std::size_t size, std::size_t paths) {
+        auto& settings = Settings::instance();
+        settings.setSubdocOffloadSizeThreshold(size);
+        settings.setSubdocOffloadPathThreshold(paths);
+    }
+
+    static bool shouldOffload(std::size_t documentSize,
+                              std::size_t numSpecs,
+                              bool mutator = false,
+                              bool compressed = false) {
+        return SubdocWorkerPool::shouldOffload(SubdocWorkerPool::estimateCost(
+                documentSize, numSpecs, mutator, compressed));
+    }
+
+    std::size_t sizeThreshold = 0;
+    std::size_t pathThreshold = 0;
+};
+
+TEST_F(SubdocWorkerPoolTest, SizeThreshold) {
+    EXPECT_TRUE(shouldOffload(1_MiB + 1, 1));
+    EXPECT_TRUE(shouldOffload(1_MiB + 1, 1, true));
+    EXPECT_FALSE(shouldOffload(512_KiB, 1));
+    EXPECT_FALSE(shouldOffload(0, 1));
+}
+
+TEST_F(SubdocWorkerPoolTest, PathsThreshold) {
+    EXPECT_FALSE(shouldOffload(0, 16));
+    EXPECT_TRUE(shouldOffload(0, 17));
+    EXPECT_FALSE(shouldOffload(0, 16, true));
+    EXPECT_TRUE(shouldOffload(0, 17, true));
+}
+
+TEST_F(SubdocWorkerPoolTest, ThresholdsAlwaysOffload) {
+    // Operations over either threshold are offloaded for any setting, and
+    // the specs alone don't offload an operation within the paths
+    // threshold (unless the size threshold is tiny compared to it)
+    for (const std::size_t size : {0_KiB, 1_KiB, 1_MiB, 20_MiB}) {
+        for (const std::size_t paths : {0, 1, 16, 100}) {
+            setThresholds(size, paths);
+            EXPECT_TRUE(shouldOffload(size + 1, 1)) << size << " " << paths;
+            EXPECT_TRUE(shouldOffload(0, paths + 1)) << size << " " << paths;
+            if (size >= paths * (paths + 1)) {
+                EXPECT_FALSE(shouldOffload(0, paths))
+                        << size << " " << paths;
+            }
+        }
+    }
+}
+
+TEST_F(SubdocWorkerPoolTest, MutationSpecsRewriteTheDocument) {
+    EXPECT_FALSE(shouldOffload(600_KiB, 2));
+    EXPECT_TRUE(shouldOffload(600_KiB, 2, true));
+    EXPECT_FALSE(shouldOffload(400_KiB, 2, true));
+}
+
+TEST_F(SubdocWorkerPoolTest, CompressedDocumentIsInflated) {
+    EXPECT_FALSE(shouldOffload(600_KiB, 1));
+    EXPECT_TRUE(shouldOffload(600_KiB, 1, false, true));
+}
+
+TEST_F(SubdocWorkerPoolTest, SpecsAddToTheDocument) {
+    EXPECT_FALSE(shouldOffload(900_KiB, 1));
+    EXPECT_TRUE(shouldOffload(900_KiB, 3));
+}
+
+TEST_F(SubdocWorkerPoolTest, SetNumThreads) {
+    auto& pool = SubdocWorkerPool::instance();
+    pool.setNumThreads(2);
+    EXPECT_EQ(2, pool.getNumThreads());
+    pool.setNumThreads(0);
+    EXPECT_EQ(1, pool.getNumThreads());
+
+    // The functions run on a worker thread, with the buffers of the thread
+    folly::Baton<> baton;
+    bool workerThread = false;
+    pool.add([&baton, &workerThread]() {
+        workerThread = SubdocWorkerPool::isWorkerThread();
+        SubdocWorkerPool::getThreadBuffers();
+        baton.post();
+    });
+    baton.wait();
+    EXPECT_TRUE(workerThread);
+    EXPECT_FALSE(SubdocWorkerPool::isWorkerThread());
+    EXPECT_THROW(SubdocWorkerPool::getThreadBuffers(), std::logic_error);
+
+    pool.setNumThreads(Settings::instance().getSubdocOffloadThreads());
+}
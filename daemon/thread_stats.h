@@ -42,6 +42,7 @@ struct HighResolutionThreadStats {
         cmd_subdoc_lookup = 0;
         cmd_subdoc_mutation = 0;
         subdoc_offload_count = 0;
+        subdoc_frontend_execute_time = 0;
         cmd_lock = 0;
         lock_errors = 0;
         subdoc_update_races = 0;
@@ -75,6 +76,7 @@ struct HighResolutionThreadStats {
         cmd_subdoc_lookup += other.cmd_subdoc_lookup;
         cmd_subdoc_mutation += other.cmd_subdoc_mutation;
         subdoc_offload_count += other.subdoc_offload_count;
+        subdoc_frontend_execute_time += other.subdoc_frontend_execute_time;
 
         cmd_lock += other.cmd_lock;
         lock_errors += other.lock_errors;
@@ -117,8 +119,10 @@ struct HighResolutionThreadStats {
     cb::RelaxedAtomic<uint64_t> cmd_subdoc_lookup;
     /* # of subdoc mutation commands */
     cb::RelaxedAtomic<uint64_t> cmd_subdoc_mutation;
-    /// The number of subdoc operations run on NonIO threads
+    /// The number of subdoc operations run on the subdoc worker pool
     cb::RelaxedAtomic<uint64_t> subdoc_offload_count;
+    /// The time (in usec) front end threads spent executing subdoc specs
+    cb::RelaxedAtomic<uint64_t> subdoc_frontend_execute_time;
 
     /** # of lock commands */
     cb::RelaxedAtomic<uint64_t> cmd_lock;
@@ -16,13 +16,17 @@
 #include "item.h"
 #include "kvstore/kvstore_config.h"
 #include "kvstore/kvstore_iface.h"
+#include "kvstore/kvstore_op_trace.h"
 #include "kvstore/kvstore_transaction_context.h"
 #include "tests/module_tests/test_helpers.h"
 #include "vb_commit.h"
+#include "vbucket_bgfetch_item.h"
 #include "vbucket_state.h"
 #include <benchmark/benchmark.h>
 #include <executor/workload.h>
+#include <fmt/format.h>
 #include <folly/portability/GTest.h>
+#include <hdrhistogram/hdrhistogram.h>
 #include <platform/dirutils.h>
 #include <programs/engine_testapp/mock_server.h>
 
@@ -32,7 +36,10 @@ enum Storage {
     COUCHSTORE = 0
 #ifdef EP_USE_MAGMA
     ,
-    MAGMA
+    MAGMA,
+    // NexusKVStore running couchstore as the primary and magma as the
+    // secondary (comparing the results of each operation)
+    NEXUS
 #endif
 };
 
@@ -94,6 +101,12 @@ protected:
             config.parseConfiguration(configStr + ";backend=magma");
             break;
         }
+        case NEXUS: {
+            state.SetLabel("Nexus");
+            config.parseConfiguration(configStr + ";backend=nexus" +
+                                      generateNexusConfig("couchstore_magma"));
+            break;
+        }
 #endif
         }
         WorkLoadPolicy workload(
@@ -138,17 +151,22 @@ protected:
         std::filesystem::remove_all(kvstoreConfig->getDBName());
     }
 
-private:
-    std::unique_ptr<KVStoreIface> setup_kv_store(KVStoreConfig& config) {
-        auto kvstore = KVStoreFactory::create(config, {}, {});
+    /// Create the given vBucket (in active state) in the KVStore
+    void createVBucket(KVStoreIface& store, Vbid vb) {
         Collections::VB::Manifest m{std::make_shared<Collections::Manager>()};
         VB::Commit meta(m);
         meta.proposedVBState.transition.state = vbucket_state_active;
-        if (!kvstore->snapshotVBucket(vbid, meta)) {
+        if (!store.snapshotVBucket(vb, meta)) {
             throw std::runtime_error(
                     "Could not persist vbstate, benchmark "
                     "cannot continue");
         }
+    }
+
+private:
+    std::unique_ptr<KVStoreIface> setup_kv_store(KVStoreConfig& config) {
+        auto kvstore = KVStoreFactory::create(config, {}, {});
+        createVBucket(*kvstore, vbid);
         return kvstore;
     }
 
@@ -197,6 +215,271 @@ BENCHMARK_DEFINE_F(KVStoreBench, GetAggrDbFileInfo)(benchmark::State& state) {
     }
 }
 
+/**
+ * Drives a KVStore with the operations of a KVStore operation trace (as
+ * recorded by RecordingKVStore) and tracks the latency of each operation type.
+ *
+ * Only the shape of the original operations is available in a trace, so keys
+ * are synthesised from the recorded key hash (preserving key re-use) and values
+ * are filled to the recorded size. Trace vBuckets are remapped onto vBuckets
+ * owned by the KVStore under test. Compactions cannot be replayed without a
+ * VBucket object and are counted as skipped.
+ */
+class KVStoreTraceReplayer {
+public:
+    using Callback = std::function<void(Vbid)>;
+
+    KVStoreTraceReplayer(KVStoreIface& kvstore, Callback createVBucket)
+        : kvstore(kvstore), createVBucket(std::move(createVBucket)) {
+    }
+
+    void replay(const std::vector<KVStoreOpTraceRecord>& trace) {
+        for (const auto& rec : trace) {
+            if (rec.op == KVStoreOp::GetMultiKey) {
+                // Accumulated here and timed as part of the following GetMulti
+                addToGetMulti(rec);
+                continue;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            if (replayOne(rec)) {
+                latency[static_cast<size_t>(rec.op)].add(
+                        std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - start));
+                ++replayed;
+            } else {
+                ++skipped;
+            }
+        }
+    }
+
+    /// Add throughput and per-operation latency counters to the state
+    void report(benchmark::State& state) const {
+        state.counters["ops_skipped"] = double(skipped);
+        for (size_t ii = 0; ii < latency.size(); ++ii) {
+            const auto& histo = latency[ii];
+            if (histo.getValueCount() == 0) {
+                continue;
+            }
+            const auto name = format_as(static_cast<KVStoreOp>(ii));
+            state.counters[name] = benchmark::Counter(
+                    double(histo.getValueCount()),
+                    benchmark::Counter::kIsRate);
+            state.counters[name + "_p50_us"] =
+                    double(histo.getValueAtPercentile(50.0));
+            state.counters[name + "_p99_us"] =
+                    double(histo.getValueAtPercentile(99.0));
+            state.counters[name + "_max_us"] = double(histo.getMaxValue());
+        }
+    }
+
+    size_t getReplayed() const {
+        return replayed;
+    }
+
+private:
+    struct VBucketReplayState {
+        Vbid vbid;
+        uint64_t seqno{0};
+        std::unique_ptr<TransactionContext> txn;
+    };
+
+    VBucketReplayState& getVBucket(uint16_t traceVbid) {
+        auto itr = vbuckets.find(traceVbid);
+        if (itr != vbuckets.end()) {
+            return itr->second;
+        }
+        // Map trace vBuckets onto the vBuckets owned by shard 0
+        const auto& config = kvstore.getConfig();
+        const auto perShard = config.getMaxVBuckets() / config.getMaxShards();
+        const Vbid vb(gsl::narrow_cast<Vbid::id_type>(
+                (vbuckets.size() % perShard) * config.getMaxShards()));
+        createVBucket(vb);
+        auto& state = vbuckets[traceVbid];
+        state.vbid = vb;
+        state.seqno = kvstore.getLastPersistedSeqno(vb);
+        return state;
+    }
+
+    StoredDocKey makeKey(const KVStoreOpTraceRecord& rec) const {
+        auto key = fmt::format("{:016x}", rec.keyHash);
+        // The recorded size includes the collection prefix
+        key.resize(std::clamp(size_t(rec.keySize), key.size(), size_t(250)),
+                   'k');
+        return makeStoredDocKey(key);
+    }
+
+    TransactionContext& getTransaction(VBucketReplayState& vb) {
+        if (!vb.txn) {
+            vb.txn = kvstore.begin(vb.vbid);
+        }
+        return *vb.txn;
+    }
+
+    void addToGetMulti(const KVStoreOpTraceRecord& rec) {
+        vb_bgfetch_item_ctx_t ctx;
+        ctx.addBgFetch(std::make_unique<FrontEndBGFetchItem>(
+                nullptr, ValueFilter::VALUES_DECOMPRESSED, 0));
+        pendingGetMulti[DiskDocKey{makeKey(rec)}] = std::move(ctx);
+    }
+
+    bool replayOne(const KVStoreOpTraceRecord& rec) {
+        auto& vb = getVBucket(rec.vbid);
+        switch (rec.op) {
+        case KVStoreOp::Begin:
+            vb.txn = kvstore.begin(vb.vbid);
+            return true;
+        case KVStoreOp::Set: {
+            auto qi = makeCommittedItem(
+                    makeKey(rec), std::string(rec.valueSize, 'v'), vb.vbid);
+            qi->setBySeqno(++vb.seqno);
+            kvstore.set(getTransaction(vb), qi);
+            return true;
+        }
+        case KVStoreOp::Del: {
+            auto qi = makeDeletedItem(makeKey(rec));
+            qi->setVBucketId(vb.vbid);
+            qi->setBySeqno(++vb.seqno);
+            kvstore.del(getTransaction(vb), qi);
+            return true;
+        }
+        case KVStoreOp::Commit: {
+            Collections::VB::Manifest m{
+                    std::make_shared<Collections::Manager>()};
+            VB::Commit commit(m);
+            commit.proposedVBState.transition.state = vbucket_state_active;
+            commit.proposedVBState.lastSnapStart = vb.seqno;
+            commit.proposedVBState.lastSnapEnd = vb.seqno;
+            getTransaction(vb);
+            return kvstore.commit(std::move(vb.txn), commit);
+        }
+        case KVStoreOp::Get:
+            kvstore.get(DiskDocKey{makeKey(rec)}, vb.vbid);
+            return true;
+        case KVStoreOp::GetMultiKey:
+            // Handled by replay()
+            return false;
+        case KVStoreOp::GetMulti:
+            kvstore.getMulti(vb.vbid,
+                             pendingGetMulti,
+                             KVStoreIface::getDefaultCreateItemCallback());
+            pendingGetMulti.clear();
+            return true;
+        case KVStoreOp::ScanBySeqno:
+        case KVStoreOp::ScanById: {
+            // Both are replayed as a full by-seqno scan of the vBucket, the
+            // trace does not capture the scanned key ranges.
+            auto scanContext = kvstore.initBySeqnoScanContext(
+                    std::make_unique<MockDiskCallback>(),
+                    std::make_unique<MockCacheCallback>(),
+                    vb.vbid,
+                    0,
+                    DocumentFilter::ALL_ITEMS,
+                    ValueFilter::VALUES_COMPRESSED,
+                    SnapshotSource::Head);
+            return scanContext &&
+                   kvstore.scan(*scanContext) == ScanStatus::Success;
+        }
+        case KVStoreOp::Compact:
+            return false;
+        }
+        return false;
+    }
+
+    KVStoreIface& kvstore;
+    Callback createVBucket;
+    std::unordered_map<uint16_t, VBucketReplayState> vbuckets;
+    vb_bgfetch_queue_t pendingGetMulti;
+    size_t replayed{0};
+    size_t skipped{0};
+    std::array<Hdr1sfMicroSecHistogram,
+               size_t(KVStoreOp::Compact) + 1>
+            latency;
+};
+
+/**
+ * Generate a synthetic trace: batches of sets (with some overwrites and
+ * deletes) committed to a handful of vBuckets, followed by bgfetch batches
+ * and a scan of each vBucket.
+ */
+static std::vector<KVStoreOpTraceRecord> makeSyntheticTrace(size_t numItems) {
+    std::vector<KVStoreOpTraceRecord> trace;
+    const size_t numVBuckets = 4;
+    const size_t batchSize = 250;
+    auto add = [&trace](KVStoreOp op, size_t vb, uint64_t key, uint32_t size) {
+        KVStoreOpTraceRecord rec;
+        rec.op = op;
+        rec.vbid = gsl::narrow_cast<uint16_t>(vb);
+        rec.keyHash = key;
+        rec.keySize = key ? 20 : 0;
+        rec.valueSize = size;
+        trace.push_back(rec);
+    };
+
+    for (size_t ii = 0; ii < numItems; ii += batchSize) {
+        const auto vb = (ii / batchSize) % numVBuckets;
+        add(KVStoreOp::Begin, vb, 0, 0);
+        for (size_t jj = ii; jj < std::min(numItems, ii + batchSize); ++jj) {
+            // Every 10th mutation is a delete of an earlier key
+            if (jj % 10 == 9) {
+                add(KVStoreOp::Del, vb, jj - 5, 0);
+            } else {
+                add(KVStoreOp::Set, vb, jj, 512 + uint32_t(jj % 1024));
+            }
+        }
+        add(KVStoreOp::Commit, vb, 0, 0);
+    }
+
+    for (size_t ii = 0; ii < numItems; ii += 16) {
+        const auto vb = (ii / batchSize) % numVBuckets;
+        for (size_t jj = ii; jj < std::min(numItems, ii + 16); ++jj) {
+            add(KVStoreOp::GetMultiKey, vb, jj, 0);
+        }
+        add(KVStoreOp::GetMulti, vb, 0, 0);
+    }
+
+    for (size_t vb = 0; vb < numVBuckets; ++vb) {
+        add(KVStoreOp::ScanBySeqno, vb, 0, 0);
+    }
+    return trace;
+}
+
+/*
+ * Benchmark replaying a KVStore operation trace. The trace is read from the
+ * file named by the KVSTORE_REPLAY_TRACE environment variable (see the
+ * kvstore_op_trace_file configuration parameter), otherwise a synthetic
+ * trace is generated.
+ */
+BENCHMARK_DEFINE_F(KVStoreBench, Replay)(benchmark::State& state) {
+    std::vector<KVStoreOpTraceRecord> trace;
+    if (const char* path = std::getenv("KVSTORE_REPLAY_TRACE")) {
+        trace = KVStoreOpTraceReader(path).readAll();
+    } else {
+        trace = makeSyntheticTrace(state.range(2));
+    }
+
+    size_t replayed = 0;
+    for (auto _ : state) {
+        // Each iteration replays into a fresh KVStore so that every
+        // iteration sees the same starting state.
+        state.PauseTiming();
+        kvstore.reset();
+        std::filesystem::remove_all(kvstoreConfig->getDBName());
+        std::filesystem::create_directories(kvstoreConfig->getDBName());
+        kvstore = KVStoreFactory::create(*kvstoreConfig, {}, {});
+        KVStoreTraceReplayer replayer(
+                *kvstore, [this](Vbid vb) { createVBucket(*kvstore, vb); });
+        state.ResumeTiming();
+
+        replayer.replay(trace);
+
+        state.PauseTiming();
+        replayed += replayer.getReplayed();
+        replayer.report(state);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(replayed);
+}
+
 const int NUM_ITEMS = 100000;
 
 BENCHMARK_REGISTER_F(KVStoreBench, Scan)
@@ -211,4 +494,12 @@ BENCHMARK_REGISTER_F(KVStoreBench, GetAggrDbFileInfo)
 #ifdef EP_USE_MAGMA
         ->Args({NUM_ITEMS, MAGMA})
 #endif
-        ;
\ No newline at end of file
+        ;
+
+BENCHMARK_REGISTER_F(KVStoreBench, Replay)
+        ->Args({0, COUCHSTORE, NUM_ITEMS})
+#ifdef EP_USE_MAGMA
+        ->Args({0, MAGMA, NUM_ITEMS})
+        ->Args({0, NEXUS, NUM_ITEMS})
+#endif
+        ->Unit(benchmark::kMillisecond);
@@ -114,6 +114,25 @@ cb::engine_errc ConnHandler::mutation(uint32_t opaque,
     return cb::engine_errc::disconnect;
 }
 
+cb::engine_errc ConnHandler::mutation_patch(CookieIface& cookie,
+                                            uint32_t opaque,
+                                            const DocKeyView& key,
+                                            cb::const_byte_buffer patch,
+                                            uint8_t datatype,
+                                            uint64_t cas,
+                                            Vbid vbucket,
+                                            uint32_t flags,
+                                            uint64_t by_seqno,
+                                            uint64_t rev_seqno,
+                                            uint32_t expiration,
+                                            uint32_t lock_time,
+                                            uint8_t nru) {
+    logger->warn(
+            "Disconnecting - This connection doesn't "
+            "support the mutation_patch API");
+    return cb::engine_errc::disconnect;
+}
+
 cb::engine_errc ConnHandler::deletion(uint32_t opaque,
                                       const DocKeyView& key,
                                       cb::const_byte_buffer value,
@@ -133,6 +133,25 @@ public:
                                      uint32_t lock_time,
                                      uint8_t nru);
 
+    /**
+     * A Mutation sent as a patch (DcpMutationPatch). The cookie is the one
+     * of the message, used if the base of the patch has to be read from
+     * disk first.
+     */
+    virtual cb::engine_errc mutation_patch(CookieIface& cookie,
+                                           uint32_t opaque,
+                                           const DocKeyView& key,
+                                           cb::const_byte_buffer patch,
+                                           uint8_t datatype,
+                                           uint64_t cas,
+                                           Vbid vbucket,
+                                           uint32_t flags,
+                                           uint64_t by_seqno,
+                                           uint64_t rev_seqno,
+                                           uint32_t expiration,
+                                           uint32_t lock_time,
+                                           uint8_t nru);
+
     virtual cb::engine_errc deletion(uint32_t opaque,
                                      const DocKeyView& key,
                                      cb::const_byte_buffer value,
@@ -15,6 +15,7 @@
 #include "checkpoint_manager.h"
 #include "configuration.h"
 #include "dcp/backfill-manager.h"
+#include "dcp/delta_mutation_cache.h"
 #include "dcp/producer.h"
 #include "dcp/response.h"
 #include "ep_time.h"
@@ -101,6 +102,7 @@ ActiveStream::ActiveStream(EventuallyPersistentEngine* e,
                                     : ForceValueCompression::No),
       syncReplication(p->getSyncReplSupport()),
       flatBuffersSystemEventsEnabled(p->areFlatBuffersSystemEventsEnabled()),
+      deltaMutationCache(p->getDeltaMutationCache(vbucket.getId())),
       filter(std::move(f)),
       changeStreamsEnabled(p->areChangeStreamsEnabled()),
       endSeqno(en_seqno),
@@ -1305,6 +1307,9 @@ std::unique_ptr<DcpResponse> ActiveStream::makeResponseFromItem(
     if ((item->getOperation() == queue_op::commit_sync_write) &&
         (supportSyncWrites()) &&
         sendCommitSyncWriteAs == SendCommitSyncWriteAs::Commit) {
+        if (deltaMutationCache) {
+            deltaMutationCache->erase(*item);
+        }
         return std::make_unique<CommitSyncWrite>(opaque_,
                                                  item->getVBucketId(),
                                                  item->getPrepareSeqno(),
@@ -1385,21 +1390,11 @@ std::unique_ptr<DcpResponse> ActiveStream::makeResponseFromItem(
             /**
              * Create a mutation response to be placed in the ready queue.
              */
-            return std::make_unique<MutationResponse>(std::move(finalItem),
-                                                      opaque_,
-                                                      includeDeleteTime,
-                                                      includeCollectionID,
-                                                      enableExpiryOutput,
-                                                      sid);
+            return makeMutationResponse(std::move(finalItem));
         }
 
         // Item unmodified - construct response from original.
-        return std::make_unique<MutationResponse>(item,
-                                                  opaque_,
-                                                  includeDeleteTime,
-                                                  includeCollectionID,
-                                                  enableExpiryOutput,
-                                                  sid);
+        return makeMutationResponse(item);
     }
 
     if (flatBuffersSystemEventsEnabled) {
@@ -1409,6 +1404,36 @@ std::unique_ptr<DcpResponse> ActiveStream::makeResponseFromItem(
     return SystemEventProducerMessage::make(opaque_, item, sid);
 }
 
+std::unique_ptr<DcpResponse> ActiveStream::makeMutationResponse(
+        queued_item item) {
+    if (deltaMutationCache) {
+        // The consumer's copy of the document is only the value kept in the
+        // cache if the key was last sent as a Mutation
+        if (MutationResponse::eventFromItem(*item) ==
+            DcpResponse::Event::Mutation) {
+            const auto patch = deltaMutationCache->makePatch(opaque_, *item);
+            if (patch) {
+                return std::make_unique<MutationPatchResponse>(
+                        std::move(item),
+                        opaque_,
+                        includeDeleteTime,
+                        includeCollectionID,
+                        enableExpiryOutput,
+                        sid,
+                        *patch);
+            }
+        } else {
+            deltaMutationCache->erase(*item);
+        }
+    }
+    return std::make_unique<MutationResponse>(std::move(item),
+                                              opaque_,
+                                              includeDeleteTime,
+                                              includeCollectionID,
+                                              enableExpiryOutput,
+                                              sid);
+}
+
 void ActiveStream::processItemsInner(
         const std::lock_guard<std::mutex>& lg,
         OutstandingItemsResult& outstandingItemsResult) {
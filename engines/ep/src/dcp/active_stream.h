@@ -27,6 +27,7 @@ enum class DcpSnapshotMarkerFlag : uint32_t;
 
 class BackfillManager;
 class Configuration;
+class DeltaMutationCache;
 class CheckpointManager;
 class VBucket;
 enum class ValueFilter;
@@ -630,6 +631,13 @@ protected:
     std::unique_ptr<DcpResponse> makeResponseFromItem(
             queued_item& item, SendCommitSyncWriteAs sendCommitSyncWriteAs);
 
+    /**
+     * Create the MutationResponse to send the (final) item with, which is
+     * a MutationPatchResponse if the producer sends delta mutations and
+     * the value is a small change of the value sent for the key before.
+     */
+    std::unique_ptr<DcpResponse> makeMutationResponse(queued_item item);
+
     /* The transitionState function is protected (as opposed to private) for
      * testing purposes.
      */
@@ -1021,6 +1029,10 @@ private:
     /// Does this stream send system-events with a FlatBuffers value?
     const bool flatBuffersSystemEventsEnabled{false};
 
+    /// The values sent by the producer, used to send Mutations as patches
+    /// (nullptr unless delta mutations are enabled)
+    const std::shared_ptr<DeltaMutationCache> deltaMutationCache;
+
     /**
      * The filter the stream will use to decide which keys should be transmitted
      */
@@ -214,6 +214,10 @@ DcpConsumer::DcpConsumer(EventuallyPersistentEngine& engine,
         cacheTransfer = true;
     });
 
+    controls->emplace_back(DcpControlKeys::DeltaMutations, "true", [this]() {
+        deltaMutations = true;
+    });
+
     // MB-68753: Pause the consumer so subsequent scheduleNotify will wake the
     // consumer and the connection will get callbacks from ConnManager::run
     pause(PausedReason::ReadyListEmpty);
@@ -488,11 +492,40 @@ cb::engine_errc DcpConsumer::streamEnd(uint32_t opaque,
         // Stream End message successfully passed to stream. Can now remove
         // the stream from the streams map as it has completed its lifetime.
         removeStream(vbucket);
+        if (stream->isPatchResyncPending() &&
+            status == cb::mcbp::DcpStreamEndStatus::Closed) {
+            restartStreamForPatchResync(*stream);
+        }
     }
 
     return res;
 }
 
+void DcpConsumer::restartStreamForPatchResync(const PassiveStream& ended) {
+    const auto vbucket = ended.getVBucket();
+    OBJ_LOG_INFO_CTX(*logger,
+                     "Requesting the stream again as a mutation patch didn't "
+                     "match our copy of the document",
+                     {"vb", vbucket});
+
+    // The new stream starts after the last seqno processed. The producer
+    // sends complete values on it (patches need a value sent on the same
+    // stream), and a cache transfer is only done once.
+    const auto flags =
+            ended.getFlags() & ~cb::mcbp::DcpAddStreamFlag::CacheTransfer;
+    const auto status = doAddStream(0 /*opaque*/, vbucket, flags);
+    if (status != cb::engine_errc::success) {
+        OBJ_LOG_WARN_CTX(*logger,
+                         "Failed to request the stream again",
+                         {"vb", vbucket},
+                         {"status", cb::to_string(status)});
+        return;
+    }
+
+    // ns_server didn't add the stream so it doesn't expect a response
+    findStream(vbucket)->disableAddStreamResponse();
+}
+
 cb::engine_errc DcpConsumer::processMutationOrPrepare(Vbid vbucket,
                                                       uint32_t opaque,
                                                       const DocKeyView& key,
@@ -550,6 +583,96 @@ cb::engine_errc DcpConsumer::mutation(uint32_t opaque,
             MutationResponse::mutationBaseMsgBytes + key.size() + value.size());
 }
 
+cb::engine_errc DcpConsumer::mutation_patch(CookieIface& cookie,
+                                            uint32_t opaque,
+                                            const DocKeyView& key,
+                                            cb::const_byte_buffer patch,
+                                            uint8_t datatype,
+                                            uint64_t cas,
+                                            Vbid vbucket,
+                                            uint32_t flags,
+                                            uint64_t bySeqno,
+                                            uint64_t revSeqno,
+                                            uint32_t exptime,
+                                            uint32_t lock_time,
+                                            uint8_t nru) {
+    using cb::mcbp::request::DcpMutationPatchHeader;
+    lastMessageTime = ep_uptime_now();
+
+    if (!deltaMutations) {
+        OBJ_LOG_WARN_CTX(*logger,
+                         "Received a mutation patch without enabling "
+                         "delta_mutations",
+                         {"vb", vbucket});
+        return cb::engine_errc::invalid_arguments;
+    }
+    if (bySeqno == 0) {
+        OBJ_LOG_WARN_CTX(*logger,
+                         "Invalid sequence number (0) for mutation patch!",
+                         {"vb", vbucket});
+        return cb::engine_errc::invalid_arguments;
+    }
+    if (cb::mcbp::datatype::is_snappy(datatype)) {
+        // The patch is a byte range of the uncompressed value, and the
+        // producer never compresses it
+        OBJ_LOG_WARN_CTX(*logger,
+                         "Received a compressed mutation patch",
+                         {"vb", vbucket},
+                         {"seqno", bySeqno});
+        return cb::engine_errc::invalid_arguments;
+    }
+    if (patch.size() < sizeof(DcpMutationPatchHeader)) {
+        return cb::engine_errc::invalid_arguments;
+    }
+
+    const auto& header =
+            *reinterpret_cast<const DcpMutationPatchHeader*>(patch.data());
+    const auto insert = patch.subspan(sizeof(DcpMutationPatchHeader));
+
+    // The item holds the bytes to insert until the patch is applied
+    queued_item item(new Item(key,
+                              flags,
+                              exptime,
+                              insert.data(),
+                              insert.size(),
+                              datatype,
+                              cas,
+                              bySeqno,
+                              vbucket,
+                              revSeqno,
+                              nru /*freqCounter */));
+
+    const auto msgBytes =
+            MutationResponse::mutationBaseMsgBytes + key.size() + patch.size();
+
+    // The patch is applied to the replica's copy of the document before
+    // the message is passed to the stream, as reading the copy from disk
+    // blocks the message (memcached retries it once the copy is fetched).
+    // If the stream can't take the message the stream reports why.
+    auto stream = findStream(vbucket);
+    if (stream && stream->getOpaque() == opaque && stream->isActive()) {
+        const auto status = stream->applyMutationPatch(
+                cookie,
+                *item,
+                MutationPatch{header.getBaseCas(),
+                              header.getOffset(),
+                              header.getRemoveLength(),
+                              uint32_t(insert.size())});
+        if (status == cb::engine_errc::would_block) {
+            return status;
+        }
+        if (status != cb::engine_errc::success) {
+            // The stream stopped, and the error response makes the producer
+            // end it (see PassiveStream::applyMutationPatch)
+            UpdateFlowControl ufc(*this, msgBytes);
+            return status;
+        }
+    }
+
+    return processMutationOrPrepare(
+            vbucket, opaque, key, std::move(item), msgBytes);
+}
+
 cb::engine_errc DcpConsumer::deletion(uint32_t opaque,
                                       const DocKeyView& key,
                                       cb::const_byte_buffer value,
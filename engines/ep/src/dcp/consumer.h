@@ -185,6 +185,20 @@ public:
                              uint32_t lock_time,
                              uint8_t nru) override;
 
+    cb::engine_errc mutation_patch(CookieIface& cookie,
+                                   uint32_t opaque,
+                                   const DocKeyView& key,
+                                   cb::const_byte_buffer patch,
+                                   uint8_t datatype,
+                                   uint64_t cas,
+                                   Vbid vbucket,
+                                   uint32_t flags,
+                                   uint64_t bySeqno,
+                                   uint64_t revSeqno,
+                                   uint32_t exptime,
+                                   uint32_t lock_time,
+                                   uint8_t nru) override;
+
     cb::engine_errc deletion(uint32_t opaque,
                              const DocKeyView& key,
                              cb::const_byte_buffer value,
@@ -403,6 +417,13 @@ public:
         return cacheTransfer;
     }
 
+    /**
+     * @return true if our producer may send Mutations as patches.
+     */
+    bool areDeltaMutationsEnabled() const {
+        return deltaMutations;
+    }
+
 protected:
     /**
      * Records when the consumer last received a message from producer.
@@ -571,6 +592,13 @@ protected:
                                 Vbid vbucket,
                                 cb::mcbp::DcpAddStreamFlag flags);
 
+    /**
+     * Request a stream again after the producer ended it because the
+     * stream stopped on a mutation patch which didn't match our copy of
+     * the document (see PassiveStream::applyMutationPatch).
+     */
+    void restartStreamForPatchResync(const PassiveStream& ended);
+
     /**
      * The container of DCP control negotiations. BlockingDcpControlNegotiation
      * objects are added by construction and can even be added by the success or
@@ -643,6 +671,10 @@ protected:
     // transfer is available.
     bool cacheTransfer = false;
 
+    // True if the DCP consumer has negotiated with the producer that
+    // Mutations may be sent as patches (DcpMutationPatch).
+    bool deltaMutations = false;
+
     // Sync Replication: The identifier the consumer should to identify itself
     // to the producer.
     const std::string consumerName;
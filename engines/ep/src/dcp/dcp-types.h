@@ -175,6 +175,20 @@ enum class MarkerVersion {
 
 std::string to_string(MarkerVersion);
 
+/**
+ * The description of a Mutation sent as a patch (DcpMutationPatch): the new
+ * value is the value with the CAS baseCas with removeLength bytes at offset
+ * replaced with the insertLength bytes at offset in the new value.
+ */
+struct MutationPatch {
+    uint64_t baseCas = 0;
+    uint32_t offset = 0;
+    uint32_t removeLength = 0;
+    uint32_t insertLength = 0;
+
+    bool operator==(const MutationPatch&) const = default;
+};
+
 // See docs/dcp/documentation/commands/control.md for more information on
 // control keys.
 namespace DcpControlKeys {
@@ -207,4 +221,5 @@ constexpr std::string_view ChangeStreams = "change_streams"sv;
 constexpr std::string_view EnableSyncWrites = "enable_sync_writes"sv;
 constexpr std::string_view SnapshotMaxMarkerVersion = "max_marker_version"sv;
 constexpr std::string_view CacheTransfer = "cache_transfer"sv;
+constexpr std::string_view DeltaMutations = "delta_mutations"sv;
 } // namespace DcpControlKeys
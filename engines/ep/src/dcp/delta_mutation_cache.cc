@@ -0,0 +1,110 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "delta_mutation_cache.h"
+
+#include "item.h"
+
+#include <mcbp/protocol/datatype.h>
+#include <memcached/protocol_binary.h>
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
+DeltaMutationCache::DeltaMutationCache(size_t maxSize) : maxSize(maxSize) {
+}
+
+std::string DeltaMutationCache::makeKey(const Item& item) {
+    const auto vbid = item.getVBucketId().get();
+    std::string ret(reinterpret_cast<const char*>(&vbid), sizeof(vbid));
+    const auto key = item.getKey();
+    ret.append(reinterpret_cast<const char*>(key.data()), key.size());
+    return ret;
+}
+
+std::optional<MutationPatch> DeltaMutationCache::makePatch(uint32_t opaque,
+                                                           const Item& item) {
+    const auto& value = item.getValue();
+    if (!value || item.getNBytes() < MinValueSize ||
+        cb::mcbp::datatype::is_snappy(item.getDataType()) ||
+        item.getNBytes() > maxSize) {
+        erase(item);
+        return std::nullopt;
+    }
+
+    const std::string_view next{item.getData(), item.getNBytes()};
+    auto key = makeKey(item);
+    auto locked = state.lock();
+
+    std::optional<MutationPatch> ret;
+    auto iter = locked->entries.find(key);
+    if (iter != locked->entries.end()) {
+        auto& entry = iter->second;
+        if (entry.opaque == opaque) {
+            const std::string_view base{entry.value->getData(),
+                                        entry.value->valueSize()};
+            // The common prefix and suffix of the values
+            const auto shortest = std::min(base.size(), next.size());
+            const auto prefix =
+                    std::mismatch(base.begin(),
+                                  base.begin() + shortest,
+                                  next.begin())
+                            .first -
+                    base.begin();
+            const auto suffix =
+                    std::mismatch(base.rbegin(),
+                                  base.rbegin() + (shortest - prefix),
+                                  next.rbegin())
+                            .first -
+                    base.rbegin();
+            const auto insert = next.size() - prefix - suffix;
+            // Only worth it if the patch is a fraction of the value
+            if (sizeof(cb::mcbp::request::DcpMutationPatchHeader) + insert <
+                next.size() / 2) {
+                ret = MutationPatch{entry.cas,
+                                    uint32_t(prefix),
+                                    uint32_t(base.size() - prefix - suffix),
+                                    uint32_t(insert)};
+                ++patchesSent;
+                bytesSaved += next.size() - insert;
+            }
+        }
+        locked->size -= entry.value->valueSize();
+        entry = Entry{opaque, item.getCas(), value};
+        locked->size += next.size();
+    } else {
+        locked->entries.set(std::move(key),
+                            Entry{opaque, item.getCas(), value});
+        locked->size += next.size();
+    }
+
+    while (locked->size > maxSize && !locked->entries.empty()) {
+        auto lru = std::prev(locked->entries.end());
+        locked->size -= lru->second.value->valueSize();
+        locked->entries.erase(lru);
+    }
+    return ret;
+}
+
+void DeltaMutationCache::erase(const Item& item) {
+    auto locked = state.lock();
+    if (locked->entries.empty()) {
+        return;
+    }
+    auto iter = locked->entries.findWithoutPromotion(makeKey(item));
+    if (iter != locked->entries.end()) {
+        locked->size -= iter->second.value->valueSize();
+        locked->entries.erase(iter);
+    }
+}
+
+size_t DeltaMutationCache::getSize() const {
+    return state.lock()->size;
+}
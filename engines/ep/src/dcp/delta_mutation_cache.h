@@ -0,0 +1,97 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "blob.h"
+#include "dcp/dcp-types.h"
+
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+class Item;
+
+/**
+ * The DeltaMutationCache keeps the value of the most recent Mutations a
+ * DcpProducer sent for each key (bounded by the total size of the values)
+ * so that the next Mutation of a key may be sent as a patch against the
+ * previous value (DcpMutationPatch) instead of the complete value. This
+ * is what makes a small sub-document update of a large document cheap to
+ * replicate.
+ *
+ * The consumer applies the patch to its copy of the document after
+ * verifying the CAS of its copy is the base CAS of the patch.
+ */
+class DeltaMutationCache {
+public:
+    /// Values smaller than this are always sent in full
+    static constexpr size_t MinValueSize = 1024;
+
+    /// @param maxSize the max total size of the values kept
+    explicit DeltaMutationCache(size_t maxSize);
+
+    /**
+     * Compute the patch to send for the (uncompressed, alive) item instead
+     * of its complete value, and keep the value of the item as the base of
+     * the next Mutation of the key.
+     *
+     * @param opaque The opaque of the stream sending the item (the values
+     *               sent on a different stream can't be used as the base)
+     * @param item The item to send
+     * @return The patch if it is worth sending instead of the value
+     */
+    std::optional<MutationPatch> makePatch(uint32_t opaque, const Item& item);
+
+    /**
+     * Forget the value kept for the key of the item (for when the item is
+     * sent as anything but a Mutation, so the consumer's copy of the
+     * document is no longer the value kept)
+     */
+    void erase(const Item& item);
+
+    /// The total size of the values kept
+    size_t getSize() const;
+
+    /// The number of Mutations sent as patches
+    size_t getPatchesSent() const {
+        return patchesSent;
+    }
+
+    /// The number of value bytes saved by sending patches
+    size_t getBytesSaved() const {
+        return bytesSaved;
+    }
+
+protected:
+    struct Entry {
+        uint32_t opaque;
+        uint64_t cas;
+        value_t value;
+    };
+
+    struct State {
+        /// The values kept in LRU order
+        folly::EvictingCacheMap<std::string, Entry> entries{0};
+        size_t size = 0;
+    };
+
+    /// The key of the item in the cache (vbucket and document key)
+    static std::string makeKey(const Item& item);
+
+    const size_t maxSize;
+    folly::Synchronized<State, std::mutex> state;
+    std::atomic<size_t> patchesSent{0};
+    std::atomic<size_t> bytesSaved{0};
+};
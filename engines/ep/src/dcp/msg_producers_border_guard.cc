@@ -112,6 +112,33 @@ cb::engine_errc DcpMsgProducersBorderGuard::mutation(
                             nru,
                             sid);
 }
+cb::engine_errc DcpMsgProducersBorderGuard::mutation_patch(
+        uint32_t opaque,
+        cb::unique_item_ptr itm,
+        Vbid vbucket,
+        uint64_t by_seqno,
+        uint64_t rev_seqno,
+        uint32_t lock_time,
+        uint8_t nru,
+        uint64_t base_cas,
+        uint32_t offset,
+        uint32_t remove_length,
+        uint32_t insert_length,
+        cb::mcbp::DcpStreamId sid) {
+    NonBucketAllocationGuard guard;
+    return guarded.mutation_patch(opaque,
+                                  std::move(itm),
+                                  vbucket,
+                                  by_seqno,
+                                  rev_seqno,
+                                  lock_time,
+                                  nru,
+                                  base_cas,
+                                  offset,
+                                  remove_length,
+                                  insert_length,
+                                  sid);
+}
 cb::engine_errc DcpMsgProducersBorderGuard::deletion(
         uint32_t opaque,
         cb::unique_item_ptr itm,
@@ -24,11 +24,14 @@
 #include "vbucket.h"
 
 #include <gsl/gsl-lite.hpp>
+#include <mcbp/protocol/datatype.h>
 #include <mcbp/protocol/json_utilities.h>
 #include <nlohmann/json.hpp>
+#include <platform/compress.h>
 #include <platform/json_log_conversions.h>
 #include <platform/optional.h>
 #include <statistics/cbstat_collector.h>
+#include <utilities/logtags.h>
 
 #include <memory>
 
@@ -127,6 +130,7 @@ void PassiveStream::streamRequest_UNLOCKED(const VBucket& vb,
 }
 
 void PassiveStream::setDead(cb::mcbp::DcpStreamEndStatus status) {
+    patchResyncPending = false;
     std::lock_guard<std::mutex> slh(streamMutex);
     if (transitionState(StreamState::Dead)) {
         const auto severity =
@@ -215,8 +219,10 @@ void PassiveStream::acceptStream(cb::mcbp::Status status, uint32_t add_opaque) {
 
     std::unique_lock<std::mutex> lh(streamMutex);
     if (isPending()) {
-        pushToReadyQ(std::make_unique<AddStreamResponse>(
-                add_opaque, opaque_, status));
+        if (sendAddStreamResponse) {
+            pushToReadyQ(std::make_unique<AddStreamResponse>(
+                    add_opaque, opaque_, status));
+        }
         if (status == cb::mcbp::Status::Success) {
             // Before we receive/process anything else, send a seqno ack if we
             // are a stream for a pre-existing vBucket to ensure that the
@@ -523,6 +529,111 @@ cb::engine_errc PassiveStream::processMessageInner(
     return ret;
 }
 
+/**
+ * Build the new value of a document by applying the patch to the value it
+ * was computed against.
+ *
+ * @return false if the patch doesn't fit in the base value
+ */
+static bool applyPatchToValue(std::string_view base,
+                              uint8_t baseDatatype,
+                              const MutationPatch& patch,
+                              std::string_view insert,
+                              std::string& value) {
+    cb::compression::Buffer inflated;
+    if (cb::mcbp::datatype::is_snappy(baseDatatype)) {
+        if (!cb::compression::inflateSnappy(base, inflated)) {
+            return false;
+        }
+        base = std::string_view{inflated};
+    }
+    if (patch.offset > base.size() ||
+        patch.removeLength > base.size() - patch.offset) {
+        return false;
+    }
+
+    value.reserve(base.size() - patch.removeLength + insert.size());
+    value.append(base.substr(0, patch.offset));
+    value.append(insert);
+    value.append(base.substr(patch.offset + patch.removeLength));
+    return true;
+}
+
+cb::engine_errc PassiveStream::applyMutationPatch(CookieIface& cookie,
+                                                  Item& item,
+                                                  const MutationPatch& patch) {
+    VBucketPtr vb = engine->getVBucket(vb_);
+    if (!vb) {
+        return cb::engine_errc::not_my_vbucket;
+    }
+
+    const std::string_view insert{item.getData(), item.getNBytes()};
+    std::string value;
+    bool applied = false;
+    bool fetch = false;
+    {
+        auto res = vb->ht.findForRead(item.getKey(),
+                                      TrackReference::No,
+                                      WantsDeleted::No,
+                                      ForGetReplicaOp::Yes);
+        const auto* sv = res.storedValue;
+        if (sv && !sv->isTempItem() && sv->isResident()) {
+            if (sv->getCas() == patch.baseCas) {
+                const auto& blob = sv->getValue();
+                std::string_view base;
+                if (blob) {
+                    base = {blob->getData(), blob->valueSize()};
+                }
+                applied = applyPatchToValue(
+                        base, sv->getDatatype(), patch, insert, value);
+            }
+        } else {
+            // The value was evicted (or with full eviction the whole
+            // document may be on disk only)
+            fetch = sv || engine->getKVBucket()->isFullEviction();
+        }
+    }
+
+    if (fetch) {
+        auto gv = engine->getKVBucket()->getReplica(
+                item.getKey(), vb_, &cookie, QUEUE_BG_FETCH);
+        if (gv.getStatus() == cb::engine_errc::would_block) {
+            // The value is restored into the HashTable and the cookie
+            // notified, and memcached then retries the message
+            return cb::engine_errc::would_block;
+        }
+        if (gv.getStatus() == cb::engine_errc::success &&
+            gv.item->getCas() == patch.baseCas) {
+            applied = applyPatchToValue(
+                    {gv.item->getData(), gv.item->getNBytes()},
+                    gv.item->getDataType(),
+                    patch,
+                    insert,
+                    value);
+        }
+    }
+
+    if (!applied) {
+        OBJ_LOG_WARN_CTX(
+                *this,
+                "PassiveStream::applyMutationPatch: Our copy of the document "
+                "isn't the base of the patch; Stopping the stream to stream "
+                "the vbucket again",
+                {"key", cb::UserDataView(item.getKey().to_string())},
+                {"base_cas", fmt::format("{:#x}", patch.baseCas)},
+                {"offset", patch.offset},
+                {"remove_length", patch.removeLength},
+                {"seqno", item.getBySeqno()},
+                {"last_seqno", last_seqno.load()});
+        setDead(cb::mcbp::DcpStreamEndStatus::Closed);
+        patchResyncPending = true;
+        return cb::engine_errc::key_already_exists;
+    }
+
+    item.setData(value.data(), value.size());
+    return cb::engine_errc::success;
+}
+
 void PassiveStream::seqnoAck(int64_t seqno) {
     // Only send a seqnoAck if we have an active stream that the producer has
     // responded with Success to the stream request
@@ -32,7 +32,9 @@ class CreateScopeEvent;
 class DropCollectionEvent;
 class DropScopeEvent;
 class EventuallyPersistentEngine;
+class Item;
 class MutationResponse;
+struct MutationPatch;
 class SystemEventMessage;
 class SystemEventConsumerMessage;
 class UpdateFlowControl;
@@ -94,6 +96,15 @@ public:
 
     void acceptStream(cb::mcbp::Status status, uint32_t add_opaque);
 
+    /**
+     * Don't send an AddStream response to ns_server when the stream is
+     * accepted, as the consumer requested the stream itself (see
+     * DcpConsumer::restartStreamForPatchResync).
+     */
+    void disableAddStreamResponse() {
+        sendAddStreamResponse = false;
+    }
+
     void reconnectStream(const VBucket& vb,
                          uint32_t new_opaque,
                          uint64_t start_seqno);
@@ -110,6 +121,32 @@ public:
     cb::engine_errc messageReceived(std::unique_ptr<DcpResponse> response,
                                     UpdateFlowControl& ackSize);
 
+    /**
+     * Replace the value of the item of a patch message (the bytes to insert)
+     * with the complete value of the document, by applying the patch to our
+     * copy of the document.
+     *
+     * If the copy was evicted it is read from disk first (and would_block
+     * returned). If the copy isn't the base of the patch the stream stops
+     * (ignoring the messages until the producer ends it), and the consumer
+     * streams the vbucket again when it receives the StreamEnd.
+     *
+     * @param cookie The cookie of the message (notified once the copy is
+     *        read from disk)
+     * @param item The item of the message
+     * @param patch The patch to apply
+     * @return success, would_block, or key_already_exists if our copy of
+     *         the document isn't the base of the patch
+     */
+    cb::engine_errc applyMutationPatch(CookieIface& cookie,
+                                       Item& item,
+                                       const MutationPatch& patch);
+
+    /// @returns true if the stream stopped as the base of a patch didn't match
+    bool isPatchResyncPending() const {
+        return patchResyncPending;
+    }
+
     void addStats(const AddStatFn& add_stat, CookieIface& c) override;
 
     /**
@@ -491,6 +528,13 @@ protected:
     // Flag indicating if the CacheTransfer has logged out of memory.
     bool hasLoggedCacheTransferOutOfMemory{false};
 
+    // Set when the stream stopped as our copy of a document wasn't the base
+    // of a mutation patch; cleared if the stream is closed
+    std::atomic<bool> patchResyncPending{false};
+
+    // False if the consumer (not ns_server) requested the stream
+    bool sendAddStreamResponse{true};
+
     nlohmann::json stream_req_value;
 
     // Set of states that the vbucket must match for a PassiveStream to attempt
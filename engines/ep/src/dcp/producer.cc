@@ -23,6 +23,7 @@
 #include "dcp/backfill-manager.h"
 #include "dcp/cache_transfer_stream.h"
 #include "dcp/dcpconnmap.h"
+#include "dcp/delta_mutation_cache.h"
 #include "dcp/producer_stream.h"
 #include "dcp/response.h"
 #include "ep_time.h"
@@ -1096,6 +1097,22 @@ cb::engine_errc DcpProducer::step(bool throttled,
 
         case DcpResponse::Event::Mutation: {
             Expects(itmCpy);
+            if (const auto* patch = mutationResponse->getPatch(); patch) {
+                ret = producers.mutation_patch(
+                        mutationResponse->getOpaque(),
+                        toUniqueItemPtr(std::move(itmCpy)),
+                        mutationResponse->getVBucket(),
+                        *mutationResponse->getBySeqno(),
+                        mutationResponse->getRevSeqno(),
+                        0 /* lock time */,
+                        encodeItemHotness(*mutationResponse->getItem()),
+                        patch->baseCas,
+                        patch->offset,
+                        patch->removeLength,
+                        patch->insertLength,
+                        mutationResponse->getStreamId());
+                break;
+            }
             ret = producers.mutation(
                     mutationResponse->getOpaque(),
                     toUniqueItemPtr(std::move(itmCpy)),
@@ -1567,6 +1584,19 @@ cb::engine_errc DcpProducer::control(uint32_t opaque,
         return engine_.getConfiguration().isDcpCacheTransferEnabled()
                        ? cb::engine_errc::success
                        : cb::engine_errc::not_supported;
+    } else if (key == DcpControlKeys::DeltaMutations && value == "true") {
+        // Only enabling is allowed. The streams pick up the cache when they
+        // are created (streams created before keep sending full values)
+        const auto size =
+                engine_.getConfiguration().getDcpDeltaMutationCacheSize();
+        if (size == 0) {
+            return cb::engine_errc::not_supported;
+        }
+        auto locked = deltaMutationCache.lock();
+        if (!*locked) {
+            *locked = std::make_shared<DeltaMutationCache>(size);
+        }
+        return cb::engine_errc::success;
     }
 
     OBJ_LOG_WARN_CTX(
@@ -1749,6 +1779,24 @@ bool DcpProducer::handleResponse(const cb::mcbp::Response& response) {
             return true;
         }
         return errorMessageHandler();
+    case cb::mcbp::ClientOpcode::DcpMutationPatch:
+        if (responseStatus == cb::mcbp::Status::KeyEexists) {
+            // The consumer's copy of the document isn't the base of the
+            // patch. It stopped the stream, so end it (the consumer then
+            // streams the vbucket again) and send the vbucket's Mutations
+            // in full from now on.
+            auto stream = find_if2(streamFindFn);
+            if (stream) {
+                deltaMutationsDisabled.lock()->insert(stream->getVBucket());
+                OBJ_LOG_INFO_CTX(*logger,
+                                 "Consumer rejected a mutation patch; Ending "
+                                 "the stream and disabling patches",
+                                 {"vb", stream->getVBucket()});
+                stream->setDead(cb::mcbp::DcpStreamEndStatus::Closed);
+            }
+            return true;
+        }
+        return errorMessageHandler();
     case cb::mcbp::ClientOpcode::DcpCachedValue:
         if (responseStatus == cb::mcbp::Status::Enomem) {
             // A PassiveStream which has no memory available for the transfer
@@ -1981,6 +2029,14 @@ void DcpProducer::addStats(const AddStatFn& add_stat, CookieIface& c) {
             add_stat,
             c);
     addStat("enable_expiry_opcode", enableExpiryOpcode, add_stat, c);
+    if (const auto cache = getDeltaMutationCache(); cache) {
+        addStat("delta_mutations_cache_size", cache->getSize(), add_stat, c);
+        addStat("delta_mutations_sent", cache->getPatchesSent(), add_stat, c);
+        addStat("delta_mutations_bytes_saved",
+                cache->getBytesSaved(),
+                add_stat,
+                c);
+    }
     addStat("enable_stream_id",
             multipleStreamRequests == MultipleStreamRequests::Yes,
             add_stat,
@@ -25,10 +25,12 @@
 #include <folly/SharedMutex.h>
 #include <folly/lang/Aligned.h>
 #include <platform/atomic_duration.h>
+#include <set>
 
 class BackfillManager;
 class CheckpointCursor;
 class DcpResponse;
+class DeltaMutationCache;
 class MutationResponse;
 class ProducerStream;
 class VBucket;
@@ -274,6 +276,25 @@ public:
         return multipleStreamRequests == MultipleStreamRequests::Yes;
     }
 
+    /**
+     * @return the cache of the values sent used to send Mutations as
+     *         patches (nullptr unless the consumer enabled delta_mutations)
+     */
+    std::shared_ptr<DeltaMutationCache> getDeltaMutationCache() const {
+        return *deltaMutationCache.lock();
+    }
+
+    /**
+     * @return the cache to send the Mutations of the vbucket as patches
+     *         (nullptr if the consumer rejected a patch of the vbucket)
+     */
+    std::shared_ptr<DeltaMutationCache> getDeltaMutationCache(Vbid vb) const {
+        if (deltaMutationsDisabled.lock()->contains(vb)) {
+            return {};
+        }
+        return getDeltaMutationCache();
+    }
+
     void setLastReceiveTime(cb::time::steady_clock::time_point time) {
         lastReceiveTime = time;
     }
@@ -725,6 +746,14 @@ protected:
 
     folly::Synchronized<std::string, std::mutex> consumerName;
 
+    /// The values sent (see DcpControlKeys::DeltaMutations)
+    folly::Synchronized<std::shared_ptr<DeltaMutationCache>, std::mutex>
+            deltaMutationCache;
+
+    /// The vbuckets for which the consumer rejected a patch as it didn't
+    /// have the base (new streams send complete values only)
+    folly::Synchronized<std::set<Vbid>, std::mutex> deltaMutationsDisabled;
+
     /// Timestamp of when we last transmitted a message to our peer.
     cb::AtomicTimePoint<> lastSendTime;
     folly::Synchronized<BufferLog> log;
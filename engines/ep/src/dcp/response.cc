@@ -282,6 +282,11 @@ bool MutationResponse::isEqual(const DcpResponse& rsp) const {
     return *item_ == *other.item_ && DcpResponse::isEqual(rsp);
 }
 
+bool MutationPatchResponse::isEqual(const DcpResponse& rsp) const {
+    const auto& other = static_cast<const MutationPatchResponse&>(rsp);
+    return patch == other.patch && MutationResponse::isEqual(rsp);
+}
+
 bool SeqnoAcknowledgement::isEqual(const DcpResponse& rsp) const {
     const auto& other = static_cast<const SeqnoAcknowledgement&>(rsp);
     return vbucket == other.vbucket &&
@@ -576,6 +576,14 @@ public:
         return item_->getRevSeqno();
     }
 
+    /**
+     * @return the patch to send instead of the complete value of the item,
+     *         or nullptr if the item is sent with its value
+     */
+    virtual const MutationPatch* getPatch() const {
+        return nullptr;
+    }
+
     /**
       * @return size of message to be sent over the wire to the consumer.
       */
@@ -644,6 +652,50 @@ protected:
     const queued_item item_;
 };
 
+/**
+ * A Mutation sent as a patch against the previous value of the document
+ * (DcpMutationPatch). The item holds the complete new value. (The consumer
+ * applies the patch before it creates the message, see
+ * PassiveStream::applyMutationPatch.)
+ */
+class MutationPatchResponse : public MutationResponse {
+public:
+    MutationPatchResponse(queued_item item,
+                          uint32_t opaque,
+                          IncludeDeleteTime includeDeleteTime,
+                          DocKeyEncodesCollectionId includeCollectionID,
+                          EnableExpiryOutput enableExpiryOut,
+                          cb::mcbp::DcpStreamId sid,
+                          MutationPatch patch)
+        : MutationResponse(std::move(item),
+                           opaque,
+                           includeDeleteTime,
+                           includeCollectionID,
+                           enableExpiryOut,
+                           sid,
+                           Event::Mutation),
+          patch(patch),
+          messageSize(MutationResponse::getMessageSize() - item_->getNBytes() +
+                      sizeof(cb::mcbp::request::DcpMutationPatchHeader) +
+                      patch.insertLength) {
+    }
+
+    const MutationPatch* getPatch() const override {
+        return &patch;
+    }
+
+    /// The size of the patch message (instead of the complete value)
+    size_t getMessageSize() const override {
+        return messageSize;
+    }
+
+protected:
+    bool isEqual(const DcpResponse& rsp) const override;
+
+    const MutationPatch patch;
+    const size_t messageSize;
+};
+
 /**
  * Represents a sequence number acknowledgement message sent from replication
  * consumer to producer to notify the producer what seqno the consumer has
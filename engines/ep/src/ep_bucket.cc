@@ -27,6 +27,7 @@
 #include "kvstore/persistence_callback.h"
 #include "kvstore/rollback_callback.h"
 #include "range_scans/range_scan_callbacks.h"
+#include "range_scans/range_scan_coordinator.h"
 #include "rollback_result.h"
 #include "snapshots/cache.h"
 #include "snapshots/download_snapshot_task.h"
@@ -203,17 +204,55 @@ bool BloomFilterCallback::initTempFilter(Vbid vbucketId) {
     return true;
 }
 
+/**
+ * Expiry callback for compaction. Expired items are collected into batches of
+ * up to batchSize items, each of which is then expired in the vBucket in one
+ * go (see KVBucket::processExpiredItems) rather than paying for the vBucket
+ * lookup, state lock and flusher/DCP notification once per item.
+ *
+ * Any partial batch is processed by flush(), which must be called when
+ * compaction completes; as a backstop (e.g. a compaction which is aborted)
+ * it is also processed on destruction.
+ */
 class ExpiredItemsCallback : public Callback<Item&, time_t&> {
 public:
-    explicit ExpiredItemsCallback(KVBucket& store) : epstore(store) {
+    ExpiredItemsCallback(KVBucket& store, size_t batchSize)
+        : epstore(store), batchSize(batchSize) {
+        batch.reserve(batchSize);
+    }
+
+    ~ExpiredItemsCallback() override {
+        try {
+            flush();
+        } catch (const std::exception& e) {
+            EP_LOG_WARN_CTX(
+                    "ExpiredItemsCallback::~ExpiredItemsCallback: failed to "
+                    "process expired items",
+                    {"items", batch.size()},
+                    {"error", e.what()});
+        }
     }
 
     void callback(Item& item, time_t& startTime) override {
-        epstore.processExpiredItem(item, startTime, ExpireBy::Compactor);
+        batch.emplace_back(item, startTime);
+        if (batch.size() >= batchSize) {
+            flush();
+        }
+    }
+
+    /// Expire all of the items collected so far
+    void flush() {
+        if (batch.empty()) {
+            return;
+        }
+        epstore.processExpiredItems(batch);
+        batch.clear();
     }
 
 private:
     KVBucket& epstore;
+    const size_t batchSize;
+    std::vector<std::pair<Item, time_t>> batch;
 };
 
 void NotifyFlusherCB::callback(Vbid& vbid) {
@@ -1445,7 +1484,8 @@ std::shared_ptr<CompactionContext> EPBucket::makeCompactionContext(
     BloomFilterCBPtr filter(new BloomFilterCallback(*this));
     ctx->bloomFilterCallback = filter;
 
-    ExpiredItemsCBPtr expiry(new ExpiredItemsCallback(*this));
+    auto expiry = std::make_shared<ExpiredItemsCallback>(
+            *this, configuration.getCompactionExpiryBatchSize());
     ctx->expiryCallback = expiry;
 
     // take a raw ref to the context as if the function is being called we know
@@ -1461,7 +1501,10 @@ std::shared_ptr<CompactionContext> EPBucket::makeCompactionContext(
                 highCompletedSeqno);
     };
 
-    ctx->completionCallback = [this](CompactionContext& ctx) {
+    ctx->completionCallback = [this, expiry](CompactionContext& ctx) {
+        // Expire any remaining batched items before the in-memory state is
+        // updated for the end of compaction.
+        expiry->flush();
         compactionCompletionCallback(ctx);
     };
 
@@ -2974,6 +3017,64 @@ cb::engine_errc EPBucket::cancelRangeScan(Vbid vbid,
     return vb->cancelRangeScan(uuid, &cookie);
 }
 
+cb::engine_errc EPBucket::multiRangeScan(
+        CookieIface& cookie,
+        const cb::rangescan::MultiVbucketParameters& params) {
+    // With a token the scan is running, this is the I/O complete phase which
+    // sends the data read since the previous phase
+    if (auto token =
+                engine.takeEngineSpecific<RangeScanCoordinatorToken>(cookie)) {
+        const auto status = token->coordinator->sendOnFrontendThread(cookie);
+        if (status == cb::engine_errc::would_block ||
+            status == cb::engine_errc::too_much_data_in_output_buffer) {
+            engine.storeEngineSpecific(cookie, std::move(*token));
+        }
+        return status;
+    }
+
+    // The checks of each vbucket scan are repeated when the scan is created,
+    // but fail the request now if it would fail for every vbucket
+    const auto status = engine.checkCollectionAccess(
+            cookie,
+            {},
+            cb::rbac::Privilege::SystemCollectionLookup,
+            cb::rbac::Privilege::RangeScan,
+            params.cid);
+    if (status != cb::engine_errc::success) {
+        return status;
+    }
+
+    auto vbuckets = params.vbuckets;
+    if (vbuckets.empty()) {
+        vbuckets = getVBucketsInState(vbucket_state_active);
+    } else {
+        std::ranges::sort(vbuckets);
+        vbuckets.erase(std::unique(vbuckets.begin(), vbuckets.end()),
+                       vbuckets.end());
+    }
+
+    if (vbuckets.empty()) {
+        // Nothing to scan, send the final response
+        return RangeScanCoordinator(*this, cookie, params, {}, 0)
+                .sendOnFrontendThread(cookie);
+    }
+
+    // The tasks of the scan count against the same limit as the tasks which
+    // run range-scan-continue
+    const auto tasks =
+            getReadyRangeScans()->reserveCoordinatorTasks(vbuckets.size());
+    if (tasks == 0) {
+        return cb::engine_errc::too_busy;
+    }
+    auto coordinator = std::make_shared<RangeScanCoordinator>(
+            *this, cookie, params, std::move(vbuckets), tasks);
+
+    // The token must be stored before a task can notify the cookie
+    engine.storeEngineSpecific(cookie, RangeScanCoordinatorToken{coordinator});
+    coordinator->schedule();
+    return cb::engine_errc::would_block;
+}
+
 cb::engine_errc EPBucket::prepareForPause(
         folly::CancellationToken cancellationToken) {
     // 1. Wait for all outstanding disk writing operations to complete.
@@ -426,6 +426,10 @@ public:
                                     cb::rangescan::Id uuid,
                                     CookieIface& cookie) override;
 
+    cb::engine_errc multiRangeScan(
+            CookieIface& cookie,
+            const cb::rangescan::MultiVbucketParameters& params) override;
+
     cb::engine_errc prepareForPause(folly::CancellationToken) override;
 
     cb::engine_errc prepareForResume() override;
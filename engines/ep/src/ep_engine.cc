@@ -1246,6 +1246,43 @@ cb::engine_errc EventuallyPersistentEngine::mutation(
                           nru);
 }
 
+cb::engine_errc EventuallyPersistentEngine::mutation_patch(
+        CookieIface& cookie,
+        uint32_t opaque,
+        const DocKeyView& key,
+        cb::const_byte_buffer patch,
+        uint8_t datatype,
+        uint64_t cas,
+        Vbid vbucket,
+        uint32_t flags,
+        uint64_t by_seqno,
+        uint64_t rev_seqno,
+        uint32_t expiration,
+        uint32_t lock_time,
+        uint8_t nru) {
+    if (!cb::mcbp::datatype::is_valid(datatype)) {
+        EP_LOG_WARN_RAW(
+                "Invalid value for datatype "
+                " (DCPMutationPatch)");
+        return cb::engine_errc::invalid_arguments;
+    }
+    auto engine = acquireEngine(this);
+    auto conn = engine->getConnHandler(cookie);
+    return conn->mutation_patch(cookie,
+                                opaque,
+                                key,
+                                patch,
+                                datatype,
+                                cas,
+                                vbucket,
+                                flags,
+                                by_seqno,
+                                rev_seqno,
+                                expiration,
+                                lock_time,
+                                nru);
+}
+
 cb::engine_errc EventuallyPersistentEngine::deletion(
         CookieIface& cookie,
         uint32_t opaque,
@@ -3557,6 +3594,10 @@ cb::engine_errc EventuallyPersistentEngine::doEngineStatsHighCardinality(
                       epstats.compressorNumVisited);
     collector.addStat(Key::ep_item_compressor_num_compressed,
                       epstats.compressorNumCompressed);
+    collector.addStat(Key::ep_item_compressor_input_bytes,
+                      epstats.compressorInputBytes);
+    collector.addStat(Key::ep_item_compressor_output_bytes,
+                      epstats.compressorOutputBytes);
 
     collector.addStat(Key::ep_cursors_dropped, epstats.cursorsDropped);
     collector.addStat(Key::ep_mem_freed_by_checkpoint_removal,
@@ -4596,6 +4637,8 @@ void EventuallyPersistentEngine::doTimingStats(
     collector.addStat(Key::checkpoint_remover, stats.checkpointRemoverHisto);
     collector.addStat(Key::item_pager, stats.itemPagerHisto);
     collector.addStat(Key::expiry_pager, stats.expiryPagerHisto);
+    collector.addStat(Key::compaction_expiry_batch,
+                      stats.compactionExpiryBatchHisto);
     collector.addStat(Key::storage_age, stats.dirtyAgeHisto);
 
     // Regular commands
@@ -7474,6 +7517,12 @@ cb::engine_errc EventuallyPersistentEngine::cancelRangeScan(
             vbid, uuid, cookie);
 }
 
+cb::engine_errc EventuallyPersistentEngine::multiRangeScan(
+        CookieIface& cookie,
+        const cb::rangescan::MultiVbucketParameters& params) {
+    return acquireEngine(this)->getKVBucket()->multiRangeScan(cookie, params);
+}
+
 cb::engine_errc EventuallyPersistentEngine::doRangeScanStats(
         const BucketStatCollector& collector, std::string_view statKey) {
     class StatVBucketVisitor : public VBucketVisitor {
@@ -325,6 +325,9 @@ public:
     cb::engine_errc cancelRangeScan(CookieIface& cookie,
                                     Vbid vbid,
                                     cb::rangescan::Id uuid) override;
+    cb::engine_errc multiRangeScan(
+            CookieIface& cookie,
+            const cb::rangescan::MultiVbucketParameters& params) override;
     cb::engine_errc syncFusionLogstore(Vbid vbid) override;
     cb::engine_errc startFusionUploader(Vbid vbid, uint64_t term) override;
     cb::engine_errc stopFusionUploader(Vbid vbid) override;
@@ -432,6 +435,19 @@ public:
                              uint32_t expiration,
                              uint32_t lock_time,
                              uint8_t nru) override;
+    cb::engine_errc mutation_patch(CookieIface& cookie,
+                                   uint32_t opaque,
+                                   const DocKeyView& key,
+                                   cb::const_byte_buffer patch,
+                                   uint8_t datatype,
+                                   uint64_t cas,
+                                   Vbid vbucket,
+                                   uint32_t flags,
+                                   uint64_t by_seqno,
+                                   uint64_t rev_seqno,
+                                   uint32_t expiration,
+                                   uint32_t lock_time,
+                                   uint8_t nru) override;
     cb::engine_errc deletion(CookieIface& cookie,
                              uint32_t opaque,
                              const DocKeyView& key,
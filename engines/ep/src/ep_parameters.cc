@@ -96,6 +96,7 @@ static const std::unordered_set<std::string_view> flushParamSet{
         "persistent_metadata_purge_age",
         "compaction_expire_from_start",
         "compaction_expiry_fetch_inline",
+        "compaction_expiry_batch_size",
         "vbucket_mapping_sanity_checking",
         "vbucket_mapping_sanity_checking_error_mode",
         "seqno_persistence_timeout",
@@ -103,6 +104,8 @@ static const std::unordered_set<std::string_view> flushParamSet{
         "bucket_quota_change_task_poll_interval",
         "range_scan_read_buffer_send_size",
         "range_scan_max_lifetime",
+        "range_scan_memory_snapshot_max_items",
+        "range_scan_memory_snapshot_resident_ratio",
         "item_eviction_strategy",
         "history_retention_seconds",
         "history_retention_bytes",
@@ -152,6 +155,7 @@ static const std::unordered_set<std::string_view> dcpParamSet{
         "dcp_consumer_buffer_ratio",
         "connection_manager_interval",
         "connection_cleanup_interval",
+        "dcp_delta_mutation_cache_size",
         "dcp_enable_noop",
         "dcp_idle_timeout",
         "dcp_noop_tx_interval",
@@ -1381,7 +1381,8 @@ std::pair<cb::engine_errc, cb::rangescan::Id> EPVBucket::createRangeScan(
         handler = std::make_unique<RangeScanDataHandler>(
                 bucket->getEPEngine(),
                 params.keyOnly == cb::rangescan::KeyOnly::Yes,
-                params.includeXattrs == cb::rangescan::IncludeXattrs::Yes);
+                params.includeXattrs == cb::rangescan::IncludeXattrs::Yes,
+                params.projection);
     }
 
     // At this point the scan can proceed to create, but we need to check and
@@ -72,6 +72,8 @@ bool ItemCompressorTask::run() {
         // Update stats
         stats.compressorNumCompressed.fetch_add(visitor.getCompressedCount());
         stats.compressorNumVisited.fetch_add(visitor.getVisitedCount());
+        stats.compressorInputBytes.fetch_add(visitor.getInputBytes());
+        stats.compressorOutputBytes.fetch_add(visitor.getOutputBytes());
 
         // Check if the visitor completed a full pass.
         bool completed =
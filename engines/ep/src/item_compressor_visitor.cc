@@ -37,6 +37,9 @@ bool ItemCompressorVisitor::visit(const HashTable::HashBucketLock& lh,
         cb::compression::Buffer deflated;
         if (cb::compression::deflateSnappy(
                     {v.getValue()->getData(), v.valuelen()}, deflated)) {
+            input_bytes += v.valuelen();
+            output_bytes += deflated.size();
+
             auto comp_ratio = static_cast<float>(v.valuelen()) /
                               static_cast<float>(deflated.size());
 
@@ -64,6 +67,8 @@ bool ItemCompressorVisitor::visit(const HashTable::HashBucketLock& lh,
 void ItemCompressorVisitor::clearStats() {
     compressed_count = 0;
     visited_count = 0;
+    input_bytes = 0;
+    output_bytes = 0;
 }
 
 size_t ItemCompressorVisitor::getCompressedCount() const {
@@ -74,6 +79,14 @@ size_t ItemCompressorVisitor::getVisitedCount() const {
     return visited_count;
 }
 
+size_t ItemCompressorVisitor::getInputBytes() const {
+    return input_bytes;
+}
+
+size_t ItemCompressorVisitor::getOutputBytes() const {
+    return output_bytes;
+}
+
 void ItemCompressorVisitor::setCompressionMode(
         const BucketCompressionMode compressionMode) {
     compressMode = compressionMode;
@@ -47,6 +47,13 @@ public:
     // Returns the number of documents that have been visited.
     size_t getVisitedCount() const;
 
+    // Returns the uncompressed size of the documents the visitor deflated.
+    size_t getInputBytes() const;
+
+    // Returns the Snappy compressed size of the documents the visitor
+    // deflated (whether or not the compressed value was kept).
+    size_t getOutputBytes() const;
+
     void setCurrentVBucket(VBucket& vb) override;
 
 private:
@@ -60,6 +67,9 @@ private:
     size_t compressed_count;
     // How many documents have been visited.
     size_t visited_count;
+    // Uncompressed / compressed bytes of the documents deflated.
+    size_t input_bytes{0};
+    size_t output_bytes{0};
 
     // Current compression mode of the bucket
     BucketCompressionMode compressMode;
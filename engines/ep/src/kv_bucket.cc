@@ -697,6 +697,86 @@ void KVBucket::processExpiredItem(Item& it, time_t startTime, ExpireBy source) {
     bgfetch->complete(engine, vb, fetchStartTime, key);
 }
 
+void KVBucket::processExpiredItems(
+        std::vector<std::pair<Item, time_t>>& items) {
+    if (items.empty()) {
+        return;
+    }
+
+    const auto start = cb::time::steady_clock::now();
+
+    // Yield if checkpoint's full - The call also wakes up the mem recovery task
+    if (isCheckpointMemoryStateFull(verifyCheckpointMemoryState())) {
+        return;
+    }
+
+    const auto vbid = items.front().first.getVBucketId();
+    auto vb = getVBucket(vbid);
+    if (!vb) {
+        return;
+    }
+
+    for (auto& [it, startTime] : items) {
+        Expects(it.getVBucketId() == vbid);
+        // MB-25931: Empty XATTR items need their value before we can call
+        // pre_expiry. These occur because the value has been evicted.
+        if (cb::mcbp::datatype::is_xattr(it.getDataType()) &&
+            it.getNBytes() == 0) {
+            getValue(it);
+        }
+
+        // Process positive seqnos (ignoring special *temp* items) and only
+        // those items with a value
+        if (it.getBySeqno() >= 0 && it.getNBytes()) {
+            runPreExpiryHook(*vb, it);
+        }
+    }
+
+    std::vector<std::pair<Item*, std::unique_ptr<CompactionBGFetchItem>>>
+            bgfetches;
+    VBNotifyCtx notifyCtx;
+
+    // Obtain reader access to the VB state change lock so that the VB can't
+    // switch state whilst we're processing
+    {
+        std::shared_lock rlh(vb->getStateLock());
+        if (vb->getState() == vbucket_state_active) {
+            for (auto& [it, startTime] : items) {
+                auto bgfetch = vb->processExpiredItem(
+                        it, startTime, ExpireBy::Compactor, &notifyCtx);
+                if (bgfetch) {
+                    bgfetches.emplace_back(&it, std::move(bgfetch));
+                }
+            }
+        }
+    }
+
+    // Every expiry in the batch was queued into the same vBucket, so a single
+    // notification of the highest seqno covers them all.
+    if (notifyCtx.getSeqno()) {
+        notifyNewSeqno(vbid, notifyCtx);
+    }
+
+    for (size_t ii = 0; ii < items.size(); ++ii) {
+        processExpiredItemHook();
+    }
+
+    for (auto& [it, bgfetch] : bgfetches) {
+        auto fetchStartTime = cb::time::steady_clock::now();
+
+        auto key = DiskDocKey(*it);
+        auto gv = getROUnderlying(vbid)->get(key, vbid);
+
+        bgfetch->value = &gv;
+
+        bgfetch->complete(engine, vb, fetchStartTime, key);
+    }
+
+    stats.compactionExpiryBatchHisto.add(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                    cb::time::steady_clock::now() - start));
+}
+
 bool KVBucket::isMetaDataResident(VBucketPtr& vb, const DocKeyView& key) {
     if (!vb) {
         throw std::invalid_argument("EPStore::isMetaDataResident: vb is NULL");
@@ -3363,6 +3443,11 @@ cb::engine_errc KVBucket::cancelRangeScan(Vbid,
     return cb::engine_errc::not_supported;
 }
 
+cb::engine_errc KVBucket::multiRangeScan(
+        CookieIface&, const cb::rangescan::MultiVbucketParameters&) {
+    return cb::engine_errc::not_supported;
+}
+
 void KVBucket::processBucketQuotaChange(size_t desiredQuota) {
     Expects(bucketQuotaChangeTask);
     bucketQuotaChangeTask->notifyNewQuotaChange(desiredQuota);
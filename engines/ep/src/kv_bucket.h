@@ -501,6 +501,20 @@ public:
                             time_t startTime,
                             ExpireBy source) override;
 
+    /**
+     * Expire a batch of items (all from the same vBucket) found by the
+     * compactor. Equivalent to calling processExpiredItem() for each item
+     * (with ExpireBy::Compactor), but looks up the vBucket, checks checkpoint
+     * memory and acquires the vBucket state lock once for the whole batch,
+     * and notifies the flusher / DCP of the new seqnos once, after the last
+     * item has been expired.
+     *
+     * @param items pairs of the item to expire and the time to compare the
+     *        item's expiry time against. Items may be modified (see
+     *        processExpiredItem()).
+     */
+    void processExpiredItems(std::vector<std::pair<Item, time_t>>& items);
+
     /**
      * Get the value for the Item
      * If the value is already deleted no update occurs
@@ -1102,6 +1116,9 @@ public:
     cb::engine_errc cancelRangeScan(Vbid vbid,
                                     cb::rangescan::Id uuid,
                                     CookieIface& cookie) override;
+    cb::engine_errc multiRangeScan(
+            CookieIface& cookie,
+            const cb::rangescan::MultiVbucketParameters& params) override;
 
     /**
      * Process a bucket quota change to the desired value
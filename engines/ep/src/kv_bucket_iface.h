@@ -931,6 +931,18 @@ public:
                                             cb::rangescan::Id uuid,
                                             CookieIface& cookie) = 0;
 
+    /**
+     * Scan a range of a collection across many vbuckets (range-scan-multi)
+     *
+     * @param cookie The client cookie requesting the scan
+     * @param params Bundled parameters of the scan
+     * @return would_block whilst the scan runs, range_scan_complete or
+     *         range_scan_more when the final response has been sent
+     */
+    virtual cb::engine_errc multiRangeScan(
+            CookieIface& cookie,
+            const cb::rangescan::MultiVbucketParameters& params) = 0;
+
     /**
      * Prepare the bucket for being paused - ensure that any on-disk state
      * is quiesced.
@@ -54,6 +54,7 @@ CouchKVStoreConfig::CouchKVStoreConfig(Configuration& config,
             std::make_unique<ConfigChangeListener>(*this));
     midpointRollbackOptimisationEnabled =
             config.isCouchstoreMidpointRollbackOptimisation();
+    pipelinedFlush = config.isCouchstorePipelinedFlush();
 }
 
 CouchKVStoreConfig::CouchKVStoreConfig(uint16_t maxVBuckets,
@@ -87,6 +87,14 @@ public:
         return midpointRollbackOptimisationEnabled;
     }
 
+    void setPipelinedFlush(bool value) {
+        pipelinedFlush = value;
+    }
+
+    bool isPipelinedFlush() const {
+        return pipelinedFlush;
+    }
+
 private:
     class ConfigChangeListener;
 
@@ -104,4 +112,8 @@ private:
     std::atomic_bool couchstoreMprotectEnabled;
 
     bool midpointRollbackOptimisationEnabled{true};
+
+    /// Compress document bodies on a separate encoder thread while the
+    /// flusher is still queueing the batch (see CouchFlushEncoder)
+    bool pipelinedFlush{false};
 };
\ No newline at end of file
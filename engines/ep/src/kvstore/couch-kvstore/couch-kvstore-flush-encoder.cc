@@ -0,0 +1,89 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "couch-kvstore-flush-encoder.h"
+
+#include "couch-kvstore.h"
+#include "ep_task.h"
+
+#include <executor/executorpool.h>
+
+#include <utility>
+
+/// Runs the encode stage of one flush transaction
+class CouchFlushEncodeTask : public EpTask {
+public:
+    CouchFlushEncodeTask(EventuallyPersistentEngine& engine,
+                         std::shared_ptr<CouchFlushEncoder> encoder)
+        : EpTask(engine, TaskId::CouchFlushEncodeTask, 0, false),
+          encoder(std::move(encoder)) {
+    }
+
+    std::string getDescription() const override {
+        return "Encoding couchstore flush batch";
+    }
+
+    std::chrono::microseconds maxExpectedDuration() const override {
+        // Compresses at most one flush batch
+        return std::chrono::milliseconds(100);
+    }
+
+    bool run() override {
+        encoder->run();
+        return false;
+    }
+
+private:
+    const std::shared_ptr<CouchFlushEncoder> encoder;
+};
+
+CouchFlushEncoder::CouchFlushEncoder(EventuallyPersistentEngine* engine)
+    : engine(engine) {
+}
+
+void CouchFlushEncoder::encode(CouchRequest& request) {
+    std::lock_guard<std::mutex> lh(mutex);
+    queue.push_back(&request);
+    if (engine && !scheduled) {
+        scheduled = true;
+        // The task shares the encoder so a task which runs after the
+        // transaction has gone finds an empty queue
+        ExecutorPool::get()->schedule(std::make_shared<CouchFlushEncodeTask>(
+                *engine, shared_from_this()));
+    }
+}
+
+bool CouchFlushEncoder::drain() {
+    std::unique_lock<std::mutex> lh(mutex);
+    encodeQueuedLH(lh);
+    drained.wait(lh, [this]() { return encoding == 0; });
+    return !std::exchange(failed, false);
+}
+
+void CouchFlushEncoder::encodeQueuedLH(std::unique_lock<std::mutex>& lh) {
+    while (!queue.empty()) {
+        auto* request = queue.front();
+        queue.pop_front();
+        ++encoding;
+        lh.unlock();
+        const bool encoded = request->encodeValue();
+        lh.lock();
+        failed |= !encoded;
+        --encoding;
+    }
+}
+
+void CouchFlushEncoder::run() {
+    std::unique_lock<std::mutex> lh(mutex);
+    scheduled = false;
+    encodeQueuedLH(lh);
+    drained.notify_all();
+}
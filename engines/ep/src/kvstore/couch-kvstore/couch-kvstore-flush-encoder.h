@@ -0,0 +1,83 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+class CouchRequest;
+class EventuallyPersistentEngine;
+
+/**
+ * The encode stage of a pipelined CouchKVStore flush.
+ *
+ * Without the encoder, document bodies are snappy-compressed by couchstore
+ * inside couchstore_save_documents() - i.e. on the flusher thread, serialised
+ * with the writes of the batch. With the encoder, each CouchRequest is handed
+ * over as soon as the flusher queues it (KVStore::set / del) and compressed
+ * by a NonIO task while the flusher carries on collecting and processing the
+ * rest of the batch. By the time commit() is reached the bodies are (mostly)
+ * already compressed and couchstore only has to write them.
+ *
+ * Each flush transaction has its own encoder (many flushers may flush the
+ * vbuckets of one shard concurrently), so the requests and the failure of
+ * one batch are never mixed up with another's.
+ *
+ * drain() must be called before the requests are written or destroyed; it
+ * encodes any request the task has not yet picked up on the calling thread
+ * and then waits for the one (if any) the task is encoding, so the flusher
+ * never waits behind a backlog (or for the task to be run at all).
+ */
+class CouchFlushEncoder
+    : public std::enable_shared_from_this<CouchFlushEncoder> {
+public:
+    /**
+     * @param engine The engine to run the encode task for, if null all of
+     *        the requests are encoded by drain()
+     */
+    explicit CouchFlushEncoder(EventuallyPersistentEngine* engine);
+
+    /**
+     * Queue a request for encoding. The request must remain valid (and must
+     * not be modified by the caller) until drain() has returned.
+     */
+    void encode(CouchRequest& request);
+
+    /**
+     * Complete encoding of all queued requests before returning.
+     * @return true if all requests queued since the last drain() were
+     *         successfully encoded.
+     */
+    bool drain();
+
+    /// Body of the encode task - encodes requests until the queue is empty
+    void run();
+
+private:
+    /// Encode requests until the queue is empty. Called (and returns) with
+    /// the mutex held; drops it while encoding each request.
+    void encodeQueuedLH(std::unique_lock<std::mutex>& lh);
+
+    EventuallyPersistentEngine* const engine;
+
+    std::mutex mutex;
+    std::condition_variable drained;
+    std::deque<CouchRequest*> queue;
+    /// Is the encode task scheduled (and not yet running)?
+    bool scheduled{false};
+    /// How many requests are being encoded (with the mutex dropped)?
+    size_t encoding{0};
+    /// Has encoding of any request failed since the last drain()?
+    bool failed{false};
+};
@@ -25,6 +25,7 @@
 #include "kvstore/persistence_callback.h"
 #include "kvstore/rollback_callback.h"
 #include "kvstore/storage_common/storage_common/local_doc_constants.h"
+#include "objectregistry.h"
 #include "rollback_result.h"
 #include "statistics/cbstat_collector.h"
 #include "utilities/logtags.h"
@@ -391,6 +392,43 @@ CouchRequest::CouchRequest(queued_item it)
 
 CouchRequest::~CouchRequest() = default;
 
+bool CouchRequest::encodeValue() {
+    if (!(dbDocInfo.content_meta & COUCH_DOC_IS_COMPRESSED)) {
+        // No value, or the value is already snappy compressed
+        return true;
+    }
+
+    // Note: Unlike Item::compressValue we must keep the compressed value even
+    // if it is larger; COUCH_DOC_IS_COMPRESSED tells readers the body on disk
+    // is snappy.
+    try {
+        if (!cb::compression::deflateSnappy({dbDoc.data.buf, dbDoc.data.size},
+                                            encodedValue)) {
+            return false;
+        }
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    dbDoc.data.buf = encodedValue.data();
+    dbDoc.data.size = encodedValue.size();
+    return true;
+}
+
+void CouchRequest::resetEncodedValue() {
+    if (item->getNBytes()) {
+        dbDoc.data.buf = const_cast<char*>(value->getData());
+        dbDoc.data.size = item->getNBytes();
+    }
+    encodedValue = {};
+}
+
+size_t CouchRequest::getLogicalDataSize() const {
+    // key len + revision metadata (expiry, flags, etc) + value len (if not
+    // deleted).
+    return dbDocInfo.id.size + dbDocInfo.rev_meta.size +
+           ((isDelete() && value.get() == nullptr) ? 0 : item->getNBytes());
+}
+
 CouchKVStore::CouchKVStore(const CouchKVStoreConfig& config,
                            EncryptionKeyProvider* encryptionKeyProvider)
     : CouchKVStore(config,
@@ -621,7 +659,10 @@ void CouchKVStore::set(TransactionContext& txnCtx, queued_item item) {
 
     // each req will be de-allocated after commit
     auto& ctx = dynamic_cast<CouchKVStoreTransactionContext&>(txnCtx);
-    ctx.pendingReqsQ.emplace_back(std::move(item));
+    auto& req = ctx.pendingReqsQ.emplace_back(std::move(item));
+    if (ctx.encoder) {
+        ctx.encoder->encode(req);
+    }
 }
 
 GetValue CouchKVStore::get(const DiskDocKey& key,
@@ -882,7 +923,10 @@ void CouchKVStore::del(TransactionContext& txnCtx, queued_item item) {
     checkIfInTransaction(txnCtx.vbid, "CouchKVStore::del");
 
     auto& ctx = dynamic_cast<CouchKVStoreTransactionContext&>(txnCtx);
-    ctx.pendingReqsQ.emplace_back(std::move(item));
+    auto& req = ctx.pendingReqsQ.emplace_back(std::move(item));
+    if (ctx.encoder) {
+        ctx.encoder->encode(req);
+    }
 }
 
 void CouchKVStore::delVBucket(Vbid vbucket,
@@ -3024,6 +3068,26 @@ bool CouchKVStore::commit(std::unique_ptr<TransactionContext> txnCtx,
                  "pendingCommitCnt",
                  pendingCommitCnt);
 
+    if (ctx.encoder) {
+        // Wait for the encode stage to complete for this batch
+        const auto encodeStart = cb::time::steady_clock::now();
+        ctx.valuesEncoded = ctx.encoder->drain();
+        st.flushEncodeWaitHisto.add(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                        cb::time::steady_clock::now() - encodeStart));
+        if (!ctx.valuesEncoded) {
+            // Couchstore can only compress all or none of the batch; undo
+            // the encode stage and let it compress the whole batch.
+            logger.warn(
+                    "CouchKVStore::commit: {} encode stage failed, "
+                    "compressing batch during save",
+                    vbid);
+            for (auto& req : ctx.pendingReqsQ) {
+                req.resetEncodedValue();
+            }
+        }
+    }
+
     std::vector<Doc*> docs(pendingCommitCnt);
     std::vector<DocInfo*> docinfos(pendingCommitCnt);
     std::vector<void*> kvReqs(pendingCommitCnt);
@@ -3144,17 +3208,6 @@ static void saveDocsCallback(const DocInfo* oldInfo,
     }
 }
 
-/**
- * Returns the logical size of the data within the given Doc - i.e. the
- * "useful" data ep-engine is writing to disk for this document.
- * Used for Write Amplification calculation.
- */
-static size_t calcLogicalDataSize(const Doc* doc, const DocInfo& info) {
-    // key len + revision metadata (expiry, flags, etc) + value len (if not
-    // deleted).
-    return info.id.size + info.rev_meta.size + (doc ? doc->data.size : 0);
-}
-
 couchstore_error_t CouchKVStore::saveDocs(
         CouchKVStoreTransactionContext& txnCtx,
         const std::vector<Doc*>& docs,
@@ -3203,7 +3256,9 @@ couchstore_error_t CouchKVStore::saveDocs(
             }
             maxDBSeqno = std::max(maxDBSeqno, docinfos[idx]->db_seq);
             // Accumulate the size of the useful data in this docinfo.
-            docsLogicalBytes += calcLogicalDataSize(docs[idx], *docinfos[idx]);
+            docsLogicalBytes +=
+                    static_cast<const CouchRequest*>(kvReqs[idx])
+                            ->getLogicalDataSize();
         }
 
         // If dropped collections exists, read the dropped collections metadata
@@ -3230,7 +3285,11 @@ couchstore_error_t CouchKVStore::saveDocs(
 
         auto cs_begin = cb::time::steady_clock::now();
 
-        uint64_t flags = COMPRESS_DOC_BODIES | COUCHSTORE_SEQUENCE_AS_IS;
+        // Bodies have already been compressed if the encode stage ran
+        uint64_t flags = COUCHSTORE_SEQUENCE_AS_IS;
+        if (!txnCtx.valuesEncoded) {
+            flags |= COMPRESS_DOC_BODIES;
+        }
         const auto errCode =
                 couchstore_save_documents_and_callback(db,
                                                        docs.data(),
@@ -3363,8 +3422,7 @@ void CouchKVStore::commitCallback(TransactionContext& txnCtx,
                                   couchstore_error_t errCode) {
     const auto flushSuccess = (errCode == COUCHSTORE_SUCCESS);
     for (auto& committed : committedReqs) {
-        const auto docLogicalSize = calcLogicalDataSize(
-                committed.getDbDoc(), *committed.getDbDocInfo());
+        const auto docLogicalSize = committed.getLogicalDataSize();
         ++st.io_num_write;
         st.io_document_write_bytes += docLogicalSize;
 
@@ -4831,8 +4889,15 @@ std::unique_ptr<TransactionContext> CouchKVStore::begin(
         return {};
     }
 
+    std::shared_ptr<CouchFlushEncoder> encoder;
+    if (configuration.isPipelinedFlush()) {
+        // Encode on a task of the flushing engine (none when the KVStore is
+        // used outside of a bucket, e.g. by tests)
+        encoder = std::make_shared<CouchFlushEncoder>(
+                ObjectRegistry::getCurrentEngine());
+    }
     return std::make_unique<CouchKVStoreTransactionContext>(
-            *this, vbid, std::move(pcb));
+            *this, vbid, std::move(pcb), std::move(encoder));
 }
 
 bool CouchKVStore::pause() {
@@ -12,6 +12,7 @@
 
 #include "configuration.h"
 #include "couch-fs-stats.h"
+#include "couch-kvstore-flush-encoder.h"
 #include "couch-kvstore-metadata.h"
 #include "kvstore/kvstore.h"
 #include "kvstore/kvstore_priv.h"
@@ -22,6 +23,7 @@
 #include <folly/SharedMutex.h>
 #include <folly/Synchronized.h>
 #include <libcouchstore/couch_db.h>
+#include <platform/compress.h>
 #include <platform/monotonic.h>
 #include <relaxed_atomic.h>
 #include <spdlog/common.h>
@@ -88,11 +90,37 @@ public:
         return update;
     }
 
+    /**
+     * Encode the document body for storage ahead of the write - i.e. perform
+     * the snappy compression couchstore would otherwise do in
+     * couchstore_save_documents(). Used by the encode stage of a pipelined
+     * flush (see CouchFlushEncoder); once encoded the document must be saved
+     * without COMPRESS_DOC_BODIES.
+     *
+     * @return false if the value could not be compressed (the request is
+     *         left unencoded)
+     */
+    bool encodeValue();
+
+    /// Undo encodeValue(), so the document can be saved with
+    /// COMPRESS_DOC_BODIES.
+    void resetEncodedValue();
+
+    /**
+     * @return the logical size of the document - i.e. the "useful" data
+     *         ep-engine is writing to disk (key + metadata + uncompressed
+     *         value). Used for Write Amplification calculation.
+     */
+    size_t getLogicalDataSize() const;
+
 protected:
     static couchstore_content_meta_flags getContentMeta(const Item& it);
 
     value_t value;
 
+    /// Compressed copy of the value, populated by encodeValue()
+    cb::compression::Buffer encodedValue;
+
     MetaData meta;
     Doc dbDoc;
     DocInfo dbDocInfo;
@@ -1108,10 +1136,27 @@ private:
 struct CouchKVStoreTransactionContext : public TransactionContext {
     CouchKVStoreTransactionContext(KVStore& kvstore,
                                    Vbid vbid,
-                                   std::unique_ptr<PersistenceCallback> cb)
-        : TransactionContext(kvstore, vbid, std::move(cb)) {
+                                   std::unique_ptr<PersistenceCallback> cb,
+                                   std::shared_ptr<CouchFlushEncoder> encoder)
+        : TransactionContext(kvstore, vbid, std::move(cb)),
+          encoder(std::move(encoder)) {
     }
 
+    ~CouchKVStoreTransactionContext() override {
+        // The encoder may still reference requests in pendingReqsQ (if the
+        // transaction is abandoned without a commit).
+        if (encoder) {
+            encoder->drain();
+        }
+    }
+
+    /// Encoder the pendingReqsQ are handed to (one per transaction), or
+    /// nullptr if values are compressed by couchstore at commit.
+    const std::shared_ptr<CouchFlushEncoder> encoder;
+
+    /// Set by commit if all pendingReqsQ have been encoded.
+    bool valuesEncoded{false};
+
     CouchKVStore::PendingRequestQueue pendingReqsQ;
 
     /**
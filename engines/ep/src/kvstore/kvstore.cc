@@ -26,6 +26,7 @@
 #include "kvstore/couch-kvstore/couch-kvstore.h"
 #include "kvstore/nexus-kvstore/nexus-kvstore-config.h"
 #include "kvstore/nexus-kvstore/nexus-kvstore.h"
+#include "kvstore/recording-kvstore/recording-kvstore.h"
 #include "kvstore_config.h"
 #include "mcbp/protocol/datatype.h"
 #include "persistence_callback.h"
@@ -211,6 +212,7 @@ void KVStoreStats::reset() {
     commitHisto.reset();
     compactHisto.reset();
     saveDocsHisto.reset();
+    flushEncodeWaitHisto.reset();
     batchSize.reset();
     snapshotHisto.reset();
 
@@ -220,18 +222,10 @@ void KVStoreStats::reset() {
     flusherWriteAmplificationHisto.reset();
 }
 
-std::unique_ptr<KVStoreIface> KVStoreFactory::create(
+static std::unique_ptr<KVStoreIface> createBackend(
         KVStoreConfig& config,
         EncryptionKeyProvider* encryptionKeyProvider,
         std::string_view chronicleAuthToken) {
-    // Directory for kvstore files should exist already (see
-    // EventuallyPersistentEngine::initialize).
-    if (!cb::io::isDirectory(config.getDBName())) {
-        throw std::runtime_error(fmt::format(
-                "KVStoreFactory ctor: Specified dbname '{}' is not a directory",
-                config.getDBName()));
-    }
-
     const auto backend = config.getBackendString();
     if (backend == "couchdb") {
         return std::make_unique<CouchKVStore>(
@@ -259,6 +253,34 @@ std::unique_ptr<KVStoreIface> KVStoreFactory::create(
                         config.getBackendString()));
 }
 
+std::unique_ptr<KVStoreIface> KVStoreFactory::create(
+        KVStoreConfig& config,
+        EncryptionKeyProvider* encryptionKeyProvider,
+        std::string_view chronicleAuthToken) {
+    // Directory for kvstore files should exist already (see
+    // EventuallyPersistentEngine::initialize).
+    if (!cb::io::isDirectory(config.getDBName())) {
+        throw std::runtime_error(fmt::format(
+                "KVStoreFactory ctor: Specified dbname '{}' is not a directory",
+                config.getDBName()));
+    }
+
+    auto kvstore =
+            createBackend(config, encryptionKeyProvider, chronicleAuthToken);
+
+    const auto traceFile = config.getOpTraceFile();
+    if (!traceFile.empty()) {
+        EP_LOG_INFO_CTX("KVStoreFactory::create: Recording KVStore operations",
+                        {"backend", config.getBackendString()},
+                        {"shard", config.getShardId()},
+                        {"path", traceFile});
+        kvstore = std::make_unique<RecordingKVStore>(
+                std::move(kvstore),
+                std::make_unique<KVStoreOpTraceWriter>(traceFile));
+    }
+    return kvstore;
+}
+
 bool KVStore::needsToBePersisted(Vbid vbid, const vbucket_state& newVbstate) {
     /*
      * The vbucket state information is to be persisted only if there is no
@@ -465,6 +487,8 @@ void KVStore::addTimingStats(const AddStatFn& add_stat, CookieIface& c) const {
     add_prefixed_stat(prefix, "snapshot", st.snapshotHisto, add_stat, c);
     add_prefixed_stat(prefix, "delete", st.delTimeHisto, add_stat, c);
     add_prefixed_stat(prefix, "save_documents", st.saveDocsHisto, add_stat, c);
+    add_prefixed_stat(
+            prefix, "flush_encode_wait", st.flushEncodeWaitHisto, add_stat, c);
     add_prefixed_stat(prefix, "readTime", st.readTimeHisto, add_stat, c);
     add_prefixed_stat(prefix, "readSize", st.readSizeHisto, add_stat, c);
     add_prefixed_stat(prefix, "writeTime", st.writeTimeHisto, add_stat, c);
@@ -585,6 +609,18 @@ bool IORequest::isDelete() const {
     return item->isDeleted() && !item->isPending();
 }
 
+CompactionContext::CompactionContext(VBucketPtr vb,
+                                     CompactionConfig config,
+                                     uint64_t purgeSeq,
+                                     std::optional<time_t> timeToExpireFrom)
+    : compactConfig(std::move(config)),
+      vbid(vb ? vb->getId() : Vbid(0)),
+      timeToExpireFrom(timeToExpireFrom),
+      purgedItemCtx(std::make_unique<PurgedItemCtx>(purgeSeq)),
+      vb(std::move(vb)) {
+    isShuttingDown = []() { return false; };
+}
+
 CompactionConfig::CompactionConfig(CompactionConfig&& other) {
     *this = std::move(other);
 }
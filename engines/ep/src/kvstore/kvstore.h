@@ -243,13 +243,7 @@ struct CompactionContext {
     CompactionContext(VBucketPtr vb,
                       CompactionConfig config,
                       uint64_t purgeSeq,
-                      std::optional<time_t> timeToExpireFrom = {})
-        : compactConfig(std::move(config)),
-          timeToExpireFrom(timeToExpireFrom),
-          purgedItemCtx(std::make_unique<PurgedItemCtx>(purgeSeq)),
-          vb(std::move(vb)) {
-        isShuttingDown = []() { return false; };
-    }
+                      std::optional<time_t> timeToExpireFrom = {});
 
     uint64_t getRollbackPurgeSeqno() const {
         return purgedItemCtx->rollbackPurgeSeqnoCtx->getRollbackPurgeSeqno();
@@ -266,6 +260,8 @@ struct CompactionContext {
 
     /// The configuration for this compaction.
     const CompactionConfig compactConfig;
+    /// The vbucket being compacted (known even once the VBucket has gone)
+    const Vbid vbid;
     BloomFilterCBPtr bloomFilterCallback;
     ExpiredItemsCBPtr expiryCallback;
     struct CompactionStats stats;
@@ -698,6 +694,8 @@ public:
     Hdr1sfMicroSecHistogram compactHisto;
     // Time spent in saving documents to disk
     Hdr1sfMicroSecHistogram saveDocsHisto;
+    // Time commit spent waiting for the encode stage of a pipelined flush
+    Hdr1sfMicroSecHistogram flushEncodeWaitHisto;
     // Batch size while saving documents
     Hdr1sfInt32Histogram batchSize;
     //Time spent in vbucket snapshot
@@ -730,7 +728,9 @@ public:
                writeSizeHisto.getMemFootPrint() +
                delTimeHisto.getMemFootPrint() + compactHisto.getMemFootPrint() +
                snapshotHisto.getMemFootPrint() + commitHisto.getMemFootPrint() +
-               saveDocsHisto.getMemFootPrint() + batchSize.getMemFootPrint() +
+               saveDocsHisto.getMemFootPrint() +
+               flushEncodeWaitHisto.getMemFootPrint() +
+               batchSize.getMemFootPrint() +
                getMultiFsReadHisto.getMemFootPrint() +
                getMultiFsReadPerDocHisto.getMemFootPrint() +
                flusherWriteAmplificationHisto.getMemFootPrint();
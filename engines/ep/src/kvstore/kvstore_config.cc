@@ -20,6 +20,7 @@
 #include "kvstore/magma-kvstore/magma-kvstore_config.h"
 #endif
 
+#include <fmt/format.h>
 #include <memory>
 #include <utility>
 
@@ -57,6 +58,7 @@ KVStoreConfig::KVStoreConfig(Configuration& config,
 
     setMetadataPurgeAge(
             std::chrono::seconds{config.getPersistentMetadataPurgeAge()});
+    setOpTraceFilePrefix(config.getKvstoreOpTraceFile());
     config.addValueChangedListener(
             "persistent_metadata_purge_age",
             std::make_unique<ConfigChangeListener>(*this));
@@ -81,7 +83,8 @@ KVStoreConfig::KVStoreConfig(const KVStoreConfig& other)
       dbname(other.dbname),
       backend(other.backend),
       shardId(other.shardId),
-      logger(other.logger) {
+      logger(other.logger),
+      opTraceFilePrefix(other.opTraceFilePrefix) {
 }
 
 KVStoreConfig::~KVStoreConfig() = default;
@@ -95,6 +98,13 @@ size_t KVStoreConfig::getCacheSize() const {
     return std::ceil(float(getMaxVBuckets()) / getMaxShards());
 }
 
+std::string KVStoreConfig::getOpTraceFile() const {
+    if (opTraceFilePrefix.empty()) {
+        return {};
+    }
+    return fmt::format("{}.{}.{}", opTraceFilePrefix, backend, shardId);
+}
+
 std::unique_ptr<KVStoreConfig> KVStoreConfig::createKVStoreConfig(
         Configuration& config,
         std::string_view backend,
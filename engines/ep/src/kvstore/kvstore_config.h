@@ -93,6 +93,16 @@ public:
     /// @returns the size to use for the cached values in the KVStores
     size_t getCacheSize() const;
 
+    /**
+     * @returns the path of the file KVStore operations should be recorded to
+     * (see RecordingKVStore), or an empty string if recording is disabled.
+     */
+    std::string getOpTraceFile() const;
+
+    void setOpTraceFilePrefix(std::string prefix) {
+        opTraceFilePrefix = std::move(prefix);
+    }
+
 protected:
     /**
      * This constructor intialises the object from a central
@@ -123,6 +133,9 @@ protected:
     uint16_t shardId;
     BucketLogger* logger;
 
+    /// Prefix of the KVStore operation trace file, empty if disabled
+    std::string opTraceFilePrefix;
+
     // Following config variables are atomic as can be changed (via
     // ConfigChangeListener) at runtime by front-end threads while read by
     // IO threads.
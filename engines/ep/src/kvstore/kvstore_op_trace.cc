@@ -0,0 +1,142 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "kvstore_op_trace.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+std::string format_as(KVStoreOp op) {
+    switch (op) {
+    case KVStoreOp::Begin:
+        return "begin";
+    case KVStoreOp::Set:
+        return "set";
+    case KVStoreOp::Del:
+        return "del";
+    case KVStoreOp::Commit:
+        return "commit";
+    case KVStoreOp::Get:
+        return "get";
+    case KVStoreOp::GetMultiKey:
+        return "getMultiKey";
+    case KVStoreOp::GetMulti:
+        return "getMulti";
+    case KVStoreOp::ScanBySeqno:
+        return "scanBySeqno";
+    case KVStoreOp::ScanById:
+        return "scanById";
+    case KVStoreOp::Compact:
+        return "compact";
+    }
+    return fmt::format("KVStoreOp::<invalid:{}>", static_cast<int>(op));
+}
+
+KVStoreOpTraceWriter::KVStoreOpTraceWriter(std::filesystem::path path,
+                                           size_t bufferedRecords)
+    : path(std::move(path)),
+      bufferedRecords(std::max(size_t(1), bufferedRecords)),
+      epoch(std::chrono::steady_clock::now()) {
+    stream.open(this->path, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open()) {
+        throw std::system_error(
+                errno,
+                std::system_category(),
+                fmt::format("KVStoreOpTraceWriter: Failed to open '{}'",
+                            this->path.string()));
+    }
+    stream.write(Magic.data(), Magic.size());
+    stream.put(static_cast<char>(Version));
+    buffer.reserve(this->bufferedRecords);
+}
+
+KVStoreOpTraceWriter::~KVStoreOpTraceWriter() {
+    std::lock_guard<std::mutex> guard(mutex);
+    flushLH();
+}
+
+void KVStoreOpTraceWriter::record(const KVStoreOpTraceRecord& rec) {
+    std::lock_guard<std::mutex> guard(mutex);
+    buffer.push_back(rec);
+    ++recordCount;
+    if (buffer.size() >= bufferedRecords) {
+        flushLH();
+    }
+}
+
+void KVStoreOpTraceWriter::record(
+        KVStoreOpTraceRecord rec,
+        std::chrono::steady_clock::time_point startTime) {
+    rec.start = startTime - epoch;
+    rec.duration = std::chrono::steady_clock::now() - startTime;
+    record(rec);
+}
+
+void KVStoreOpTraceWriter::flush() {
+    std::lock_guard<std::mutex> guard(mutex);
+    flushLH();
+}
+
+size_t KVStoreOpTraceWriter::getRecordCount() const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return recordCount;
+}
+
+void KVStoreOpTraceWriter::flushLH() {
+    if (!buffer.empty()) {
+        stream.write(reinterpret_cast<const char*>(buffer.data()),
+                     buffer.size() * sizeof(KVStoreOpTraceRecord));
+        buffer.clear();
+    }
+    stream.flush();
+}
+
+KVStoreOpTraceReader::KVStoreOpTraceReader(const std::filesystem::path& path)
+    : stream(path, std::ios::binary) {
+    if (!stream.is_open()) {
+        throw std::system_error(
+                errno,
+                std::system_category(),
+                fmt::format("KVStoreOpTraceReader: Failed to open '{}'",
+                            path.string()));
+    }
+
+    std::string magic(KVStoreOpTraceWriter::Magic.size(), '\0');
+    stream.read(magic.data(), magic.size());
+    const auto version = stream.get();
+    if (!stream || magic != KVStoreOpTraceWriter::Magic ||
+        version != KVStoreOpTraceWriter::Version) {
+        throw std::runtime_error(fmt::format(
+                "KVStoreOpTraceReader: '{}' is not a version {} KVStore "
+                "operation trace",
+                path.string(),
+                KVStoreOpTraceWriter::Version));
+    }
+}
+
+std::optional<KVStoreOpTraceRecord> KVStoreOpTraceReader::next() {
+    KVStoreOpTraceRecord rec;
+    if (!stream.read(reinterpret_cast<char*>(&rec), sizeof(rec))) {
+        return std::nullopt;
+    }
+    return rec;
+}
+
+std::vector<KVStoreOpTraceRecord> KVStoreOpTraceReader::readAll() {
+    std::vector<KVStoreOpTraceRecord> records;
+    while (auto rec = next()) {
+        records.push_back(*rec);
+    }
+    return records;
+}
@@ -0,0 +1,158 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The KVStore operations which can be captured in an operation trace.
+ */
+enum class KVStoreOp : uint8_t {
+    Begin = 0,
+    Set,
+    Del,
+    Commit,
+    Get,
+    /// One key of a getMulti batch. Always followed (once all keys of the
+    /// batch have been recorded) by a GetMulti record for the batch.
+    GetMultiKey,
+    GetMulti,
+    ScanBySeqno,
+    ScanById,
+    Compact,
+};
+
+std::string format_as(KVStoreOp op);
+
+/**
+ * A single entry in a KVStore operation trace.
+ *
+ * Only the shape of the operation is recorded (sizes, a hash of the key and
+ * timing) - no key or value data is ever written to the trace so that traces
+ * captured on production nodes may be shared.
+ *
+ * The record is written to disk as-is (host byte order), so the layout must
+ * remain stable; bump KVStoreOpTraceWriter::Version if it changes.
+ */
+struct KVStoreOpTraceRecord {
+    KVStoreOp op{KVStoreOp::Begin};
+    uint8_t reserved{0};
+    uint16_t vbid{0};
+    /// Size of the key (or sum of key sizes for batched operations)
+    uint32_t keySize{0};
+    /// Size of the value written / read (or bytes read for a scan)
+    uint32_t valueSize{0};
+    /// Number of items affected by the operation (committed items, keys in a
+    /// getMulti batch, keys visited by a scan ...)
+    uint32_t count{0};
+    /// Hash of the key, allowing a replay to reproduce key re-use
+    uint64_t keyHash{0};
+    /// Start time of the operation, relative to the start of the trace
+    std::chrono::nanoseconds start{0};
+    std::chrono::nanoseconds duration{0};
+
+    bool operator==(const KVStoreOpTraceRecord& other) const = default;
+};
+
+static_assert(sizeof(KVStoreOpTraceRecord) == 40,
+              "KVStoreOpTraceRecord is persisted - layout must not change "
+              "without bumping KVStoreOpTraceWriter::Version");
+
+/**
+ * Appends KVStoreOpTraceRecords to a trace file.
+ *
+ * Records are buffered in memory and written in batches so that recording
+ * adds little overhead to the flusher / bgfetcher. The writer is thread safe
+ * as a KVStore may be accessed concurrently from multiple threads.
+ */
+class KVStoreOpTraceWriter {
+public:
+    /// Magic and version written at the start of every trace file
+    static constexpr std::string_view Magic = "KVOPTRC";
+    static constexpr uint8_t Version = 1;
+
+    /**
+     * Create a writer for the given path. Any existing file is truncated.
+     * @throws std::system_error if the file cannot be opened
+     */
+    explicit KVStoreOpTraceWriter(std::filesystem::path path,
+                                  size_t bufferedRecords = 4096);
+
+    ~KVStoreOpTraceWriter();
+
+    /// @return the time point trace record start times are relative to
+    std::chrono::steady_clock::time_point getEpoch() const {
+        return epoch;
+    }
+
+    /// Append a record to the trace
+    void record(const KVStoreOpTraceRecord& rec);
+
+    /**
+     * Convenience for recording an operation which started at the given time
+     * and has just completed.
+     */
+    void record(KVStoreOpTraceRecord rec,
+                std::chrono::steady_clock::time_point startTime);
+
+    /// Write all buffered records to the file
+    void flush();
+
+    /// @return the number of records recorded so far
+    size_t getRecordCount() const;
+
+    const std::filesystem::path& getPath() const {
+        return path;
+    }
+
+private:
+    void flushLH();
+
+    const std::filesystem::path path;
+    const size_t bufferedRecords;
+    const std::chrono::steady_clock::time_point epoch;
+
+    mutable std::mutex mutex;
+    std::ofstream stream;
+    std::vector<KVStoreOpTraceRecord> buffer;
+    size_t recordCount{0};
+};
+
+/**
+ * Reads back a trace file created by KVStoreOpTraceWriter.
+ */
+class KVStoreOpTraceReader {
+public:
+    /**
+     * Open the given trace file and validate the header
+     * @throws std::system_error if the file cannot be opened
+     * @throws std::runtime_error if the file is not a valid trace
+     */
+    explicit KVStoreOpTraceReader(const std::filesystem::path& path);
+
+    /// @return the next record in the trace, or nullopt at the end of it
+    std::optional<KVStoreOpTraceRecord> next();
+
+    /// Read all of the (remaining) records in the trace
+    std::vector<KVStoreOpTraceRecord> readAll();
+
+private:
+    std::ifstream stream;
+};
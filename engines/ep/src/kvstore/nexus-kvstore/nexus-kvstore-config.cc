@@ -39,6 +39,12 @@ NexusKVStoreConfig::NexusKVStoreConfig(Configuration& config,
     secondaryConfig->setDBName(secondaryConfig->getDBName() +
                                cb::io::DirectorySeparator + "nexus-secondary");
 
+    // KVStore operations are recorded at the Nexus level only. A recording
+    // primary/secondary would also hide their type from NexusKVStore (see
+    // calculateRollbackOrder)
+    primaryConfig->setOpTraceFilePrefix({});
+    secondaryConfig->setOpTraceFilePrefix({});
+
     // Nexus needs compaction to expire items from the same time point to assert
     // that items expired by both KVStores are the same.
     config.setCompactionExpireFromStart(true);
@@ -0,0 +1,581 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "recording-kvstore.h"
+
+#include "collections/collection_persisted_stats.h"
+#include "item.h"
+#include "kvstore/kvstore_transaction_context.h"
+#include "kvstore/rollback_callback.h"
+#include "rollback_result.h"
+#include "vb_commit.h"
+#include "vbucket.h"
+#include "vbucket_bgfetch_item.h"
+#include "vbucket_state.h"
+
+#include <gsl/gsl-lite.hpp>
+
+#include <limits>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+KVStoreOpTraceRecord makeRecord(KVStoreOp op, Vbid vbid) {
+    KVStoreOpTraceRecord rec;
+    rec.op = op;
+    rec.vbid = vbid.get();
+    return rec;
+}
+
+KVStoreOpTraceRecord makeItemRecord(KVStoreOp op, const Item& item) {
+    auto rec = makeRecord(op, item.getVBucketId());
+    const DiskDocKey key{item};
+    rec.keySize = gsl::narrow_cast<uint32_t>(key.size());
+    rec.keyHash = key.hash();
+    rec.valueSize = item.getNBytes();
+    rec.count = 1;
+    return rec;
+}
+} // namespace
+
+RecordingKVStore::RecordingKVStore(
+        std::unique_ptr<KVStoreIface> underlying,
+        std::unique_ptr<KVStoreOpTraceWriter> writer)
+    : underlying(std::move(underlying)), writer(std::move(writer)) {
+    Expects(this->underlying);
+    Expects(this->writer);
+}
+
+RecordingKVStore::~RecordingKVStore() = default;
+
+void RecordingKVStore::deinitialize() {
+    underlying->deinitialize();
+    writer->flush();
+}
+
+bool RecordingKVStore::pause() {
+    writer->flush();
+    return underlying->pause();
+}
+
+void RecordingKVStore::resume() {
+    underlying->resume();
+}
+
+void RecordingKVStore::addStats(const AddStatFn& add_stat,
+                                CookieIface& cookie) const {
+    underlying->addStats(add_stat, cookie);
+}
+
+std::variant<cb::engine_errc, std::unordered_set<std::string>>
+RecordingKVStore::getEncryptionKeyIds() const {
+    return underlying->getEncryptionKeyIds();
+}
+
+std::variant<cb::engine_errc, cb::snapshot::Manifest>
+RecordingKVStore::prepareSnapshot(
+        CookieIface& cookie,
+        const std::filesystem::path& snapshotDirectory,
+        Vbid vb,
+        bool generateChecksums) {
+    return underlying->prepareSnapshot(
+            cookie, snapshotDirectory, vb, generateChecksums);
+}
+
+cb::engine_errc RecordingKVStore::processSnapshots(
+        const std::filesystem::path& path, cb::snapshot::Cache& cache) const {
+    return underlying->processSnapshots(path, cache);
+}
+
+bool RecordingKVStore::getStat(std::string_view name, size_t& value) const {
+    return underlying->getStat(name, value);
+}
+
+GetStatsMap RecordingKVStore::getStats(
+        gsl::span<const std::string_view> keys) const {
+    return underlying->getStats(keys);
+}
+
+void RecordingKVStore::addTimingStats(const AddStatFn& add_stat,
+                                      CookieIface& c) const {
+    underlying->addTimingStats(add_stat, c);
+}
+
+void RecordingKVStore::resetStats() {
+    underlying->resetStats();
+}
+
+size_t RecordingKVStore::getMemFootPrint() const {
+    return underlying->getMemFootPrint();
+}
+
+bool RecordingKVStore::commit(std::unique_ptr<TransactionContext> txnCtx,
+                              VB::Commit& commitData) {
+    auto rec = makeRecord(KVStoreOp::Commit, txnCtx->vbid);
+    {
+        std::lock_guard<std::mutex> guard(pendingCommitsMutex);
+        auto itr = pendingCommits.find(txnCtx->vbid);
+        if (itr != pendingCommits.end()) {
+            rec.count = itr->second.items;
+            rec.valueSize = itr->second.bytes;
+            pendingCommits.erase(itr);
+        }
+    }
+    const auto start = Clock::now();
+    const auto ret = underlying->commit(std::move(txnCtx), commitData);
+    writer->record(rec, start);
+    return ret;
+}
+
+StorageProperties RecordingKVStore::getStorageProperties() const {
+    return underlying->getStorageProperties();
+}
+
+void RecordingKVStore::set(TransactionContext& txnCtx, queued_item item) {
+    auto rec = makeItemRecord(KVStoreOp::Set, *item);
+    const auto start = Clock::now();
+    underlying->set(txnCtx, std::move(item));
+    writer->record(rec, start);
+    addToPendingCommit(txnCtx.vbid, rec);
+}
+
+GetValue RecordingKVStore::get(const DiskDocKey& key,
+                               Vbid vb,
+                               ValueFilter filter) const {
+    auto rec = makeRecord(KVStoreOp::Get, vb);
+    rec.keySize = gsl::narrow_cast<uint32_t>(key.size());
+    rec.keyHash = key.hash();
+    const auto start = Clock::now();
+    auto gv = underlying->get(key, vb, filter);
+    if (gv.item) {
+        rec.valueSize = gv.item->getNBytes();
+        rec.count = 1;
+    }
+    writer->record(rec, start);
+    return gv;
+}
+
+GetValue RecordingKVStore::getWithHeader(const KVFileHandle& kvFileHandle,
+                                         const DiskDocKey& key,
+                                         Vbid vb,
+                                         ValueFilter filter) const {
+    return underlying->getWithHeader(kvFileHandle, key, vb, filter);
+}
+
+void RecordingKVStore::setMaxDataSize(size_t size) {
+    underlying->setMaxDataSize(size);
+}
+
+void RecordingKVStore::getMulti(Vbid vb,
+                                vb_bgfetch_queue_t& itms,
+                                CreateItemCB createItemCb) const {
+    auto batch = makeRecord(KVStoreOp::GetMulti, vb);
+    const auto start = Clock::now();
+    underlying->getMulti(vb, itms, std::move(createItemCb));
+    for (const auto& [key, ctx] : itms) {
+        auto rec = makeRecord(KVStoreOp::GetMultiKey, vb);
+        rec.keySize = gsl::narrow_cast<uint32_t>(key.size());
+        rec.keyHash = key.hash();
+        if (ctx.value.item) {
+            rec.valueSize = ctx.value.item->getNBytes();
+            rec.count = 1;
+        }
+        rec.start = start - writer->getEpoch();
+        writer->record(rec);
+
+        batch.keySize += rec.keySize;
+        batch.valueSize += rec.valueSize;
+    }
+    batch.count = gsl::narrow_cast<uint32_t>(itms.size());
+    writer->record(batch, start);
+}
+
+void RecordingKVStore::getRange(Vbid vb,
+                                const DiskDocKey& startKey,
+                                const DiskDocKey& endKey,
+                                ValueFilter filter,
+                                const GetRangeCb& cb) const {
+    underlying->getRange(vb, startKey, endKey, filter, cb);
+}
+
+void RecordingKVStore::del(TransactionContext& txnCtx, queued_item item) {
+    auto rec = makeItemRecord(KVStoreOp::Del, *item);
+    const auto start = Clock::now();
+    underlying->del(txnCtx, std::move(item));
+    writer->record(rec, start);
+    addToPendingCommit(txnCtx.vbid, rec);
+}
+
+void RecordingKVStore::addToPendingCommit(Vbid vbid,
+                                          const KVStoreOpTraceRecord& rec) {
+    std::lock_guard<std::mutex> guard(pendingCommitsMutex);
+    auto& pending = pendingCommits[vbid];
+    ++pending.items;
+    pending.bytes += rec.keySize + rec.valueSize;
+}
+
+void RecordingKVStore::delVBucket(Vbid vbucket,
+                                  std::unique_ptr<KVStoreRevision> fileRev) {
+    underlying->delVBucket(vbucket, std::move(fileRev));
+}
+
+std::vector<vbucket_state*> RecordingKVStore::listPersistedVbuckets() {
+    return underlying->listPersistedVbuckets();
+}
+
+void RecordingKVStore::completeLoadingVBuckets() {
+    underlying->completeLoadingVBuckets();
+}
+
+bool RecordingKVStore::snapshotVBucket(Vbid vbucketId, const VB::Commit& meta) {
+    return underlying->snapshotVBucket(vbucketId, meta);
+}
+
+CompactDBStatus RecordingKVStore::compactDB(
+        std::unique_lock<std::mutex>& vbLock,
+        std::shared_ptr<CompactionContext> c) {
+    auto rec = makeRecord(KVStoreOp::Compact, c->vbid);
+    auto ctx = c;
+    const auto start = Clock::now();
+    const auto status = underlying->compactDB(vbLock, std::move(c));
+    rec.count = gsl::narrow_cast<uint32_t>(ctx->stats.tombstonesPurged);
+    writer->record(rec, start);
+    return status;
+}
+
+void RecordingKVStore::abortCompactionIfRunning(
+        std::unique_lock<std::mutex>& vbLock, Vbid vbid) {
+    underlying->abortCompactionIfRunning(vbLock, vbid);
+}
+
+vbucket_state* RecordingKVStore::getCachedVBucketState(Vbid vbid) {
+    return underlying->getCachedVBucketState(vbid);
+}
+
+KVStoreIface::ReadVBStateResult RecordingKVStore::getPersistedVBucketState(
+        Vbid vbid) const {
+    return underlying->getPersistedVBucketState(vbid);
+}
+
+KVStoreIface::ReadVBStateResult RecordingKVStore::getPersistedVBucketState(
+        KVFileHandle& handle, Vbid vbid) const {
+    return underlying->getPersistedVBucketState(handle, vbid);
+}
+
+std::pair<cb::engine_errc, std::vector<std::string>>
+RecordingKVStore::mountVBucket(Vbid vbid,
+                               VBucketSnapshotSource source,
+                               const std::vector<std::string>& paths) {
+    return underlying->mountVBucket(vbid, source, paths);
+}
+
+KVStoreIface::ReadVBStateResult RecordingKVStore::loadVBucketSnapshot(
+        Vbid vbid, vbucket_state_t state, const nlohmann::json& topology) {
+    return underlying->loadVBucketSnapshot(vbid, state, topology);
+}
+
+size_t RecordingKVStore::getNumPersistedDeletes(Vbid vbid) {
+    return underlying->getNumPersistedDeletes(vbid);
+}
+
+DBFileInfo RecordingKVStore::getDbFileInfo(Vbid dbFileId) {
+    return underlying->getDbFileInfo(dbFileId);
+}
+
+DBFileInfo RecordingKVStore::getAggrDbFileInfo() {
+    return underlying->getAggrDbFileInfo();
+}
+
+size_t RecordingKVStore::getItemCount(Vbid vbid) {
+    return underlying->getItemCount(vbid);
+}
+
+uint64_t RecordingKVStore::getPurgeSeqno(Vbid vbid) {
+    return underlying->getPurgeSeqno(vbid);
+}
+
+RollbackResult RecordingKVStore::rollback(Vbid vbid,
+                                          uint64_t rollbackseqno,
+                                          std::unique_ptr<RollbackCB> ptr) {
+    return underlying->rollback(vbid, rollbackseqno, std::move(ptr));
+}
+
+void RecordingKVStore::pendingTasks() {
+    underlying->pendingTasks();
+}
+
+cb::engine_errc RecordingKVStore::getAllKeys(
+        Vbid vbid,
+        const DiskDocKey& start_key,
+        uint32_t count,
+        std::shared_ptr<StatusCallback<const DiskDocKey&>> cb) const {
+    return underlying->getAllKeys(vbid, start_key, count, std::move(cb));
+}
+
+bool RecordingKVStore::supportsHistoricalSnapshots() const {
+    return underlying->supportsHistoricalSnapshots();
+}
+
+std::unique_ptr<BySeqnoScanContext> RecordingKVStore::initBySeqnoScanContext(
+        std::unique_ptr<StatusCallback<GetValue>> cb,
+        std::unique_ptr<StatusCallback<CacheLookup>> cl,
+        Vbid vbid,
+        uint64_t startSeqno,
+        DocumentFilter options,
+        ValueFilter valOptions,
+        SnapshotSource source,
+        std::unique_ptr<KVFileHandle> fileHandle) const {
+    return underlying->initBySeqnoScanContext(std::move(cb),
+                                              std::move(cl),
+                                              vbid,
+                                              startSeqno,
+                                              options,
+                                              valOptions,
+                                              source,
+                                              std::move(fileHandle));
+}
+
+std::unique_ptr<ByIdScanContext> RecordingKVStore::initByIdScanContext(
+        std::unique_ptr<StatusCallback<GetValue>> cb,
+        std::unique_ptr<StatusCallback<CacheLookup>> cl,
+        Vbid vbid,
+        const std::vector<ByIdRange>& ranges,
+        DocumentFilter options,
+        ValueFilter valOptions,
+        std::unique_ptr<KVFileHandle> handle) const {
+    return underlying->initByIdScanContext(std::move(cb),
+                                           std::move(cl),
+                                           vbid,
+                                           ranges,
+                                           options,
+                                           valOptions,
+                                           std::move(handle));
+}
+
+void RecordingKVStore::recordScan(KVStoreOp op,
+                                  const ScanContext& sctx,
+                                  size_t keysScannedBefore,
+                                  size_t diskBytesReadBefore,
+                                  Clock::time_point startTime) const {
+    auto rec = makeRecord(op, sctx.vbid);
+    rec.count = gsl::narrow_cast<uint32_t>(sctx.keysScanned -
+                                           keysScannedBefore);
+    rec.valueSize = gsl::narrow_cast<uint32_t>(
+            std::min(sctx.diskBytesRead - diskBytesReadBefore,
+                     size_t(std::numeric_limits<uint32_t>::max())));
+    writer->record(rec, startTime);
+}
+
+ScanStatus RecordingKVStore::scan(BySeqnoScanContext& sctx) const {
+    const auto keysScanned = sctx.keysScanned;
+    const auto diskBytesRead = sctx.diskBytesRead;
+    const auto start = Clock::now();
+    const auto status = underlying->scan(sctx);
+    recordScan(KVStoreOp::ScanBySeqno, sctx, keysScanned, diskBytesRead, start);
+    return status;
+}
+
+ScanStatus RecordingKVStore::scanAllVersions(BySeqnoScanContext& sctx) const {
+    const auto keysScanned = sctx.keysScanned;
+    const auto diskBytesRead = sctx.diskBytesRead;
+    const auto start = Clock::now();
+    const auto status = underlying->scanAllVersions(sctx);
+    recordScan(KVStoreOp::ScanBySeqno, sctx, keysScanned, diskBytesRead, start);
+    return status;
+}
+
+ScanStatus RecordingKVStore::scan(ByIdScanContext& sctx) const {
+    const auto keysScanned = sctx.keysScanned;
+    const auto diskBytesRead = sctx.diskBytesRead;
+    const auto start = Clock::now();
+    const auto status = underlying->scan(sctx);
+    recordScan(KVStoreOp::ScanById, sctx, keysScanned, diskBytesRead, start);
+    return status;
+}
+
+std::unique_ptr<KVFileHandle> RecordingKVStore::makeFileHandle(
+        Vbid vbid) const {
+    return underlying->makeFileHandle(vbid);
+}
+
+std::pair<KVStoreIface::GetCollectionStatsStatus,
+          Collections::VB::PersistedStats>
+RecordingKVStore::getCollectionStats(const KVFileHandle& kvFileHandle,
+                                     CollectionID collection) const {
+    return underlying->getCollectionStats(kvFileHandle, collection);
+}
+
+std::pair<KVStoreIface::GetCollectionStatsStatus,
+          Collections::VB::PersistedStats>
+RecordingKVStore::getCollectionStats(Vbid vbid, CollectionID collection) const {
+    return underlying->getCollectionStats(vbid, collection);
+}
+
+std::optional<Collections::ManifestUid>
+RecordingKVStore::getCollectionsManifestUid(KVFileHandle& kvFileHandle) const {
+    return underlying->getCollectionsManifestUid(kvFileHandle);
+}
+
+std::pair<bool, Collections::KVStore::Manifest>
+RecordingKVStore::getCollectionsManifest(Vbid vbid) const {
+    return underlying->getCollectionsManifest(vbid);
+}
+
+std::pair<bool, std::vector<Collections::KVStore::DroppedCollection>>
+RecordingKVStore::getDroppedCollections(Vbid vbid) const {
+    return underlying->getDroppedCollections(vbid);
+}
+
+const KVStoreConfig& RecordingKVStore::getConfig() const {
+    return underlying->getConfig();
+}
+
+GetValue RecordingKVStore::getBySeqno(KVFileHandle& handle,
+                                      Vbid vbid,
+                                      uint64_t seq,
+                                      ValueFilter filter) const {
+    return underlying->getBySeqno(handle, vbid, seq, filter);
+}
+
+void RecordingKVStore::setStorageThreads(
+        ThreadPoolConfig::StorageThreadCount num) {
+    underlying->setStorageThreads(num);
+}
+
+void RecordingKVStore::endTransaction(Vbid vbid) {
+    underlying->endTransaction(vbid);
+}
+
+std::unique_ptr<TransactionContext> RecordingKVStore::begin(
+        Vbid vbid, std::unique_ptr<PersistenceCallback> pcb) {
+    const auto start = Clock::now();
+    auto ctx = underlying->begin(vbid, std::move(pcb));
+    writer->record(makeRecord(KVStoreOp::Begin, vbid), start);
+    {
+        std::lock_guard<std::mutex> guard(pendingCommitsMutex);
+        pendingCommits[vbid] = {};
+    }
+    return ctx;
+}
+
+const KVStoreStats& RecordingKVStore::getKVStoreStat() const {
+    return underlying->getKVStoreStat();
+}
+
+void RecordingKVStore::setMakeCompactionContextCallback(
+        MakeCompactionContextCallback cb) {
+    underlying->setMakeCompactionContextCallback(std::move(cb));
+}
+
+void RecordingKVStore::setPreFlushHook(std::function<void()> hook) {
+    underlying->setPreFlushHook(std::move(hook));
+}
+
+void RecordingKVStore::setPostFlushHook(std::function<void()> hook) {
+    underlying->setPostFlushHook(std::move(hook));
+}
+
+void RecordingKVStore::setSaveDocsPostWriteDocsHook(
+        std::function<void()> hook) {
+    underlying->setSaveDocsPostWriteDocsHook(std::move(hook));
+}
+
+nlohmann::json RecordingKVStore::getPersistedStats() const {
+    return underlying->getPersistedStats();
+}
+
+bool RecordingKVStore::snapshotStats(const nlohmann::json& stats) {
+    return underlying->snapshotStats(stats);
+}
+
+std::unique_ptr<RollbackCtx> RecordingKVStore::prepareToRollback(Vbid vbid) {
+    return underlying->prepareToRollback(vbid);
+}
+
+void RecordingKVStore::prepareToCreate(Vbid vbid) {
+    underlying->prepareToCreate(vbid);
+}
+
+bool RecordingKVStore::keyMayExist(Vbid vbid, const DocKeyView& key) const {
+    return underlying->keyMayExist(vbid, key);
+}
+
+std::unique_ptr<KVStoreRevision> RecordingKVStore::prepareToDelete(Vbid vbid) {
+    return underlying->prepareToDelete(vbid);
+}
+
+uint64_t RecordingKVStore::getLastPersistedSeqno(Vbid vbid) {
+    return underlying->getLastPersistedSeqno(vbid);
+}
+
+void RecordingKVStore::prepareForDeduplication(
+        std::vector<queued_item>& items) {
+    underlying->prepareForDeduplication(items);
+}
+
+void RecordingKVStore::setSystemEvent(TransactionContext& txnCtx,
+                                      const queued_item item) {
+    underlying->setSystemEvent(txnCtx, item);
+}
+
+void RecordingKVStore::delSystemEvent(TransactionContext& txnCtx,
+                                      const queued_item item) {
+    underlying->delSystemEvent(txnCtx, item);
+}
+
+void RecordingKVStore::setHistoryRetentionBytes(size_t size,
+                                                size_t nVbuckets) {
+    underlying->setHistoryRetentionBytes(size, nVbuckets);
+}
+
+void RecordingKVStore::setHistoryRetentionSeconds(std::chrono::seconds secs) {
+    underlying->setHistoryRetentionSeconds(secs);
+}
+
+std::optional<uint64_t> RecordingKVStore::getHistoryStartSeqno(Vbid vbid) {
+    return underlying->getHistoryStartSeqno(vbid);
+}
+
+std::pair<cb::engine_errc, nlohmann::json> RecordingKVStore::getFusionStats(
+        FusionStat stat, Vbid vbid) {
+    return underlying->getFusionStats(stat, vbid);
+}
+
+cb::engine_errc RecordingKVStore::setChronicleAuthToken(
+        std::string_view token) {
+    return underlying->setChronicleAuthToken(token);
+}
+
+std::string RecordingKVStore::getChronicleAuthToken() const {
+    return underlying->getChronicleAuthToken();
+}
+
+cb::engine_errc RecordingKVStore::syncFusionLogstore(Vbid vbid) {
+    return underlying->syncFusionLogstore(vbid);
+}
+
+cb::engine_errc RecordingKVStore::startFusionUploader(Vbid vbid,
+                                                      uint64_t term) {
+    return underlying->startFusionUploader(vbid, term);
+}
+
+cb::engine_errc RecordingKVStore::stopFusionUploader(Vbid vbid) {
+    return underlying->stopFusionUploader(vbid);
+}
+
+std::unique_ptr<KVStoreRevision> RecordingKVStore::prepareToDeleteImpl(
+        Vbid vbid) {
+    return underlying->prepareToDeleteImpl(vbid);
+}
+
+void RecordingKVStore::prepareToCreateImpl(Vbid vbid) {
+    underlying->prepareToCreateImpl(vbid);
+}
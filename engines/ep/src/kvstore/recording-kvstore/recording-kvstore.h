@@ -0,0 +1,220 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "kvstore/kvstore.h"
+#include "kvstore/kvstore_op_trace.h"
+
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * KVStore which forwards every operation to an underlying KVStore and records
+ * the shape and timing of the interesting ones (begin/set/del/commit, gets,
+ * scans and compaction) into a KVStoreOpTraceWriter.
+ *
+ * The resulting trace can be replayed against any KVStore implementation by
+ * the KVStoreReplayBench benchmark to reproduce production storage behaviour
+ * offline.
+ */
+class RecordingKVStore : public KVStoreIface {
+public:
+    RecordingKVStore(std::unique_ptr<KVStoreIface> underlying,
+                     std::unique_ptr<KVStoreOpTraceWriter> writer);
+
+    ~RecordingKVStore() override;
+
+    KVStoreIface& getUnderlying() const {
+        return *underlying;
+    }
+
+    const KVStoreOpTraceWriter& getTraceWriter() const {
+        return *writer;
+    }
+
+    void deinitialize() override;
+
+    bool pause() override;
+    void resume() override;
+
+    void addStats(const AddStatFn& add_stat,
+                  CookieIface& cookie) const override;
+    std::variant<cb::engine_errc, std::unordered_set<std::string>>
+    getEncryptionKeyIds() const override;
+    std::variant<cb::engine_errc, cb::snapshot::Manifest> prepareSnapshot(
+            CookieIface& cookie,
+            const std::filesystem::path& snapshotDirectory,
+            Vbid vb,
+            bool generateChecksums) override;
+    cb::engine_errc processSnapshots(
+            const std::filesystem::path& path,
+            cb::snapshot::Cache& cache) const override;
+    bool getStat(std::string_view name, size_t& value) const override;
+    GetStatsMap getStats(gsl::span<const std::string_view> keys) const override;
+    void addTimingStats(const AddStatFn& add_stat,
+                        CookieIface& c) const override;
+    void resetStats() override;
+    size_t getMemFootPrint() const override;
+    bool commit(std::unique_ptr<TransactionContext> txnCtx,
+                VB::Commit& commitData) override;
+    StorageProperties getStorageProperties() const override;
+    void set(TransactionContext& txnCtx, queued_item item) override;
+    GetValue get(const DiskDocKey& key,
+                 Vbid vb,
+                 ValueFilter filter) const override;
+    GetValue getWithHeader(const KVFileHandle& kvFileHandle,
+                           const DiskDocKey& key,
+                           Vbid vb,
+                           ValueFilter filter) const override;
+    void setMaxDataSize(size_t size) override;
+    void getMulti(Vbid vb,
+                  vb_bgfetch_queue_t& itms,
+                  CreateItemCB createItemCb) const override;
+    void getRange(Vbid vb,
+                  const DiskDocKey& startKey,
+                  const DiskDocKey& endKey,
+                  ValueFilter filter,
+                  const GetRangeCb& cb) const override;
+    void del(TransactionContext& txnCtx, queued_item item) override;
+    void delVBucket(Vbid vbucket,
+                    std::unique_ptr<KVStoreRevision> fileRev) override;
+    std::vector<vbucket_state*> listPersistedVbuckets() override;
+    void completeLoadingVBuckets() override;
+    bool snapshotVBucket(Vbid vbucketId, const VB::Commit& meta) override;
+    CompactDBStatus compactDB(std::unique_lock<std::mutex>& vbLock,
+                              std::shared_ptr<CompactionContext> c) override;
+    void abortCompactionIfRunning(std::unique_lock<std::mutex>& vbLock,
+                                  Vbid vbid) override;
+    vbucket_state* getCachedVBucketState(Vbid vbid) override;
+    ReadVBStateResult getPersistedVBucketState(Vbid vbid) const override;
+    ReadVBStateResult getPersistedVBucketState(KVFileHandle& handle,
+                                               Vbid vbid) const override;
+    std::pair<cb::engine_errc, std::vector<std::string>> mountVBucket(
+            Vbid vbid,
+            VBucketSnapshotSource source,
+            const std::vector<std::string>& paths) override;
+    ReadVBStateResult loadVBucketSnapshot(
+            Vbid vbid,
+            vbucket_state_t state,
+            const nlohmann::json& topology) override;
+    size_t getNumPersistedDeletes(Vbid vbid) override;
+    DBFileInfo getDbFileInfo(Vbid dbFileId) override;
+    DBFileInfo getAggrDbFileInfo() override;
+    size_t getItemCount(Vbid vbid) override;
+    uint64_t getPurgeSeqno(Vbid vbid) override;
+    RollbackResult rollback(Vbid vbid,
+                            uint64_t rollbackseqno,
+                            std::unique_ptr<RollbackCB> ptr) override;
+    void pendingTasks() override;
+    cb::engine_errc getAllKeys(
+            Vbid vbid,
+            const DiskDocKey& start_key,
+            uint32_t count,
+            std::shared_ptr<StatusCallback<const DiskDocKey&>> cb)
+            const override;
+    bool supportsHistoricalSnapshots() const override;
+    std::unique_ptr<BySeqnoScanContext> initBySeqnoScanContext(
+            std::unique_ptr<StatusCallback<GetValue>> cb,
+            std::unique_ptr<StatusCallback<CacheLookup>> cl,
+            Vbid vbid,
+            uint64_t startSeqno,
+            DocumentFilter options,
+            ValueFilter valOptions,
+            SnapshotSource source,
+            std::unique_ptr<KVFileHandle> fileHandle = nullptr) const override;
+    std::unique_ptr<ByIdScanContext> initByIdScanContext(
+            std::unique_ptr<StatusCallback<GetValue>> cb,
+            std::unique_ptr<StatusCallback<CacheLookup>> cl,
+            Vbid vbid,
+            const std::vector<ByIdRange>& ranges,
+            DocumentFilter options,
+            ValueFilter valOptions,
+            std::unique_ptr<KVFileHandle> handle = nullptr) const override;
+    ScanStatus scan(BySeqnoScanContext& sctx) const override;
+    ScanStatus scanAllVersions(BySeqnoScanContext& sctx) const override;
+    ScanStatus scan(ByIdScanContext& sctx) const override;
+    std::unique_ptr<KVFileHandle> makeFileHandle(Vbid vbid) const override;
+    std::pair<GetCollectionStatsStatus, Collections::VB::PersistedStats>
+    getCollectionStats(const KVFileHandle& kvFileHandle,
+                       CollectionID collection) const override;
+    std::pair<GetCollectionStatsStatus, Collections::VB::PersistedStats>
+    getCollectionStats(Vbid vbid, CollectionID collection) const override;
+    std::optional<Collections::ManifestUid> getCollectionsManifestUid(
+            KVFileHandle& kvFileHandle) const override;
+    std::pair<bool, Collections::KVStore::Manifest> getCollectionsManifest(
+            Vbid vbid) const override;
+    std::pair<bool, std::vector<Collections::KVStore::DroppedCollection>>
+    getDroppedCollections(Vbid vbid) const override;
+    const KVStoreConfig& getConfig() const override;
+    GetValue getBySeqno(KVFileHandle& handle,
+                        Vbid vbid,
+                        uint64_t seq,
+                        ValueFilter filter) const override;
+    void setStorageThreads(ThreadPoolConfig::StorageThreadCount num) override;
+    void endTransaction(Vbid vbid) override;
+    std::unique_ptr<TransactionContext> begin(
+            Vbid vbid, std::unique_ptr<PersistenceCallback> pcb) override;
+    const KVStoreStats& getKVStoreStat() const override;
+    void setMakeCompactionContextCallback(
+            MakeCompactionContextCallback cb) override;
+    void setPreFlushHook(std::function<void()> hook) override;
+    void setPostFlushHook(std::function<void()> hook) override;
+    void setSaveDocsPostWriteDocsHook(std::function<void()> hook) override;
+    nlohmann::json getPersistedStats() const override;
+    bool snapshotStats(const nlohmann::json& stats) override;
+    std::unique_ptr<RollbackCtx> prepareToRollback(Vbid vbid) override;
+    void prepareToCreate(Vbid vbid) override;
+    bool keyMayExist(Vbid vbid, const DocKeyView& key) const override;
+    std::unique_ptr<KVStoreRevision> prepareToDelete(Vbid vbid) override;
+    uint64_t getLastPersistedSeqno(Vbid vbid) override;
+    void prepareForDeduplication(std::vector<queued_item>& items) override;
+    void setSystemEvent(TransactionContext& txnCtx,
+                        const queued_item item) override;
+    void delSystemEvent(TransactionContext& txnCtx,
+                        const queued_item item) override;
+    void setHistoryRetentionBytes(size_t size, size_t nVbuckets) override;
+    void setHistoryRetentionSeconds(std::chrono::seconds secs) override;
+    std::optional<uint64_t> getHistoryStartSeqno(Vbid vbid) override;
+    std::pair<cb::engine_errc, nlohmann::json> getFusionStats(
+            FusionStat stat, Vbid vbid) override;
+    cb::engine_errc setChronicleAuthToken(std::string_view token) override;
+    std::string getChronicleAuthToken() const override;
+    cb::engine_errc syncFusionLogstore(Vbid vbid) override;
+    cb::engine_errc startFusionUploader(Vbid vbid, uint64_t term) override;
+    cb::engine_errc stopFusionUploader(Vbid vbid) override;
+
+protected:
+    std::unique_ptr<KVStoreRevision> prepareToDeleteImpl(Vbid vbid) override;
+    void prepareToCreateImpl(Vbid vbid) override;
+
+    /// Record a scan of the given type which started at startTime
+    void recordScan(KVStoreOp op,
+                    const ScanContext& sctx,
+                    size_t keysScannedBefore,
+                    size_t diskBytesReadBefore,
+                    std::chrono::steady_clock::time_point startTime) const;
+
+    /// Account a set/del against the current transaction of the vBucket
+    void addToPendingCommit(Vbid vbid, const KVStoreOpTraceRecord& rec);
+
+    std::unique_ptr<KVStoreIface> underlying;
+    std::unique_ptr<KVStoreOpTraceWriter> writer;
+
+    /// Items and bytes queued in the open transaction of each vBucket, so
+    /// that the Commit record describes the size of the flush batch.
+    struct PendingCommit {
+        uint32_t items{0};
+        uint32_t bytes{0};
+    };
+    std::mutex pendingCommitsMutex;
+    std::unordered_map<Vbid, PendingCommit> pendingCommits;
+};
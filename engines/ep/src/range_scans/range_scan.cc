@@ -12,9 +12,11 @@
 
 #include "bucket_logger.h"
 #include "collections/collection_persisted_stats.h"
+#include "collections/vbucket_manifest_handles.h"
 #include "dcp/dcpconnmap.h"
 #include "ep_bucket.h"
 #include "ep_engine.h"
+#include "ep_time.h"
 #include "failover-table.h"
 #include "item.h"
 #include "kvstore/kvstore.h"
@@ -32,6 +34,94 @@
 #include <statistics/cbstat_collector.h>
 #include <utilities/logtags.h>
 
+#include <algorithm>
+
+/// An item of RangeScan::MemorySnapshot
+struct RangeScanSnapshotEntry {
+    /// The item (without a value for a key scan or a non-resident value)
+    std::unique_ptr<Item> item;
+    /// false when the value must be read from disk
+    bool resident{true};
+};
+
+struct RangeScan::MemorySnapshot {
+    explicit MemorySnapshot(EPBucket& bucket) : bucket(bucket) {
+    }
+
+    EPBucket& bucket;
+    /// The items of the range in key order
+    std::vector<RangeScanSnapshotEntry> entries;
+    /// The index of the next entry to return
+    size_t next{0};
+    /// The last key returned with a 0 appended (as ByIdScanContext)
+    DiskDocKey resumeFromKey{nullptr, 0};
+};
+
+namespace {
+std::string_view getKeyBytes(DocKeyView key) {
+    return {reinterpret_cast<const char*>(key.data()), key.size()};
+}
+
+/**
+ * Collect the committed, alive items of the range from the HashTable. Gives
+ * up if the range has more than maxItems items.
+ */
+class RangeScanSnapshotVisitor : public HashTableVisitor {
+public:
+    RangeScanSnapshotVisitor(Vbid vbid,
+                             DocKeyView start,
+                             DocKeyView end,
+                             bool keyOnly,
+                             size_t maxItems,
+                             std::vector<RangeScanSnapshotEntry>& entries)
+        : vbid(vbid),
+          start(getKeyBytes(start)),
+          end(getKeyBytes(end)),
+          keyOnly(keyOnly),
+          maxItems(maxItems),
+          entries(entries) {
+    }
+
+    bool visit(const HashTable::HashBucketLock&, StoredValue& v) override {
+        if (v.isTempItem() || v.isDeleted() || v.isPending() ||
+            v.isPrepareCompleted() || v.isExpired(now)) {
+            return true;
+        }
+        const auto key = getKeyBytes(v.getKey());
+        if (key < start || key > end) {
+            return true;
+        }
+        if (entries.size() == maxItems) {
+            tooLarge = true;
+            return false;
+        }
+        const bool resident = v.isResident();
+        entries.push_back(
+                {v.toItem(vbid,
+                          StoredValue::HideLockedCas::Yes,
+                          keyOnly || !resident
+                                  ? StoredValue::IncludeValue::No
+                                  : StoredValue::IncludeValue::Yes),
+                 resident});
+        return true;
+    }
+
+    bool isTooLarge() const {
+        return tooLarge;
+    }
+
+private:
+    const Vbid vbid;
+    const std::string_view start;
+    const std::string_view end;
+    const bool keyOnly;
+    const size_t maxItems;
+    const time_t now{ep_real_time()};
+    std::vector<RangeScanSnapshotEntry>& entries;
+    bool tooLarge{false};
+};
+} // namespace
+
 RangeScan::RangeScan(
         EPBucket& bucket,
         const VBucket& vbucket,
@@ -170,6 +260,14 @@ cb::rangescan::Id RangeScan::createScan(
                             getLogId()));
     }
 
+    // A sample needs the collection stats of the disk snapshot and a strict
+    // snapshot requirement needs the seqno index, else try memory first
+    if (!samplingConfig &&
+        (!snapshotReqs || !snapshotReqs->seqnoMustBeInSnapshot) &&
+        createMemorySnapshot(bucket, snapshotReqs)) {
+        return boost::uuids::random_generator()();
+    }
+
     auto valFilter = cookie.isDatatypeSupported(PROTOCOL_BINARY_DATATYPE_SNAPPY)
                              ? ValueFilter::VALUES_COMPRESSED
                              : ValueFilter::VALUES_DECOMPRESSED;
@@ -352,6 +450,82 @@ size_t RangeScan::tryAndScanOneKey(KVStoreIface& kvstore) {
     return checkOneKey->diskBytesRead;
 }
 
+bool RangeScan::createMemorySnapshot(
+        EPBucket& bucket,
+        const std::optional<cb::rangescan::SnapshotRequirements>&
+                snapshotReqs) {
+    const auto& config = bucket.getEPEngine().getConfiguration();
+    const auto maxItems = config.getRangeScanMemorySnapshotMaxItems();
+    // Only value eviction guarantees that every key is in the HashTable
+    if (maxItems == 0 ||
+        bucket.getItemEvictionPolicy() != EvictionPolicy::Value) {
+        return false;
+    }
+
+    auto vb = bucket.getVBucket(getVBucketId());
+    if (!vb) {
+        return false;
+    }
+
+    // The visit is of the whole HashTable, so bound it by the vbucket size
+    const auto items = vb->getNumItems();
+    if (items == 0 || items > maxItems) {
+        return false;
+    }
+    const auto nonResident = std::min(items, vb->getNumNonResidentItems());
+    if (double(items - nonResident) / double(items) <
+        config.getRangeScanMemorySnapshotResidentRatio()) {
+        return false;
+    }
+
+    if (snapshotReqs) {
+        if (snapshotReqs->vbUuid != vbUuid) {
+            throw cb::engine_error(cb::engine_errc::vbuuid_not_equal,
+                                   fmt::format("{} createMemorySnapshot "
+                                               "snapshotReqs vbUuid mismatch "
+                                               "res:{} vs vbstate:{}",
+                                               getLogId(),
+                                               snapshotReqs->vbUuid,
+                                               vbUuid));
+        }
+        if (uint64_t(vb->getHighSeqno()) < snapshotReqs->seqno) {
+            // Let the disk snapshot decide
+            return false;
+        }
+    }
+
+    // The snapshot is of the HashTable as the visit finds it, a mutation
+    // made during the visit may or may not be seen (but every key committed
+    // before the visit is seen)
+    auto snapshot = std::make_unique<MemorySnapshot>(bucket);
+    RangeScanSnapshotVisitor visitor(getVBucketId(),
+                                     start.getDocKey(),
+                                     end.getDocKey(),
+                                     isKeyOnly(),
+                                     maxItems,
+                                     snapshot->entries);
+    vb->ht.visit(visitor);
+    if (visitor.isTooLarge()) {
+        return false;
+    }
+
+    if (snapshot->entries.empty()) {
+        throw cb::engine_error(
+                cb::engine_errc::no_such_key,
+                fmt::format("{} createMemorySnapshot no keys in range",
+                            getLogId()));
+    }
+
+    std::sort(snapshot->entries.begin(),
+              snapshot->entries.end(),
+              [](const auto& a, const auto& b) {
+                  return getKeyBytes(a.item->getKey()) <
+                         getKeyBytes(b.item->getKey());
+              });
+    memorySnapshot = std::move(snapshot);
+    return true;
+}
+
 cb::engine_errc RangeScan::hasPrivilege(
         CookieIface& cookie, const EventuallyPersistentEngine& engine) {
     return engine.checkCollectionAccess(
@@ -451,6 +625,9 @@ std::unique_ptr<RangeScanContinueResult> RangeScan::cancelOnFrontendThread() {
 
 cb::engine_errc RangeScan::continueOnIOThread(KVStoreIface& kvstore) {
     EP_LOG_DEBUG("{} continueOnIOThread", getLogId());
+    if (memorySnapshot) {
+        return continueFromMemory(kvstore);
+    }
     auto scanStatus = kvstore.scan(*scanCtx);
     cb::engine_errc engineStatus = cb::engine_errc::success;
     switch (scanStatus) {
@@ -483,6 +660,90 @@ cb::engine_errc RangeScan::continueOnIOThread(KVStoreIface& kvstore) {
     return engineStatus;
 }
 
+cb::engine_errc RangeScan::continueFromMemory(KVStoreIface& kvstore) {
+    auto& snapshot = *memorySnapshot;
+
+    // The same checks as RangeScanCacheCallback, once per continue
+    {
+        VBucketPtr vb = snapshot.bucket.getVBucket(getVBucketId());
+        if (!vb) {
+            cancelOnIOThread(cb::engine_errc::not_my_vbucket);
+            return cb::engine_errc::not_my_vbucket;
+        }
+        std::shared_lock rlh(vb->getStateLock());
+        if (!isVbucketScannable(*vb)) {
+            cancelOnIOThread(cb::engine_errc::not_my_vbucket);
+            return cb::engine_errc::not_my_vbucket;
+        }
+        auto cHandle = vb->lockCollections(start.getDocKey());
+        if (!cHandle.valid()) {
+            setUnknownCollectionManifestUid(cHandle.getManifestUid());
+            cancelOnIOThread(cb::engine_errc::unknown_collection);
+            return cb::engine_errc::unknown_collection;
+        }
+    }
+
+    const auto valFilter = continueRunState.isSnappyEnabled()
+                                   ? ValueFilter::VALUES_COMPRESSED
+                                   : ValueFilter::VALUES_DECOMPRESSED;
+    while (snapshot.next < snapshot.entries.size()) {
+        if (isCancelled()) {
+            cancelOnIOThread(cb::engine_errc::range_scan_cancelled);
+            return cb::engine_errc::range_scan_cancelled;
+        }
+
+        const auto& entry = snapshot.entries[snapshot.next];
+        if (isKeyOnly()) {
+            handleKey(entry.item->getKey());
+        } else if (entry.resident) {
+            // The copy shares the value of the snapshot
+            auto item = std::make_unique<Item>(*entry.item);
+            removeXattrs(*item);
+            handleItem(std::move(item), Source::Memory);
+        } else {
+            // Evicted when the snapshot was taken. The item on disk is the
+            // snapshot's, unless it was written again since
+            auto gv = kvstore.get(
+                    DiskDocKey{*entry.item}, getVBucketId(), valFilter);
+            if (gv.getStatus() == cb::engine_errc::success) {
+                if (!gv.item->isDeleted()) {
+                    removeXattrs(*gv.item);
+                    handleItem(std::move(gv.item), Source::Disk);
+                }
+            } else if (gv.getStatus() != cb::engine_errc::no_such_key) {
+                EP_LOG_WARN("{} continueFromMemory get failed {}",
+                            getLogId(),
+                            gv.getStatus());
+                return cb::engine_errc::failed;
+            }
+        }
+
+        snapshot.resumeFromKey = DiskDocKey{*entry.item};
+        snapshot.resumeFromKey.append(0);
+        if (++snapshot.next < snapshot.entries.size() && shouldScanYield()) {
+            return continueRunState.getYieldStatusCodeAndReset();
+        }
+    }
+    return cb::engine_errc::range_scan_complete;
+}
+
+void RangeScan::removeXattrs(Item& item) const {
+    if (!isIncludeXattrs()) {
+        // strip all xattrs if not requested
+        item.removeXattrs();
+    } else if (!hasSystemXattrAccess()) {
+        // Strip system xattrs if no read access
+        item.removeSystemXattrs();
+    }
+}
+
+const DiskDocKey& RangeScan::getResumeFromKey() const {
+    if (memorySnapshot) {
+        return memorySnapshot->resumeFromKey;
+    }
+    return scanCtx->resumeFromKey;
+}
+
 void RangeScan::cancelOnIOThread(cb::engine_errc status) {
     // This status will get returned via notifyIOComplete
     continueRunState.setCancelledStatus(status);
@@ -704,6 +965,8 @@ void RangeScan::addStats(const StatCollector& collector) const {
     addStat("total_items_from_memory", totalValuesFromMemory);
     addStat("total_items_from_disk", totalValuesFromDisk);
     addStat("continues", continueCount);
+    addStat("memory_snapshot",
+            memorySnapshot ? memorySnapshot->entries.size() : 0);
 
     continueRunState.addStats(std::string_view{prefix.data(), prefix.size()},
                               collector);
@@ -54,6 +54,10 @@ struct SnapshotRequirements;
  * so that the KVStore::scan function can be used to iterate over the range and
  * return keys or Items to the RangeScanDataHandlerIFace.
  *
+ * When the vbucket is (mostly) resident, the scan may instead take a sorted
+ * snapshot of the keys in the range from the HashTable and serve the continues
+ * from memory, only reading from disk the values which were not resident when
+ * the snapshot was taken (see range_scan_memory_snapshot_max_items).
  */
 class RangeScan {
 public:
@@ -197,6 +201,11 @@ public:
      */
     cb::engine_errc continueOnIOThread(KVStoreIface& kvstore);
 
+    /// @return true if the scan is served from a snapshot of the HashTable
+    bool isMemorySnapshot() const {
+        return memorySnapshot != nullptr;
+    }
+
     /**
      * IO thread calls this method when an error occurs and the scan must be
      * cancelled.
@@ -209,6 +218,12 @@ public:
         return uuid;
     }
 
+    /**
+     * @return the key from which a yielded scan resumes (inclusive), every
+     *         key before it has been passed to the handler
+     */
+    const DiskDocKey& getResumeFromKey() const;
+
     /// @return true if the scan is currently idle
     bool isIdle() const;
 
@@ -403,6 +418,28 @@ protected:
      */
     size_t tryAndScanOneKey(KVStoreIface& kvstore);
 
+    /**
+     * method used in construction - when the vbucket is eligible, take a
+     * sorted snapshot of the keys in the range from the HashTable so that the
+     * scan does not need a KVStore snapshot.
+     *
+     * @throws cb::engine_error if the snapshot is taken but the range is empty
+     *         or the snapshotReqs vb-uuid doesn't match
+     * @param bucket The EPBucket owning the vbucket
+     * @param snapshotReqs optional requirements for the snapshot
+     * @return true if the scan will be served from the snapshot
+     */
+    bool createMemorySnapshot(
+            EPBucket& bucket,
+            const std::optional<cb::rangescan::SnapshotRequirements>&
+                    snapshotReqs);
+
+    /// continueOnIOThread for a scan served from the memory snapshot
+    cb::engine_errc continueFromMemory(KVStoreIface& kvstore);
+
+    /// Strip the xattrs of item which the scan must not return
+    void removeXattrs(Item& item) const;
+
     /// @return true if this scan is a random sample scan
     bool isSampling() const;
 
@@ -413,6 +450,9 @@ protected:
     // uuid of the vbucket to assist detection of a vbucket state change
     const uint64_t vbUuid{0};
     std::unique_ptr<ByIdScanContext> scanCtx;
+    /// The keys of the scan when served from memory (scanCtx is then null)
+    struct MemorySnapshot;
+    std::unique_ptr<MemorySnapshot> memorySnapshot;
     std::unique_ptr<RangeScanDataHandlerIFace> handler;
     KVStoreScanTracker& resourceTracker;
     /// keys read for the life of this scan (counted for key and value scans)
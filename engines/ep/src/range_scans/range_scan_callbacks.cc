@@ -10,29 +10,41 @@
 
 #include "range_scans/range_scan_callbacks.h"
 
+#include "bucket_logger.h"
 #include "collections/vbucket_manifest_handles.h"
 #include "ep_bucket.h"
 #include "ep_engine.h"
 #include "item.h"
 #include "objectregistry.h"
 #include "range_scans/range_scan.h"
+#include "range_scans/range_scan_projection.h"
 #include "range_scans/range_scan_types.h"
 #include "vbucket.h"
 
+#include <gsl/gsl-lite.hpp>
 #include <mcbp/codec/range_scan_continue_codec.h>
+#include <mcbp/protocol/datatype.h>
 #include <mcbp/protocol/unsigned_leb128.h>
 #include <memcached/cookie_iface.h>
 #include <statistics/cbstat_collector.h>
 
-RangeScanDataHandler::RangeScanDataHandler(EventuallyPersistentEngine& engine,
-                                           bool keyOnly,
-                                           bool includeXattrs)
+RangeScanDataHandler::RangeScanDataHandler(
+        EventuallyPersistentEngine& engine,
+        bool keyOnly,
+        bool includeXattrs,
+        const std::optional<cb::rangescan::ProjectionConfiguration>&
+                projectionConfig)
     : sendTriggerThreshold(
               engine.getConfiguration().getRangeScanReadBufferSendSize()),
       keyOnly(keyOnly),
       includeXattrs(includeXattrs) {
+    if (projectionConfig) {
+        projection = std::make_unique<RangeScanProjection>(*projectionConfig);
+    }
 }
 
+RangeScanDataHandler::~RangeScanDataHandler() = default;
+
 RangeScanDataHandler::Status RangeScanDataHandler::getScanStatus(
         size_t bufferedSize) {
     if (bufferedSize >= sendTriggerThreshold) {
@@ -92,6 +104,15 @@ RangeScanDataHandler::cancelOnFrontendThread() {
     });
 }
 
+std::pair<std::vector<uint8_t>, size_t>
+RangeScanDataHandler::takeBufferedData() {
+    return scannedData.withLock([](auto& ls) {
+        auto readBytes = ls.pendingReadBytes;
+        ls.pendingReadBytes = 0;
+        return std::make_pair(std::move(ls.responseBuffer), readBytes);
+    });
+}
+
 RangeScanDataHandler::Status RangeScanDataHandler::handleKey(DocKeyView key) {
     auto locked = scannedData.lock();
     locked->pendingReadBytes += key.size();
@@ -107,15 +128,55 @@ RangeScanDataHandler::Status RangeScanDataHandler::handleKey(DocKeyView key) {
 
 RangeScanDataHandler::Status RangeScanDataHandler::handleItem(
         std::unique_ptr<Item> item) {
+    const auto readBytes = item->getKey().size() + item->getNBytes();
+
+    // Evaluate the projection/filter here (on the I/O task) so only what the
+    // client asked for is buffered and sent
+    std::string projected;
+    if (projection) {
+        std::string_view value;
+        bool isJson = false;
+        if (item->decompressValue()) {
+            value = {item->getData(), item->getNBytes()};
+            isJson = cb::mcbp::datatype::is_json(item->getDataType());
+        } else {
+            // The value can't be read, so it has none of the fields
+            EP_LOG_WARN(
+                    "RangeScanDataHandler::handleItem failed to snappy "
+                    "uncompress the value of key:{}",
+                    cb::UserDataView(item->getKey().to_string()));
+        }
+        if (!projection->matchesFilter(value, isJson)) {
+            ++filteredValues;
+            auto locked = scannedData.lock();
+            locked->pendingReadBytes += readBytes;
+            return getScanStatus(locked->responseBuffer.size());
+        }
+        if (projection->hasPaths()) {
+            projected = projection->project(value, isJson);
+            if (projected.size() < value.size()) {
+                projectedBytesSaved += value.size() - projected.size();
+            }
+        }
+    }
+
+    auto info = item->toItemInfo(0, false);
+    if (projection && projection->hasPaths()) {
+        info.value[0].iov_base = projected.data();
+        info.value[0].iov_len = projected.size();
+        info.nbytes = gsl::narrow_cast<uint32_t>(projected.size());
+        info.datatype = PROTOCOL_BINARY_DATATYPE_JSON;
+    }
+
     auto locked = scannedData.lock();
-    locked->pendingReadBytes += item->getKey().size() + item->getNBytes();
+    locked->pendingReadBytes += readBytes;
 
     // ensure the buffer is sized for the configured buffer size, this scan will
     // read keys upto this size and we can avoid alloc/memcpy as we push back
     locked->responseBuffer.reserve(sendTriggerThreshold);
 
     cb::mcbp::response::RangeScanContinueValuePayload::encode(
-            locked->responseBuffer, item->toItemInfo(0, false));
+            locked->responseBuffer, info);
     return getScanStatus(locked->responseBuffer.size());
 }
 
@@ -129,6 +190,10 @@ void RangeScanDataHandler::addStats(std::string_view prefix,
     };
 
     addStat("send_threshold", sendTriggerThreshold);
+    if (projection) {
+        addStat("filtered_values", filteredValues.load());
+        addStat("projection_bytes_saved", projectedBytesSaved.load());
+    }
 }
 
 RangeScanCacheCallback::RangeScanCacheCallback(RangeScan& scan,
@@ -15,6 +15,10 @@
 
 #include <folly/Synchronized.h>
 #include <memcached/engine_error.h>
+#include <memcached/range_scan_optional_configuration.h>
+#include <relaxed_atomic.h>
+
+#include <optional>
 
 namespace Collections::VB {
 class CachingReadHandle;
@@ -25,6 +29,7 @@ class EventuallyPersistentEngine;
 class EPBucket;
 class RangeScan;
 class RangeScanContinueResult;
+class RangeScanProjection;
 class StatCollector;
 class VBucket;
 
@@ -123,9 +128,14 @@ public:
  */
 class RangeScanDataHandler : public RangeScanDataHandlerIFace {
 public:
-    RangeScanDataHandler(EventuallyPersistentEngine& engine,
-                         bool keyOnly,
-                         bool includeXattrs);
+    RangeScanDataHandler(
+            EventuallyPersistentEngine& engine,
+            bool keyOnly,
+            bool includeXattrs,
+            const std::optional<cb::rangescan::ProjectionConfiguration>&
+                    projectionConfig = {});
+
+    ~RangeScanDataHandler() override;
 
     Status handleKey(DocKeyView key) override;
 
@@ -145,6 +155,13 @@ public:
 
     std::unique_ptr<RangeScanContinueResult> cancelOnFrontendThread() override;
 
+    /**
+     * Take the buffered data (the mcbp encoded keys/documents) and the number
+     * of bytes read since the previous take. This is for the
+     * RangeScanCoordinator, which sends the data of many scans itself.
+     */
+    std::pair<std::vector<uint8_t>, size_t> takeBufferedData();
+
 private:
     /**
      * @return the status of the scan based on the amount of buffered data
@@ -175,6 +192,15 @@ private:
     const bool keyOnly{false};
 
     const bool includeXattrs{false};
+
+    /// The projection/filter of the values (evaluated by the I/O task)
+    std::unique_ptr<RangeScanProjection> projection;
+
+    /// The number of values dropped by the filter
+    cb::RelaxedAtomic<size_t> filteredValues{0};
+
+    /// The number of value bytes not sent because of the projection
+    cb::RelaxedAtomic<size_t> projectedBytesSaved{0};
 };
 
 /**
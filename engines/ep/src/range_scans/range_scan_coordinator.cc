@@ -0,0 +1,409 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan_coordinator.h"
+
+#include "bucket_logger.h"
+#include "ep_bucket.h"
+#include "ep_engine.h"
+#include "kvstore/kvstore_iface.h"
+#include "objectregistry.h"
+#include "range_scans/range_scan.h"
+#include "range_scans/range_scan_callbacks.h"
+#include "range_scans/range_scan_coordinator_task.h"
+#include "range_scans/range_scan_create_task.h"
+#include "range_scans/range_scan_owner.h"
+#include "vbucket.h"
+
+#include <executor/executorpool.h>
+#include <folly/ScopeGuard.h>
+#include <mcbp/codec/range_scan_continue_codec.h>
+#include <memcached/connection_iface.h>
+#include <memcached/cookie_iface.h>
+#include <nlohmann/json.hpp>
+#include <platform/base64.h>
+
+static std::map<Vbid, std::string> makeResumeMap(
+        const std::vector<std::pair<Vbid, std::string>>& resume) {
+    return {resume.begin(), resume.end()};
+}
+
+static std::optional<std::chrono::steady_clock::time_point> makeDeadline(
+        std::chrono::milliseconds timeLimit) {
+    if (timeLimit.count() == 0) {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::now() + timeLimit;
+}
+
+RangeScanCoordinator::RangeScanCoordinator(
+        EPBucket& bucket,
+        CookieIface& cookie,
+        const cb::rangescan::MultiVbucketParameters& params,
+        std::vector<Vbid> vbuckets,
+        size_t tasks)
+    : bucket(bucket),
+      cookie(cookie),
+      cid(params.cid),
+      start(RangeScanCreateTask::makeStartStoredDocKey(params.cid,
+                                                       params.start)),
+      end(RangeScanCreateTask::makeEndStoredDocKey(params.cid, params.end)),
+      keyOnly(params.keyOnly),
+      includeXattrs(params.includeXattrs),
+      projection(params.projection),
+      requestResume(makeResumeMap(params.resume)),
+      byteLimit(params.byteLimit),
+      name(params.name),
+      deadline(makeDeadline(params.timeLimit)),
+      slots(tasks),
+      maxQueuedBytes(2 * slots.size() *
+                     bucket.getEPEngine()
+                             .getConfiguration()
+                             .getRangeScanReadBufferSendSize()) {
+    state.lock()->pending = {vbuckets.begin(), vbuckets.end()};
+}
+
+RangeScanCoordinator::~RangeScanCoordinator() = default;
+
+void RangeScanCoordinator::schedule() {
+    state.lock()->runningTasks = slots.size();
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+        taskIds.push_back(ExecutorPool::get()->schedule(
+                std::make_shared<RangeScanCoordinatorTask>(
+                        bucket, shared_from_this(), slot)));
+    }
+}
+
+RangeScanCoordinator::RunStatus RangeScanCoordinator::runOnIOThread(
+        size_t slot) {
+    auto& vbScan = slots.at(slot);
+    if (!vbScan.scan) {
+        return startNextScan(vbScan);
+    }
+
+    {
+        auto locked = state.lock();
+        if (locked->cancelled) {
+            vbScan = {};
+            return RunStatus::Again;
+        }
+        if (isLimitReached(*locked)) {
+            stopScan(*locked, vbScan);
+            return RunStatus::Again;
+        }
+        if (locked->queuedBytes >= maxQueuedBytes) {
+            // The client hasn't taken the queued data yet (e.g. its send
+            // queue is full), sendOnFrontendThread wakes the task
+            return RunStatus::Wait;
+        }
+    }
+
+    const auto status = vbScan.scan->continueOnIOThread(
+            *bucket.getRWUnderlying(vbScan.vbid));
+    auto [data, readBytes] = vbScan.handler->takeBufferedData();
+
+    auto locked = state.lock();
+    if (locked->cancelled) {
+        vbScan = {};
+        return RunStatus::Again;
+    }
+
+    locked->readBytes += readBytes;
+    if (!data.empty()) {
+        locked->queuedBytes += data.size();
+        locked->totalBytes += data.size();
+        locked->chunks.push_back({vbScan.vbid, std::move(data)});
+    }
+
+    switch (status) {
+    case cb::engine_errc::success:
+        // The send buffer filled, the scan continues on the next run
+        break;
+    case cb::engine_errc::range_scan_more:
+        // The time limit of the request was reached
+        locked->stopped = true;
+        stopScan(*locked, vbScan);
+        break;
+    case cb::engine_errc::range_scan_complete:
+        finishScan(*locked, vbScan, std::nullopt);
+        break;
+    default:
+        finishScan(*locked, vbScan, status);
+        break;
+    }
+
+    notifyIfWaiting(*locked);
+    if (locked->queuedBytes >= maxQueuedBytes) {
+        return RunStatus::Wait;
+    }
+    return RunStatus::Again;
+}
+
+RangeScanCoordinator::RunStatus RangeScanCoordinator::startNextScan(
+        VBucketScan& vbScan) {
+    Vbid vbid;
+    {
+        auto locked = state.lock();
+        if (locked->cancelled || isLimitReached(*locked) ||
+            locked->pending.empty()) {
+            // This task is done, the last task to finish completes the scan
+            --locked->runningTasks;
+            bucket.getReadyRangeScans()->releaseCoordinatorTask(bucket);
+            notifyIfWaiting(*locked);
+            return RunStatus::Finished;
+        }
+
+        if (!bucket.getKVStoreScanTracker().canCreateAndReserveRangeScan()) {
+            // Every scan the bucket permits is open, try again shortly
+            return RunStatus::Retry;
+        }
+        vbid = locked->pending.front();
+        locked->pending.pop_front();
+    }
+
+    // Until a RangeScan owns the reservation, release it on every way out
+    auto reservation = folly::makeGuard([this] {
+        bucket.getKVStoreScanTracker().decrNumRunningRangeScans();
+    });
+
+    std::optional<cb::engine_errc> failure;
+    try {
+        auto vb = bucket.getVBucket(vbid);
+        if (!vb || vb->getState() != vbucket_state_active) {
+            failure = cb::engine_errc::not_my_vbucket;
+        } else {
+            // The start of the vbucket is the key after the resume key (if
+            // any)
+            auto vbStart = start;
+            if (const auto* resume = getRequestResumeKey(vbid)) {
+                vbStart = RangeScanCreateTask::makeStartStoredDocKey(
+                        cid,
+                        cb::rangescan::KeyView{
+                                *resume, cb::rangescan::KeyType::Exclusive});
+            }
+            auto handler = std::make_unique<RangeScanDataHandler>(
+                    bucket.getEPEngine(),
+                    keyOnly == cb::rangescan::KeyOnly::Yes,
+                    includeXattrs == cb::rangescan::IncludeXattrs::Yes,
+                    projection);
+            auto* handlerPtr = handler.get();
+            // The RangeScan owns the reservation from here, the constructor
+            // releases it when it throws (the snapshot cannot be opened, or
+            // the range is empty)
+            reservation.dismiss();
+            vbScan.scan = std::make_unique<RangeScan>(bucket,
+                                                      *vb,
+                                                      DiskDocKey{vbStart},
+                                                      DiskDocKey{end},
+                                                      std::move(handler),
+                                                      cookie,
+                                                      keyOnly,
+                                                      includeXattrs,
+                                                      std::nullopt,
+                                                      std::nullopt,
+                                                      name);
+            vbScan.handler = handlerPtr;
+            vbScan.vbid = vbid;
+        }
+    } catch (const cb::engine_error& e) {
+        failure = cb::engine_errc(e.code().value());
+    } catch (const std::exception& e) {
+        EP_LOG_WARN_CTX("RangeScanCoordinator failed to create the scan",
+                        {"vb", vbid},
+                        {"error", e.what()},
+                        {"name", name});
+        failure = cb::engine_errc::failed;
+    }
+
+    if (failure) {
+        auto locked = state.lock();
+        vbScan.vbid = vbid;
+        // An empty range is a scan which found nothing
+        finishScan(*locked,
+                   vbScan,
+                   *failure == cb::engine_errc::no_such_key
+                           ? std::nullopt
+                           : failure);
+        return RunStatus::Again;
+    }
+
+    // The scan runs without item/byte limits (the request limits are checked
+    // between the runs), but the time limit is enforced by the scan
+    std::chrono::milliseconds timeLimit{0};
+    if (deadline) {
+        timeLimit = std::max(
+                std::chrono::milliseconds(1),
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                        *deadline - std::chrono::steady_clock::now()));
+    }
+    vbScan.scan->setStateContinuing(cookie, 0, timeLimit, 0);
+    vbScan.scan->prepareToRunOnContinueTask();
+    return RunStatus::Again;
+}
+
+void RangeScanCoordinator::stopScan(State& locked, VBucketScan& vbScan) {
+    const auto& resumeFrom = vbScan.scan->getResumeFromKey();
+    if (resumeFrom.size()) {
+        // resumeFrom is the last key read with a 0 appended
+        auto key = resumeFrom.getDocKey().makeDocKeyWithoutCollectionID();
+        locked.resume[vbScan.vbid] = std::string{
+                reinterpret_cast<const char*>(key.data()), key.size() - 1};
+    } else if (const auto* resume = getRequestResumeKey(vbScan.vbid)) {
+        // Nothing read, so resume where this request resumed
+        locked.resume[vbScan.vbid] = *resume;
+    } else {
+        // Nothing read, the vbucket is still to be started
+        locked.pending.push_front(vbScan.vbid);
+    }
+    vbScan = {};
+}
+
+void RangeScanCoordinator::finishScan(State& locked,
+                                      VBucketScan& vbScan,
+                                      std::optional<cb::engine_errc> failure) {
+    if (failure) {
+        EP_LOG_INFO_CTX("RangeScanCoordinator scan of vbucket failed",
+                        {"vb", vbScan.vbid},
+                        {"status", *failure},
+                        {"name", name});
+        locked.failed[vbScan.vbid] = *failure;
+    }
+    vbScan = {};
+}
+
+void RangeScanCoordinator::notifyIfWaiting(State& locked) {
+    if (locked.waiting && !locked.cancelled &&
+        (!locked.chunks.empty() || locked.runningTasks == 0)) {
+        locked.waiting = false;
+        bucket.getEPEngine().notifyIOComplete(cookie,
+                                              cb::engine_errc::success);
+    }
+}
+
+bool RangeScanCoordinator::isLimitReached(const State& locked) const {
+    if (locked.stopped) {
+        return true;
+    }
+    if (byteLimit && locked.totalBytes >= byteLimit) {
+        return true;
+    }
+    return deadline && std::chrono::steady_clock::now() >= *deadline;
+}
+
+const std::string* RangeScanCoordinator::getRequestResumeKey(Vbid vbid) const {
+    auto itr = requestResume.find(vbid);
+    if (itr == requestResume.end()) {
+        return nullptr;
+    }
+    return &itr->second;
+}
+
+bool RangeScanCoordinator::isFinished() const {
+    return state.lock()->runningTasks == 0;
+}
+
+cb::engine_errc RangeScanCoordinator::sendOnFrontendThread(
+        CookieIface& client) {
+    if (client.getConnectionIface().isSendQueueFull()) {
+        // The client isn't reading what it has been sent. Keep the data
+        // queued (the tasks wait once the queue is full) and leave the client
+        // to be executed again when its send queue has drained
+        return cb::engine_errc::too_much_data_in_output_buffer;
+    }
+
+    auto locked = state.lock();
+    {
+        NonBucketAllocationGuard guard;
+        for (const auto& chunk : locked->chunks) {
+            cb::mcbp::response::RangeScanMultiResponseExtras extras(
+                    keyOnly == cb::rangescan::KeyOnly::Yes, chunk.vbid);
+            client.sendResponse(
+                    cb::engine_errc::success,
+                    extras.getBuffer(),
+                    {reinterpret_cast<const char*>(chunk.data.data()),
+                     chunk.data.size()});
+        }
+    }
+    locked->chunks.clear();
+    locked->queuedBytes = 0;
+    client.addDocumentReadBytes(locked->readBytes);
+    locked->readBytes = 0;
+
+    if (locked->runningTasks == 0) {
+        const bool more = !locked->resume.empty() || !locked->pending.empty();
+        const auto status = more ? cb::engine_errc::range_scan_more
+                                 : cb::engine_errc::range_scan_complete;
+        const auto response = makeFinalResponse(*locked);
+        NonBucketAllocationGuard guard;
+        client.sendResponse(status, {}, response);
+        return status;
+    }
+
+    locked->waiting = true;
+    locked.unlock();
+    // The tasks waiting for the client can continue
+    wakeTasks();
+    return cb::engine_errc::would_block;
+}
+
+std::string RangeScanCoordinator::makeFinalResponse(
+        const State& locked) const {
+    nlohmann::json json = nlohmann::json::object();
+    if (!locked.resume.empty()) {
+        auto& resume = json["resume"];
+        for (const auto& [vbid, key] : locked.resume) {
+            resume[std::to_string(vbid.get())] = cb::base64::encode(key);
+        }
+    }
+    if (!locked.pending.empty()) {
+        auto& pending = json["pending"];
+        for (const auto& vbid : locked.pending) {
+            pending.push_back(vbid.get());
+        }
+    }
+    if (!locked.failed.empty()) {
+        auto& failed = json["failed"];
+        for (const auto& [vbid, status] : locked.failed) {
+            failed[std::to_string(vbid.get())] = to_string(status);
+        }
+    }
+    return json.dump();
+}
+
+void RangeScanCoordinator::cancel() {
+    {
+        auto locked = state.lock();
+        locked->cancelled = true;
+        locked->waiting = false;
+    }
+    wakeTasks();
+}
+
+void RangeScanCoordinator::wakeTasks() {
+    for (const auto id : taskIds) {
+        ExecutorPool::get()->wake(id);
+    }
+}
+
+RangeScanCoordinatorToken::RangeScanCoordinatorToken(
+        std::shared_ptr<RangeScanCoordinator> coordinator)
+    : coordinator(std::move(coordinator)) {
+}
+
+RangeScanCoordinatorToken::RangeScanCoordinatorToken(
+        RangeScanCoordinatorToken&& other) noexcept
+    : coordinator(std::move(other.coordinator)) {
+}
+
+RangeScanCoordinatorToken::~RangeScanCoordinatorToken() {
+    if (coordinator && !coordinator->isFinished()) {
+        coordinator->cancel();
+    }
+}
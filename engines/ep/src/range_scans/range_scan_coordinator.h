@@ -0,0 +1,215 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <memcached/engine_error.h>
+#include <memcached/range_scan.h>
+#include <memcached/range_scan_optional_configuration.h>
+#include <memcached/storeddockey.h>
+#include <memcached/vbucket.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+class CookieIface;
+class EPBucket;
+class RangeScan;
+class RangeScanDataHandler;
+
+/**
+ * RangeScanCoordinator runs one logical range scan (range-scan-multi) of a
+ * collection across many vbuckets.
+ *
+ * The vbuckets are scanned by a bounded number of RangeScanCoordinatorTasks
+ * (AuxIO, counted with the RangeScanContinueTasks against the bucket's range
+ * scan task limit), each task scans one vbucket at a time using a RangeScan
+ * which is private to the coordinator (it is not added to the RangeScanOwner
+ * of the vbucket). The data the tasks read is queued (per vbucket) and the
+ * frontend thread sends the queued data to the client, interleaving the
+ * vbuckets.
+ *
+ * The coordinator holds no state beyond the request. When the request stops
+ * early (a limit is reached) the final response tells the client the key
+ * each vbucket stopped at, and the client resumes with a new request.
+ */
+class RangeScanCoordinator
+    : public std::enable_shared_from_this<RangeScanCoordinator> {
+public:
+    /// What a task does after a call to runOnIOThread
+    enum class RunStatus {
+        /// Run again (the task has more to scan)
+        Again,
+        /// Sleep until woken, the client hasn't caught up with the scan
+        Wait,
+        /// Run again after a short sleep, the bucket has no capacity to scan
+        Retry,
+        /// Exit, there is nothing more for the task to scan
+        Finished
+    };
+
+    /**
+     * @param bucket The bucket to scan
+     * @param cookie The client requesting the scan
+     * @param params The parameters of the scan (copied)
+     * @param vbuckets The vbuckets to scan
+     * @param tasks The number of tasks to scan with, reserved from the
+     *        bucket's ReadyRangeScans (each is released as the task finishes)
+     */
+    RangeScanCoordinator(EPBucket& bucket,
+                         CookieIface& cookie,
+                         const cb::rangescan::MultiVbucketParameters& params,
+                         std::vector<Vbid> vbuckets,
+                         size_t tasks);
+
+    ~RangeScanCoordinator();
+
+    /// Schedule the tasks which scan the vbuckets
+    void schedule();
+
+    /**
+     * Scan the next part of the vbucket the task is scanning (starting on
+     * the next vbucket when the task has none). Called by the task.
+     *
+     * @param slot The index of the calling task
+     */
+    RunStatus runOnIOThread(size_t slot);
+
+    /**
+     * Send the queued data to the client and when the scan is finished the
+     * final response.
+     *
+     * @return range_scan_complete/range_scan_more when the final response
+     *         was sent, too_much_data_in_output_buffer when nothing was sent
+     *         because the send queue of the client is full, else would_block
+     */
+    cb::engine_errc sendOnFrontendThread(CookieIface& client);
+
+    /// Stop the scan, no more data will be read and the client will not be
+    /// notified (for when the client has gone)
+    void cancel();
+
+    /// @return true when every task has finished
+    bool isFinished() const;
+
+protected:
+    /// The scan of one vbucket by one task
+    struct VBucketScan {
+        Vbid vbid;
+        std::unique_ptr<RangeScan> scan;
+        /// The handler of scan (owned by the scan)
+        RangeScanDataHandler* handler{nullptr};
+    };
+
+    /// Data read from a vbucket and not yet sent
+    struct Chunk {
+        Vbid vbid;
+        std::vector<uint8_t> data;
+    };
+
+    struct State {
+        /// The vbuckets not yet started
+        std::deque<Vbid> pending;
+        /// The data to send
+        std::deque<Chunk> chunks;
+        /// The size of chunks
+        size_t queuedBytes{0};
+        /// The size of all data read (sent or queued)
+        size_t totalBytes{0};
+        /// The document bytes read but not yet accounted to the client
+        size_t readBytes{0};
+        /// The last key read of the vbuckets which stopped before the end
+        std::map<Vbid, std::string> resume;
+        /// The vbuckets which failed and why
+        std::map<Vbid, cb::engine_errc> failed;
+        /// The number of tasks still running
+        size_t runningTasks{0};
+        /// true when the client is blocked waiting for a notification
+        bool waiting{true};
+        /// true when a limit of the request has been reached
+        bool stopped{false};
+        /// true when the client has gone
+        bool cancelled{false};
+    };
+
+    /// Start the scan of the next vbucket on the slot
+    RunStatus startNextScan(VBucketScan& vbScan);
+
+    /**
+     * The scan of the vbucket on the slot stopped before the end, record
+     * where it can resume from and discard the scan.
+     */
+    void stopScan(State& state, VBucketScan& vbScan);
+
+    /// The scan of the vbucket on the slot is done (complete or failed)
+    void finishScan(State& state,
+                    VBucketScan& vbScan,
+                    std::optional<cb::engine_errc> failure);
+
+    /// Notify the client if it is waiting and there is something for it
+    void notifyIfWaiting(State& state);
+
+    /// @return true if a limit of the request has been reached
+    bool isLimitReached(const State& state) const;
+
+    /// @return the resume token of the vbucket given in the request
+    const std::string* getRequestResumeKey(Vbid vbid) const;
+
+    /// @return the final response (json)
+    std::string makeFinalResponse(const State& state) const;
+
+    /// Wake all of the tasks (those waiting for the client)
+    void wakeTasks();
+
+    EPBucket& bucket;
+    CookieIface& cookie;
+    const CollectionID cid;
+    const StoredDocKey start;
+    const StoredDocKey end;
+    const cb::rangescan::KeyOnly keyOnly;
+    const cb::rangescan::IncludeXattrs includeXattrs;
+    const std::optional<cb::rangescan::ProjectionConfiguration> projection;
+    const std::map<Vbid, std::string> requestResume;
+    const size_t byteLimit;
+    const std::string name;
+    /// When the request must stop (if the request has a time limit)
+    const std::optional<std::chrono::steady_clock::time_point> deadline;
+
+    /// The scan of each task (only accessed by the owning task)
+    std::vector<VBucketScan> slots;
+    /// The bytes which may be queued before the tasks wait for the client
+    const size_t maxQueuedBytes;
+    /// The ids of the tasks (the tasks own the coordinator)
+    std::vector<size_t> taskIds;
+
+    folly::Synchronized<State, std::mutex> state;
+};
+
+/**
+ * The engine specific data of a range-scan-multi whilst the scan runs. When
+ * the token is destroyed with the scan still running (the client has gone)
+ * the scan is cancelled.
+ */
+struct RangeScanCoordinatorToken {
+    explicit RangeScanCoordinatorToken(
+            std::shared_ptr<RangeScanCoordinator> coordinator);
+    RangeScanCoordinatorToken(RangeScanCoordinatorToken&& other) noexcept;
+    RangeScanCoordinatorToken& operator=(RangeScanCoordinatorToken&&) = delete;
+    ~RangeScanCoordinatorToken();
+
+    std::shared_ptr<RangeScanCoordinator> coordinator;
+};
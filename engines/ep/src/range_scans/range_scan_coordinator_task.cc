@@ -0,0 +1,47 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan_coordinator_task.h"
+
+#include "ep_bucket.h"
+#include "ep_engine.h"
+#include "range_scans/range_scan_coordinator.h"
+
+#include <folly/lang/Assume.h>
+#include <phosphor/phosphor.h>
+
+RangeScanCoordinatorTask::RangeScanCoordinatorTask(
+        EPBucket& bucket,
+        std::shared_ptr<RangeScanCoordinator> coordinator,
+        size_t slot)
+    : EpNotifiableTask(bucket.getEPEngine(),
+                       TaskId::RangeScanCoordinatorTask,
+                       0 /*sleeptime*/),
+      coordinator(std::move(coordinator)),
+      slot(slot) {
+}
+
+bool RangeScanCoordinatorTask::runInner(bool) {
+    TRACE_EVENT1("ep-engine/task", "RangeScanCoordinatorTask", "slot", slot);
+    switch (coordinator->runOnIOThread(slot)) {
+    case RangeScanCoordinator::RunStatus::Again:
+        snooze(0);
+        return true;
+    case RangeScanCoordinator::RunStatus::Wait:
+        // Sleep until the coordinator wakes the task
+        return true;
+    case RangeScanCoordinator::RunStatus::Retry:
+        snooze(0.01);
+        return true;
+    case RangeScanCoordinator::RunStatus::Finished:
+        return false;
+    }
+    folly::assume_unreachable();
+}
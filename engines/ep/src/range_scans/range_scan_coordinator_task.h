@@ -0,0 +1,45 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "ep_task.h"
+
+#include <memory>
+
+class EPBucket;
+class RangeScanCoordinator;
+
+/**
+ * RangeScanCoordinatorTask scans vbuckets for a RangeScanCoordinator, one
+ * vbucket at a time, until the coordinator has no more vbuckets to scan.
+ * The task sleeps whilst the client catches up with the data read.
+ */
+class RangeScanCoordinatorTask : public EpNotifiableTask {
+public:
+    RangeScanCoordinatorTask(EPBucket& bucket,
+                             std::shared_ptr<RangeScanCoordinator> coordinator,
+                             size_t slot);
+
+    std::string getDescription() const override {
+        return "RangeScanCoordinatorTask";
+    }
+
+    std::chrono::microseconds maxExpectedDuration() const override {
+        // Each run reads up to the send threshold of one vbucket
+        return std::chrono::seconds(1);
+    }
+
+protected:
+    bool runInner(bool manuallyNotified) override;
+
+    const std::shared_ptr<RangeScanCoordinator> coordinator;
+    const size_t slot;
+};
@@ -60,17 +60,20 @@ void ReadyRangeScans::addScan(EPBucket& bucket,
     auto lockedTasks = continueTasks.wlock();
     // If more scans than tasks, see if we can create a new task
     if (lockedScans->size() > lockedTasks->size() &&
-        lockedTasks->size() < concurrentTaskLimit) {
-        // new task
-        auto [itr, emplaced] =
-                lockedTasks->emplace(ExecutorPool::get()->schedule(
-                        std::make_shared<RangeScanContinueTask>(bucket)));
-        if (!emplaced) {
-            throw std::runtime_error(
-                    fmt::format("ReadyRangeScans::addScan failed to add a new "
-                                "task, ID collision {}",
-                                *itr));
-        }
+        lockedTasks->size() + coordinatorTasks < concurrentTaskLimit) {
+        addContinueTask(bucket, *lockedTasks);
+    }
+}
+
+void ReadyRangeScans::addContinueTask(EPBucket& bucket,
+                                      std::unordered_set<size_t>& tasks) {
+    auto [itr, emplaced] = tasks.emplace(ExecutorPool::get()->schedule(
+            std::make_shared<RangeScanContinueTask>(bucket)));
+    if (!emplaced) {
+        throw std::runtime_error(
+                fmt::format("ReadyRangeScans::addContinueTask failed to add a "
+                            "new task, ID collision {}",
+                            *itr));
     }
 }
 
@@ -81,7 +84,8 @@ std::shared_ptr<RangeScan> ReadyRangeScans::takeNextScan(size_t taskId) {
         auto lockedTasks = continueTasks.wlock();
         // If no scans or the number of tasks now exceeds the limit
         // this calling task is told to exit
-        if (lockedScans->empty() || lockedTasks->size() > concurrentTaskLimit) {
+        if (lockedScans->empty() ||
+            lockedTasks->size() + coordinatorTasks > concurrentTaskLimit) {
             // Remove the calling task from the set of tasks
             if (lockedTasks->erase(taskId) == 0) {
                 throw std::runtime_error(
@@ -100,9 +104,38 @@ std::shared_ptr<RangeScan> ReadyRangeScans::takeNextScan(size_t taskId) {
     return scan;
 }
 
+size_t ReadyRangeScans::reserveCoordinatorTasks(size_t wanted) {
+    auto lockedTasks = continueTasks.wlock();
+    const auto running = lockedTasks->size() + coordinatorTasks;
+    if (running >= concurrentTaskLimit) {
+        return 0;
+    }
+    const auto reserved = std::min(wanted, concurrentTaskLimit - running);
+    coordinatorTasks += reserved;
+    return reserved;
+}
+
+void ReadyRangeScans::releaseCoordinatorTask(EPBucket& bucket) {
+    // Same lock order as addScan
+    auto lockedScans = rangeScans.wlock();
+    auto lockedTasks = continueTasks.wlock();
+    if (coordinatorTasks == 0) {
+        throw std::logic_error(
+                "ReadyRangeScans::releaseCoordinatorTask no task is reserved");
+    }
+    --coordinatorTasks;
+
+    // Scans added whilst the coordinators held the tasks may have no task
+    if (lockedScans->size() > lockedTasks->size() &&
+        lockedTasks->size() + coordinatorTasks < concurrentTaskLimit) {
+        addContinueTask(bucket, *lockedTasks);
+    }
+}
+
 void ReadyRangeScans::addStats(const StatCollector& collector) const {
     collector.addStat("concurrent_task_limit", concurrentTaskLimit);
     collector.addStat("tasks_size", getTaskQueueSize());
+    collector.addStat("coordinator_tasks", getCoordinatorTasks());
     collector.addStat("ready_queue_size", getReadyQueueSize());
     collector.addStat("max_duration", maxDuration.load().count());
     // Log the "current time" according to RangeScan so that any logged
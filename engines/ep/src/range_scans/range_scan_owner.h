@@ -67,6 +67,27 @@ public:
      */
     std::shared_ptr<RangeScan> takeNextScan(size_t taskId);
 
+    /**
+     * Reserve tasks for a range-scan-multi (RangeScanCoordinatorTasks). The
+     * tasks are counted against concurrentTaskLimit together with the
+     * RangeScanContinueTasks, so the bucket runs no more range scan tasks
+     * than the limit.
+     *
+     * @param wanted The number of tasks the scan could use
+     * @return the number of tasks reserved (up to wanted, 0 when the limit
+     *         is reached)
+     */
+    size_t reserveCoordinatorTasks(size_t wanted);
+
+    /**
+     * Release a task reserved by reserveCoordinatorTasks (the task is done).
+     * If scans are waiting for a RangeScanContinueTask a new task is created
+     * in place of the released task.
+     *
+     * @param bucket The bucket of the scans - needed for task creation
+     */
+    void releaseCoordinatorTask(EPBucket& bucket);
+
     /**
      * Method will set concurrentTaskLimit using the parameter value and the
      * AUXIO thread pool size. The parameter specifies the number of threads
@@ -75,6 +96,15 @@ public:
      */
     void setConcurrentTaskLimit(size_t maxContinueTasksValue);
 
+    size_t getConcurrentTaskLimit() const {
+        return concurrentTaskLimit;
+    }
+
+    size_t getCoordinatorTasks() const {
+        return continueTasks.withRLock(
+                [this](const auto&) { return coordinatorTasks; });
+    }
+
     void setMaxDuration(std::chrono::seconds maxDuration) {
         this->maxDuration.store(maxDuration);
     }
@@ -94,6 +124,9 @@ protected:
         return continueTasks.rlock()->size();
     }
 
+    /// Schedule a new RangeScanContinueTask and add it to tasks
+    void addContinueTask(EPBucket& bucket, std::unordered_set<size_t>& tasks);
+
     std::atomic<size_t> concurrentTaskLimit;
 
     std::atomic<std::chrono::seconds> maxDuration;
@@ -103,6 +136,10 @@ protected:
     // The IDs of the tasks that will run the range scans. The size() of this
     // container is the value that limits concurrency of continue.
     folly::Synchronized<std::unordered_set<size_t>> continueTasks;
+
+    // The number of tasks reserved by range-scan-multi requests, these also
+    // count against concurrentTaskLimit. Guarded by the continueTasks lock.
+    size_t coordinatorTasks{0};
 };
 
 namespace VB {
@@ -0,0 +1,72 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan_projection.h"
+
+RangeScanProjection::RangeScanProjection(
+        const cb::rangescan::ProjectionConfiguration& config) {
+    for (const auto& path : config.paths) {
+        paths.emplace_back(path, nlohmann::json(path).dump());
+    }
+    if (config.filter) {
+        filter.emplace(config.filter->path,
+                       nlohmann::json::parse(config.filter->value));
+    }
+}
+
+std::optional<std::string_view> RangeScanProjection::lookup(
+        std::string_view document, std::string_view path) {
+    operation.clear();
+    operation.set_result_buf(&result);
+    operation.set_code(Subdoc::Command::GET);
+    operation.set_doc(document.data(), document.size());
+    if (operation.op_exec(path.data(), path.size()) !=
+        Subdoc::Error::SUCCESS) {
+        return std::nullopt;
+    }
+    const auto& match = result.matchloc();
+    return std::string_view{match.at, match.length};
+}
+
+bool RangeScanProjection::matchesFilter(std::string_view value, bool isJson) {
+    if (!filter) {
+        return true;
+    }
+    if (!isJson) {
+        return false;
+    }
+    const auto field = lookup(value, filter->first);
+    if (!field) {
+        return false;
+    }
+    const auto parsed = nlohmann::json::parse(*field, nullptr, false);
+    return !parsed.is_discarded() && parsed == filter->second;
+}
+
+std::string RangeScanProjection::project(std::string_view value,
+                                         bool isJson) {
+    std::string projected{"{"};
+    if (isJson) {
+        for (const auto& [path, key] : paths) {
+            const auto field = lookup(value, path);
+            if (!field) {
+                continue;
+            }
+            if (projected.size() > 1) {
+                projected.push_back(',');
+            }
+            projected.append(key);
+            projected.push_back(':');
+            projected.append(*field);
+        }
+    }
+    projected.push_back('}');
+    return projected;
+}
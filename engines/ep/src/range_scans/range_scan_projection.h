@@ -0,0 +1,79 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <memcached/range_scan_optional_configuration.h>
+#include <nlohmann/json.hpp>
+#include <subdoc/operations.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * RangeScanProjection evaluates the projection (and filter) of a value scan
+ * on the documents read by the scan, so that only the requested fields of
+ * the documents which pass the filter are buffered and sent to the client.
+ *
+ * The projected value is a JSON object with a member per projected path
+ * found in the document, keyed by the path, e.g. the projection
+ * ["name", "address.city"] returns {"name":"foo","address.city":"Oslo"}.
+ *
+ * The object is not thread safe, it is used by the one I/O task running the
+ * continue of the scan.
+ */
+class RangeScanProjection {
+public:
+    explicit RangeScanProjection(
+            const cb::rangescan::ProjectionConfiguration& config);
+
+    /**
+     * Does the (uncompressed, xattr free) value of a document pass the
+     * filter (which all values do if there's no filter)
+     *
+     * @param value The document value
+     * @param isJson If the value is JSON (non JSON values have no fields)
+     */
+    bool matchesFilter(std::string_view value, bool isJson);
+
+    /// @return true if the projection returns a subset of the value (else
+    ///         only the filter is applied)
+    bool hasPaths() const {
+        return !paths.empty();
+    }
+
+    /**
+     * Project the fields of the (uncompressed, xattr free) value of a
+     * document
+     *
+     * @param value The document value
+     * @param isJson If the value is JSON (non JSON values have no fields)
+     * @return The projected value
+     */
+    std::string project(std::string_view value, bool isJson);
+
+protected:
+    /// Look up path in the document, returning the JSON text of its value
+    std::optional<std::string_view> lookup(std::string_view document,
+                                           std::string_view path);
+
+    /// The paths to project and their JSON encoding (the key in the
+    /// projected object)
+    std::vector<std::pair<std::string, std::string>> paths;
+
+    /// The filter path and the value it must be equal to
+    std::optional<std::pair<std::string, nlohmann::json>> filter;
+
+    Subdoc::Operation operation;
+    Subdoc::Result result;
+};
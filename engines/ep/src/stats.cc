@@ -261,6 +261,8 @@ void EPStats::reset() {
     defragNumMoved.reset();
     compressorNumVisited.reset();
     compressorNumCompressed.reset();
+    compressorInputBytes.reset();
+    compressorOutputBytes.reset();
     snapshotBytesRead.reset();
 
     pendingOpsHisto.reset();
@@ -271,6 +273,7 @@ void EPStats::reset() {
     checkpointRemoverHisto.reset();
     itemPagerHisto.reset();
     expiryPagerHisto.reset();
+    compactionExpiryBatchHisto.reset();
     getVbucketCmdHisto.reset();
     setVbucketCmdHisto.reset();
     delVbucketCmdHisto.reset();
@@ -363,6 +366,7 @@ size_t EPStats::getMemFootPrint() const {
            checkpointRemoverHisto.getMemFootPrint() +
            itemPagerHisto.getMemFootPrint() +
            expiryPagerHisto.getMemFootPrint() +
+           compactionExpiryBatchHisto.getMemFootPrint() +
            getVbucketCmdHisto.getMemFootPrint() +
            setVbucketCmdHisto.getMemFootPrint() +
            delVbucketCmdHisto.getMemFootPrint() +
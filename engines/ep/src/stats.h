@@ -448,6 +448,9 @@ public:
     Hdr1sfMicroSecHistogram itemPagerHisto;
     //! Histogram of expiry pager run times
     Hdr1sfMicroSecHistogram expiryPagerHisto;
+    //! Histogram of the time taken to expire each batch of items found by
+    //! compaction
+    Hdr1sfMicroSecHistogram compactionExpiryBatchHisto;
 
     //! The number of basic store (add, set, arithmetic, touch, etc.) operations
     Counter numOpsStore;
@@ -533,6 +536,11 @@ public:
 
     Counter compressorNumVisited;
     Counter compressorNumCompressed;
+    //! Uncompressed and Snappy-compressed size of the values the item
+    //! compressor deflated; their ratio is the achieved compression ratio of
+    //! the resident working set.
+    Counter compressorInputBytes;
+    Counter compressorOutputBytes;
 
     Counter snapshotBytesRead;
     Counter cacheTransferBytesRead;
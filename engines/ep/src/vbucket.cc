@@ -2672,7 +2672,10 @@ cb::engine_errc VBucket::deleteWithMeta(
 }
 
 std::unique_ptr<CompactionBGFetchItem> VBucket::processExpiredItem(
-        const Item& it, time_t startTime, ExpireBy source) {
+        const Item& it,
+        time_t startTime,
+        ExpireBy source,
+        VBNotifyCtx* deferredNotify) {
     // Pending items should not be subject to expiry
     if (it.isPending()) {
         std::stringstream ss;
@@ -2732,7 +2735,11 @@ std::unique_ptr<CompactionBGFetchItem> VBucket::processExpiredItem(
             // we unlock ht lock here because we want to avoid potential lock
             // inversions arising from notifyNewSeqno() call
             hbl.getHTLock().unlock();
-            notifyNewSeqno(notifyCtx);
+            if (deferredNotify) {
+                *deferredNotify = notifyCtx;
+            } else {
+                notifyNewSeqno(notifyCtx);
+            }
             doCollectionsStats(cHandle, notifyCtx);
         }
     } else if (eviction == EvictionPolicy::Full) {
@@ -2789,7 +2796,11 @@ std::unique_ptr<CompactionBGFetchItem> VBucket::processExpiredItem(
             // we unlock ht lock here because we want to avoid potential
             // lock inversions arising from notifyNewSeqno() call
             hbl.getHTLock().unlock();
-            notifyNewSeqno(notifyCtx);
+            if (deferredNotify) {
+                *deferredNotify = notifyCtx;
+            } else {
+                notifyNewSeqno(notifyCtx);
+            }
             doCollectionsStats(cHandle, notifyCtx);
         }
     }
@@ -1302,12 +1302,19 @@ public:
      * @param it item to be deleted
      * @param startTime the time to be compared with this item's expiry time
      * @param source Expiry source
+     * @param deferredNotify If non-null, the seqno notification for a
+     *        successful expiry is recorded here instead of being issued, so
+     *        that a caller expiring a batch of items can notify once for the
+     *        whole batch (see notifyNewSeqno()).
      *
      * @return Bgfetch item which will attempt to read the to-be-expired item
      *         from disk. May be null.
      */
     [[nodiscard]] std::unique_ptr<CompactionBGFetchItem> processExpiredItem(
-            const Item& it, time_t startTime, ExpireBy source);
+            const Item& it,
+            time_t startTime,
+            ExpireBy source,
+            VBNotifyCtx* deferredNotify = nullptr);
 
     /**
      * Evict a key from memory.
@@ -6294,6 +6294,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_collections_enabled",
               "ep_compaction_expire_from_start",
               "ep_compaction_expiry_fetch_inline",
+              "ep_compaction_expiry_batch_size",
               "ep_compaction_max_concurrent_ratio",
               "ep_compression_mode",
               "ep_concurrent_pagers",
@@ -6322,6 +6323,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_dcp_consumer_buffer_ratio",
               "ep_dcp_consumer_flow_control_ack_ratio",
               "ep_dcp_consumer_flow_control_ack_seconds",
+              "ep_dcp_delta_mutation_cache_size",
               "ep_dcp_enable_noop",
               "ep_dcp_consumer_flow_control_enabled",
               "ep_dcp_min_compression_ratio",
@@ -6368,6 +6370,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_couchstore_write_validation",
               "ep_couchstore_mprotect",
               "ep_couchstore_midpoint_rollback_optimisation",
+              "ep_couchstore_pipelined_flush",
               "ep_getl_default_timeout",
               "ep_getl_max_timeout",
               "ep_hlc_drift_ahead_threshold_us",
@@ -6569,6 +6572,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_collections_enabled",
               "ep_compaction_expire_from_start",
               "ep_compaction_expiry_fetch_inline",
+              "ep_compaction_expiry_batch_size",
               "ep_compaction_max_concurrent_ratio",
               "ep_compression_mode",
               "ep_concurrent_pagers",
@@ -6613,6 +6617,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_dcp_consumer_buffer_ratio",
               "ep_dcp_consumer_flow_control_ack_ratio",
               "ep_dcp_consumer_flow_control_ack_seconds",
+              "ep_dcp_delta_mutation_cache_size",
               "ep_dcp_enable_noop",
               "ep_dcp_consumer_flow_control_enabled",
               "ep_dcp_idle_timeout",
@@ -6674,6 +6679,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_couchstore_write_validation",
               "ep_couchstore_mprotect",
               "ep_couchstore_midpoint_rollback_optimisation",
+              "ep_couchstore_pipelined_flush",
               "ep_getl_default_timeout",
               "ep_getl_max_timeout",
               "ep_hlc_drift_ahead_threshold_us",
@@ -6696,9 +6702,11 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_io_total_write_amplification",
               "ep_io_total_write_bytes",
               "ep_item_compressor_chunk_duration",
+              "ep_item_compressor_input_bytes",
               "ep_item_compressor_interval",
               "ep_item_compressor_num_compressed",
               "ep_item_compressor_num_visited",
+              "ep_item_compressor_output_bytes",
               "ep_item_eviction_age_percentage",
               "ep_item_eviction_initial_mfu_percentile",
               "ep_item_eviction_initial_mfu_update_interval",
@@ -7118,6 +7126,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
                 "ep_alog_sleep_time",
                 "ep_alog_task_time",
                 "ep_item_eviction_policy",
+                "ep_kvstore_op_trace_file",
                 "ep_persistent_metadata_purge_age",
                 "ep_warmup",
                 "ep_warmup_accesslog_load_duration",
@@ -245,6 +245,29 @@ public:
                         sid);
     }
 
+    // A patch is observed as the mutation of the (complete) item
+    cb::engine_errc mutation_patch(uint32_t opaque,
+                                   cb::unique_item_ptr itm,
+                                   Vbid vbucket,
+                                   uint64_t by_seqno,
+                                   uint64_t rev_seqno,
+                                   uint32_t lock_time,
+                                   uint8_t nru,
+                                   uint64_t,
+                                   uint32_t,
+                                   uint32_t,
+                                   uint32_t,
+                                   cb::mcbp::DcpStreamId sid) override {
+        return mutation(opaque,
+                        reinterpret_cast<Item*>(itm.get()),
+                        vbucket,
+                        by_seqno,
+                        rev_seqno,
+                        lock_time,
+                        nru,
+                        sid);
+    }
+
     cb::engine_errc deletion(uint32_t opaque,
                              cb::unique_item_ptr itm,
                              Vbid vbucket,
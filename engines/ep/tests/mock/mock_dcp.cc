@@ -167,6 +167,33 @@ cb::engine_errc MockDcpMessageProducers::mutation(uint32_t opaque,
     return result;
 }
 
+cb::engine_errc MockDcpMessageProducers::mutation_patch(
+        uint32_t opaque,
+        cb::unique_item_ptr itm,
+        Vbid vbucket,
+        uint64_t by_seqno,
+        uint64_t rev_seqno,
+        uint32_t lock_time,
+        uint8_t nru,
+        uint64_t base_cas,
+        uint32_t offset,
+        uint32_t remove_length,
+        uint32_t insert_length,
+        cb::mcbp::DcpStreamId sid) {
+    // Record the complete value of the item (as the consumer would see it
+    // once it applied the patch)
+    return handleMutationOrPrepare(cb::mcbp::ClientOpcode::DcpMutationPatch,
+                                   opaque,
+                                   std::move(itm),
+                                   vbucket,
+                                   by_seqno,
+                                   rev_seqno,
+                                   lock_time,
+                                   {},
+                                   nru,
+                                   sid);
+}
+
 cb::engine_errc MockDcpMessageProducers::handleMutationOrPrepare(
         cb::mcbp::ClientOpcode opcode,
         uint32_t opaque,
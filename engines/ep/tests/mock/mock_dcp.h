@@ -75,6 +75,19 @@ public:
                              uint8_t nru,
                              cb::mcbp::DcpStreamId sid) override;
 
+    cb::engine_errc mutation_patch(uint32_t opaque,
+                                   cb::unique_item_ptr itm,
+                                   Vbid vbucket,
+                                   uint64_t by_seqno,
+                                   uint64_t rev_seqno,
+                                   uint32_t lock_time,
+                                   uint8_t nru,
+                                   uint64_t base_cas,
+                                   uint32_t offset,
+                                   uint32_t remove_length,
+                                   uint32_t insert_length,
+                                   cb::mcbp::DcpStreamId sid) override;
+
     cb::engine_errc deletion(uint32_t opaque,
                              cb::unique_item_ptr itm,
                              Vbid vbucket,
@@ -130,6 +130,12 @@ public:
         return useDcpV7StatusCodes;
     }
 
+    /// Allow Mutations to be received as patches without the control
+    /// negotiation
+    void enableDeltaMutations() {
+        deltaMutations = true;
+    }
+
     bool isOpaqueBlockingDcpControl(uint64_t opaque) const {
         return pendingControls.withLock([opaque](const auto& container) {
             if (container.empty()) {
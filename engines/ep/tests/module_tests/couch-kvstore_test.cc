@@ -94,6 +94,101 @@ TEST_F(CouchKVStoreTest, StatsTest) {
     EXPECT_GE(io_total_write_bytes, io_write_bytes);
 }
 
+// Verify that values compressed by the encode stage of a pipelined flush
+// (rather than by couchstore) read back correctly, and that the logical write
+// stats still account the uncompressed size.
+TEST_F(CouchKVStoreTest, PipelinedFlush) {
+    CouchKVStoreConfig config(1024, 4, data_dir, "couchdb", 0);
+    config.setPipelinedFlush(true);
+    auto kvstore = setup_kv_store(config);
+
+    // Compressible, incompressible (grows when compressed) and a delete
+    const std::string compressible(4096, 'x');
+    const std::string incompressible{"v"};
+    auto ctx = kvstore->begin(vbid, std::make_unique<PersistenceCallback>());
+    auto qi = makeCommittedItem(makeStoredDocKey("compressible"), compressible);
+    qi->setBySeqno(1);
+    kvstore->set(*ctx, qi);
+    qi = makeCommittedItem(makeStoredDocKey("incompressible"), incompressible);
+    qi->setBySeqno(2);
+    kvstore->set(*ctx, qi);
+    qi = makeDeletedItem(makeStoredDocKey("deleted"));
+    qi->setBySeqno(3);
+    kvstore->del(*ctx, qi);
+    flush.proposedVBState.lastSnapEnd = 3;
+    ASSERT_TRUE(kvstore->commit(std::move(ctx), flush));
+
+    for (const auto& [key, value] :
+         {std::pair{"compressible", compressible},
+          std::pair{"incompressible", incompressible}}) {
+        auto gv = kvstore->get(makeDiskDocKey(key), vbid);
+        ASSERT_EQ(cb::engine_errc::success, gv.getStatus()) << key;
+        EXPECT_EQ(value, gv.item->getValueView()) << key;
+    }
+
+    std::map<std::string, std::string> stats;
+    auto add_stat_callback = [&stats](std::string_view key,
+                                      std::string_view value,
+                                      CookieIface&) {
+        stats.emplace(key, value);
+    };
+    auto* cookie = create_mock_cookie();
+    kvstore->addStats(add_stat_callback, *cookie);
+    destroy_mock_cookie(cookie);
+    EXPECT_EQ("3", stats["rw_0:io_num_write"]);
+    // 1 (for the namespace) per key
+    const auto metaSize = MetaData::getMetaDataSize(MetaData::Version::V1);
+    EXPECT_EQ((1 + strlen("compressible") + compressible.size() + metaSize) +
+                      (1 + strlen("incompressible") + incompressible.size() +
+                       metaSize) +
+                      (1 + strlen("deleted") + metaSize),
+              stoul(stats["rw_0:io_document_write_bytes"]));
+}
+
+// Flushers of the vbuckets of one shard may run concurrently; each flush
+// transaction has its own encode stage, so interleaved batches are encoded
+// and committed independently.
+TEST_F(CouchKVStoreTest, PipelinedFlushInterleavedTransactions) {
+    CouchKVStoreConfig config(1024, 4, data_dir, "couchdb", 0);
+    config.setPipelinedFlush(true);
+    // vb:0 and vb:4 are both of shard 0
+    const Vbid otherVbid(4);
+    auto kvstore = setup_kv_store(config, {vbid, otherVbid});
+
+    auto ctx = kvstore->begin(vbid, std::make_unique<PersistenceCallback>());
+    auto otherCtx =
+            kvstore->begin(otherVbid, std::make_unique<PersistenceCallback>());
+    const std::string value(4096, 'x');
+    const std::string otherValue(4096, 'y');
+    for (int seqno = 1; seqno <= 10; ++seqno) {
+        const auto key = makeStoredDocKey("key" + std::to_string(seqno));
+        auto qi = makeCommittedItem(key, value);
+        qi->setBySeqno(seqno);
+        kvstore->set(*ctx, qi);
+        qi = makeCommittedItem(key, otherValue);
+        qi->setVBucketId(otherVbid);
+        qi->setBySeqno(seqno);
+        kvstore->set(*otherCtx, qi);
+    }
+
+    flush.proposedVBState.lastSnapEnd = 10;
+    ASSERT_TRUE(kvstore->commit(std::move(ctx), flush));
+    // The other batch is still pending
+    EXPECT_EQ(cb::engine_errc::no_such_key,
+              kvstore->get(makeDiskDocKey("key1"), otherVbid).getStatus());
+    ASSERT_TRUE(kvstore->commit(std::move(otherCtx), flush));
+
+    for (int seqno = 1; seqno <= 10; ++seqno) {
+        const auto key = makeDiskDocKey("key" + std::to_string(seqno));
+        auto gv = kvstore->get(key, vbid);
+        ASSERT_EQ(cb::engine_errc::success, gv.getStatus());
+        EXPECT_EQ(value, gv.item->getValueView());
+        gv = kvstore->get(key, otherVbid);
+        ASSERT_EQ(cb::engine_errc::success, gv.getStatus());
+        EXPECT_EQ(otherValue, gv.item->getValueView());
+    }
+}
+
 // Verify the compaction stats returned from operations are accurate.
 TEST_F(CouchKVStoreTest, CompactStatsTest) {
     CouchKVStoreConfig config(4, 4, data_dir, "couchdb", 0);
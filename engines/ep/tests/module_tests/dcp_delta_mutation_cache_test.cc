@@ -0,0 +1,90 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "dcp/delta_mutation_cache.h"
+#include "item.h"
+#include "test_helpers.h"
+
+#include <folly/portability/GTest.h>
+
+class DeltaMutationCacheTest : public ::testing::Test {
+protected:
+    Item makeItem(const std::string& value, uint64_t cas) {
+        auto item = make_item(vbid, key, value);
+        item.setCas(cas);
+        return item;
+    }
+
+    const Vbid vbid{0};
+    const StoredDocKey key = makeStoredDocKey("key");
+    const std::string value = std::string(4096, 'a');
+    DeltaMutationCache cache{1024 * 1024};
+};
+
+TEST_F(DeltaMutationCacheTest, FirstMutationSentInFull) {
+    EXPECT_FALSE(cache.makePatch(1, makeItem(value, 1)));
+    EXPECT_EQ(value.size(), cache.getSize());
+}
+
+TEST_F(DeltaMutationCacheTest, SmallChangeSentAsPatch) {
+    ASSERT_FALSE(cache.makePatch(1, makeItem(value, 1)));
+
+    auto next = value;
+    next.replace(100, 3, "bbbbb");
+    const auto patch = cache.makePatch(1, makeItem(next, 2));
+    ASSERT_TRUE(patch);
+    EXPECT_EQ((MutationPatch{1, 100, 3, 5}), *patch);
+    EXPECT_EQ(1, cache.getPatchesSent());
+    EXPECT_EQ(next.size() - 5, cache.getBytesSaved());
+
+    // The next patch is against the value just sent
+    const auto again = cache.makePatch(1, makeItem(next + "c", 3));
+    ASSERT_TRUE(again);
+    EXPECT_EQ((MutationPatch{2, uint32_t(next.size()), 0, 1}), *again);
+}
+
+TEST_F(DeltaMutationCacheTest, LargeChangeSentInFull) {
+    ASSERT_FALSE(cache.makePatch(1, makeItem(value, 1)));
+    EXPECT_FALSE(cache.makePatch(1, makeItem(std::string(4096, 'b'), 2)));
+    EXPECT_EQ(0, cache.getPatchesSent());
+}
+
+TEST_F(DeltaMutationCacheTest, SmallValueNotKept) {
+    EXPECT_FALSE(cache.makePatch(1, makeItem("small", 1)));
+    EXPECT_EQ(0, cache.getSize());
+}
+
+TEST_F(DeltaMutationCacheTest, OtherStreamSentInFull) {
+    ASSERT_FALSE(cache.makePatch(1, makeItem(value, 1)));
+    EXPECT_FALSE(cache.makePatch(2, makeItem(value + "b", 2)));
+    // But the value is the base for the new stream
+    EXPECT_TRUE(cache.makePatch(2, makeItem(value + "bc", 3)));
+}
+
+TEST_F(DeltaMutationCacheTest, Erase) {
+    const auto item = makeItem(value, 1);
+    ASSERT_FALSE(cache.makePatch(1, item));
+    cache.erase(item);
+    EXPECT_EQ(0, cache.getSize());
+    EXPECT_FALSE(cache.makePatch(1, makeItem(value + "b", 2)));
+}
+
+TEST_F(DeltaMutationCacheTest, EvictsLeastRecentlySent) {
+    DeltaMutationCache small{2 * value.size()};
+    const auto other = makeStoredDocKey("other");
+    const auto third = makeStoredDocKey("third");
+    ASSERT_FALSE(small.makePatch(1, makeItem(value, 1)));
+    ASSERT_FALSE(small.makePatch(1, make_item(vbid, other, value)));
+    ASSERT_FALSE(small.makePatch(1, make_item(vbid, third, value)));
+    EXPECT_EQ(2 * value.size(), small.getSize());
+
+    // "key" was evicted
+    EXPECT_FALSE(small.makePatch(1, makeItem(value + "b", 2)));
+}
@@ -20,6 +20,7 @@
 #include <tests/mock/mock_checkpoint_manager.h>
 #include <tests/mock/mock_dcp_consumer.h>
 #include <tests/mock/mock_dcp_producer.h>
+#include <tests/mock/mock_global_task.h>
 #include <tests/mock/mock_stream.h>
 #include <tests/mock/mock_synchronous_ep_engine.h>
 
@@ -31,6 +32,7 @@
 #include "dcp/response.h"
 #include "durability/passive_durability_monitor.h"
 #include "ep_bucket.h"
+#include "ep_vb.h"
 #include "evp_store_single_threaded_test.h"
 #include "failover-table.h"
 #include "kv_bucket.h"
@@ -3035,6 +3037,305 @@ TEST_P(DCPCacheTransferVE, CacheTransferVE_ZeroResident) {
     EXPECT_EQ(0, replicaVB->dirtyQueueSize);
 }
 
+/**
+ * Tests for Mutations sent as patches (DcpMutationPatch) from the producer
+ * to the consumer, with the patch passed to the consumer as memcached does.
+ */
+class DCPLoopbackDeltaMutations : public DCPLoopbackStreamTest {
+protected:
+    void SetUp() override {
+        // Delta mutations are disabled by default
+        config_string += "dcp_delta_mutation_cache_size=10485760";
+        DCPLoopbackStreamTest::SetUp();
+    }
+
+    /// A DcpMutationPatch message as the consumer receives it
+    struct PatchMessage {
+        uint32_t opaque;
+        queued_item item;
+        protocol_binary_datatype_t datatype;
+        std::string patch;
+    };
+
+    /// Enable delta mutations at both ends of the route and add the stream
+    void addStream(DcpRoute& route) {
+        ASSERT_EQ(cb::engine_errc::success,
+                  route.producer->control(
+                          0, DcpControlKeys::DeltaMutations, "true"));
+        route.consumer->enableDeltaMutations();
+        ASSERT_EQ(cb::engine_errc::success, route.doStreamRequest().first);
+    }
+
+    /**
+     * Read the next message of the producer, which must be a Mutation sent
+     * as a patch
+     *
+     * @param baseCas Send the patch with this base CAS instead
+     */
+    void getMutationPatch(DcpRoute& route,
+                          PatchMessage& message,
+                          std::optional<uint64_t> baseCas = {}) {
+        auto msg = route.getNextProducerMsg(*route.getStreams().first);
+        ASSERT_TRUE(msg);
+        ASSERT_EQ(DcpResponse::Event::Mutation, msg->getEvent());
+        const auto& mutation = static_cast<MutationResponse&>(*msg);
+        const auto* patch = mutation.getPatch();
+        ASSERT_TRUE(patch) << "The Mutation wasn't sent as a patch";
+
+        message.opaque = mutation.getOpaque();
+        message.item = mutation.getItem();
+        message.datatype = message.item->getDataType();
+        const cb::mcbp::request::DcpMutationPatchHeader header(
+                baseCas.value_or(patch->baseCas),
+                patch->offset,
+                patch->removeLength);
+        const auto buffer = header.getBuffer();
+        message.patch.assign(reinterpret_cast<const char*>(buffer.data()),
+                             buffer.size());
+        message.patch.append(
+                std::string_view{message.item->getData(),
+                                 message.item->getNBytes()}
+                        .substr(patch->offset, patch->insertLength));
+    }
+
+    cb::engine_errc sendMutationPatch(DcpRoute& route,
+                                      const PatchMessage& message) {
+        const auto& item = *message.item;
+        return route.consumer->mutation_patch(
+                *route.consumer->getCookie(),
+                message.opaque,
+                item.getKey(),
+                {reinterpret_cast<const uint8_t*>(message.patch.data()),
+                 message.patch.size()},
+                message.datatype,
+                item.getCas(),
+                vbid,
+                item.getFlags(),
+                item.getBySeqno(),
+                item.getRevSeqno(),
+                item.getExptime(),
+                0 /*lock_time*/,
+                0 /*nru*/);
+    }
+
+    /// Send the first value (in full) and store the next value
+    void sendFirstValueAndUpdate(DcpRoute& route) {
+        store_item(vbid, key, value);
+        addStream(route);
+        route.transferMessage(DcpResponse::Event::SnapshotMarker);
+        route.transferMutation(key, 1);
+        ASSERT_EQ(value, getReplicaValue());
+
+        store_item(vbid, key, next);
+        route.transferMessage(DcpResponse::Event::SnapshotMarker);
+    }
+
+    std::string getReplicaValue() {
+        auto vb = engines[Node1]->getVBucket(vbid);
+        auto res = vb->ht.findForRead(key);
+        if (!res.storedValue || !res.storedValue->getValue()) {
+            return {};
+        }
+        const auto& blob = res.storedValue->getValue();
+        return {blob->getData(), blob->valueSize()};
+    }
+
+    void runReplicaBGFetcher() {
+        MockGlobalTask task(engines[Node1]->getTaskable(),
+                            TaskId::MultiBGFetcherTask);
+        auto vb = engines[Node1]->getVBucket(vbid);
+        dynamic_cast<EPVBucket&>(*vb).getBgFetcher(0).run(&task);
+    }
+
+    /**
+     * Accept the stream the consumer requested (again) itself, which
+     * starts after startSeqno
+     */
+    void acceptRestartedStream(DcpRoute& route, uint64_t startSeqno) {
+        auto stream = route.consumer->getVbucketStream(vbid);
+        ASSERT_TRUE(stream);
+        auto request = stream->next();
+        ASSERT_TRUE(request);
+        ASSERT_EQ(DcpResponse::Event::StreamReq, request->getEvent());
+        auto& sr = static_cast<StreamRequest&>(*request);
+        EXPECT_EQ(startSeqno, sr.getStartSeqno());
+
+        uint64_t rollbackSeqno = 0;
+        ASSERT_EQ(cb::engine_errc::success,
+                  route.producer->streamRequest(sr.getFlags(),
+                                                sr.getOpaque(),
+                                                vbid,
+                                                sr.getStartSeqno(),
+                                                sr.getEndSeqno(),
+                                                sr.getVBucketUUID(),
+                                                sr.getSnapStartSeqno(),
+                                                sr.getSnapEndSeqno(),
+                                                &rollbackSeqno,
+                                                fakeDcpAddFailoverLog,
+                                                sr.getRequestValue()));
+
+        std::vector<vbucket_failover_t> networkFailoverLog;
+        for (const auto& entry :
+             engine->getVBucket(vbid)->failovers->getFailoverLog()) {
+            networkFailoverLog.push_back(
+                    {htonll(entry.uuid), htonll(entry.seqno)});
+        }
+        route.consumer->public_streamAccepted(
+                sr.getOpaque(),
+                cb::mcbp::Status::Success,
+                {reinterpret_cast<const uint8_t*>(networkFailoverLog.data()),
+                 networkFailoverLog.size() * sizeof(vbucket_failover_t)});
+
+        // ns_server didn't add the stream, so it doesn't get a response
+        EXPECT_FALSE(stream->next());
+        EXPECT_TRUE(stream->isActive());
+    }
+
+    const StoredDocKey key = makeStoredDocKey("key");
+    const std::string value = std::string(4096, 'a');
+    const std::string next = [this] {
+        auto ret = value;
+        ret.replace(100, 3, "bbbbb");
+        return ret;
+    }();
+};
+
+TEST_P(DCPLoopbackDeltaMutations, PatchApplied) {
+    auto route0_1 = createDcpRoute(Node0, Node1);
+    sendFirstValueAndUpdate(route0_1);
+
+    PatchMessage message;
+    getMutationPatch(route0_1, message);
+    EXPECT_LT(message.patch.size(), 32);
+    EXPECT_EQ(cb::engine_errc::success, sendMutationPatch(route0_1, message));
+    EXPECT_EQ(next, getReplicaValue());
+
+    auto vb = engines[Node1]->getVBucket(vbid);
+    EXPECT_EQ(2, vb->getHighSeqno());
+    EXPECT_EQ(engine->getVBucket(vbid)->ht.findForRead(key).storedValue->getCas(),
+              vb->ht.findForRead(key).storedValue->getCas());
+}
+
+TEST_P(DCPLoopbackDeltaMutations, CompressedPatchRejected) {
+    auto route0_1 = createDcpRoute(Node0, Node1);
+    sendFirstValueAndUpdate(route0_1);
+
+    PatchMessage message;
+    getMutationPatch(route0_1, message);
+    message.datatype |= PROTOCOL_BINARY_DATATYPE_SNAPPY;
+    EXPECT_EQ(cb::engine_errc::invalid_arguments,
+              sendMutationPatch(route0_1, message));
+    EXPECT_EQ(value, getReplicaValue());
+}
+
+TEST_P(DCPLoopbackDeltaMutations, EvictedBaseIsFetched) {
+    auto route0_1 = createDcpRoute(Node0, Node1);
+    store_item(vbid, key, value);
+    addStream(route0_1);
+    route0_1.transferMessage(DcpResponse::Event::SnapshotMarker);
+    route0_1.transferMutation(key, 1);
+
+    // Evict the replica's copy of the document
+    flushNodeIfPersistent(Node1);
+    const char* msg;
+    ASSERT_EQ(cb::engine_errc::success,
+              engines[Node1]->getKVBucket()->evictKey(key, vbid, &msg));
+    ASSERT_EQ("", getReplicaValue());
+
+    store_item(vbid, key, next);
+    route0_1.transferMessage(DcpResponse::Event::SnapshotMarker);
+    PatchMessage message;
+    getMutationPatch(route0_1, message);
+
+    // The message blocks until the copy is read from disk, and memcached
+    // then sends it again
+    EXPECT_EQ(cb::engine_errc::would_block,
+              sendMutationPatch(route0_1, message));
+    EXPECT_EQ(1, engines[Node1]->getVBucket(vbid)->getHighSeqno());
+    runReplicaBGFetcher();
+    EXPECT_EQ(cb::engine_errc::success, sendMutationPatch(route0_1, message));
+    EXPECT_EQ(next, getReplicaValue());
+    EXPECT_EQ(2, engines[Node1]->getVBucket(vbid)->getHighSeqno());
+}
+
+TEST_P(DCPLoopbackDeltaMutations, BaseMismatchRestartsStream) {
+    auto route0_1 = createDcpRoute(Node0, Node1);
+    sendFirstValueAndUpdate(route0_1);
+    auto* consumerStream = route0_1.getStreams().second;
+
+    // The consumer's copy isn't the base of the patch. It can't apply it,
+    // and stops the stream (without disconnecting)
+    PatchMessage message;
+    const auto cas =
+            engine->getVBucket(vbid)->ht.findForRead(key).storedValue->getCas();
+    getMutationPatch(route0_1, message, cas + 1);
+    EXPECT_EQ(cb::engine_errc::key_already_exists,
+              sendMutationPatch(route0_1, message));
+    EXPECT_EQ(value, getReplicaValue());
+    EXPECT_FALSE(consumerStream->isActive());
+    EXPECT_TRUE(consumerStream->isPatchResyncPending());
+
+    // Messages in flight are ignored
+    EXPECT_EQ(cb::engine_errc::success, sendMutationPatch(route0_1, message));
+    EXPECT_EQ(value, getReplicaValue());
+
+    // The producer ends the stream when it gets the error response, and
+    // stops sending patches for the vbucket
+    cb::mcbp::Response response{};
+    response.setMagic(cb::mcbp::Magic::ClientResponse);
+    response.setOpcode(cb::mcbp::ClientOpcode::DcpMutationPatch);
+    response.setOpaque(message.opaque);
+    response.setStatus(cb::mcbp::Status::KeyEexists);
+    EXPECT_TRUE(route0_1.producer->handleResponse(response));
+    EXPECT_FALSE(route0_1.producer->getDeltaMutationCache(vbid));
+    EXPECT_TRUE(route0_1.producer->getDeltaMutationCache());
+
+    auto msg = route0_1.getNextProducerMsg(*route0_1.getStreams().first);
+    ASSERT_TRUE(msg);
+    ASSERT_EQ(DcpResponse::Event::StreamEnd, msg->getEvent());
+    EXPECT_EQ(cb::mcbp::DcpStreamEndStatus::Closed,
+              static_cast<StreamEndResponse&>(*msg).getFlags());
+
+    // The consumer requests the stream again from the last seqno it
+    // processed, and receives the value in full
+    EXPECT_EQ(cb::engine_errc::success,
+              route0_1.consumer->streamEnd(message.opaque,
+                                           vbid,
+                                           cb::mcbp::DcpStreamEndStatus::Closed));
+    ASSERT_NE(consumerStream, route0_1.consumer->getVbucketStream(vbid).get());
+    acceptRestartedStream(route0_1, 1);
+
+    route0_1.transferMessage(DcpResponse::Event::SnapshotMarker);
+    auto streams = route0_1.getStreams();
+    msg = route0_1.getNextProducerMsg(*streams.first);
+    ASSERT_TRUE(msg);
+    ASSERT_EQ(DcpResponse::Event::Mutation, msg->getEvent());
+    EXPECT_FALSE(static_cast<MutationResponse&>(*msg).getPatch());
+    EXPECT_EQ(cb::engine_errc::success,
+              streams.second->messageReceived(std::move(msg)));
+    EXPECT_EQ(next, getReplicaValue());
+    EXPECT_EQ(2, engines[Node1]->getVBucket(vbid)->getHighSeqno());
+}
+
+TEST_P(DCPLoopbackDeltaMutations, ClosedStreamNotRestarted) {
+    auto route0_1 = createDcpRoute(Node0, Node1);
+    sendFirstValueAndUpdate(route0_1);
+
+    PatchMessage message;
+    getMutationPatch(route0_1, message, 0);
+    EXPECT_EQ(cb::engine_errc::key_already_exists,
+              sendMutationPatch(route0_1, message));
+
+    // ns_server closed the stream meanwhile
+    EXPECT_EQ(cb::engine_errc::success,
+              route0_1.consumer->closeStream(0, vbid, {}));
+    EXPECT_EQ(cb::engine_errc::success,
+              route0_1.consumer->streamEnd(message.opaque,
+                                           vbid,
+                                           cb::mcbp::DcpStreamEndStatus::Closed));
+    EXPECT_FALSE(route0_1.consumer->getVbucketStream(vbid));
+}
+
 INSTANTIATE_TEST_SUITE_P(DCPLoopbackStreamTests,
                          DCPLoopbackStreamTest,
                          STParameterizedBucketTest::allConfigValues(),
@@ -3050,6 +3351,11 @@ INSTANTIATE_TEST_SUITE_P(DCPRollbackTest,
                          DCPRollbackTest::allConfigValues(),
                          DCPRollbackTest::PrintToStringParamName);
 
+INSTANTIATE_TEST_SUITE_P(DCPLoopbackDeltaMutations,
+                         DCPLoopbackDeltaMutations,
+                         STParameterizedBucketTest::persistentConfigValues(),
+                         STParameterizedBucketTest::PrintToStringParamName);
+
 INSTANTIATE_TEST_SUITE_P(DCPReflectionCacheTransferTests,
                          DCPCacheTransfer,
                          STParameterizedBucketTest::persistentConfigValues(),
@@ -3535,6 +3535,36 @@ TEST_P(STParameterizedBucketTest, enable_expiry_output) {
     producer.reset();
 }
 
+// Compaction expires items in batches of compaction_expiry_batch_size; check
+// that every expired item is processed, including the final partial batch.
+TEST_P(STParamPersistentBucketTest, CompactionExpiresItemsInBatches) {
+    engine->getConfiguration().setCompactionExpiryBatchSize(2);
+    setVBucketStateAndRunPersistTask(vbid, vbucket_state_active);
+
+    const int numItems = 5;
+    for (int ii = 0; ii < numItems; ++ii) {
+        store_item(vbid,
+                   makeStoredDocKey("key" + std::to_string(ii)),
+                   "value",
+                   ep_convert_to_expiry_time(1));
+    }
+    flushVBucketToDiskIfPersistent(vbid, numItems);
+
+    auto& stats = engine->getEpStats();
+    ASSERT_EQ(0, stats.expired_compactor);
+    ASSERT_EQ(0, stats.compactionExpiryBatchHisto.getValueCount());
+
+    TimeTraveller wyld(64000);
+    runCompaction(vbid);
+
+    // Two full batches and the remaining item
+    EXPECT_EQ(numItems, stats.expired_compactor);
+    EXPECT_EQ(3, stats.compactionExpiryBatchHisto.getValueCount());
+    EXPECT_EQ(numItems, store->getVBucket(vbid)->numExpiredItems);
+    flushVBucketToDiskIfPersistent(vbid, numItems);
+    EXPECT_EQ(0, store->getVBucket(vbid)->getNumItems());
+}
+
 TEST_P(XattrSystemUserTest, MB_29040) {
     auto& kvbucket = *engine->getKVBucket();
     setVBucketStateAndRunPersistTask(vbid, vbucket_state_active);
@@ -15,6 +15,8 @@
 #include "test_helpers.h"
 #include "vbucket.h"
 
+#include <platform/compress.h>
+
 TEST_P(ItemCompressorTest, testCompressionInActiveMode) {
     std::string compressibleValue(
             "{\"product\": \"car\",\"price\": \"100\"},"
@@ -87,6 +89,14 @@ TEST_P(ItemCompressorTest, testCompressionInActiveMode) {
     EXPECT_EQ(new_datatype_count + 1,
               vbucket->ht.getDatatypeCounts()[new_datatype]);
     EXPECT_EQ(itemCount, vbucket->ht.getNumItems());
+
+    // Both values were deflated (the second is just not kept)
+    cb::compression::Buffer deflated;
+    ASSERT_TRUE(cb::compression::deflateSnappy(nonCompressibleValue, deflated));
+    EXPECT_EQ(compressibleValue.size() + nonCompressibleValue.size(),
+              visitor.getInputBytes());
+    EXPECT_EQ(compressible_item->getNBytes() + deflated.size(),
+              visitor.getOutputBytes());
 }
 
 // Test that an item will be left as uncompressed if the
@@ -0,0 +1,133 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "kvstore/kvstore_op_trace.h"
+#include "kvstore/kvstore_config.h"
+#include "kvstore/recording-kvstore/recording-kvstore.h"
+#include "kvstore_test.h"
+#include "test_helpers.h"
+#include "vbucket_bgfetch_item.h"
+
+#include <executor/workload.h>
+
+#include <fstream>
+
+using namespace std::string_literals;
+
+class KVStoreOpTraceTest : public KVStoreTest {
+protected:
+    void SetUp() override {
+        KVStoreTest::SetUp();
+        config.parseConfiguration("dbname="s + data_dir +
+                                  ";backend=couchdb;max_vbuckets=16;"
+                                  "max_num_shards=2;kvstore_op_trace_file=" +
+                                  data_dir + "/trace");
+        WorkLoadPolicy workload(
+                gsl::narrow_cast<int>(config.getMaxNumWorkers()),
+                gsl::narrow_cast<int>(config.getMaxNumShards()));
+        kvstoreConfig = KVStoreConfig::createKVStoreConfig(
+                config,
+                config.getBackendString(),
+                gsl::narrow_cast<uint16_t>(workload.getNumShards()),
+                0 /*shardId*/);
+        kvstore = setup_kv_store(*kvstoreConfig);
+    }
+
+    void TearDown() override {
+        kvstore.reset();
+        KVStoreTest::TearDown();
+    }
+
+    /// Destroy the KVStore (flushing the trace) and return the recorded trace
+    std::vector<KVStoreOpTraceRecord> readTrace() {
+        kvstore.reset();
+        return KVStoreOpTraceReader(kvstoreConfig->getOpTraceFile()).readAll();
+    }
+
+    Configuration config;
+    std::unique_ptr<KVStoreConfig> kvstoreConfig;
+    std::unique_ptr<KVStoreIface> kvstore;
+};
+
+TEST_F(KVStoreOpTraceTest, WriterReaderRoundTrip) {
+    const auto path = std::filesystem::path(data_dir) / "roundtrip";
+    std::vector<KVStoreOpTraceRecord> expected;
+    {
+        KVStoreOpTraceWriter writer(path, 2 /*bufferedRecords*/);
+        for (uint32_t ii = 0; ii < 5; ++ii) {
+            KVStoreOpTraceRecord rec;
+            rec.op = KVStoreOp::Set;
+            rec.vbid = 3;
+            rec.keySize = ii;
+            rec.valueSize = ii * 100;
+            rec.count = 1;
+            rec.keyHash = 0xdeadbeef + ii;
+            rec.start = std::chrono::nanoseconds(ii * 10);
+            rec.duration = std::chrono::nanoseconds(ii);
+            writer.record(rec);
+            expected.push_back(rec);
+        }
+        EXPECT_EQ(5, writer.getRecordCount());
+    }
+    EXPECT_EQ(expected, KVStoreOpTraceReader(path).readAll());
+}
+
+TEST_F(KVStoreOpTraceTest, ReaderRejectsInvalidFile) {
+    const auto path = std::filesystem::path(data_dir) / "invalid";
+    std::ofstream(path) << "not a trace";
+    EXPECT_THROW(KVStoreOpTraceReader{path}, std::runtime_error);
+}
+
+// Check that enabling the trace wraps the KVStore and that flush and bgfetch
+// operations are recorded with their sizes
+TEST_F(KVStoreOpTraceTest, RecordsOperations) {
+    ASSERT_TRUE(dynamic_cast<RecordingKVStore*>(kvstore.get()));
+
+    auto ctx = kvstore->begin(vbid, std::make_unique<PersistenceCallback>());
+    auto qi = makeCommittedItem(makeStoredDocKey("key"), "value");
+    qi->setBySeqno(1);
+    kvstore->set(*ctx, qi);
+    auto deleted = makeDeletedItem(makeStoredDocKey("gone"));
+    deleted->setBySeqno(2);
+    kvstore->del(*ctx, deleted);
+    flush.proposedVBState.lastSnapEnd = 2;
+    ASSERT_TRUE(kvstore->commit(std::move(ctx), flush));
+
+    vb_bgfetch_queue_t q;
+    vb_bgfetch_item_ctx_t bgctx;
+    bgctx.addBgFetch(std::make_unique<FrontEndBGFetchItem>(
+            nullptr, ValueFilter::VALUES_DECOMPRESSED, 0));
+    q[makeDiskDocKey("key")] = std::move(bgctx);
+    kvstore->getMulti(vbid, q, kvstore->getDefaultCreateItemCallback());
+
+    const auto trace = readTrace();
+    std::vector<KVStoreOp> ops;
+    for (const auto& rec : trace) {
+        ops.push_back(rec.op);
+        EXPECT_EQ(vbid.get(), rec.vbid);
+    }
+    EXPECT_EQ((std::vector<KVStoreOp>{KVStoreOp::Begin,
+                                      KVStoreOp::Set,
+                                      KVStoreOp::Del,
+                                      KVStoreOp::Commit,
+                                      KVStoreOp::GetMultiKey,
+                                      KVStoreOp::GetMulti}),
+              ops);
+
+    const auto keySize = DiskDocKey{*qi}.size();
+    EXPECT_EQ(keySize, trace[1].keySize);
+    EXPECT_EQ(DiskDocKey{*qi}.hash(), trace[1].keyHash);
+    EXPECT_EQ(5, trace[1].valueSize);
+    EXPECT_EQ(2, trace[3].count);
+    EXPECT_EQ(trace[1].keyHash, trace[4].keyHash);
+    EXPECT_EQ(5, trace[4].valueSize);
+    EXPECT_EQ(1, trace[5].count);
+}
@@ -19,6 +19,9 @@
 #include "memcached/range_scan.h"
 #include "range_scans/range_scan.h"
 #include "range_scans/range_scan_callbacks.h"
+#include "range_scans/range_scan_coordinator.h"
+#include "range_scans/range_scan_owner.h"
+#include "range_scans/range_scan_projection.h"
 #include "tests/mock/mock_synchronous_ep_engine.h"
 #include "tests/module_tests/evp_store_single_threaded_test.h"
 #include "tests/module_tests/test_helpers.h"
@@ -26,12 +29,18 @@
 
 #include <boost/uuid/name_generator.hpp>
 #include <folly/portability/GTest.h>
+#include <mcbp/codec/range_scan_continue_codec.h>
 #include <memcached/range_scan_optional_configuration.h>
+#include <nlohmann/json.hpp>
+#include <platform/base64.h>
 #include <programs/engine_testapp/mock_cookie.h>
 #include <programs/engine_testapp/mock_server.h>
 #include <utilities/test_manifest.h>
 
+#include <algorithm>
 #include <chrono>
+#include <map>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -2336,6 +2345,550 @@ TEST_P(RangeScanTestSimple, MB_54053) {
     EXPECT_FALSE(result2.cookie);
 }
 
+TEST(RangeScanProjectionTest, project) {
+    cb::rangescan::ProjectionConfiguration config;
+    config.paths = {"name", "address.city", "missing", "tags[1]"};
+    RangeScanProjection projection(config);
+    EXPECT_TRUE(projection.hasPaths());
+
+    const std::string value =
+            R"({"name":"foo","age":42,"address":{"city":"Oslo","zip":"0150"},)"
+            R"("tags":["a","b"]})";
+    EXPECT_TRUE(projection.matchesFilter(value, true));
+    // The missing path is omitted from the projected object
+    EXPECT_EQ(R"({"name":"foo","address.city":"Oslo","tags[1]":"b"})",
+              projection.project(value, true));
+
+    // A non JSON value has none of the fields
+    EXPECT_EQ("{}", projection.project("binary", false));
+}
+
+TEST(RangeScanProjectionTest, filter) {
+    cb::rangescan::ProjectionConfiguration config;
+    config.filter = cb::rangescan::ProjectionConfiguration::Filter{
+            "address.city", R"("Oslo")"};
+    RangeScanProjection projection(config);
+    EXPECT_FALSE(projection.hasPaths());
+
+    EXPECT_TRUE(projection.matchesFilter(
+            R"({"address":{"city":"Oslo"}})", true));
+    // Whitespace in the document doesn't matter
+    EXPECT_TRUE(projection.matchesFilter(
+            R"({"address":{"city" : "Oslo" }})", true));
+    EXPECT_FALSE(projection.matchesFilter(
+            R"({"address":{"city":"Bergen"}})", true));
+    EXPECT_FALSE(projection.matchesFilter(R"({"address":{}})", true));
+    EXPECT_FALSE(projection.matchesFilter(R"("Oslo")", true));
+    EXPECT_FALSE(projection.matchesFilter("Oslo", false));
+
+    // Numbers compare by value
+    config.filter = cb::rangescan::ProjectionConfiguration::Filter{"n", "1"};
+    RangeScanProjection number(config);
+    EXPECT_TRUE(number.matchesFilter(R"({"n":1})", true));
+    EXPECT_FALSE(number.matchesFilter(R"({"n":"1"})", true));
+}
+
+// Scans of a resident value eviction vbucket, served from memory
+class RangeScanMemorySnapshotTest : public RangeScanTest {
+public:
+    void SetUp() override {
+        config_string += "range_scan_memory_snapshot_max_items=1000;";
+        RangeScanTest::SetUp();
+    }
+
+    void testScan(const std::unordered_set<StoredDocKey>& expectedKeys) {
+        auto uuid = createScan(scanCollection, {"user"}, {"user\xFF"});
+        auto vb = store->getVBucket(vbid);
+        auto& epVb = dynamic_cast<EPVBucket&>(*vb);
+        EXPECT_TRUE(epVb.getRangeScan(uuid)->isMemorySnapshot());
+
+        continueRangeScan(
+                uuid, 0, 0ms, 0, cb::engine_errc::range_scan_complete);
+        if (isKeyOnly()) {
+            validateKeyScan(expectedKeys);
+        } else {
+            validateItemScan(expectedKeys);
+        }
+
+        // Let the completed scan destruct
+        runNextTask(*task_executor->getLpTaskQ(TaskType::AuxIO),
+                    "RangeScanContinueTask");
+    }
+};
+
+TEST_P(RangeScanMemorySnapshotTest, user_prefix) {
+    testScan(getUserKeys());
+}
+
+// The snapshot has the limits/resume of a disk scan
+TEST_P(RangeScanMemorySnapshotTest, user_prefix_with_item_limit) {
+    auto expectedKeys = getUserKeys();
+    testRangeScan(expectedKeys,
+                  scanCollection,
+                  {"user"},
+                  {"user\xFF"},
+                  2,
+                  0ms,
+                  0,
+                  expectedKeys.size() / 2);
+}
+
+// Unlike a disk snapshot, the memory snapshot sees what isn't yet flushed
+TEST_P(RangeScanMemorySnapshotTest, unflushed_key) {
+    auto key = makeStoredDocKey("user-unflushed", scanCollection);
+    store_item(vbid, key, key.to_string());
+
+    auto expectedKeys = getUserKeys();
+    expectedKeys.emplace(key);
+    testScan(expectedKeys);
+}
+
+// A value which isn't resident is read from disk
+TEST_P(RangeScanMemorySnapshotTest, evicted_value) {
+    evict_key(vbid, makeStoredDocKey("user-alan", scanCollection));
+    testScan(getUserKeys());
+}
+
+// Below the resident ratio the scan uses a disk snapshot
+TEST_P(RangeScanMemorySnapshotTest, not_resident) {
+    for (const auto& key : generateTestKeys()) {
+        evict_key(vbid, key);
+    }
+    auto uuid = createScan(scanCollection, {"user"}, {"user\xFF"});
+    auto vb = store->getVBucket(vbid);
+    auto& epVb = dynamic_cast<EPVBucket&>(*vb);
+    EXPECT_FALSE(epVb.getRangeScan(uuid)->isMemorySnapshot());
+    EXPECT_EQ(cb::engine_errc::success, vb->cancelRangeScan(uuid, cookie));
+    runNextTask(*task_executor->getLpTaskQ(TaskType::AuxIO),
+                "RangeScanContinueTask");
+}
+
+TEST_P(RangeScanMemorySnapshotTest, empty_range) {
+    createScan(scanCollection,
+               {"nothing"},
+               {"nothing\xFF"},
+               {},
+               {},
+               cb::engine_errc::no_such_key);
+}
+
+// A cookie which keeps the responses of a range-scan-multi
+class RangeScanMultiCookie : public MockCookie {
+public:
+    explicit RangeScanMultiCookie(EngineIface* e) : MockCookie(e) {
+        setUserNotifyIoComplete([this](cb::engine_errc) { ++notifications; });
+    }
+
+    bool sendResponse(cb::engine_errc status,
+                      std::string_view extras,
+                      std::string_view value) override {
+        responses.push_back({status, std::string{extras}, std::string{value}});
+        return true;
+    }
+
+    struct Response {
+        cb::engine_errc status;
+        std::string extras;
+        std::string value;
+    };
+    std::vector<Response> responses;
+    size_t notifications{0};
+};
+
+// A coordinator without tasks, the tests run the slots of the tasks
+class MockRangeScanCoordinator : public RangeScanCoordinator {
+public:
+    using RangeScanCoordinator::RangeScanCoordinator;
+
+    /// Start the scan as schedule() does, but without scheduling the tasks
+    void startWithoutTasks() {
+        state.lock()->runningTasks = slots.size();
+    }
+
+    /// @return the number of chunks read and not yet sent
+    size_t getQueuedChunks() {
+        return state.lock()->chunks.size();
+    }
+};
+
+class RangeScanCoordinatorTest : public RangeScanTest {
+public:
+    void SetUp() override {
+        setupConfig();
+        SingleThreadedEPBucketTest::SetUp();
+        setVBucketStateAndRunPersistTask(vbid, vbucket_state_active);
+        setVBucketStateAndRunPersistTask(vbid1, vbucket_state_active);
+
+        cm.add(CollectionEntry::vegetable);
+        setCollections(cookie, cm);
+        for (const auto vb : {vbid, vbid1}) {
+            flush_vbucket_to_disk(vb, 1);
+            for (const auto& key : vbucketKeys) {
+                store_item(vb, makeStoredDocKey(key, scanCollection), key);
+            }
+            flushVBucket(vb);
+        }
+        multiCookie = std::make_unique<RangeScanMultiCookie>(engine.get());
+    }
+
+    void TearDown() override {
+        multiCookie.reset();
+        RangeScanTest::TearDown();
+    }
+
+    /// @return the parameters of a scan of every key of the collection
+    cb::rangescan::MultiVbucketParameters makeParams() const {
+        return {scanCollection,
+                {"\0", 1},
+                {"\xFF"},
+                getScanType(),
+                getIncludeXattrs(),
+                cb::engine_errc::success};
+    }
+
+    std::shared_ptr<MockRangeScanCoordinator> makeCoordinator(
+            const cb::rangescan::MultiVbucketParameters& params,
+            std::vector<Vbid> vbuckets,
+            size_t tasks) {
+        EXPECT_EQ(tasks,
+                  getEPBucket().getReadyRangeScans()->reserveCoordinatorTasks(
+                          tasks));
+        auto coordinator = std::make_shared<MockRangeScanCoordinator>(
+                getEPBucket(),
+                *multiCookie,
+                params,
+                std::move(vbuckets),
+                tasks);
+        coordinator->startWithoutTasks();
+        return coordinator;
+    }
+
+    /**
+     * Run the slots of the coordinator in turn until every slot finishes,
+     * sending the data to the client when a slot waits for the client.
+     */
+    void runToEnd(RangeScanCoordinator& coordinator, size_t tasks) {
+        std::vector<bool> finished(tasks, false);
+        for (size_t runs = 0; std::ranges::count(finished, false); ++runs) {
+            ASSERT_LT(runs, 1000) << "The scan did not finish";
+            for (size_t slot = 0; slot < tasks; ++slot) {
+                if (finished[slot]) {
+                    continue;
+                }
+                switch (coordinator.runOnIOThread(slot)) {
+                case RangeScanCoordinator::RunStatus::Finished:
+                    finished[slot] = true;
+                    break;
+                case RangeScanCoordinator::RunStatus::Wait:
+                    EXPECT_EQ(cb::engine_errc::would_block,
+                              coordinator.sendOnFrontendThread(*multiCookie));
+                    break;
+                case RangeScanCoordinator::RunStatus::Again:
+                case RangeScanCoordinator::RunStatus::Retry:
+                    break;
+                }
+            }
+        }
+    }
+
+    struct MultiResult {
+        /// The keys returned for each vbucket (in the order returned)
+        std::map<Vbid, std::vector<std::string>> keys;
+        /// The vbucket of each data response
+        std::vector<Vbid> order;
+        /// The status and value of the final response
+        std::optional<cb::engine_errc> status;
+        nlohmann::json finalValue;
+    };
+
+    /// Decode (and clear) the responses the client has been sent
+    MultiResult takeResponses() {
+        MultiResult rv;
+        for (const auto& response : multiCookie->responses) {
+            if (response.status != cb::engine_errc::success) {
+                EXPECT_FALSE(rv.status) << "Only one final response expected";
+                rv.status = response.status;
+                rv.finalValue = nlohmann::json::parse(response.value);
+                continue;
+            }
+            EXPECT_EQ(sizeof(cb::mcbp::response::RangeScanMultiResponseExtras),
+                      response.extras.size());
+            const auto* extras = reinterpret_cast<
+                    const cb::mcbp::response::RangeScanMultiResponseExtras*>(
+                    response.extras.data());
+            const auto vb = extras->getVBucket();
+            rv.order.push_back(vb);
+            auto& keys = rv.keys[vb];
+            if (isKeyOnly()) {
+                cb::mcbp::response::RangeScanContinueKeyPayload payload(
+                        response.value);
+                for (auto key = payload.next(); !key.empty();
+                     key = payload.next()) {
+                    keys.emplace_back(key);
+                }
+            } else {
+                cb::mcbp::response::RangeScanContinueValuePayload payload(
+                        response.value);
+                for (auto record = payload.next(); record.key.data();
+                     record = payload.next()) {
+                    keys.emplace_back(record.key);
+                }
+            }
+        }
+        multiCookie->responses.clear();
+        return rv;
+    }
+
+    const Vbid vbid1{1};
+    const std::vector<std::string> vbucketKeys{"a", "b", "c", "d"};
+    std::unique_ptr<RangeScanMultiCookie> multiCookie;
+};
+
+TEST_P(RangeScanCoordinatorTest, interleaves_vbuckets) {
+    auto coordinator = makeCoordinator(makeParams(), {vbid, vbid1}, 2);
+    using RunStatus = RangeScanCoordinator::RunStatus;
+
+    // Each slot opens a vbucket, then reads it (all of the keys fit in the
+    // send buffer)
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(0));
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(1));
+    EXPECT_EQ(2, store->getKVStoreScanTracker().getNumRunningRangeScans());
+    EXPECT_EQ(0, multiCookie->notifications);
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(1));
+    EXPECT_EQ(1, multiCookie->notifications);
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(0));
+    EXPECT_EQ(0, store->getKVStoreScanTracker().getNumRunningRangeScans());
+
+    // The data of both vbuckets is sent as read, the scan is still running
+    EXPECT_EQ(cb::engine_errc::would_block,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    auto result = takeResponses();
+    EXPECT_EQ(std::vector<Vbid>({vbid1, vbid}), result.order);
+    EXPECT_FALSE(result.status);
+
+    // Nothing left to scan, the last task to finish notifies the client
+    EXPECT_EQ(RunStatus::Finished, coordinator->runOnIOThread(0));
+    EXPECT_EQ(1, multiCookie->notifications);
+    EXPECT_EQ(RunStatus::Finished, coordinator->runOnIOThread(1));
+    EXPECT_EQ(2, multiCookie->notifications);
+    EXPECT_TRUE(coordinator->isFinished());
+    EXPECT_EQ(0, getEPBucket().getReadyRangeScans()->getCoordinatorTasks());
+
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    const auto last = takeResponses();
+    EXPECT_EQ(cb::engine_errc::range_scan_complete, last.status);
+    EXPECT_EQ(nlohmann::json::object(), last.finalValue);
+
+    EXPECT_EQ(vbucketKeys, result.keys[vbid]);
+    EXPECT_EQ(vbucketKeys, result.keys[vbid1]);
+}
+
+TEST_P(RangeScanCoordinatorTest, one_task_scans_vbuckets_in_turn) {
+    auto coordinator = makeCoordinator(makeParams(), {vbid, vbid1}, 1);
+    runToEnd(*coordinator, 1);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    auto result = takeResponses();
+    EXPECT_EQ(std::vector<Vbid>({vbid, vbid1}), result.order);
+    EXPECT_EQ(vbucketKeys, result.keys[vbid]);
+    EXPECT_EQ(vbucketKeys, result.keys[vbid1]);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete, result.status);
+}
+
+// The tasks wait when the client hasn't taken the data read, and continue
+// once it has
+TEST_P(RangeScanCoordinatorTest, waits_for_the_client) {
+    // Every key fills the send buffer, and two keys fill the queue
+    engine->getConfiguration().setRangeScanReadBufferSendSize(1);
+    auto coordinator = makeCoordinator(makeParams(), {vbid}, 1);
+    using RunStatus = RangeScanCoordinator::RunStatus;
+
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(0));
+    EXPECT_EQ(RunStatus::Wait, coordinator->runOnIOThread(0));
+    EXPECT_EQ(1, multiCookie->notifications);
+    EXPECT_EQ(cb::engine_errc::would_block,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    EXPECT_EQ(1, multiCookie->responses.size());
+
+    // The client took the data, so the scan carries on
+    EXPECT_EQ(RunStatus::Wait, coordinator->runOnIOThread(0));
+    EXPECT_EQ(2, multiCookie->notifications);
+    runToEnd(*coordinator, 1);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    auto result = takeResponses();
+    EXPECT_EQ(vbucketKeys, result.keys[vbid]);
+    EXPECT_EQ(vbucketKeys.size(), result.order.size());
+}
+
+// Nothing is sent while the send queue of the client is full, and the tasks
+// read nothing more until it drains
+TEST_P(RangeScanCoordinatorTest, waits_for_the_send_queue) {
+    // Every key fills the send buffer, and two keys fill the queue
+    engine->getConfiguration().setRangeScanReadBufferSendSize(1);
+    auto coordinator = makeCoordinator(makeParams(), {vbid}, 1);
+    using RunStatus = RangeScanCoordinator::RunStatus;
+
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(0));
+    EXPECT_EQ(RunStatus::Wait, coordinator->runOnIOThread(0));
+    EXPECT_EQ(1, multiCookie->notifications);
+    EXPECT_EQ(1, coordinator->getQueuedChunks());
+
+    multiCookie->getConnection().setSendQueueFull(true);
+    EXPECT_EQ(cb::engine_errc::too_much_data_in_output_buffer,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    EXPECT_TRUE(multiCookie->responses.empty());
+
+    // However often the task runs, the scan makes no progress
+    for (int ii = 0; ii < 3; ++ii) {
+        EXPECT_EQ(RunStatus::Wait, coordinator->runOnIOThread(0));
+    }
+    EXPECT_EQ(1, coordinator->getQueuedChunks());
+    EXPECT_EQ(1, multiCookie->notifications);
+
+    // The send queue drained, the core executes the command again
+    multiCookie->getConnection().setSendQueueFull(false);
+    EXPECT_EQ(cb::engine_errc::would_block,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    EXPECT_EQ(1, multiCookie->responses.size());
+    EXPECT_EQ(0, coordinator->getQueuedChunks());
+
+    runToEnd(*coordinator, 1);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    auto result = takeResponses();
+    EXPECT_EQ(vbucketKeys, result.keys[vbid]);
+    EXPECT_EQ(vbucketKeys.size(), result.order.size());
+}
+
+// The byte limit stops the scan, and the final response resumes it
+TEST_P(RangeScanCoordinatorTest, byte_limit_and_resume) {
+    engine->getConfiguration().setRangeScanReadBufferSendSize(1);
+    auto params = makeParams();
+    params.byteLimit = 1;
+    auto coordinator = makeCoordinator(params, {vbid, vbid1}, 1);
+    runToEnd(*coordinator, 1);
+    EXPECT_EQ(cb::engine_errc::range_scan_more,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    auto result = takeResponses();
+    EXPECT_EQ(cb::engine_errc::range_scan_more, result.status);
+    EXPECT_EQ(std::vector<std::string>{"a"}, result.keys[vbid]);
+    EXPECT_EQ(0, result.keys.count(vbid1));
+    EXPECT_EQ(cb::base64::encode("a"),
+              result.finalValue["resume"]["0"].get<std::string>());
+    EXPECT_EQ(nlohmann::json::array({1}), result.finalValue["pending"]);
+    EXPECT_EQ(0, store->getKVStoreScanTracker().getNumRunningRangeScans());
+
+    // Resume the scan of vbucket 0 and start vbucket 1
+    params.byteLimit = 0;
+    params.resume = {{vbid, "a"}};
+    coordinator = makeCoordinator(params, {vbid, vbid1}, 2);
+    runToEnd(*coordinator, 2);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    result = takeResponses();
+    EXPECT_EQ(std::vector<std::string>({"b", "c", "d"}), result.keys[vbid]);
+    EXPECT_EQ(vbucketKeys, result.keys[vbid1]);
+    EXPECT_EQ(nlohmann::json::object(), result.finalValue);
+}
+
+// When the time limit passed before a vbucket started, every vbucket is
+// pending
+TEST_P(RangeScanCoordinatorTest, time_limit) {
+    auto params = makeParams();
+    params.timeLimit = 1ms;
+    auto coordinator = makeCoordinator(params, {vbid, vbid1}, 2);
+    std::this_thread::sleep_for(2ms);
+    runToEnd(*coordinator, 2);
+    EXPECT_EQ(cb::engine_errc::range_scan_more,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    auto result = takeResponses();
+    EXPECT_TRUE(result.order.empty());
+    EXPECT_EQ(nlohmann::json::array({0, 1}), result.finalValue["pending"]);
+    EXPECT_FALSE(result.finalValue.contains("resume"));
+}
+
+TEST_P(RangeScanCoordinatorTest, failed_vbucket) {
+    setVBucketStateAndRunPersistTask(vbid1, vbucket_state_replica);
+    auto coordinator = makeCoordinator(makeParams(), {vbid, vbid1, Vbid(2)}, 2);
+    runToEnd(*coordinator, 2);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              coordinator->sendOnFrontendThread(*multiCookie));
+    auto result = takeResponses();
+    EXPECT_EQ(vbucketKeys, result.keys[vbid]);
+    EXPECT_EQ(1, result.keys.size());
+    const auto& failed = result.finalValue["failed"];
+    EXPECT_EQ(2, failed.size());
+    EXPECT_TRUE(failed.contains("1"));
+    EXPECT_TRUE(failed.contains("2"));
+
+    // The reservations of the vbuckets which failed were released
+    EXPECT_EQ(0, store->getKVStoreScanTracker().getNumRunningRangeScans());
+}
+
+// The scan is cancelled when the token goes (the client disconnected)
+TEST_P(RangeScanCoordinatorTest, cancel_on_disconnect) {
+    auto coordinator = makeCoordinator(makeParams(), {vbid, vbid1}, 2);
+    using RunStatus = RangeScanCoordinator::RunStatus;
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(0));
+    EXPECT_EQ(1, store->getKVStoreScanTracker().getNumRunningRangeScans());
+
+    {
+        // The client disconnected, so its token is destroyed
+        RangeScanCoordinatorToken token{coordinator};
+    }
+
+    // The open scan is dropped, and nothing more is started
+    EXPECT_EQ(RunStatus::Again, coordinator->runOnIOThread(0));
+    EXPECT_EQ(0, store->getKVStoreScanTracker().getNumRunningRangeScans());
+    EXPECT_EQ(RunStatus::Finished, coordinator->runOnIOThread(0));
+    EXPECT_EQ(RunStatus::Finished, coordinator->runOnIOThread(1));
+    EXPECT_TRUE(coordinator->isFinished());
+    EXPECT_EQ(0, getEPBucket().getReadyRangeScans()->getCoordinatorTasks());
+
+    // And the client isn't notified or sent anything
+    EXPECT_EQ(0, multiCookie->notifications);
+    EXPECT_TRUE(multiCookie->responses.empty());
+}
+
+// range-scan-multi and range-scan-continue share the bucket's task limit
+TEST_P(RangeScanCoordinatorTest, shares_the_task_limit) {
+    auto& ready = *getEPBucket().getReadyRangeScans();
+    ready.setConcurrentTaskLimit(2);
+    auto coordinator = makeCoordinator(makeParams(), {vbid, vbid1}, 2);
+    EXPECT_EQ(0, ready.reserveCoordinatorTasks(1));
+
+    auto params = makeParams();
+    params.vbuckets = {vbid};
+    EXPECT_EQ(cb::engine_errc::too_busy,
+              getEPBucket().multiRangeScan(*cookie, params));
+
+    // A continue gets no task whilst the coordinator holds every task
+    auto uuid = createScan(scanCollection, {"\0", 1}, {"\xFF"});
+    cb::rangescan::ContinueParameters continueParams{
+            vbid, uuid, 0, 0ms, 0, cb::engine_errc::success};
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->continueRangeScan(*cookie, continueParams));
+    auto* q = task_executor->getLpTaskQ(TaskType::AuxIO);
+    EXPECT_EQ(0, q->getFutureQueueSize());
+    EXPECT_EQ(0, q->getReadyQueueSize());
+
+    // The first task of the coordinator to finish makes way for the continue
+    runToEnd(*coordinator, 2);
+    EXPECT_EQ(0, ready.getCoordinatorTasks());
+    EXPECT_EQ(1, q->getFutureQueueSize());
+    runNextTask(*q, "RangeScanContinueTask");
+    continueParams.currentStatus = mock_waitfor_cookie(cookie);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              continueParams.currentStatus);
+    EXPECT_EQ(cb::engine_errc::range_scan_complete,
+              store->continueRangeScan(*cookie, continueParams));
+
+    // Let the completed scan destruct
+    runNextTask(*q, "RangeScanContinueTask");
+}
+
 auto valueScanConfig = ::testing::Combine(
         ::testing::Values("persistent_couchdb"
 #ifdef EP_USE_MAGMA
@@ -2379,3 +2932,23 @@ INSTANTIATE_TEST_SUITE_P(RangeScanTestSimpleKeyScan,
                          RangeScanTestSimple,
                          keyScanConfig,
                          RangeScanTest::PrintToStringParamName);
+
+INSTANTIATE_TEST_SUITE_P(
+        RangeScanMemorySnapshot,
+        RangeScanMemorySnapshotTest,
+        ::testing::Combine(::testing::Values("persistent_couchdb"),
+                           ::testing::Values("value_only"),
+                           ::testing::Values("key_scan",
+                                             "value_scan",
+                                             "value_scan_include_xattrs")),
+        RangeScanTest::PrintToStringParamName);
+
+INSTANTIATE_TEST_SUITE_P(RangeScanCoordinatorKeyScan,
+                         RangeScanCoordinatorTest,
+                         keyScanConfig,
+                         RangeScanTest::PrintToStringParamName);
+
+INSTANTIATE_TEST_SUITE_P(RangeScanCoordinatorValueScan,
+                         RangeScanCoordinatorTest,
+                         valueScanConfig,
+                         RangeScanTest::PrintToStringParamName);
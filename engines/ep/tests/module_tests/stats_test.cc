@@ -1378,6 +1378,8 @@ protected:
         stats.defragNumMoved.store(nonDefaultCounterValue);
         stats.compressorNumVisited.store(nonDefaultCounterValue);
         stats.compressorNumCompressed.store(nonDefaultCounterValue);
+        stats.compressorInputBytes.store(nonDefaultCounterValue);
+        stats.compressorOutputBytes.store(nonDefaultCounterValue);
 
         stats.pendingOpsHisto.addValue(datapoint);
         stats.bgWaitHisto.addValue(datapoint);
@@ -1387,6 +1389,7 @@ protected:
         stats.checkpointRemoverHisto.addValue(datapoint);
         stats.itemPagerHisto.addValue(datapoint);
         stats.expiryPagerHisto.addValue(datapoint);
+        stats.compactionExpiryBatchHisto.addValue(datapoint);
         stats.getVbucketCmdHisto.addValue(datapoint);
         stats.setVbucketCmdHisto.addValue(datapoint);
         stats.delVbucketCmdHisto.addValue(datapoint);
@@ -1518,6 +1521,8 @@ protected:
         EXPECT_EQ(initializedValue, stats.defragNumMoved);
         EXPECT_EQ(initializedValue, stats.compressorNumVisited);
         EXPECT_EQ(initializedValue, stats.compressorNumCompressed);
+        EXPECT_EQ(initializedValue, stats.compressorInputBytes);
+        EXPECT_EQ(initializedValue, stats.compressorOutputBytes);
 
         // Histograms
         EXPECT_TRUE(stats.pendingOpsHisto.isEmpty());
@@ -1528,6 +1533,7 @@ protected:
         EXPECT_TRUE(stats.checkpointRemoverHisto.isEmpty());
         EXPECT_TRUE(stats.itemPagerHisto.isEmpty());
         EXPECT_TRUE(stats.expiryPagerHisto.isEmpty());
+        EXPECT_TRUE(stats.compactionExpiryBatchHisto.isEmpty());
         EXPECT_TRUE(stats.getVbucketCmdHisto.isEmpty());
         EXPECT_TRUE(stats.setVbucketCmdHisto.isEmpty());
         EXPECT_TRUE(stats.delVbucketCmdHisto.isEmpty());
@@ -267,6 +267,9 @@ public:
     cb::engine_errc cancelRangeScan(CookieIface& cookie,
                                     Vbid vbid,
                                     cb::rangescan::Id uuid) override;
+    cb::engine_errc multiRangeScan(
+            CookieIface& cookie,
+            const cb::rangescan::MultiVbucketParameters& params) override;
     cb::engine_errc syncFusionLogstore(Vbid vbid) override;
     cb::engine_errc startFusionUploader(Vbid vbid, uint64_t term) override;
     cb::engine_errc stopFusionUploader(Vbid vbid) override;
@@ -366,6 +369,19 @@ public:
                              uint32_t expiration,
                              uint32_t lock_time,
                              uint8_t nru) override;
+    cb::engine_errc mutation_patch(CookieIface& cookie,
+                                   uint32_t opaque,
+                                   const DocKeyView& key,
+                                   cb::const_byte_buffer patch,
+                                   uint8_t datatype,
+                                   uint64_t cas,
+                                   Vbid vbucket,
+                                   uint32_t flags,
+                                   uint64_t by_seqno,
+                                   uint64_t rev_seqno,
+                                   uint32_t expiration,
+                                   uint32_t lock_time,
+                                   uint8_t nru) override;
     cb::engine_errc deletion(CookieIface& cookie,
                              uint32_t opaque,
                              const DocKeyView& key,
@@ -1480,6 +1496,12 @@ cb::engine_errc EWB_Engine::cancelRangeScan(CookieIface& cookie,
     return real_engine->cancelRangeScan(cookie, vbid, uuid);
 }
 
+cb::engine_errc EWB_Engine::multiRangeScan(
+        CookieIface& cookie,
+        const cb::rangescan::MultiVbucketParameters& params) {
+    return real_engine->multiRangeScan(cookie, params);
+}
+
 cb::engine_errc EWB_Engine::mountVBucket(
         CookieIface& cookie,
         Vbid vbid,
@@ -1706,6 +1728,37 @@ cb::engine_errc EWB_Engine::mutation(CookieIface& cookie,
                                      nru);
 }
 
+cb::engine_errc EWB_Engine::mutation_patch(CookieIface& cookie,
+                                           uint32_t opaque,
+                                           const DocKeyView& key,
+                                           cb::const_byte_buffer patch,
+                                           uint8_t datatype,
+                                           uint64_t cas,
+                                           Vbid vbucket,
+                                           uint32_t flags,
+                                           uint64_t by_seqno,
+                                           uint64_t rev_seqno,
+                                           uint32_t expiration,
+                                           uint32_t lock_time,
+                                           uint8_t nru) {
+    if (!real_engine_dcp) {
+        return cb::engine_errc::not_supported;
+    }
+    return real_engine_dcp->mutation_patch(cookie,
+                                           opaque,
+                                           key,
+                                           patch,
+                                           datatype,
+                                           cas,
+                                           vbucket,
+                                           flags,
+                                           by_seqno,
+                                           rev_seqno,
+                                           expiration,
+                                           lock_time,
+                                           nru);
+}
+
 cb::engine_errc EWB_Engine::deletion(CookieIface& cookie,
                                      uint32_t opaque,
                                      const DocKeyView& key,
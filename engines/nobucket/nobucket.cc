@@ -241,6 +241,22 @@ public:
         return cb::engine_errc::no_bucket;
     }
 
+    cb::engine_errc mutation_patch(CookieIface&,
+                                   uint32_t,
+                                   const DocKeyView&,
+                                   cb::const_byte_buffer,
+                                   uint8_t,
+                                   uint64_t,
+                                   Vbid,
+                                   uint32_t,
+                                   uint64_t,
+                                   uint64_t,
+                                   uint32_t,
+                                   uint32_t,
+                                   uint8_t) override {
+        return cb::engine_errc::no_bucket;
+    }
+
     cb::engine_errc deletion(CookieIface&,
                              uint32_t,
                              const DocKeyView&,
@@ -54,6 +54,12 @@ cb::engine_errc EngineIface::cancelRangeScan(CookieIface& cookie,
     return cb::engine_errc::not_supported;
 }
 
+cb::engine_errc EngineIface::multiRangeScan(
+        CookieIface& cookie,
+        const cb::rangescan::MultiVbucketParameters& params) {
+    return cb::engine_errc::not_supported;
+}
+
 cb::engine_errc EngineIface::mountVBucket(
         CookieIface& cookie,
         Vbid vbid,
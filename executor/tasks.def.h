@@ -68,6 +68,7 @@ TASK(BackfillManagerTask, TaskType::AuxIO, 4)
 TASK(CompactVBucketTask, TaskType::AuxIO, 5)
 TASK(RangeScanCreateTask, TaskType::AuxIO, 6)
 TASK(RangeScanContinueTask, TaskType::AuxIO, 6)
+TASK(RangeScanCoordinatorTask, TaskType::AuxIO, 6)
 TASK(Core_PrepareSnapshotTask, TaskType::AuxIO, 0)
 TASK(Core_ReleaseSnapshotTask, TaskType::AuxIO, 6)
 TASK(Core_ReadFileFragmentTask, TaskType::AuxIO, 0)
@@ -110,6 +111,7 @@ TASK(CheckpointMemRecoveryTask, TaskType::NonIO, 6)
 TASK(VBucketMemoryDeletionTask, TaskType::NonIO, 6)
 TASK(DefragmenterTask, TaskType::NonIO, 7)
 TASK(ItemCompressorTask, TaskType::NonIO, 7)
+TASK(CouchFlushEncodeTask, TaskType::NonIO, 3)
 TASK(EphTombstoneHTCleaner, TaskType::NonIO, 7)
 TASK(EphTombstoneStaleItemDeleter, TaskType::NonIO, 7)
 TASK(ItemFreqDecayerTask, TaskType::NonIO, 7)
@@ -128,7 +130,6 @@ TASK(Core_SaslStartTask, TaskType::NonIO, 10)
 TASK(Core_SaslStepTask, TaskType::NonIO, 10)
 TASK(Core_Ifconfig, TaskType::NonIO, 10)
 TASK(Core_SetActiveEncryptionKeysTask, TaskType::NonIO, 10)
-TASK(Core_SubdocExecuteTask, TaskType::NonIO, 10)
 TASK(SeqnoPersistenceNotifyTask, TaskType::NonIO, 1)
 TASK(InitialMFUTask, TaskType::NonIO, 20)
 TASK(CacheTransferTask, TaskType::NonIO, 20)
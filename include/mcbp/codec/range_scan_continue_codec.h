@@ -102,4 +102,29 @@ protected:
 static_assert(sizeof(RangeScanContinueResponseExtras) == 4,
               "Unexpected object size");
 
+// The structure which is attached to the data response packets from
+// RangeScanMulti. The payload is encoded as for RangeScan continue, and the
+// vbucket identifies which vbucket the keys/documents were read from.
+#pragma pack(1)
+class RangeScanMultiResponseExtras {
+public:
+    RangeScanMultiResponseExtras(bool keyOnly, Vbid vbid);
+
+    std::string_view getBuffer() const {
+        return {reinterpret_cast<const char*>(this), sizeof(*this)};
+    }
+
+    RangeScanContinueResponseExtras::Flags getFlags() const;
+
+    Vbid getVBucket() const;
+
+protected:
+    uint32_t flags{0};
+    Vbid vbid;
+};
+#pragma pack()
+
+static_assert(sizeof(RangeScanMultiResponseExtras) == 6,
+              "Unexpected object size");
+
 } // namespace cb::mcbp::response
\ No newline at end of file
@@ -153,6 +153,7 @@ enum class ClientOpcode : uint8_t {
     DcpCachedValue = 0x66,
     DcpCachedKeyMeta = 0x67,
     DcpCacheTransferEnd = 0x68,
+    DcpMutationPatch = 0x69,
     /* End DCP */
 
     /// Fusion
@@ -357,6 +358,8 @@ enum class ClientOpcode : uint8_t {
     RangeScanContinue = 0xdb,
     /* Cancel a "key-index" RangeScan */
     RangeScanCancel = 0xdc,
+    /* Scan a range of a collection across many vbuckets */
+    RangeScanMulti = 0xdd,
 
     /* snapshot related opcodes */
     PrepareSnapshot = 0xe0,
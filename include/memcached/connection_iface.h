@@ -131,6 +131,14 @@ public:
     virtual void setDcpFlowControlBufferSize(std::size_t size) {
     }
 
+    /**
+     * Is the send queue of the connection full (max_send_queue_size)? An
+     * engine sending data without an explicit limit should stop producing
+     * more and return too_much_data_in_output_buffer, and the core will
+     * execute the command again once the send queue is drained.
+     */
+    virtual bool isSendQueueFull() const = 0;
+
     /// Get the timestamp for when the connection was created
     const auto& getCreationTimestamp() const {
         return created;
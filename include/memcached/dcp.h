@@ -153,6 +153,43 @@ struct DcpMessageProducersIface {
             uint8_t nru,
             cb::mcbp::DcpStreamId sid) = 0;
 
+    /**
+     * Send a Mutation as a patch against the previous value of the
+     * document (the value with the CAS base_cas). The new value is the
+     * previous value with remove_length bytes at offset replaced with the
+     * insert_length bytes at offset in the value of itm.
+     *
+     * @param opaque this is the opaque requested by the consumer
+     *               in the Stream Request message
+     * @param itm the item to send (holding the complete new value)
+     * @param vbucket the vbucket id the message belong to
+     * @param by_seqno
+     * @param rev_seqno
+     * @param lock_time
+     * @param nru the nru field used by ep-engine (may safely be ignored)
+     * @param base_cas the CAS of the value the patch applies to
+     * @param offset the offset of the change
+     * @param remove_length the number of bytes removed from the previous
+     *                      value
+     * @param insert_length the number of bytes inserted (from itm)
+     * @param sid The stream-ID the mutation applies to (can be 0 for none)
+     *
+     * @return cb::engine_errc::success upon success
+     */
+    [[nodiscard]] virtual cb::engine_errc mutation_patch(
+            uint32_t opaque,
+            cb::unique_item_ptr itm,
+            Vbid vbucket,
+            uint64_t by_seqno,
+            uint64_t rev_seqno,
+            uint32_t lock_time,
+            uint8_t nru,
+            uint64_t base_cas,
+            uint32_t offset,
+            uint32_t remove_length,
+            uint32_t insert_length,
+            cb::mcbp::DcpStreamId sid) = 0;
+
     /**
      * Send a deletion
      *
@@ -602,6 +639,40 @@ struct DcpIface {
                                                    uint32_t lock_time,
                                                    uint8_t nru) = 0;
 
+    /**
+     * Callback to the engine that a mutation patch message was received
+     *
+     * @param cookie The cookie representing the connection
+     * @param opaque The opaque field in the message (identifying the stream)
+     * @param key The documents key
+     * @param patch The patch (a DcpMutationPatchHeader followed by the
+     *              bytes to insert)
+     * @param datatype The datatype of the patched document
+     * @param cas The CAS value of the patched document
+     * @param vbucket The vbucket identifier for the document
+     * @param flags The user specified flags
+     * @param by_seqno The sequence number in the vbucket
+     * @param rev_seqno The revision number for the item
+     * @param expiration When the document expire
+     * @param lock_time The lock time for the document
+     * @param nru The engine's NRU value
+     * @return Standard engine error code.
+     */
+    [[nodiscard]] virtual cb::engine_errc mutation_patch(
+            CookieIface& cookie,
+            uint32_t opaque,
+            const DocKeyView& key,
+            cb::const_byte_buffer patch,
+            uint8_t datatype,
+            uint64_t cas,
+            Vbid vbucket,
+            uint32_t flags,
+            uint64_t by_seqno,
+            uint64_t rev_seqno,
+            uint32_t expiration,
+            uint32_t lock_time,
+            uint8_t nru) = 0;
+
     /**
      * Callback to the engine that a deletion message was received
      *
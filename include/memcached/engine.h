@@ -948,6 +948,19 @@ struct EngineIface {
     [[nodiscard]] virtual cb::engine_errc cancelRangeScan(
             CookieIface& cookie, Vbid vbid, cb::rangescan::Id uuid);
 
+    /**
+     * Scan a range of a collection across many vbuckets. The keys/documents
+     * of the vbuckets are sent to the client as they are read.
+     *
+     * @param cookie The cookie identifying the request
+     * @param params Bundled parameters of the scan
+     * @return would_block whilst the scan runs, range_scan_complete or
+     *         range_scan_more when the engine has sent the final response
+     */
+    [[nodiscard]] virtual cb::engine_errc multiRangeScan(
+            CookieIface& cookie,
+            const cb::rangescan::MultiVbucketParameters& params);
+
     /**
      * Force flush to disk of the magma write cache for the given vbucket and
      * sync the data to fusion.
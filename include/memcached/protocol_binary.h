@@ -1185,6 +1185,51 @@ protected:
 };
 static_assert(sizeof(DcpSeqnoAdvancedPayload) == 8, "Unexpected struct size");
 
+/**
+ * The header at the start of the value of a DcpMutationPatch message. The
+ * new value of the document is the value with the provided base CAS with
+ * remove_length bytes at offset replaced with the rest of the message
+ * value.
+ */
+class DcpMutationPatchHeader {
+public:
+    DcpMutationPatchHeader() = default;
+    DcpMutationPatchHeader(uint64_t base_cas,
+                           uint32_t offset,
+                           uint32_t remove_length)
+        : base_cas(htonll(base_cas)),
+          offset(htonl(offset)),
+          remove_length(htonl(remove_length)) {
+    }
+    [[nodiscard]] uint64_t getBaseCas() const {
+        return ntohll(base_cas);
+    }
+    void setBaseCas(uint64_t value) {
+        base_cas = htonll(value);
+    }
+    [[nodiscard]] uint32_t getOffset() const {
+        return ntohl(offset);
+    }
+    void setOffset(uint32_t value) {
+        offset = htonl(value);
+    }
+    [[nodiscard]] uint32_t getRemoveLength() const {
+        return ntohl(remove_length);
+    }
+    void setRemoveLength(uint32_t value) {
+        remove_length = htonl(value);
+    }
+    [[nodiscard]] cb::const_byte_buffer getBuffer() const {
+        return {reinterpret_cast<const uint8_t*>(this), sizeof(*this)};
+    }
+
+protected:
+    uint64_t base_cas = 0;
+    uint32_t offset = 0;
+    uint32_t remove_length = 0;
+};
+static_assert(sizeof(DcpMutationPatchHeader) == 16, "Unexpected struct size");
+
 } // namespace request
 } // namespace cb::mcbp
 
@@ -18,6 +18,8 @@
 
 #include <chrono>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace cb::rangescan {
 
@@ -112,6 +114,9 @@ struct CreateParameters {
 
     /// a name (can be empty) that the client can provide
     std::string_view name;
+
+    /// optional projection of the values returned by a value scan
+    std::optional<ProjectionConfiguration> projection;
 };
 
 /// All of the parameters required to continue a RangeScan included any I/O
@@ -154,6 +159,65 @@ struct ContinueParameters {
     cb::engine_errc currentStatus{cb::engine_errc::success};
 };
 
+/// All of the parameters required to scan a range of a collection across
+/// many vbuckets (range-scan-multi) including any I/O complete phase of the
+/// request.
+struct MultiVbucketParameters {
+    MultiVbucketParameters(CollectionID cid,
+                           KeyView start,
+                           KeyView end,
+                           KeyOnly keyOnly,
+                           IncludeXattrs includeXattrs,
+                           cb::engine_errc currentStatus)
+        : cid(cid),
+          start(start),
+          end(end),
+          keyOnly(keyOnly),
+          includeXattrs(includeXattrs),
+          currentStatus(currentStatus) {
+    }
+
+    /// The collection to scan
+    CollectionID cid;
+
+    /// scan start
+    KeyView start;
+
+    /// scan end
+    KeyView end;
+
+    /// key or value configuration
+    KeyOnly keyOnly{KeyOnly::Yes};
+
+    /// include xattrs with document
+    IncludeXattrs includeXattrs{IncludeXattrs::No};
+
+    /// optional projection of the values returned by a value scan
+    std::optional<ProjectionConfiguration> projection;
+
+    /// The vbuckets to scan, when empty all active vbuckets are scanned
+    std::vector<Vbid> vbuckets;
+
+    /// The keys after which the scan of a vbucket resumes (the resume tokens
+    /// returned by a previous request, these override start)
+    std::vector<std::pair<Vbid, std::string>> resume;
+
+    /// The maximum duration of the request, 0 means no limit enforced
+    std::chrono::milliseconds timeLimit{0};
+
+    /// When the number of bytes returned exceeds this value the request is
+    /// complete. This is not an absolute limit, but a trigger. A value of 0
+    /// disables this trigger.
+    size_t byteLimit{0};
+
+    /// a name (can be empty) that the client can provide
+    std::string_view name;
+
+    /// The current status of the request, required for driving the command
+    /// via the async IO complete pattern
+    cb::engine_errc currentStatus{cb::engine_errc::success};
+};
+
 const size_t MaximumNameSize = 50;
 
 } // namespace cb::rangescan
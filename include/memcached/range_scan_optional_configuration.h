@@ -15,6 +15,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace cb::rangescan {
 
@@ -43,4 +45,20 @@ struct SamplingConfiguration {
     uint32_t seed{0};
 };
 
+// Optional projection (and filter) of the documents returned by a value scan,
+// which is evaluated by the I/O task reading the documents
+struct ProjectionConfiguration {
+    // Only return the documents where the value at path equals value
+    struct Filter {
+        // The (sub-document) path of the field to compare
+        std::string path;
+        // The JSON value the field must be equal to
+        std::string value;
+    };
+    // The (sub-document) paths of the fields to return for each document.
+    // When empty the complete value of the document is returned
+    std::vector<std::string> paths;
+    std::optional<Filter> filter;
+};
+
 } // namespace cb::rangescan
\ No newline at end of file
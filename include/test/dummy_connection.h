@@ -48,6 +48,9 @@ public:
     }
     void setDcpFlowControlBufferSize(std::size_t size) override {
     }
+    bool isSendQueueFull() const override {
+        return false;
+    }
 
 protected:
     cb::rbac::UserIdent user{"dummy", cb::rbac::Domain::Local};
@@ -14,6 +14,8 @@
 #include <xattr/utils.h>
 #include <cstddef>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace cb::xattr {
 
@@ -62,6 +64,17 @@ public:
      */
     [[nodiscard]] std::string_view get(std::string_view key) const;
 
+    /**
+     * Index the keys in the blob so that get() (and set() of a value of
+     * the same size as the current value) use a binary search instead of
+     * scanning all of the keys. Building the index costs about log2(n)
+     * scans of the n keys, so use it when looking up more keys than that.
+     * The blob stays indexed (the index is rebuilt on the
+     * next lookup once keys are added or removed). The encoded blob is not
+     * affected.
+     */
+    void build_index() const;
+
     /**
      * Remove a given key (and its value) from the blob.
      *
@@ -72,6 +85,10 @@ public:
     /**
      * Set (add or replace) the given key with the specified value.
      *
+     * A value of the same size as the current value is replaced in place
+     * (in the buffer the blob was created with, if any), otherwise the key
+     * is moved to the end of the blob.
+     *
      * @param key The key to set
      * @param value The new value for the key
      */
@@ -207,6 +224,22 @@ protected:
                       std::string_view key,
                       std::string_view value);
 
+    /**
+     * Get the key of the kv-pair at the given offset
+     *
+     * @param offset The offset of the kv-pair (its length)
+     */
+    [[nodiscard]] std::string_view read_key(size_t offset) const;
+
+    /**
+     * Locate the key using the index
+     *
+     * @param key The key to look up
+     * @return The offset of the kv-pair, or nullopt if not found
+     */
+    [[nodiscard]] std::optional<size_t> find_indexed(
+            std::string_view key) const;
+
     /**
      * Get the length stored at the given offset
      *
@@ -254,6 +287,13 @@ private:
     /// The current view of the content of the blob
     cb::char_buffer blob;
 
+    /// Set once build_index() is called: lookups use the index
+    mutable bool use_index = false;
+
+    /// The offsets of the kv-pairs sorted by their key (reset when the
+    /// layout of the blob changes)
+    mutable std::optional<std::vector<uint32_t>> index;
+
     /// If we need to add data to the blob we need somewhere to store the
     /// data of the entire blob until the object dies.
     std::string allocator;
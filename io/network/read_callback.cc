@@ -79,6 +79,9 @@ void AsyncReadCallback::readErr(
 }
 
 cb::const_byte_buffer AsyncReadCallback::getAvailableBytes(size_t max) const {
+    if (input.empty()) {
+        return {};
+    }
     return {input.front()->data(),
             std::min(std::size_t(max), input.front()->length())};
 }
@@ -163,6 +163,17 @@ TEST_P(AsyncReaderUnitTests, MessageReceived) {
     EXPECT_FALSE(readCallback.isPacketAvailable());
 }
 
+// The input stream may be inspected before (and after) data is received
+TEST_P(AsyncReaderUnitTests, AvailableBytesEmptyStream) {
+    EXPECT_TRUE(readCallback.getAvailableBytes(1024).empty());
+    addFrameToStream(0);
+    EXPECT_EQ(sizeof(cb::mcbp::Header),
+              readCallback.getAvailableBytes(1024).size());
+    ASSERT_TRUE(readCallback.isPacketAvailable());
+    readCallback.nextPacket();
+    EXPECT_TRUE(readCallback.getAvailableBytes(1024).empty());
+}
+
 TEST_P(AsyncReaderUnitTests, ProtocolErrorDetected) {
     size_t ii = 0;
     while (!frame_available.has_value()) {
@@ -0,0 +1,280 @@
+/*
+ *    Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "structural_index.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace cb::json {
+
+/// The bitmasks of the interesting characters in a 64 byte block (bit N is
+/// set if byte N is the character)
+struct BlockMasks {
+    uint64_t backslash = 0;
+    uint64_t quote = 0;
+    uint64_t structural = 0;
+};
+
+#if defined(__AVX2__)
+static uint64_t eqMask(__m256i lo, __m256i hi, char c) {
+    const auto needle = _mm256_set1_epi8(c);
+    const auto l = uint32_t(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    const auto h = uint32_t(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return uint64_t(l) | (uint64_t(h) << 32);
+}
+
+static BlockMasks classify(const char* block) {
+    const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const auto hi =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    return {eqMask(lo, hi, '\\'),
+            eqMask(lo, hi, '"'),
+            eqMask(lo, hi, '{') | eqMask(lo, hi, '}') | eqMask(lo, hi, '[') |
+                    eqMask(lo, hi, ']') | eqMask(lo, hi, ':') |
+                    eqMask(lo, hi, ',')};
+}
+#elif defined(__SSE2__)
+static uint64_t eqMask(const __m128i (&in)[4], char c) {
+    const auto needle = _mm_set1_epi8(c);
+    uint64_t ret = 0;
+    for (int ii = 0; ii < 4; ++ii) {
+        ret |= uint64_t(uint16_t(
+                       _mm_movemask_epi8(_mm_cmpeq_epi8(in[ii], needle))))
+               << (ii * 16);
+    }
+    return ret;
+}
+
+static BlockMasks classify(const char* block) {
+    const __m128i in[4] = {
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48))};
+    return {eqMask(in, '\\'),
+            eqMask(in, '"'),
+            eqMask(in, '{') | eqMask(in, '}') | eqMask(in, '[') |
+                    eqMask(in, ']') | eqMask(in, ':') | eqMask(in, ',')};
+}
+#elif defined(__ARM_NEON)
+/// NEON has no movemask; weight each lane by its bit and add them up
+static uint16_t movemask(uint8x16_t input) {
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                        1, 2, 4, 8, 16, 32, 64, 128};
+    const auto masked = vandq_u8(input, vld1q_u8(weights));
+    return uint16_t(vaddv_u8(vget_low_u8(masked))) |
+           uint16_t(vaddv_u8(vget_high_u8(masked)) << 8);
+}
+
+static uint64_t eqMask(const uint8x16_t (&in)[4], char c) {
+    const auto needle = vdupq_n_u8(uint8_t(c));
+    uint64_t ret = 0;
+    for (int ii = 0; ii < 4; ++ii) {
+        ret |= uint64_t(movemask(vceqq_u8(in[ii], needle))) << (ii * 16);
+    }
+    return ret;
+}
+
+static BlockMasks classify(const char* block) {
+    const auto* ptr = reinterpret_cast<const uint8_t*>(block);
+    const uint8x16_t in[4] = {
+            vld1q_u8(ptr), vld1q_u8(ptr + 16), vld1q_u8(ptr + 32),
+            vld1q_u8(ptr + 48)};
+    return {eqMask(in, '\\'),
+            eqMask(in, '"'),
+            eqMask(in, '{') | eqMask(in, '}') | eqMask(in, '[') |
+                    eqMask(in, ']') | eqMask(in, ':') | eqMask(in, ',')};
+}
+#else
+static BlockMasks classify(const char* block) {
+    BlockMasks ret;
+    for (int ii = 0; ii < 64; ++ii) {
+        const uint64_t bit = uint64_t(1) << ii;
+        switch (block[ii]) {
+        case '\\':
+            ret.backslash |= bit;
+            break;
+        case '"':
+            ret.quote |= bit;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            ret.structural |= bit;
+            break;
+        }
+    }
+    return ret;
+}
+#endif
+
+/**
+ * Find the characters escaped by a backslash (the algorithm used by
+ * simdjson): a run of backslashes escapes the character following it if
+ * the run has an odd length.
+ *
+ * @param backslash the backslashes in the block
+ * @param prevEscaped carry: is the first character in the block escaped
+ * @return the escaped characters in the block
+ */
+static uint64_t findEscaped(uint64_t backslash, uint64_t& prevEscaped) {
+    constexpr uint64_t evenBits = 0x5555555555555555ULL;
+    backslash &= ~prevEscaped;
+    const uint64_t followsEscape = backslash << 1 | prevEscaped;
+    const uint64_t oddSequenceStarts = backslash & ~evenBits & ~followsEscape;
+    const uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+    // Carry out of the addition (the sequence runs into the next block)
+    prevEscaped = sequencesStartingOnEvenBits < oddSequenceStarts ? 1 : 0;
+    const uint64_t invertMask = sequencesStartingOnEvenBits << 1;
+    return (evenBits ^ invertMask) & followsEscape;
+}
+
+/// Set every bit between a quote and the next one (including the opening
+/// quote): the carry-less multiplication with all ones done with shifts
+static uint64_t prefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+bool StructuralIndex::build(std::string_view doc) {
+    clear();
+    if (doc.size() >= std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    document = doc;
+    documentSize = doc.size();
+    positions.reserve(doc.size() / 8);
+
+    uint64_t prevEscaped = 0;
+    uint64_t prevInString = 0;
+    for (std::size_t offset = 0; offset < doc.size(); offset += 64) {
+        BlockMasks masks;
+        if (doc.size() - offset >= 64) {
+            masks = classify(doc.data() + offset);
+        } else {
+            // Pad the last block with spaces
+            char block[64];
+            std::memset(block, ' ', sizeof(block));
+            std::memcpy(block, doc.data() + offset, doc.size() - offset);
+            masks = classify(block);
+        }
+
+        const auto escaped = findEscaped(masks.backslash, prevEscaped);
+        const auto quote = masks.quote & ~escaped;
+        const auto inString = prefixXor(quote) ^ prevInString;
+        prevInString = uint64_t(int64_t(inString) >> 63);
+
+        // The structural characters outside of strings and the quotes
+        // opening the strings
+        auto bits = (masks.structural & ~inString) | (quote & inString);
+        while (bits) {
+            positions.push_back(
+                    uint32_t(offset + std::countr_zero(bits)));
+            bits &= bits - 1;
+        }
+    }
+
+    if (prevInString) {
+        // Unterminated string
+        clear();
+        return false;
+    }
+
+    // Pair the brackets
+    pairs.resize(positions.size());
+    std::vector<uint32_t> stack;
+    for (uint32_t ii = 0; ii < positions.size(); ++ii) {
+        pairs[ii] = ii;
+        const auto c = doc[positions[ii]];
+        if (c == '{' || c == '[') {
+            stack.push_back(ii);
+            maxDepth = std::max(maxDepth, stack.size());
+        } else if (c == '}' || c == ']') {
+            if (stack.empty() ||
+                doc[positions[stack.back()]] != (c == '}' ? '{' : '[')) {
+                clear();
+                return false;
+            }
+            pairs[ii] = stack.back();
+            pairs[stack.back()] = ii;
+            stack.pop_back();
+        }
+    }
+    if (!stack.empty()) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+void StructuralIndex::clear() {
+    document = {};
+    documentSize = 0;
+    detached = false;
+    documentHash = 0;
+    positions.clear();
+    pairs.clear();
+    maxDepth = 0;
+}
+
+void StructuralIndex::detach(uint32_t hash) {
+    document = {};
+    detached = true;
+    documentHash = hash;
+}
+
+bool StructuralIndex::isFor(std::string_view doc,
+                            std::optional<uint32_t> hash) const {
+    if (detached) {
+        // The size alone doesn't identify the document
+        return doc.size() == documentSize && hash == documentHash;
+    }
+    return doc.data() == document.data() && doc.size() == document.size();
+}
+
+std::size_t StructuralIndex::getMemoryUsage() const {
+    return sizeof(*this) + positions.capacity() * sizeof(uint32_t) +
+           pairs.capacity() * sizeof(uint32_t);
+}
+
+std::size_t StructuralIndex::findClose(std::size_t offset) const {
+    const auto iter =
+            std::lower_bound(positions.begin(), positions.end(), offset);
+    if (iter == positions.end() || *iter != offset) {
+        return std::string_view::npos;
+    }
+    // Only the opening brackets are paired with a later position
+    const auto idx = uint32_t(iter - positions.begin());
+    if (pairs[idx] <= idx) {
+        return std::string_view::npos;
+    }
+    return positions[pairs[idx]];
+}
+
+} // namespace cb::json
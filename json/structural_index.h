@@ -0,0 +1,113 @@
+/*
+ *    Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace cb::json {
+
+/// The structural index of a JSON document: the offsets of the characters
+/// which define the structure of the document ('{', '}', '[', ']', ':',
+/// ',' and the quotes opening strings). The index is built in the style of
+/// simdjson's "stage 1": the document is classified 64 bytes at the time
+/// into bitmasks (using SIMD instructions where available), the escaped
+/// characters and the content of the strings are masked out with bitwise
+/// arithmetic, and the offsets are extracted from the remaining bits.
+///
+/// The brackets are paired as part of building the index, so the end of a
+/// container may be found without looking at its content.
+class StructuralIndex {
+public:
+    /**
+     * Build the index for the provided document (replacing the current
+     * index). The document must outlive the use of the index.
+     *
+     * @param doc the document to index
+     * @return true if the index was built, false if the document can't be
+     *         JSON (it has an unterminated string or unbalanced brackets)
+     *         or is too big to be indexed
+     */
+    [[nodiscard]] bool build(std::string_view doc);
+
+    /// Drop the current index
+    void clear();
+
+    /**
+     * Forget the document the index was built for (but keep the index),
+     * so that the index may outlive the document and be used for an
+     * identical copy of it (see isFor()).
+     *
+     * @param hash A hash of the document (the caller picks the function)
+     */
+    void detach(uint32_t hash);
+
+    /**
+     * Can the index be used for the provided document. That is the case
+     * if the index was built for it, or if the index is detached and the
+     * document has the same size and hash as the indexed one.
+     *
+     * @param doc The document to use the index for
+     * @param hash The hash of doc (computed as for detach()), required to
+     *             use a detached index
+     */
+    [[nodiscard]] bool isFor(std::string_view doc,
+                             std::optional<uint32_t> hash = {}) const;
+
+    /// The number of bytes used by the index
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+
+    /// The document the index was built for (empty if detached)
+    [[nodiscard]] std::string_view getDocument() const {
+        return document;
+    }
+
+    /// The size of the document the index was built for
+    [[nodiscard]] std::size_t getDocumentSize() const {
+        return documentSize;
+    }
+
+    /// The offsets of the structural characters (in document order)
+    [[nodiscard]] const std::vector<uint32_t>& getPositions() const {
+        return positions;
+    }
+
+    /// The max nesting level of the containers in the document
+    [[nodiscard]] std::size_t getMaxDepth() const {
+        return maxDepth;
+    }
+
+    /**
+     * Find the end of the container opened at the given offset
+     *
+     * @param offset the offset of a '{' or '[' in the document
+     * @return the offset of the matching '}' or ']' (or npos if offset
+     *         isn't the start of a container)
+     */
+    [[nodiscard]] std::size_t findClose(std::size_t offset) const;
+
+protected:
+    std::string_view document;
+    std::size_t documentSize = 0;
+    bool detached = false;
+    /// The hash of the document provided when detached
+    uint32_t documentHash = 0;
+    std::vector<uint32_t> positions;
+    /// For each entry in positions: the index of the matching bracket (or
+    /// the index itself for the other structural characters)
+    std::vector<uint32_t> pairs;
+    std::size_t maxDepth = 0;
+};
+
+} // namespace cb::json
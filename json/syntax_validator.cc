@@ -9,9 +9,11 @@
  */
 
 #include "syntax_validator.h"
+#include "structural_index.h"
 
 #include <JSON_checker.h>
 #include <nlohmann/json.hpp>
+#include <limits>
 #include <stdexcept>
 
 namespace cb::json {
@@ -37,6 +39,39 @@ protected:
     JSON_checker::Validator validator;
 };
 
+/// Validator building the structural index of the document before running
+/// the vectorized JSON_checker over it. The index rejects documents with
+/// unterminated strings or unbalanced brackets without running the checker,
+/// and is kept so that the caller may reuse it to navigate the document.
+class IndexedValidator : public JSON_checkerValidator {
+public:
+    IndexedValidator() : JSON_checkerValidator(true) {
+    }
+
+    [[nodiscard]] bool validate(std::string_view view) override {
+        if (view.size() >= std::numeric_limits<uint32_t>::max()) {
+            // Too big to be indexed
+            index.clear();
+            return validator.validate(view);
+        }
+        if (!index.build(view)) {
+            return false;
+        }
+        if (!validator.validate(view)) {
+            index.clear();
+            return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] const StructuralIndex* getStructuralIndex() const override {
+        return &index;
+    }
+
+protected:
+    StructuralIndex index;
+};
+
 class NlohmannValidator : public SyntaxValidator {
 public:
     [[nodiscard]] bool validate(std::string_view view) override {
@@ -52,6 +87,8 @@ std::unique_ptr<SyntaxValidator> SyntaxValidator::New(Type type) {
         return std::make_unique<JSON_checkerValidator>(false);
     case Type::JSON_checker_vectorized:
         return std::make_unique<JSON_checkerValidator>(true);
+    case Type::JSON_checker_indexed:
+        return std::make_unique<IndexedValidator>();
     case Type::Nlohmann:
         return std::make_unique<NlohmannValidator>();
     }
@@ -65,6 +102,8 @@ std::string to_string(const cb::json::SyntaxValidator::Type& type) {
         return "JSON_checker";
     case cb::json::SyntaxValidator::Type::JSON_checker_vectorized:
         return "JSON_checker_vectorized";
+    case cb::json::SyntaxValidator::Type::JSON_checker_indexed:
+        return "JSON_checker_indexed";
     case cb::json::SyntaxValidator::Type::Nlohmann:
         return "Nlohmann";
     }
@@ -16,6 +16,8 @@
 
 namespace cb::json {
 
+class StructuralIndex;
+
 /// Abstract class to provide a JSON validator of a supported type
 /// The motivation behind this class is to make it easy to flip the backend
 /// across all components without having to update all of them.
@@ -24,6 +26,9 @@ public:
     enum class [[nodiscard]] Type {
         JSON_checker,
         JSON_checker_vectorized,
+        /// JSON_checker_vectorized preceded by building the
+        /// StructuralIndex of the document (which is kept for reuse)
+        JSON_checker_indexed,
         Nlohmann
     };
 
@@ -32,6 +37,12 @@ public:
     /// Validate that the provided view contains valid JSON
     [[nodiscard]] virtual bool validate(std::string_view view) = 0;
 
+    /// Get the structural index of the last document successfully
+    /// validated (or nullptr if the backend doesn't build one)
+    [[nodiscard]] virtual const StructuralIndex* getStructuralIndex() const {
+        return nullptr;
+    }
+
     /// Create a new instance of the given type
     [[nodiscard]] static std::unique_ptr<SyntaxValidator> New(
             Type = Type::JSON_checker_vectorized);
@@ -8,6 +8,7 @@
  *   the file licenses/APL2.txt.
  */
 
+#include "structural_index.h"
 #include "syntax_validator.h"
 
 #include <benchmark/benchmark.h>
@@ -36,6 +37,9 @@ BENCHMARK_CAPTURE(BM_SyntaxValidator_Empty,
 BENCHMARK_CAPTURE(BM_SyntaxValidator_Empty,
                   JSON_checker_vectorized,
                   SyntaxValidator::Type::JSON_checker_vectorized);
+BENCHMARK_CAPTURE(BM_SyntaxValidator_Empty,
+                  JSON_checker_indexed,
+                  SyntaxValidator::Type::JSON_checker_indexed);
 BENCHMARK_CAPTURE(BM_SyntaxValidator_Empty,
                   Nlohmann,
                   SyntaxValidator::Type::Nlohmann);
@@ -57,6 +61,9 @@ BENCHMARK_CAPTURE(BM_SyntaxValidator_Binary,
 BENCHMARK_CAPTURE(BM_SyntaxValidator_Binary,
                   JSON_checker_vectorized,
                   SyntaxValidator::Type::JSON_checker_vectorized);
+BENCHMARK_CAPTURE(BM_SyntaxValidator_Binary,
+                  JSON_checker_indexed,
+                  SyntaxValidator::Type::JSON_checker_indexed);
 BENCHMARK_CAPTURE(BM_SyntaxValidator_Binary,
                   Nlohmann,
                   SyntaxValidator::Type::Nlohmann);
@@ -89,6 +96,11 @@ BENCHMARK_CAPTURE(BM_SyntaxValidator_JsonArray,
                   SyntaxValidator::Type::JSON_checker_vectorized)
         ->RangeMultiplier(10)
         ->Range(1, 10000);
+BENCHMARK_CAPTURE(BM_SyntaxValidator_JsonArray,
+                  JSON_checker_indexed,
+                  SyntaxValidator::Type::JSON_checker_indexed)
+        ->RangeMultiplier(10)
+        ->Range(1, 10000);
 BENCHMARK_CAPTURE(BM_SyntaxValidator_JsonArray,
                   Nlohmann,
                   SyntaxValidator::Type::Nlohmann)
@@ -125,6 +137,11 @@ BENCHMARK_CAPTURE(BM_SyntaxValidator_JsonNestedDict,
                   SyntaxValidator::Type::JSON_checker_vectorized)
         ->RangeMultiplier(10)
         ->Range(1, 10000);
+BENCHMARK_CAPTURE(BM_SyntaxValidator_JsonNestedDict,
+                  JSON_checker_indexed,
+                  SyntaxValidator::Type::JSON_checker_indexed)
+        ->RangeMultiplier(10)
+        ->Range(1, 10000);
 BENCHMARK_CAPTURE(BM_SyntaxValidator_JsonNestedDict,
                   Nlohmann,
                   SyntaxValidator::Type::Nlohmann)
@@ -166,6 +183,11 @@ BENCHMARK_CAPTURE(BM_SyntaxValidator_Strings,
                   SyntaxValidator::Type::JSON_checker_vectorized)
         ->RangeMultiplier(10)
         ->Range(1, 10000);
+BENCHMARK_CAPTURE(BM_SyntaxValidator_Strings,
+                  JSON_checker_indexed,
+                  SyntaxValidator::Type::JSON_checker_indexed)
+        ->RangeMultiplier(10)
+        ->Range(1, 10000);
 BENCHMARK_CAPTURE(BM_SyntaxValidator_Strings,
                   Nlohmann,
                   SyntaxValidator::Type::Nlohmann)
@@ -211,10 +233,35 @@ BENCHMARK_CAPTURE(BM_SyntaxValidator_SampleDocument,
 BENCHMARK_CAPTURE(BM_SyntaxValidator_SampleDocument,
                   JSON_checker_vectorized,
                   SyntaxValidator::Type::JSON_checker_vectorized);
+BENCHMARK_CAPTURE(BM_SyntaxValidator_SampleDocument,
+                  JSON_checker_indexed,
+                  SyntaxValidator::Type::JSON_checker_indexed);
 BENCHMARK_CAPTURE(BM_SyntaxValidator_SampleDocument,
                   Nlohmann,
                   SyntaxValidator::Type::Nlohmann);
 
+// Benchmark building the structural index alone for the documents used
+// above (the part of the indexed validator which is reused)
+static void BM_StructuralIndex_Strings(benchmark::State& state) {
+    const auto doc = makeStringsArray(state);
+    cb::json::StructuralIndex index;
+    while (state.KeepRunning()) {
+        EXPECT_TRUE(index.build(doc));
+    }
+    state.SetBytesProcessed(state.iterations() * doc.size());
+}
+BENCHMARK(BM_StructuralIndex_Strings)->RangeMultiplier(10)->Range(1, 10000);
+
+static void BM_StructuralIndex_JsonArray(benchmark::State& state) {
+    const auto doc = makeArray(state);
+    cb::json::StructuralIndex index;
+    while (state.KeepRunning()) {
+        EXPECT_TRUE(index.build(doc));
+    }
+    state.SetBytesProcessed(state.iterations() * doc.size());
+}
+BENCHMARK(BM_StructuralIndex_JsonArray)->RangeMultiplier(10)->Range(1, 10000);
+
 // Using custom main() function (instead of BENCHMARK_MAIN macro) to
 // init GoogleTest.
 int main(int argc, char** argv) {
@@ -8,10 +8,13 @@
  *   the file licenses/APL2.txt.
  */
 
+#include "structural_index.h"
 #include "syntax_validator.h"
 #include <folly/portability/GTest.h>
 #include <array>
+#include <string>
 #include <string_view>
+#include <vector>
 
 // This is a "copy" of the old unit tests we used to test for JSON_checker
 // just to verify that if we decide to replace the validator we don't
@@ -46,6 +49,7 @@ INSTANTIATE_TEST_SUITE_P(
         SyntaxValidator,
         SyntaxValidatorTest,
         ::testing::Values(cb::json::SyntaxValidator::Type::JSON_checker,
+                          cb::json::SyntaxValidator::Type::JSON_checker_indexed,
                           cb::json::SyntaxValidator::Type::Nlohmann));
 
 TEST_P(SyntaxValidatorTest, SimpleJsonChecksOk) {
@@ -134,3 +138,88 @@ TEST_P(SyntaxValidatorTest, NumberExponentValidatorTest) {
     EXPECT_TRUE(validator->validate("0E5"sv));
     EXPECT_TRUE(validator->validate("0.00e5"sv));
 }
+
+TEST(StructuralIndexTest, Positions) {
+    cb::json::StructuralIndex index;
+    const auto doc = R"({"a": [1, "x\\\"]"], "b": {}})"sv;
+    ASSERT_TRUE(index.build(doc));
+    // The content of the strings (and the quotes closing them) isn't
+    // structural
+    const std::vector<uint32_t> expected = {
+            0, 1, 4, 6, 8, 10, 18, 19, 21, 24, 26, 27, 28};
+    EXPECT_EQ(expected, index.getPositions());
+    EXPECT_EQ(28, index.findClose(0));
+    EXPECT_EQ(18, index.findClose(6));
+    EXPECT_EQ(27, index.findClose(26));
+    EXPECT_EQ(std::string_view::npos, index.findClose(1));
+    EXPECT_EQ(2, index.getMaxDepth());
+}
+
+TEST(StructuralIndexTest, EscapesAcrossBlocks) {
+    // Put a run of escaped backslashes followed by an escaped quote over
+    // the 64 byte block boundary
+    for (std::size_t run = 1; run < 8; ++run) {
+        std::string doc = "[\"" + std::string(62 - run, 'x');
+        doc.append(2 * run, '\\');
+        doc.append("\\\"\"]");
+        cb::json::StructuralIndex index;
+        ASSERT_TRUE(index.build(doc)) << doc;
+        EXPECT_EQ(doc.size() - 1, index.findClose(0)) << doc;
+    }
+}
+
+TEST(StructuralIndexTest, Detached) {
+    const std::string doc = R"({"a": [1, 2], "b": {"c": []}})";
+    cb::json::StructuralIndex index;
+    ASSERT_TRUE(index.build(doc));
+    EXPECT_TRUE(index.isFor(doc));
+    const std::string copy = doc;
+    EXPECT_FALSE(index.isFor(copy));
+
+    // A detached index may be used for a copy of the document (with the
+    // same hash)
+    index.detach(1234);
+    EXPECT_TRUE(index.getDocument().empty());
+    EXPECT_EQ(doc.size(), index.getDocumentSize());
+    EXPECT_TRUE(index.isFor(copy, 1234));
+    EXPECT_FALSE(index.isFor(copy));
+    EXPECT_FALSE(index.isFor(R"({"a": [1, 2]})", 1234));
+
+    // A document of the same size is only an identical copy if the hash
+    // says so
+    const std::string other = R"({"a": [1, 2], "b": {"d": []}})";
+    ASSERT_EQ(doc.size(), other.size());
+    EXPECT_FALSE(index.isFor(other, 5678));
+    EXPECT_EQ(11, index.findClose(6));
+    EXPECT_EQ(27, index.findClose(19));
+    EXPECT_EQ(std::string_view::npos, index.findClose(11));
+
+    index.clear();
+    EXPECT_FALSE(index.isFor(copy, 1234));
+}
+
+TEST(StructuralIndexTest, NotJson) {
+    cb::json::StructuralIndex index;
+    EXPECT_FALSE(index.build(R"({"a": "unterminated})"sv));
+    EXPECT_FALSE(index.build(R"({"a": [1, 2})"sv));
+    EXPECT_FALSE(index.build(R"([[])"sv));
+    EXPECT_FALSE(index.build(R"(])"sv));
+    EXPECT_TRUE(index.getPositions().empty());
+}
+
+TEST(StructuralIndexTest, KeptByTheIndexedValidator) {
+    auto validator = cb::json::SyntaxValidator::New(
+            cb::json::SyntaxValidator::Type::JSON_checker_indexed);
+    const auto doc = R"({"a": [1, 2]})"sv;
+    ASSERT_TRUE(validator->validate(doc));
+    const auto* index = validator->getStructuralIndex();
+    ASSERT_NE(nullptr, index);
+    EXPECT_EQ(doc.data(), index->getDocument().data());
+    EXPECT_EQ(11, index->findClose(6));
+
+    EXPECT_FALSE(validator->validate(R"({"a": [1, 2}})"sv));
+    EXPECT_TRUE(validator->getStructuralIndex()->getPositions().empty());
+
+    EXPECT_EQ(nullptr,
+              cb::json::SyntaxValidator::New()->getStructuralIndex());
+}
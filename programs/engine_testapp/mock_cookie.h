@@ -50,8 +50,18 @@ public:
         user = cb::rbac::UserIdent{newUser, cb::rbac::Domain::Local};
     }
 
+    bool isSendQueueFull() const override {
+        return sendQueueFull;
+    }
+
+    /// Make the connection look as if the client isn't reading its data
+    void setSendQueueFull(bool full) {
+        sendQueueFull = full;
+    }
+
 protected:
     ConnectionPriority priority{ConnectionPriority::Medium};
+    bool sendQueueFull{false};
     cb::rbac::UserIdent user{"nobody", cb::rbac::Domain::Local};
     const nlohmann::json description{{"peer", "you"}, {"socket", "me"}};
 };
@@ -654,6 +654,51 @@ cb::engine_errc MockEngine::mutation(CookieIface& cookie,
     return call_engine_and_handle_EWOULDBLOCK(cookie, engine_fn);
 }
 
+cb::engine_errc MockEngine::mutation_patch(CookieIface& cookie,
+                                           uint32_t opaque,
+                                           const DocKeyView& key,
+                                           cb::const_byte_buffer patch,
+                                           uint8_t datatype,
+                                           uint64_t cas,
+                                           Vbid vbucket,
+                                           uint32_t flags,
+                                           uint64_t by_seqno,
+                                           uint64_t rev_seqno,
+                                           uint32_t expiration,
+                                           uint32_t lock_time,
+                                           uint8_t nru) {
+    auto engine_fn = [this,
+                      &cookie,
+                      opaque,
+                      k = std::cref(key),
+                      patch,
+                      datatype,
+                      cas,
+                      vbucket,
+                      flags,
+                      by_seqno,
+                      rev_seqno,
+                      expiration,
+                      lock_time,
+                      nru]() {
+        return the_engine_dcp->mutation_patch(cookie,
+                                              opaque,
+                                              k,
+                                              patch,
+                                              datatype,
+                                              cas,
+                                              vbucket,
+                                              flags,
+                                              by_seqno,
+                                              rev_seqno,
+                                              expiration,
+                                              lock_time,
+                                              nru);
+    };
+
+    return call_engine_and_handle_EWOULDBLOCK(cookie, engine_fn);
+}
+
 cb::engine_errc MockEngine::deletion(CookieIface& cookie,
                                      uint32_t opaque,
                                      const DocKeyView& key,
@@ -278,6 +278,20 @@ struct MockEngine : public EngineIface, public DcpIface {
                              uint32_t lock_time,
                              uint8_t nru) override;
 
+    cb::engine_errc mutation_patch(CookieIface& cookie,
+                                   uint32_t opaque,
+                                   const DocKeyView& key,
+                                   cb::const_byte_buffer patch,
+                                   uint8_t datatype,
+                                   uint64_t cas,
+                                   Vbid vbucket,
+                                   uint32_t flags,
+                                   uint64_t by_seqno,
+                                   uint64_t rev_seqno,
+                                   uint32_t expiration,
+                                   uint32_t lock_time,
+                                   uint8_t nru) override;
+
     cb::engine_errc deletion(CookieIface& cookie,
                              uint32_t opaque,
                              const DocKeyView& key,
@@ -121,6 +121,11 @@ Options:
   --continue-byte-limit          How many byes each continue can return,
                                  default is no limit.
   --vbucket                      Scan only this vbucket (default is all)
+  --projection path              Only return this (sub-document) path of each
+                                 document (may be repeated, implies -d)
+  --filter path=json             Only return the documents where the value of
+                                 the (sub-document) path equals the JSON value
+                                 (implies -d)
   --help                         This help text
 )";
 
@@ -544,6 +549,9 @@ int main(int argc, char** argv) {
     std::chrono::milliseconds continueTimeLimit{0};
     std::optional<uint16_t> vbucketOption;
 
+    std::vector<std::string> projection;
+    std::string filter;
+
     cb::net::initialize();
 
     constexpr int sampleOptionId = 1;
@@ -554,6 +562,8 @@ int main(int argc, char** argv) {
     constexpr int timeLimitOptionId = 6;
     constexpr int byteLimitOptionId = 7;
     constexpr int vbucketOptionId = 8;
+    constexpr int projectionOptionId = 9;
+    constexpr int filterOptionId = 10;
 
     std::vector<option> long_options = {
             {"ipv4", no_argument, nullptr, '4'},
@@ -590,6 +600,8 @@ int main(int argc, char** argv) {
              nullptr,
              byteLimitOptionId},
             {"vbucket", required_argument, nullptr, vbucketOptionId},
+            {"projection", required_argument, nullptr, projectionOptionId},
+            {"filter", required_argument, nullptr, filterOptionId},
             {nullptr, 0, nullptr, 0}};
 
     while ((cmd = getopt_long(argc,
@@ -686,6 +698,14 @@ int main(int argc, char** argv) {
             vbucketOption = strtoul(optarg);
             num_connections = 1;
             break;
+        case projectionOptionId:
+            projection.emplace_back(optarg);
+            value = true;
+            break;
+        case filterOptionId:
+            filter.assign(optarg);
+            value = true;
+            break;
         default:
             usage(argv[0]);
             return EXIT_FAILURE;
@@ -748,6 +768,26 @@ int main(int argc, char** argv) {
         jsonConfig["collection"] = cid;
     }
 
+    if (!projection.empty()) {
+        jsonConfig["projection"] = projection;
+    }
+
+    if (!filter.empty()) {
+        const auto separator = filter.find('=');
+        if (separator == std::string::npos) {
+            std::cerr << "error: filter must be path=json\n";
+            return EXIT_FAILURE;
+        }
+        auto equals = nlohmann::json::parse(
+                filter.substr(separator + 1), nullptr, false);
+        if (equals.is_discarded()) {
+            std::cerr << "error: filter value is not JSON\n";
+            return EXIT_FAILURE;
+        }
+        jsonConfig["filter"] = {{"path", filter.substr(0, separator)},
+                                {"equals", std::move(equals)}};
+    }
+
     if (snapshotRequirements) {
         if (!vbucketOption) {
             std::cerr << "No vbucket specified for snapshot_requirements\n";
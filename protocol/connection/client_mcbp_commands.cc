@@ -2143,6 +2143,13 @@ BinprotRangeScanCancel::BinprotRangeScanCancel(Vbid vbid, cb::rangescan::Id id)
                                id.size()});
 }
 
+BinprotRangeScanMulti::BinprotRangeScanMulti(const nlohmann::json& config)
+    : BinprotGenericCommand(cb::mcbp::ClientOpcode::RangeScanMulti,
+                            {/*no key*/},
+                            config.dump()) {
+    setDatatype(cb::mcbp::Datatype::JSON);
+}
+
 BinprotGetKeysCommand::BinprotGetKeysCommand(std::string start,
                                              std::optional<uint32_t> nkeys)
     : BinprotGenericCommand(cb::mcbp::ClientOpcode::GetKeys, std::move(start)),
@@ -1229,6 +1229,11 @@ public:
     BinprotRangeScanCancel(Vbid vbid, cb::rangescan::Id id);
 };
 
+class BinprotRangeScanMulti : public BinprotGenericCommand {
+public:
+    explicit BinprotRangeScanMulti(const nlohmann::json& config);
+};
+
 class BinprotGetKeysCommand : public BinprotGenericCommand {
 public:
     BinprotGetKeysCommand(std::string start,
@@ -494,6 +494,8 @@ public:
               {"DCP_CACHED_KEY_META"sv, {Attribute::Supported}});
         setup(ClientOpcode::DcpCacheTransferEnd,
               {"DCP_CACHE_TRANSFER_END"sv, {Attribute::Supported}});
+        setup(ClientOpcode::DcpMutationPatch,
+              {"DCP_MUTATION_PATCH"sv, {Attribute::Supported}});
         setup(ClientOpcode::DcpOsoSnapshot,
               {"DCP_OSO_SNAPSHOT"sv, {Attribute::Supported}});
         setup(ClientOpcode::StopPersistence,
@@ -792,6 +794,11 @@ public:
                 Attribute::MustPreserveBuffer}});
         setup(ClientOpcode::RangeScanCancel,
               {"RANGE_SCAN_CANCEL"sv, {Attribute::Supported}});
+        setup(ClientOpcode::RangeScanMulti,
+              {"RANGE_SCAN_MULTI"sv,
+               {Attribute::Supported,
+                Attribute::SubjectForThrottling,
+                Attribute::MustPreserveBuffer}});
         setup(ClientOpcode::PrepareSnapshot,
               {"PREPARE_SNAPSHOT"sv, {Attribute::Supported}});
         setup(ClientOpcode::ReleaseSnapshot,
@@ -162,4 +162,23 @@ RangeScanContinueResponseExtras::getFlags() const {
     return Flags(ntohl(flags));
 }
 
+RangeScanMultiResponseExtras::RangeScanMultiResponseExtras(bool keyOnly,
+                                                           Vbid vbid)
+    : flags(htonl(uint32_t(keyOnly
+                                   ? RangeScanContinueResponseExtras::Flags::
+                                             KeyScan
+                                   : RangeScanContinueResponseExtras::Flags::
+                                             ValueScan))),
+      vbid(vbid.hton()) {
+}
+
+RangeScanContinueResponseExtras::Flags
+RangeScanMultiResponseExtras::getFlags() const {
+    return RangeScanContinueResponseExtras::Flags(ntohl(flags));
+}
+
+Vbid RangeScanMultiResponseExtras::getVBucket() const {
+    return vbid.ntoh();
+}
+
 } // namespace cb::mcbp::response
\ No newline at end of file
@@ -402,6 +402,7 @@ nlohmann::json Request::to_json(bool validated) const {
         case ClientOpcode::EwouldblockCtl:
         case ClientOpcode::Invalid:
         case ClientOpcode::RangeScanCreate:
+        case ClientOpcode::RangeScanMulti:
         case ClientOpcode::GetFileFragment:
         case ClientOpcode::PrepareSnapshot:
         case ClientOpcode::ReleaseSnapshot:
@@ -532,6 +533,7 @@ nlohmann::json Request::to_json(bool validated) const {
             }
             break;
         case ClientOpcode::DcpMutation:
+        case ClientOpcode::DcpMutationPatch:
             extras = getCommandSpecifics<DcpMutationPayload>();
             break;
         case ClientOpcode::DcpSystemEvent:
@@ -16,6 +16,7 @@
 #include <daemon/mcbp_validators.h>
 #include <mcbp/protocol/header.h>
 #include <memcached/protocol_binary.h>
+#include <array>
 
 FrontEndThread thread;
 /**
@@ -91,9 +92,36 @@ BENCHMARK_DEFINE_F(McbpValidatorBench, AddBench)(benchmark::State& state) {
     }
 }
 
+/// A command context of the same size as the typical command contexts
+class BenchCommandContext : public CommandContext {
+public:
+    std::array<char, 256> data;
+};
+
+/**
+ * Test the cost of allocating (and releasing) a command context for each
+ * command. The "allocs_per_op" counter is the number of contexts which
+ * couldn't be served from the per thread pool.
+ */
+BENCHMARK_DEFINE_F(McbpValidatorBench, CommandContextBench)
+(benchmark::State& state) {
+    Cookie cookie(connection);
+    const auto misses = CommandContext::getPoolMisses();
+
+    while (state.KeepRunning()) {
+        cookie.obtainContext<BenchCommandContext>();
+        cookie.reset();
+    }
+
+    state.counters["allocs_per_op"] = benchmark::Counter(
+            double(CommandContext::getPoolMisses() - misses),
+            benchmark::Counter::kAvgIterations);
+}
+
 BENCHMARK_REGISTER_F(McbpValidatorBench, GetBench);
 BENCHMARK_REGISTER_F(McbpValidatorBench, SetBench);
 BENCHMARK_REGISTER_F(McbpValidatorBench, AddBench);
+BENCHMARK_REGISTER_F(McbpValidatorBench, CommandContextBench);
 
 int main(int argc, char** argv) {
     using namespace std::string_view_literals;
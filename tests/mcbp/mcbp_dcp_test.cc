@@ -679,6 +679,76 @@ TEST_P(DcpMutationValidatorTest, InvalidKey2) {
     }
 }
 
+/**
+ * Test class for DcpMutationPatch validation - the bool parameter toggles
+ * collections on/off
+ */
+class DcpMutationPatchValidatorTest
+    : public ::testing::WithParamInterface<bool>,
+      public ValidatorTest {
+public:
+    DcpMutationPatchValidatorTest()
+        : ValidatorTest(GetParam()), builder({blob, sizeof(blob)}) {
+    }
+
+    void SetUp() override {
+        ValidatorTest::SetUp();
+        builder.setMagic(cb::mcbp::Magic::ClientRequest);
+        builder.setOpcode(cb::mcbp::ClientOpcode::DcpMutationPatch);
+        builder.setDatatype(cb::mcbp::Datatype::JSON);
+        extras.setBySeqno(1);
+        builder.setExtras(extras.getBuffer());
+        uint8_t key[2] = {};
+        builder.setKey({key, size_t(GetParam() ? 2 : 1)});
+        cb::mcbp::request::DcpMutationPatchHeader header(0xcafe, 1, 0);
+        std::string value(
+                reinterpret_cast<const char*>(header.getBuffer().data()),
+                header.getBuffer().size());
+        value.append("{}");
+        builder.setValue(std::string_view{value});
+    }
+
+protected:
+    std::string validate_error_context(
+            cb::mcbp::Status expectedStatus = cb::mcbp::Status::Einval) {
+        return ValidatorTest::validate_error_context(
+                cb::mcbp::ClientOpcode::DcpMutationPatch,
+                blob,
+                expectedStatus);
+    }
+
+    cb::mcbp::RequestBuilder builder;
+    cb::mcbp::request::DcpMutationPayload extras;
+};
+
+TEST_P(DcpMutationPatchValidatorTest, CorrectMessage) {
+    EXPECT_EQ("The command can only be sent on a DCP connection",
+              validate_error_context());
+}
+
+TEST_P(DcpMutationPatchValidatorTest, InvalidKeylen) {
+    builder.setKey(std::string_view{});
+    EXPECT_EQ("Request must include key", validate_error_context());
+}
+
+TEST_P(DcpMutationPatchValidatorTest, ValueTooSmall) {
+    builder.setValue(std::string_view{"abc"});
+    EXPECT_EQ("DCP Mutation Patch value too small", validate_error_context());
+}
+
+TEST_P(DcpMutationPatchValidatorTest, Snappy) {
+    builder.setDatatype(cb::mcbp::Datatype::Snappy);
+    EXPECT_EQ("DCP Mutation Patch can't be compressed",
+              validate_error_context());
+}
+
+TEST_P(DcpMutationPatchValidatorTest, InvalidSeqno) {
+    extras.setBySeqno(0);
+    builder.setExtras(extras.getBuffer());
+    EXPECT_EQ("Invalid seqno(0) for DCP Mutation Patch",
+              validate_error_context());
+}
+
 /**
  * Test class for DcpDeletion validation - the bool parameter toggles
  * collections on/off (as that subtly changes the encoding of a deletion)
@@ -1194,6 +1264,10 @@ INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
                          DcpMutationValidatorTest,
                          ::testing::Bool(),
                          ::testing::PrintToStringParamName());
+INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
+                         DcpMutationPatchValidatorTest,
+                         ::testing::Bool(),
+                         ::testing::PrintToStringParamName());
 INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
                          DcpDeletionValidatorTest,
                          ::testing::Bool(),
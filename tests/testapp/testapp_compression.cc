@@ -251,3 +251,39 @@ TEST_P(CompressionTest, GetLockedReturnsCompressedData) {
     EXPECT_EQ(value, locked.value);
     userConnection->unlock(name, Vbid{0}, locked.info.cas);
 }
+
+/// Verify that a compressed JSON value is only inflated and validated once
+/// when it is stored, and that the document is stored with the JSON
+/// datatype (and compressed)
+TEST_P(CompressionTest, StoreCompressedJsonInflatesAndValidatesOnce) {
+    auto getTotal = [this](const std::string& group) {
+        uint64_t total = 0;
+        adminConnection->stats(
+                [&total](const auto&, const auto& v) {
+                    total = nlohmann::json::parse(v)["total"].get<uint64_t>();
+                },
+                group);
+        return total;
+    };
+
+    const auto validated = getTotal("json_validate");
+    const auto inflated = getTotal("snappy_decompress");
+
+    constexpr uint64_t NumMutations = 100;
+    Document doc;
+    doc.info.id = name;
+    doc.value = fmt::format(R"({{"value":"{}"}})", std::string(4_KiB, 'a'));
+    doc.compress();
+    for (uint64_t ii = 0; ii < NumMutations; ++ii) {
+        userConnection->mutate(doc, Vbid{0}, MutationType::Set);
+    }
+
+    EXPECT_EQ(validated + NumMutations, getTotal("json_validate"));
+    EXPECT_EQ(inflated + NumMutations, getTotal("snappy_decompress"));
+
+    waitForCompression();
+    const auto document = userConnection->get(name, Vbid{0});
+    EXPECT_EQ(cb::mcbp::Datatype(uint8_t(cb::mcbp::Datatype::JSON) |
+                                 uint8_t(cb::mcbp::Datatype::Snappy)),
+              document.info.datatype);
+}
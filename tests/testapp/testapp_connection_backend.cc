@@ -0,0 +1,181 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+/*
+ * Tests which run the basic traffic through each of the connection
+ * backends (see "connection_backend" in docs/FrontendWorkerThread.md).
+ * The backend is selected when the connection is created, and the tests
+ * verify that the connection got the requested backend by looking at
+ * "connections self".
+ * The io_uring tests are skipped if the server fell back to libevent
+ * (io_uring isn't available on the platform or in the kernel).
+ */
+
+#include "testapp.h"
+
+#include <platform/byte_literals.h>
+#include <chrono>
+#include <thread>
+
+class ConnectionBackendTest
+    : public TestappTest,
+      public ::testing::WithParamInterface<std::string> {
+protected:
+    void SetUp() override {
+        TestappTest::SetUp();
+        memcached_cfg["connection_backend"] = GetParam();
+        reconfigure();
+
+        conn = connect(false);
+        const auto backend = getBackend(*conn);
+        if (GetParam() == "io_uring" && backend == "libevent") {
+            GTEST_SKIP() << "io_uring isn't available";
+        }
+        ASSERT_EQ(GetParam(), backend);
+    }
+
+    void TearDown() override {
+        conn.reset();
+        memcached_cfg.erase("connection_backend");
+        reconfigure();
+        TestappTest::TearDown();
+    }
+
+    /// Create a new connection authenticated as Luke and connected to the
+    /// test bucket
+    std::unique_ptr<MemcachedConnection> connect(bool tls) {
+        auto ret = connectionMap
+                           .getConnection(tls,
+                                          mcd_env->haveIPv4() ? AF_INET
+                                                              : AF_INET6)
+                           .clone();
+        ret->authenticate("Luke");
+        ret->selectBucket(bucketName);
+        ret->setFeatures({cb::mcbp::Feature::XERROR});
+        return ret;
+    }
+
+    /// Get the connection details the server holds for the connection
+    static nlohmann::json getConnectionStats(MemcachedConnection& c) {
+        auto stats = c.stats("connections self");
+        EXPECT_EQ(1, stats.size());
+        return stats.front();
+    }
+
+    static std::string getBackend(MemcachedConnection& c) {
+        return getConnectionStats(c)["backend"].get<std::string>();
+    }
+
+    /// Store a document with the provided size and verify that we can
+    /// read it back
+    void storeAndGet(MemcachedConnection& c, size_t size) {
+        Document doc;
+        doc.info.id = name;
+        doc.value.resize(size);
+        for (size_t ii = 0; ii < size; ++ii) {
+            doc.value[ii] = 'a' + char(ii % 26);
+        }
+        c.mutate(doc, Vbid(0), MutationType::Set);
+        const auto fetched = c.get(name, Vbid(0));
+        EXPECT_EQ(doc.value, fetched.value);
+    }
+
+    std::unique_ptr<MemcachedConnection> conn;
+};
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         ConnectionBackendTest,
+                         ::testing::Values("libevent", "io_uring"),
+                         [](const auto& info) { return info.param; });
+
+TEST_P(ConnectionBackendTest, GetSet) {
+    storeAndGet(*conn, 10);
+
+    // Pipeline a few commands so that the server get multiple frames in
+    // a single read
+    for (int ii = 0; ii < 10; ++ii) {
+        conn->sendCommand(
+                BinprotGenericCommand{cb::mcbp::ClientOpcode::Get, name});
+    }
+    for (int ii = 0; ii < 10; ++ii) {
+        BinprotResponse rsp;
+        conn->recvResponse(rsp);
+        ASSERT_TRUE(rsp.isSuccess()) << rsp.getStatus();
+    }
+}
+
+TEST_P(ConnectionBackendTest, LargeValues) {
+    // Values spanning many receive buffers in both directions, and values
+    // around the sizes where the server stops copying the value
+    for (const auto size : {511_KiB, 1_MiB, 20_MiB - 1_KiB}) {
+        storeAndGet(*conn, size);
+    }
+    for (const auto size : {511, 512, 4096, 4097}) {
+        storeAndGet(*conn, size);
+    }
+}
+
+TEST_P(ConnectionBackendTest, ChainedValues) {
+    // io_uring gathers values of 512 bytes and up straight from the item
+    // (libevent only references values above SendBuffer::MinimumDataSize)
+    const size_t threshold = GetParam() == "io_uring" ? 512 : 4097;
+    for (const size_t size : {511, 512, 4096, 4097, 64 * 1024}) {
+        storeAndGet(*conn, size);
+        const auto before =
+                getConnectionStats(*conn)["total_send_chained"].get<size_t>();
+        EXPECT_EQ(size, conn->get(name, Vbid(0)).value.size());
+        const auto after =
+                getConnectionStats(*conn)["total_send_chained"].get<size_t>();
+        if (size >= threshold) {
+            EXPECT_EQ(before + size, after) << "size: " << size;
+        } else {
+            EXPECT_EQ(before, after) << "size: " << size;
+        }
+    }
+}
+
+TEST_P(ConnectionBackendTest, Tls) {
+    // TLS connections always use libevent
+    auto tls = connect(true);
+    EXPECT_EQ("libevent", getBackend(*tls));
+    EXPECT_TRUE(getConnectionStats(*tls)["ssl"].get<bool>());
+    storeAndGet(*tls, 1_MiB);
+}
+
+TEST_P(ConnectionBackendTest, Disconnect) {
+    const auto socket = getConnectionStats(*conn)["socket"].get<int64_t>();
+
+    // Disconnect in the middle of a frame; the server should release the
+    // connection
+    auto frame = conn->encodeCmdGet(name, Vbid(0));
+    conn->sendPartialFrame(frame, frame.payload.size() - 1);
+    conn->close();
+
+    const auto timeout =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    bool found = true;
+    while (found && std::chrono::steady_clock::now() < timeout) {
+        found = false;
+        for (const auto& c : adminConnection->stats("connections")) {
+            if (c["socket"].get<int64_t>() == socket) {
+                found = true;
+            }
+        }
+        if (found) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    EXPECT_FALSE(found) << "The connection was not released by the server";
+
+    // And new connections should still work
+    conn = connect(false);
+    EXPECT_EQ(GetParam(), getBackend(*conn));
+    storeAndGet(*conn, 100);
+}
@@ -9,6 +9,7 @@
  */
 #include "testapp.h"
 #include "testapp_client_test.h"
+#include <folly/Portability.h>
 #include <gmock/gmock-matchers.h>
 #include <platform/base64.h>
 #include <platform/dirutils.h>
@@ -616,6 +617,65 @@ TEST_P(InterfacesTest, MB63984_ConnStatsBindFail) {
     cb::net::closesocket(serverSocket);
 }
 
+/// Verify that clients may connect to an interface where each of the front
+/// end threads accept clients on its own socket, and that the interface
+/// may be deleted
+TEST_P(InterfacesTest, PerThreadListeners) {
+    memcached_cfg["per_thread_listeners"] = true;
+    reconfigure();
+
+    nlohmann::json descr = {{"host", "127.0.0.1"},
+                            {"port", 0},
+                            {"family", "inet"},
+                            {"system", false},
+                            {"type", "mcbp"}};
+    auto rsp = adminConnection->execute(BinprotGenericCommand{
+            cb::mcbp::ClientOpcode::Ifconfig, "define", descr.dump()});
+    ASSERT_TRUE(rsp.isSuccess()) << rsp.getStatus() << std::endl
+                                 << rsp.getDataView();
+    auto json = rsp.getDataJson();
+    ASSERT_EQ(1, json["ports"].size()) << json.dump(2);
+    const auto uuid = json["ports"][0]["uuid"].get<std::string>();
+    const auto port = json["ports"][0]["port"].get<in_port_t>();
+
+    // Each of the front end threads should have its own socket (the mode
+    // is only available on Linux)
+    const size_t expectedListeners =
+            folly::kIsLinux ? memcached_cfg["threads"].get<size_t>() : 1;
+    EXPECT_EQ(expectedListeners,
+              json["ports"][0]["listeners"].get<size_t>())
+            << json.dump(2);
+
+    // The kernel picks the thread to accept the client on; connect enough
+    // clients for all of the threads to be likely to accept one
+    std::vector<std::unique_ptr<MemcachedConnection>> connections;
+    for (int ii = 0; ii < 10; ++ii) {
+        connections.emplace_back(std::make_unique<MemcachedConnection>(
+                "127.0.0.1", port, AF_INET, false));
+        auto& conn = *connections.back();
+        conn.connect();
+        conn.authenticate("Luke");
+        conn.selectBucket(bucketName);
+    }
+
+    rsp = adminConnection->execute(BinprotGenericCommand{
+            cb::mcbp::ClientOpcode::Ifconfig, "delete", uuid});
+    ASSERT_TRUE(rsp.isSuccess()) << rsp.getStatus() << std::endl
+                                 << rsp.getDataView();
+
+    // The connected clients stay connected, but new ones are refused
+    for (auto& conn : connections) {
+        EXPECT_TRUE(conn->execute(BinprotGenericCommand{
+                                          cb::mcbp::ClientOpcode::Noop})
+                            .isSuccess());
+    }
+    MemcachedConnection conn("127.0.0.1", port, AF_INET, false);
+    EXPECT_THROW(conn.connect(), std::exception);
+
+    memcached_cfg.erase("per_thread_listeners");
+    reconfigure();
+}
+
 class ConnectionResetTest : public TestappClientTest {
 protected:
     /// Wait for the the client named "name" to hello
@@ -0,0 +1,141 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+/*
+ * Performance tests for fetching large documents.
+ *
+ * Each test stores a 1MB document and fetches it a number of times with the
+ * configured send path, and records the time spent and the number of bytes
+ * the kernel sent with and without copying the payload per GET (as a
+ * measure of the memory bandwidth spent per GET) in the test properties.
+ */
+
+#include "testapp.h"
+#include "testapp_client_test.h"
+
+#include <folly/Portability.h>
+#include <platform/byte_literals.h>
+#include <chrono>
+#include <thread>
+
+class LargeValuePerfTest : public TestappClientTest {
+protected:
+    void TearDown() override {
+        memcached_cfg.erase("connection_backend");
+        memcached_cfg.erase("zerocopy_send_threshold");
+        reconfigure();
+        TestappClientTest::TearDown();
+    }
+
+    /**
+     * Run the test with the provided settings
+     *
+     * @param backend The connection backend to use
+     * @param threshold The zerocopy_send_threshold to use
+     */
+    void run(std::string_view backend, size_t threshold);
+
+    /// Get the number of bytes sent with zero copy (and the number of them
+    /// the kernel had to copy)
+    std::pair<uint64_t, uint64_t> getZeroCopyBytes();
+
+    static constexpr size_t iterations =
+            (folly::kIsSanitize || (folly::kIsWindows && folly::kIsDebug))
+                    ? 10
+                    : 1000;
+};
+
+INSTANTIATE_TEST_SUITE_P(TransportProtocols,
+                         LargeValuePerfTest,
+                         ::testing::Values(TransportProtocols::McbpPlain),
+                         ::testing::PrintToStringParamName());
+
+std::pair<uint64_t, uint64_t> LargeValuePerfTest::getZeroCopyBytes() {
+    uint64_t sent = 0;
+    uint64_t copied = 0;
+    adminConnection->stats([&sent, &copied](auto& k, auto& v) {
+        if (k == "zerocopy_send_bytes") {
+            sent = std::stoull(v);
+        } else if (k == "zerocopy_send_copied_bytes") {
+            copied = std::stoull(v);
+        }
+    });
+    return {sent, copied};
+}
+
+void LargeValuePerfTest::run(std::string_view backend, size_t threshold) {
+    memcached_cfg["connection_backend"] = backend;
+    memcached_cfg["zerocopy_send_threshold"] = threshold;
+    reconfigure();
+
+    // The backend is selected when the connection is created
+    auto conn = userConnection->clone();
+    conn->authenticate("Luke");
+    conn->selectBucket(bucketName);
+    const auto stats = conn->stats("connections self");
+    ASSERT_EQ(1, stats.size());
+    if (stats.front()["backend"] != backend) {
+        GTEST_SKIP() << backend << " isn't available";
+    }
+
+    Document doc;
+    doc.info.id = name;
+    doc.value.resize(1_MiB, 'a');
+    conn->mutate(doc, Vbid(0), MutationType::Set);
+
+    const auto [sentBefore, copiedBefore] = getZeroCopyBytes();
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t ii = 0; ii < iterations; ++ii) {
+        ASSERT_EQ(1_MiB, conn->get(name, Vbid(0)).value.size());
+    }
+    const auto duration = std::chrono::steady_clock::now() - start;
+    auto [sentAfter, copiedAfter] = getZeroCopyBytes();
+
+    if (threshold == 0) {
+        EXPECT_EQ(sentBefore, sentAfter) << "Zero copy should be disabled";
+    } else {
+        // Wait for the notifications for the last sends before verifying
+        // that the values were sent with zero copy
+        const auto timeout =
+                std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (sentAfter - sentBefore < iterations * 1_MiB &&
+               std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::tie(sentAfter, copiedAfter) = getZeroCopyBytes();
+        }
+        EXPECT_LE(iterations * 1_MiB, sentAfter - sentBefore)
+                << "The values were not sent with zero copy";
+    }
+
+    const auto zerocopy = (sentAfter - sentBefore) / iterations;
+    const auto copied = (copiedAfter - copiedBefore) / iterations;
+    RecordProperty(
+            "get_us",
+            std::to_string(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                            duration)
+                            .count() /
+                    iterations));
+    RecordProperty("zerocopy_bytes_per_get", std::to_string(zerocopy));
+    RecordProperty("copied_bytes_per_get",
+                   std::to_string(1_MiB - zerocopy + copied));
+}
+
+TEST_P(LargeValuePerfTest, Get_Libevent) {
+    run("libevent", 0);
+}
+
+TEST_P(LargeValuePerfTest, Get_IoUring) {
+    run("io_uring", 0);
+}
+
+TEST_P(LargeValuePerfTest, Get_IoUringZeroCopy) {
+    run("io_uring", 64_KiB);
+}
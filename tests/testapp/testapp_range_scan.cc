@@ -513,6 +513,143 @@ TEST_P(RangeScanTest, ValueScan) {
             drainScan(id, false, 2, userKeys).records); // 2 items per continue
 }
 
+TEST_P(RangeScanTest, CreateInvalidProjection) {
+    const auto expectInvalid = [this](const nlohmann::json& invalid) {
+        BinprotRangeScanCreate create(Vbid(0), invalid);
+        auto resp = userConnection->execute(create);
+        EXPECT_EQ(cb::mcbp::Status::Einval, resp.getStatus()) << invalid;
+    };
+    const auto withProjection = [this](nlohmann::json projection) {
+        auto rv = config;
+        rv["projection"] = std::move(projection);
+        return rv;
+    };
+
+    expectInvalid(withProjection("key"));
+    expectInvalid(withProjection(nlohmann::json::array()));
+    expectInvalid(withProjection({""}));
+    expectInvalid(withProjection({1}));
+    // Longer than the 1024 bytes subdoc allows for a path
+    expectInvalid(withProjection({std::string(1025, 'a')}));
+
+    // One path more than a multi-path subdoc command may have
+    auto tooMany = nlohmann::json::array();
+    for (int ii = 0; ii < 17; ++ii) {
+        tooMany.push_back(fmt::format("a{}", ii));
+    }
+    expectInvalid(withProjection(tooMany));
+
+    auto filter = config;
+    filter["filter"] = {{"path", "key"}};
+    expectInvalid(filter);
+    filter["filter"] = {{"equals", "user-alan"}};
+    expectInvalid(filter);
+    filter["filter"] = {{"path", 1}, {"equals", "user-alan"}};
+    expectInvalid(filter);
+
+    // A projection or filter needs the value (and without the xattrs)
+    auto keyOnly = withProjection({"key"});
+    keyOnly["key_only"] = true;
+    expectInvalid(keyOnly);
+    auto xattrs = config;
+    xattrs["filter"] = {{"path", "key"}, {"equals", "user-alan"}};
+    xattrs["include_xattrs"] = true;
+    expectInvalid(xattrs);
+}
+
+TEST_P(RangeScanTest, ProjectedValueScan) {
+    // The duplicate path is only projected once, and the values are
+    // projected to the one field of the documents
+    config["projection"] = {"key", "key"};
+    BinprotRangeScanCreate create(Vbid(0), config);
+    auto resp = userConnection->execute(create);
+    ASSERT_EQ(cb::mcbp::Status::Success, resp.getStatus());
+    cb::rangescan::Id id;
+    std::memcpy(id.data, resp.getDataView().data(), resp.getDataView().size());
+    EXPECT_EQ(userKeys.size(), drainScan(id, false, 2, userKeys).records);
+}
+
+TEST_P(RangeScanTest, FilteredValueScan) {
+    config["projection"] = {"key", "missing", "key"};
+    config["filter"] = {{"path", "key"}, {"equals", "user-alan"}};
+    BinprotRangeScanCreate create(Vbid(0), config);
+    auto resp = userConnection->execute(create);
+    ASSERT_EQ(cb::mcbp::Status::Success, resp.getStatus());
+    cb::rangescan::Id id;
+    std::memcpy(id.data, resp.getDataView().data(), resp.getDataView().size());
+
+    // No limits, so all of the matching documents come from one continue
+    userConnection->sendCommand(
+            BinprotRangeScanContinue(Vbid(0), id, 0, {}, 0));
+    std::vector<std::pair<std::string, std::string>> records;
+    do {
+        userConnection->recvResponse(resp);
+        if (resp.getDataView().empty()) {
+            continue;
+        }
+        cb::mcbp::response::RangeScanContinueValuePayload payload(
+                resp.getDataView());
+        for (auto record = payload.next(); record.key.data();
+             record = payload.next()) {
+            // The projected value is built uncompressed
+            EXPECT_EQ(PROTOCOL_BINARY_DATATYPE_JSON, record.meta.getDatatype());
+            records.emplace_back(record.key, record.value);
+        }
+    } while (resp.getStatus() == cb::mcbp::Status::Success);
+    EXPECT_EQ(cb::mcbp::Status::RangeScanComplete, resp.getStatus());
+
+    // Only the matching document, with only the fields found (once)
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ("user-alan", records.front().first);
+    EXPECT_EQ(R"({"key":"user-alan"})", records.front().second);
+}
+
+TEST_P(RangeScanTest, MultiKeyOnly) {
+    // range-scan-multi has no snapshot requirements, so use a create to wait
+    // for the keys to be persisted
+    BinprotRangeScanCreate create(Vbid(0), config);
+    auto resp = userConnection->execute(create);
+    ASSERT_EQ(cb::mcbp::Status::Success, resp.getStatus());
+    cb::rangescan::Id id;
+    std::memcpy(id.data, resp.getDataView().data(), resp.getDataView().size());
+    resp = userConnection->execute(BinprotRangeScanCancel(Vbid(0), id));
+    ASSERT_EQ(cb::mcbp::Status::Success, resp.getStatus());
+
+    config.erase("snapshot_requirements");
+    config["key_only"] = true;
+    config["vbuckets"] = {0};
+    userConnection->sendCommand(BinprotRangeScanMulti(config));
+
+    // The data responses (success) carry the vbucket of the keys, and are
+    // followed by the final response
+    size_t count = 0;
+    while (true) {
+        userConnection->recvResponse(resp);
+        if (resp.getStatus() != cb::mcbp::Status::Success) {
+            break;
+        }
+        ASSERT_EQ(6, resp.getExtrasView().size());
+        const auto* extras = reinterpret_cast<
+                const cb::mcbp::response::RangeScanMultiResponseExtras*>(
+                resp.getExtrasView().data());
+        EXPECT_EQ(Vbid(0), extras->getVBucket());
+        EXPECT_EQ(cb::mcbp::response::RangeScanContinueResponseExtras::Flags::
+                          KeyScan,
+                  extras->getFlags());
+
+        cb::mcbp::response::RangeScanContinueKeyPayload payload(
+                resp.getDataView());
+        for (auto key = payload.next(); key.data(); key = payload.next()) {
+            EXPECT_EQ(1, userKeys.count(std::string{key})) << key;
+            ++count;
+        }
+    }
+    ASSERT_EQ(cb::mcbp::Status::RangeScanComplete, resp.getStatus());
+    EXPECT_EQ(nlohmann::json::object(),
+              nlohmann::json::parse(resp.getDataView()));
+    EXPECT_EQ(userKeys.size(), count);
+}
+
 // Set the buffer to be 0 and check that each key is sent in a single mcbp
 // response (frames).
 void RangeScanTest::smallBufferTest(size_t itemLimit,
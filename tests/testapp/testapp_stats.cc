@@ -17,6 +17,8 @@
 #include <protocol/mcbp/ewb_encode.h>
 #include <serverless/config.h>
 #include <utilities/timing_histogram_printer.h>
+#include <chrono>
+#include <thread>
 
 using namespace std::string_view_literals;
 
@@ -1001,6 +1003,47 @@ TEST_P(StatsTest, MagmaThreadStats) {
     EXPECT_EQ(50, getStat("magma_flusher_thread_percentage"));
 }
 
+/// Verify that the front end threads keep serving clients while busy
+/// polling, and that the time spent spinning without finding any work is
+/// reported (and stops growing once busy polling is disabled)
+TEST_P(StatsTest, BusyPollSpinTime) {
+    const auto getSpinTime = []() {
+        return adminConnection->stats("")["busy_poll_spin_time_ns"]
+                .get<uint64_t>();
+    };
+
+    memcached_cfg["busy_poll_time"] = 1000;
+    reconfigure();
+    const auto before = getSpinTime();
+    for (int ii = 0; ii < 10; ++ii) {
+        EXPECT_TRUE(adminConnection
+                            ->execute(BinprotGenericCommand{
+                                    cb::mcbp::ClientOpcode::Noop})
+                            .isSuccess());
+    }
+    // The thread serving the admin connection spins for (at least) a
+    // millisecond after each of the commands before it blocks
+    const auto timeout =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto after = getSpinTime();
+    while (after == before && std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        after = getSpinTime();
+    }
+    EXPECT_LT(before, after);
+
+    // Removing the setting from the config doesn't change it, so turn it
+    // off explicitly
+    memcached_cfg["busy_poll_time"] = 0;
+    reconfigure();
+    memcached_cfg.erase("busy_poll_time");
+    // Let the threads finish the spin they were in when the setting changed
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto disabled = getSpinTime();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(disabled, getSpinTime());
+}
+
 /// The stats should contain max user and system connections to allow
 /// for alerting by monitoring the current levels with the max
 TEST_P(StatsTest, MB58199) {
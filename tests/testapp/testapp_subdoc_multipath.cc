@@ -776,3 +776,188 @@ TEST_P(SubdocTestappTest,
 
     delete_object("item");
 }
+
+// Test that repeated lookups in a large document are served from the
+// subdoc index cache, and that the cache isn't used once the document
+// changes
+// Check that the lookups resolved in a single pass over the document are
+// returned in the order requested, and that the paths it can't resolve
+// (missing, mismatched or using escaped keys) get the same status as before.
+TEST_P(SubdocTestappTest, SubdocMultiLookup_SinglePass) {
+    store_document("doc",
+                   R"({"b": {"c": [10, "x\"y", {"d": true}], "e": null},)"
+                   R"( "a": 1, "k`k": "escaped", "z": "last"})");
+
+    SubdocMultiLookupCmd lookup;
+    lookup.key = "doc";
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "z"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "b.c[2].d"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "a"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "b.c[1]"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocExists, {}, "b"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "missing"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "b.c.x"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "b.c[-1]"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "`k``k`"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "b.e"});
+
+    expect_subdoc_cmd(
+            lookup,
+            cb::mcbp::Status::SubdocMultiPathFailure,
+            {{cb::mcbp::Status::Success, R"("last")"},
+             {cb::mcbp::Status::Success, "true"},
+             {cb::mcbp::Status::Success, "1"},
+             {cb::mcbp::Status::Success, R"("x\"y")"},
+             {cb::mcbp::Status::Success, ""},
+             {cb::mcbp::Status::SubdocPathEnoent, ""},
+             {cb::mcbp::Status::SubdocPathMismatch, ""},
+             {cb::mcbp::Status::Success, R"({"d": true})"},
+             {cb::mcbp::Status::Success, R"("escaped")"},
+             {cb::mcbp::Status::Success, "null"}});
+
+    delete_object("doc");
+}
+
+TEST_P(SubdocTestappTest, SubdocMultiLookup_IndexCache) {
+    memcached_cfg["subdoc_index_cache_size"] = 1024;
+    reconfigure();
+
+    auto getHits = [this]() {
+        return adminConnection->stats("")["subdoc_index_cache_hits"]
+                .get<uint64_t>();
+    };
+
+    nlohmann::json doc = {{"padding", std::string(2048, 'x')},
+                          {"name", "foo"},
+                          {"address", {{"city", "Oslo"}}}};
+    store_document("hot", doc.dump());
+
+    SubdocMultiLookupCmd lookup;
+    lookup.key = "hot";
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "name"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "address.city"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocExists, {}, "address"});
+    std::vector<SubdocMultiLookupResult> expected{
+            {cb::mcbp::Status::Success, R"("foo")"},
+            {cb::mcbp::Status::Success, R"("Oslo")"},
+            {cb::mcbp::Status::Success, ""}};
+
+    const auto hits = getHits();
+    expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    EXPECT_EQ(hits + lookup.specs.size(), getHits());
+
+    // The document changes (and with it the location of the values)
+    doc["name"] = "a much longer name";
+    store_document("hot", doc.dump());
+    expected[0] = {cb::mcbp::Status::Success, R"("a much longer name")"};
+    expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    EXPECT_EQ(hits + 2 * lookup.specs.size(), getHits());
+
+    delete_object("hot");
+    memcached_cfg.erase("subdoc_index_cache_size");
+    reconfigure();
+}
+
+// Test that a hot document is given a structural index, and that the
+// lookup of paths not seen before is served correctly from it
+TEST_P(SubdocTestappTest, SubdocMultiLookup_IndexCacheHotDocument) {
+    memcached_cfg["subdoc_index_cache_size"] = 1024;
+    reconfigure();
+
+    auto getIndexed = [this]() {
+        return adminConnection->stats("")["subdoc_index_cache_indexed"]
+                .get<uint64_t>();
+    };
+
+    nlohmann::json doc = {{"padding", std::string(2048, 'x')},
+                          {"list", {1, 2, {{"deep", true}}}},
+                          {"name", "foo"},
+                          {"address", {{"city", "Oslo"}, {"zip", "0150"}}}};
+    store_document("hot", doc.dump());
+
+    SubdocMultiLookupCmd lookup;
+    lookup.key = "hot";
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "name"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "address.city"});
+    std::vector<SubdocMultiLookupResult> expected{
+            {cb::mcbp::Status::Success, R"("foo")"},
+            {cb::mcbp::Status::Success, R"("Oslo")"}};
+
+    const auto indexed = getIndexed();
+    for (int ii = 0; ii < 3; ++ii) {
+        expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    }
+
+    // The document is now hot, so new paths are found with its index
+    lookup.specs.clear();
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "list[2].deep"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "address.zip"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "address.street"});
+    expected = {{cb::mcbp::Status::Success, "true"},
+                {cb::mcbp::Status::Success, R"("0150")"},
+                {cb::mcbp::Status::SubdocPathEnoent, ""}};
+    expect_subdoc_cmd(
+            lookup, cb::mcbp::Status::SubdocMultiPathFailure, expected);
+    EXPECT_EQ(indexed + 1, getIndexed());
+
+    delete_object("hot");
+    memcached_cfg.erase("subdoc_index_cache_size");
+    reconfigure();
+}
+
+// Test that the structural index of a hot document isn't kept when it
+// doesn't fit in the byte budget of the indexes (and the lookups still
+// work without it)
+TEST_P(SubdocTestappTest, SubdocMultiLookup_IndexCacheIndexBytes) {
+    memcached_cfg["subdoc_index_cache_size"] = 1024;
+    memcached_cfg["subdoc_index_cache_index_bytes"] = 64;
+    reconfigure();
+
+    auto getIndexed = [this]() {
+        return adminConnection->stats("")["subdoc_index_cache_indexed"]
+                .get<uint64_t>();
+    };
+
+    nlohmann::json doc = {{"padding", std::string(2048, 'x')},
+                          {"name", "foo"},
+                          {"address", {{"city", "Oslo"}, {"zip", "0150"}}}};
+    store_document("hot", doc.dump());
+
+    SubdocMultiLookupCmd lookup;
+    lookup.key = "hot";
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "name"});
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "address.city"});
+    std::vector<SubdocMultiLookupResult> expected{
+            {cb::mcbp::Status::Success, R"("foo")"},
+            {cb::mcbp::Status::Success, R"("Oslo")"}};
+
+    const auto indexed = getIndexed();
+    for (int ii = 0; ii < 3; ++ii) {
+        expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    }
+
+    lookup.specs.clear();
+    lookup.specs.push_back(
+            {cb::mcbp::ClientOpcode::SubdocGet, {}, "address.zip"});
+    lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, "name"});
+    expected = {{cb::mcbp::Status::Success, R"("0150")"},
+                {cb::mcbp::Status::Success, R"("foo")"}};
+    expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    EXPECT_EQ(indexed, getIndexed());
+
+    delete_object("hot");
+    memcached_cfg.erase("subdoc_index_cache_size");
+    memcached_cfg.erase("subdoc_index_cache_index_bytes");
+    reconfigure();
+}
@@ -385,6 +385,37 @@ TEST_P(SubdocPerfTest, Dict_Add_Multipath) {
 }
 
 
+// Measure GETing all keys in a dictionary, looking up the maximum number of
+// paths per command (in reverse order, so the paths are spread over the
+// whole document and not sorted).
+TEST_P(SubdocPerfTest, Dict_Get_Multipath) {
+    subdoc_create_dict("dict", iterations);
+
+    SubdocMultiLookupCmd lookup;
+    lookup.key = "dict";
+    std::vector<SubdocMultiLookupResult> expected;
+    for (size_t i = iterations; i > 0; i--) {
+        std::string key(std::to_string(i - 1));
+        lookup.specs.push_back({cb::mcbp::ClientOpcode::SubdocGet, {}, key});
+        expected.push_back(
+                {cb::mcbp::Status::Success, "\"value_" + key + '"'});
+
+        if (lookup.specs.size() ==
+            Settings::instance().getSubdocMultiMaxPaths()) {
+            expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+            lookup.specs.clear();
+            expected.clear();
+        }
+    }
+
+    if (!lookup.specs.empty()) {
+        expect_subdoc_cmd(lookup, cb::mcbp::Status::Success, expected);
+    }
+
+    delete_object("dict");
+}
+
+
 /*****************************************************************************
  * 'Fulldoc' Performance Tests
  *
@@ -155,3 +155,36 @@ TEST_P(TlsTests, DHE_RSA_AES256_SHA256) {
     reloadConfig();
     shouldPass(TlsVersion::V1_2);
 }
+
+/// With kernel TLS offload enabled the connection must still work (whether
+/// the kernel takes over the record encryption depends on the kernel and
+/// the negotiated cipher), and report the offload in its details
+TEST_P(TlsTests, KernelOffload) {
+    memcached_cfg["tls_kernel_offload"] = true;
+    reconfigure();
+
+    // The setting applies to new connections
+    connection->reconnect();
+    connection->authenticate("Luke");
+    connection->selectBucket(bucketName);
+
+    Document doc;
+    doc.info.id = name;
+    doc.value = std::string(64 * 1024, 'k');
+    connection->mutate(doc, Vbid(0), MutationType::Set);
+    EXPECT_EQ(doc.value, connection->get(name, Vbid(0)).value);
+
+    auto stats = connection->stats("connections self");
+    ASSERT_EQ(1, stats.size());
+    const auto& details = stats.front();
+    EXPECT_TRUE(details["ssl"].get<bool>());
+    ASSERT_TRUE(details.contains("ktls")) << details.dump();
+    EXPECT_TRUE(details["ktls"]["send"].is_boolean());
+    EXPECT_TRUE(details["ktls"]["receive"].is_boolean());
+
+    // Removing the setting from the config doesn't change it, so turn it
+    // off explicitly
+    memcached_cfg["tls_kernel_offload"] = false;
+    reconfigure();
+    memcached_cfg.erase("tls_kernel_offload");
+}
@@ -2764,3 +2764,51 @@ TEST_P(XattrNoDocTest, TestSubdocOffloadToNonIoThread_big_doc) {
         EXPECT_EQ("false", r.value);
     }
 }
+
+TEST_P(XattrNoDocTest, TestSubdocOffloadToNonIoThread_compressed_doc) {
+    if (hasSnappySupport() != ClientSnappySupport::Yes) {
+        GTEST_SKIP() << "The document is only stored compressed with snappy";
+    }
+
+    auto getSubocNonIOCount = []() {
+        size_t count = 0;
+        userConnection->stats([&count](auto k, auto v) {
+            if (k == "subdoc_offload_count") {
+                count = std::stoi(std::string(v));
+            }
+        });
+        return count;
+    };
+
+    auto count = getSubocNonIOCount();
+
+    // The document is small when compressed, but above the offload
+    // threshold once inflated
+    nlohmann::json json = {{"key-0", false}};
+    json["key-1"] = std::string(2_MiB, 'a');
+    Document document;
+    document.info.id = name;
+    document.value = json.dump();
+    document.compress();
+    ASSERT_LT(document.value.size(), 1_MiB);
+    userConnection->mutate(document, Vbid(0), MutationType::Set);
+
+    auto rsp = subdoc_get("key-0");
+    EXPECT_EQ(Status::Success, rsp.getStatus());
+    EXPECT_EQ("false", rsp.getDataView());
+    EXPECT_EQ(++count, getSubocNonIOCount());
+
+    // The document is inflated by the worker thread. It can't be inflated
+    // above the max packet size, and the error is returned to the client
+    auto resetConfigGuard = folly::makeGuard([this]() {
+        memcached_cfg["max_packet_size"] = 20;
+        reconfigure();
+        memcached_cfg.erase("max_packet_size");
+    });
+    memcached_cfg["max_packet_size"] = 1;
+    reconfigure();
+
+    rsp = subdoc_get("key-0");
+    EXPECT_EQ(Status::Einternal, rsp.getStatus());
+    EXPECT_EQ(++count, getSubocNonIOCount());
+}
@@ -24,7 +24,8 @@
 
 namespace cb::xattr {
 
-Blob::Blob(const Blob& other) {
+Blob::Blob(const Blob& other)
+    : use_index(other.use_index), index(other.index) {
     allocator = std::string{other.blob.data(), other.blob.size()};
     blob = {allocator.data(), allocator.size()};
 }
@@ -36,6 +37,7 @@ Blob::Blob(cb::char_buffer buffer, bool compressed) {
 Blob& Blob::assign(std::string_view buffer, bool compressed) {
     blob = {};
     allocator = {};
+    index.reset();
 
     if (buffer.empty()) {
         return *this;
@@ -66,7 +68,53 @@ Blob& Blob::assign(std::string_view buffer, bool compressed) {
     return *this;
 }
 
+void Blob::build_index() const {
+    use_index = true;
+    if (index) {
+        return;
+    }
+
+    std::vector<uint32_t> offsets;
+    try {
+        size_t current = 4;
+        while (current < blob.size()) {
+            offsets.push_back(gsl::narrow<uint32_t>(current));
+            current += 4 + read_length(current);
+        }
+    } catch (const std::out_of_range&) {
+    }
+    // Stable so that we find the same (first) kv-pair as a scan would
+    std::ranges::stable_sort(offsets, [this](auto a, auto b) {
+        return read_key(a) < read_key(b);
+    });
+    index = std::move(offsets);
+}
+
+std::string_view Blob::read_key(size_t offset) const {
+    const auto* ptr = blob.data() + offset + 4;
+    return {ptr, strlen(ptr)};
+}
+
+std::optional<size_t> Blob::find_indexed(std::string_view key) const {
+    build_index();
+    const auto iter = std::ranges::lower_bound(
+            *index, key, {}, [this](auto offset) { return read_key(offset); });
+    if (iter == index->end() || read_key(*iter) != key) {
+        return std::nullopt;
+    }
+    return *iter;
+}
+
 std::string_view Blob::get(std::string_view key) const {
+    if (use_index) {
+        const auto offset = find_indexed(key);
+        if (!offset) {
+            return {};
+        }
+        const auto* value = blob.data() + *offset + 4 + key.size() + 1;
+        return {value, strlen(value)};
+    }
+
     try {
         size_t current = 4;
         while (current < blob.size()) {
@@ -130,6 +178,16 @@ void Blob::remove(std::string_view key) {
 }
 
 void Blob::set(std::string_view key, std::string_view value) {
+    const auto old = get(key);
+    if (!old.empty() && old.size() == value.size()) {
+        // Overwrite the value (the layout of the blob, and the index, stays
+        // the same)
+        std::memmove(blob.data() + (old.data() - blob.data()),
+                     value.data(),
+                     value.size());
+        return;
+    }
+
     remove(key);
     if (!value.empty()) {
         append_kvpair(key, value);
@@ -150,6 +208,7 @@ void Blob::grow_buffer(uint32_t size) {
 void Blob::write_kvpair(size_t offset,
                         std::string_view key,
                         std::string_view value) {
+    index.reset();
     // offset points to where we want to inject the value
     write_length(offset, uint32_t(key.size() + 1 + value.size() + 1));
     offset += 4;
@@ -177,6 +236,7 @@ void Blob::append_kvpair(std::string_view key, std::string_view value) {
 }
 
 void Blob::remove_segment(const size_t offset, const size_t size) {
+    index.reset();
     if (offset + size == blob.size()) {
         // No need to do anyting as this was the last thing in our blob..
         // just change the length
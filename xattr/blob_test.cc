@@ -285,3 +285,72 @@ TEST(XattrBlob, Compressed) {
                           true);
     validate(blob2);
 }
+
+TEST(XattrBlob, Indexed) {
+    cb::xattr::Blob blob;
+    for (int ii = 0; ii < 100; ++ii) {
+        blob.set(fmt::format("key-{}", ii), fmt::format("value-{}", ii));
+    }
+    const std::string encoded{blob.finalize()};
+
+    blob.build_index();
+    EXPECT_EQ(encoded, blob.finalize());
+    for (int ii = 0; ii < 100; ++ii) {
+        EXPECT_EQ(fmt::format("value-{}", ii),
+                  blob.get(fmt::format("key-{}", ii)));
+    }
+    EXPECT_TRUE(blob.get("key").empty());
+    EXPECT_TRUE(blob.get("key-100").empty());
+
+    // A value of the same size is replaced in place
+    blob.set("key-42", "value-xx");
+    EXPECT_EQ(encoded.size(), blob.finalize().size());
+    EXPECT_EQ(encoded.find("value-42"), blob.finalize().find("value-xx"));
+    EXPECT_EQ("value-xx"sv, blob.get("key-42"));
+
+    // The index follows keys being added, resized and removed
+    blob.set("key-100", "value-100");
+    blob.set("key-7", "value-777");
+    blob.remove("key-3");
+    EXPECT_TRUE(cb::xattr::validate(blob.finalize()));
+    EXPECT_EQ("value-100"sv, blob.get("key-100"));
+    EXPECT_EQ("value-777"sv, blob.get("key-7"));
+    EXPECT_TRUE(blob.get("key-3").empty());
+    EXPECT_EQ("value-99"sv, blob.get("key-99"));
+
+    // A copy uses the index too
+    cb::xattr::Blob copy(blob);
+    EXPECT_EQ("value-777"sv, copy.get("key-7"));
+}
+
+TEST(XattrBlob, SetInPlaceOnCallerBuffer) {
+    cb::xattr::Blob source;
+    source.set("_sync", R"({"cas":"0x0000000000000000"})");
+    source.set("user", "value");
+    const auto body = R"({"body":true})"sv;
+    const auto cas = R"({"cas":"0x0123456789abcdef"})"sv;
+
+    for (const bool indexed : {false, true}) {
+        std::string document{source.finalize()};
+        document.append(body);
+
+        cb::xattr::Blob blob({document.data(), document.size()}, false);
+        if (indexed) {
+            blob.build_index();
+        }
+        blob.set("_sync", cas);
+
+        // The value is written to the caller's buffer (the blob isn't
+        // copied), and the rest of the document is untouched
+        EXPECT_EQ(document.data(), blob.finalize().data()) << indexed;
+        EXPECT_EQ(source.size(), blob.size()) << indexed;
+        EXPECT_EQ(cas, blob.get("_sync")) << indexed;
+        EXPECT_EQ(body, std::string_view{document}.substr(source.size()))
+                << indexed;
+
+        const cb::xattr::Blob reread({document.data(), document.size()},
+                                     false);
+        EXPECT_EQ(cas, reread.get("_sync")) << indexed;
+        EXPECT_EQ("value"sv, reread.get("user")) << indexed;
+    }
+}